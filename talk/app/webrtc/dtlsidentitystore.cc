@@ -27,8 +27,11 @@
 
 #include "talk/app/webrtc/dtlsidentitystore.h"
 
+#include <algorithm>
+
 #include "talk/app/webrtc/webrtcsessiondescriptionfactory.h"
 #include "webrtc/base/logging.h"
+#include "webrtc/base/timeutils.h"
 
 using webrtc::DtlsIdentityRequestObserver;
 
@@ -43,9 +46,12 @@ namespace {
 enum {
   MSG_DESTROY,
   MSG_GENERATE_IDENTITY,
-  MSG_GENERATE_IDENTITY_RESULT
+  MSG_GENERATE_IDENTITY_RESULT,
+  MSG_REFILL_POOL
 };
 
+typedef rtc::TypedMessageData<rtc::KeyType> KeyTypeMessageData;
+
 }  // namespace
 
 // This class runs on the worker thread to generate the identity. It's necessary
@@ -66,13 +72,15 @@ class DtlsIdentityStoreImpl::WorkerTask : public sigslot::has_slots<>,
  private:
   void GenerateIdentity_w() {
     LOG(LS_INFO) << "Generating identity, using keytype " << key_type_;
+    uint32 start = rtc::Time();
     rtc::scoped_ptr<rtc::SSLIdentity> identity(
         rtc::SSLIdentity::Generate(kIdentityName, key_type_));
+    int generation_time_ms = rtc::TimeSince(start);
 
     // Posting to |this| avoids touching |store_| on threads other than
     // |signaling_thread_| and thus avoids having to use locks.
     IdentityResultMessageData* msg = new IdentityResultMessageData(
-        new IdentityResult(key_type_, identity.Pass()));
+        new IdentityResult(key_type_, identity.Pass(), generation_time_ms));
     signaling_thread_->Post(this, MSG_GENERATE_IDENTITY_RESULT, msg);
   }
 
@@ -93,7 +101,8 @@ class DtlsIdentityStoreImpl::WorkerTask : public sigslot::has_slots<>,
               static_cast<IdentityResultMessageData*>(msg->pdata));
           if (store_) {
             store_->OnIdentityGenerated(pdata->data()->key_type_,
-                                        pdata->data()->identity_.Pass());
+                                        pdata->data()->identity_.Pass(),
+                                        pdata->data()->generation_time_ms_);
           }
         }
         break;
@@ -121,27 +130,53 @@ DtlsIdentityStoreImpl::DtlsIdentityStoreImpl(rtc::Thread* signaling_thread,
                                              rtc::Thread* worker_thread)
     : signaling_thread_(signaling_thread),
       worker_thread_(worker_thread),
-      request_info_() {
+      request_info_(),
+      refill_cpu_budget_percent_(100) {
   DCHECK(signaling_thread_->IsCurrent());
   // Preemptively generate identities unless the worker thread and signaling
-  // thread are the same (only do preemptive work in the background).
-  if (worker_thread_ != signaling_thread_) {
-    // Only necessary for RSA.
-    GenerateIdentity(rtc::KT_RSA, nullptr);
-  }
+  // thread are the same (only do preemptive work in the background, see
+  // RefillPool). Only necessary for RSA by default.
+  SetPoolSize(rtc::KT_RSA, 1);
 }
 
 DtlsIdentityStoreImpl::~DtlsIdentityStoreImpl() {
   DCHECK(signaling_thread_->IsCurrent());
+  signaling_thread_->Clear(this);
   SignalDestroyed();
 }
 
+void DtlsIdentityStoreImpl::SetPoolSize(rtc::KeyType key_type,
+                                        size_t pool_size) {
+  DCHECK(signaling_thread_->IsCurrent());
+  RequestInfo& info = request_info_[key_type];
+  info.pool_size_ = pool_size;
+  while (info.free_identities_.collection().size() > pool_size) {
+    rtc::SSLIdentity* identity = info.free_identities_.collection().back();
+    info.free_identities_.Remove(identity);
+    delete identity;
+  }
+  RefillPool(key_type);
+}
+
+void DtlsIdentityStoreImpl::SetRefillCpuBudget(int percent) {
+  DCHECK(signaling_thread_->IsCurrent());
+  DCHECK(percent > 0 && percent <= 100);
+  refill_cpu_budget_percent_ = percent;
+}
+
+DtlsIdentityStoreImpl::Stats DtlsIdentityStoreImpl::GetStats(
+    rtc::KeyType key_type) const {
+  DCHECK(signaling_thread_->IsCurrent());
+  return request_info_[key_type].stats_;
+}
+
 void DtlsIdentityStoreImpl::RequestIdentity(
     rtc::KeyType key_type,
     const rtc::scoped_refptr<webrtc::DtlsIdentityRequestObserver>& observer) {
   DCHECK(signaling_thread_->IsCurrent());
   DCHECK(observer);
 
+  ++request_info_[key_type].stats_.requests;
   GenerateIdentity(key_type, observer);
 }
 
@@ -152,7 +187,15 @@ void DtlsIdentityStoreImpl::OnMessage(rtc::Message* msg) {
       rtc::scoped_ptr<IdentityResultMessageData> pdata(
           static_cast<IdentityResultMessageData*>(msg->pdata));
       OnIdentityGenerated(pdata->data()->key_type_,
-                          pdata->data()->identity_.Pass());
+                          pdata->data()->identity_.Pass(),
+                          pdata->data()->generation_time_ms_);
+      break;
+    }
+    case MSG_REFILL_POOL: {
+      rtc::scoped_ptr<KeyTypeMessageData> pdata(
+          static_cast<KeyTypeMessageData*>(msg->pdata));
+      request_info_[pdata->data()].refill_scheduled_ = false;
+      RefillPool(pdata->data());
       break;
     }
   }
@@ -160,34 +203,42 @@ void DtlsIdentityStoreImpl::OnMessage(rtc::Message* msg) {
 
 bool DtlsIdentityStoreImpl::HasFreeIdentityForTesting(
     rtc::KeyType key_type) const {
+  return FreeIdentityCountForTesting(key_type) != 0;
+}
+
+size_t DtlsIdentityStoreImpl::FreeIdentityCountForTesting(
+    rtc::KeyType key_type) const {
   DCHECK(signaling_thread_->IsCurrent());
-  return request_info_[key_type].free_identity_.get() != nullptr;
+  return request_info_[key_type].free_identities_.collection().size();
 }
 
 void DtlsIdentityStoreImpl::GenerateIdentity(
     rtc::KeyType key_type,
     const rtc::scoped_refptr<webrtc::DtlsIdentityRequestObserver>& observer) {
   DCHECK(signaling_thread_->IsCurrent());
+  RequestInfo& info = request_info_[key_type];
 
   // Enqueue observer to be informed when generation of |key_type| is completed.
   if (observer.get()) {
-    request_info_[key_type].request_observers_.push(observer);
+    info.request_observers_.push(observer);
 
     // Already have a free identity generated?
-    if (request_info_[key_type].free_identity_.get()) {
+    if (!info.free_identities_.collection().empty()) {
       // Return identity async - post even though we are on |signaling_thread_|.
       LOG(LS_VERBOSE) << "Using a free DTLS identity.";
-      ++request_info_[key_type].gen_in_progress_counts_;
+      ++info.stats_.pool_hits;
+      ++info.gen_in_progress_counts_;
+      rtc::scoped_ptr<rtc::SSLIdentity> identity(
+          info.free_identities_.collection().front());
+      info.free_identities_.Remove(identity.get());
       IdentityResultMessageData* msg = new IdentityResultMessageData(
-          new IdentityResult(key_type,
-                             request_info_[key_type].free_identity_.Pass()));
+          new IdentityResult(key_type, identity.Pass(), -1));
       signaling_thread_->Post(this, MSG_GENERATE_IDENTITY_RESULT, msg);
       return;
     }
 
     // Free identity in the process of being generated?
-    if (request_info_[key_type].gen_in_progress_counts_ ==
-            request_info_[key_type].request_observers_.size()) {
+    if (info.gen_in_progress_counts_ == info.request_observers_.size()) {
       // No need to do anything, the free identity will be returned to the
       // observer in a MSG_GENERATE_IDENTITY_RESULT.
       return;
@@ -195,7 +246,7 @@ void DtlsIdentityStoreImpl::GenerateIdentity(
   }
 
   // Enqueue/Post a worker task to do the generation.
-  ++request_info_[key_type].gen_in_progress_counts_;
+  ++info.gen_in_progress_counts_;
   WorkerTask* task = new WorkerTask(this, key_type);  // Post 1 task/request.
   // The WorkerTask is owned by the message data to make sure it will not be
   // leaked even if the task does not get run.
@@ -204,26 +255,40 @@ void DtlsIdentityStoreImpl::GenerateIdentity(
 }
 
 void DtlsIdentityStoreImpl::OnIdentityGenerated(
-    rtc::KeyType key_type, rtc::scoped_ptr<rtc::SSLIdentity> identity) {
+    rtc::KeyType key_type, rtc::scoped_ptr<rtc::SSLIdentity> identity,
+    int generation_time_ms) {
   DCHECK(signaling_thread_->IsCurrent());
+  RequestInfo& info = request_info_[key_type];
+
+  DCHECK(info.gen_in_progress_counts_);
+  --info.gen_in_progress_counts_;
 
-  DCHECK(request_info_[key_type].gen_in_progress_counts_);
-  --request_info_[key_type].gen_in_progress_counts_;
+  if (generation_time_ms >= 0) {
+    if (identity.get())
+      ++info.stats_.generated;
+    else
+      ++info.stats_.failed;
+    info.stats_.total_generation_time_ms += generation_time_ms;
+    info.stats_.max_generation_time_ms =
+        std::max(info.stats_.max_generation_time_ms, generation_time_ms);
+    info.last_generation_time_ms_ = generation_time_ms;
+  }
 
   rtc::scoped_refptr<webrtc::DtlsIdentityRequestObserver> observer;
-  if (!request_info_[key_type].request_observers_.empty()) {
-    observer = request_info_[key_type].request_observers_.front();
-    request_info_[key_type].request_observers_.pop();
+  if (!info.request_observers_.empty()) {
+    observer = info.request_observers_.front();
+    info.request_observers_.pop();
   }
 
   if (observer.get() == nullptr) {
     // No observer - store result in |free_identities_|.
-    DCHECK(!request_info_[key_type].free_identity_.get());
-    request_info_[key_type].free_identity_.swap(identity);
-    if (request_info_[key_type].free_identity_.get())
-      LOG(LS_VERBOSE) << "A free DTLS identity was saved.";
-    else
+    if (!identity.get()) {
+      // Don't keep retrying in the background; the next request will.
       LOG(LS_WARNING) << "Failed to generate DTLS identity (preemptively).";
+      return;
+    }
+    LOG(LS_VERBOSE) << "A free DTLS identity was saved.";
+    info.free_identities_.PushBack(identity.release());
   } else {
     // Return the result to the observer.
     if (identity.get()) {
@@ -233,16 +298,37 @@ void DtlsIdentityStoreImpl::OnIdentityGenerated(
       LOG(LS_WARNING) << "Failed to generate DTLS identity.";
       observer->OnFailure(0);
     }
+  }
 
-    // Preemptively generate another identity of the same type?
-    if (worker_thread_ != signaling_thread_ && // Only do in background thread.
-        key_type == rtc::KT_RSA &&             // Only necessary for RSA.
-        !request_info_[key_type].free_identity_.get() &&
-        request_info_[key_type].request_observers_.size() <=
-            request_info_[key_type].gen_in_progress_counts_) {
-      GenerateIdentity(key_type, nullptr);
-    }
+  // Preemptively generate another identity of the same type?
+  RefillPool(key_type);
+}
+
+void DtlsIdentityStoreImpl::RefillPool(rtc::KeyType key_type) {
+  DCHECK(signaling_thread_->IsCurrent());
+  RequestInfo& info = request_info_[key_type];
+  // Only refill in the background, one identity at a time, and never while
+  // a generation is in progress, so that the pool never delays a request
+  // by more than one generation.
+  if (worker_thread_ == signaling_thread_ ||
+      info.refill_scheduled_ ||
+      info.gen_in_progress_counts_ != 0 ||
+      info.free_identities_.collection().size() >= info.pool_size_) {
+    return;
+  }
+
+  // Wait long enough after the last generation to keep the time the worker
+  // thread spends on refills within |refill_cpu_budget_percent_|.
+  int delay_ms = info.last_generation_time_ms_ *
+                 (100 - refill_cpu_budget_percent_) /
+                 refill_cpu_budget_percent_;
+  if (delay_ms > 0) {
+    info.refill_scheduled_ = true;
+    signaling_thread_->PostDelayed(delay_ms, this, MSG_REFILL_POOL,
+                                   new KeyTypeMessageData(key_type));
+    return;
   }
+  GenerateIdentity(key_type, nullptr);
 }
 
 }  // namespace webrtc
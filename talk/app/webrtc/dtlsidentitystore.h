@@ -35,6 +35,7 @@
 #include "webrtc/base/messagequeue.h"
 #include "webrtc/base/refcount.h"
 #include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/scopedptrcollection.h"
 #include "webrtc/base/scoped_ref_ptr.h"
 #include "webrtc/base/sslidentity.h"
 #include "webrtc/base/thread.h"
@@ -79,15 +80,56 @@ class DtlsIdentityStoreInterface {
 
 // The WebRTC default implementation of DtlsIdentityStoreInterface.
 // Identity generation is performed on the worker thread.
+//
+// If the worker thread is not the same as the signaling thread, the store keeps
+// a pool of free identities of each key type, generated in the background, so
+// that requests can be answered without waiting for a generation. By default
+// the pool holds one RSA identity and no ECDSA identity.
 class DtlsIdentityStoreImpl : public DtlsIdentityStoreInterface,
                               public rtc::MessageHandler {
  public:
+  // Counters for one key type, see GetStats().
+  struct Stats {
+    Stats()
+        : requests(0),
+          pool_hits(0),
+          generated(0),
+          failed(0),
+          total_generation_time_ms(0),
+          max_generation_time_ms(0) {}
+
+    // Number of RequestIdentity calls.
+    int requests;
+    // Number of requests answered with an identity from the pool.
+    int pool_hits;
+    // Number of identities generated, for requests or for the pool.
+    int generated;
+    // Number of generations that failed.
+    int failed;
+    // Time spent generating identities on the worker thread.
+    int total_generation_time_ms;
+    int max_generation_time_ms;
+  };
+
   // This will start to preemptively generating an RSA identity in the
   // background if the worker thread is not the same as the signaling thread.
   DtlsIdentityStoreImpl(rtc::Thread* signaling_thread,
                         rtc::Thread* worker_thread);
   ~DtlsIdentityStoreImpl() override;
 
+  // Sets the number of free identities of |key_type| to keep ready, and starts
+  // filling the pool up to that number. Has no effect if the worker thread is
+  // the same as the signaling thread.
+  void SetPoolSize(rtc::KeyType key_type, size_t pool_size);
+
+  // Limits the time the worker thread spends refilling the pools to about
+  // |percent| of its time, by waiting between background generations. Requests
+  // that cannot be answered from the pool are not throttled. The default is
+  // 100, which refills the pools as fast as possible.
+  void SetRefillCpuBudget(int percent);
+
+  Stats GetStats(rtc::KeyType key_type) const;
+
   // DtlsIdentityStoreInterface override;
   void RequestIdentity(
       rtc::KeyType key_type,
@@ -98,13 +140,20 @@ class DtlsIdentityStoreImpl : public DtlsIdentityStoreInterface,
 
   // Returns true if there is a free RSA identity, used for unit tests.
   bool HasFreeIdentityForTesting(rtc::KeyType key_type) const;
+  // Returns the number of free identities of |key_type|.
+  size_t FreeIdentityCountForTesting(rtc::KeyType key_type) const;
 
  private:
   void GenerateIdentity(
       rtc::KeyType key_type,
       const rtc::scoped_refptr<DtlsIdentityRequestObserver>& observer);
+  // |generation_time_ms| is -1 if |identity| was taken from the pool.
   void OnIdentityGenerated(rtc::KeyType key_type,
-                           rtc::scoped_ptr<rtc::SSLIdentity> identity);
+                           rtc::scoped_ptr<rtc::SSLIdentity> identity,
+                           int generation_time_ms);
+  // Starts generating another free identity of |key_type| if its pool is not
+  // full and no generation of that type is in progress.
+  void RefillPool(rtc::KeyType key_type);
 
   class WorkerTask;
   typedef rtc::ScopedMessageData<DtlsIdentityStoreImpl::WorkerTask>
@@ -113,11 +162,15 @@ class DtlsIdentityStoreImpl : public DtlsIdentityStoreInterface,
   // A key type-identity pair.
   struct IdentityResult {
     IdentityResult(rtc::KeyType key_type,
-                   rtc::scoped_ptr<rtc::SSLIdentity> identity)
-        : key_type_(key_type), identity_(identity.Pass()) {}
+                   rtc::scoped_ptr<rtc::SSLIdentity> identity,
+                   int generation_time_ms)
+        : key_type_(key_type),
+          identity_(identity.Pass()),
+          generation_time_ms_(generation_time_ms) {}
 
     rtc::KeyType key_type_;
     rtc::scoped_ptr<rtc::SSLIdentity> identity_;
+    int generation_time_ms_;
   };
 
   typedef rtc::ScopedMessageData<IdentityResult> IdentityResultMessageData;
@@ -132,16 +185,28 @@ class DtlsIdentityStoreImpl : public DtlsIdentityStoreInterface,
 
   struct RequestInfo {
     RequestInfo()
-        : request_observers_(), gen_in_progress_counts_(0), free_identity_() {}
+        : request_observers_(),
+          gen_in_progress_counts_(0),
+          free_identities_(),
+          pool_size_(0),
+          refill_scheduled_(false),
+          last_generation_time_ms_(0),
+          stats_() {}
 
     std::queue<rtc::scoped_refptr<DtlsIdentityRequestObserver>>
         request_observers_;
     size_t gen_in_progress_counts_;
-    rtc::scoped_ptr<rtc::SSLIdentity> free_identity_;
+    rtc::ScopedPtrCollection<rtc::SSLIdentity> free_identities_;
+    size_t pool_size_;
+    // True while a delayed MSG_REFILL_POOL is pending.
+    bool refill_scheduled_;
+    int last_generation_time_ms_;
+    Stats stats_;
   };
 
   // One RequestInfo per KeyType. Only touch on the |signaling_thread_|.
   RequestInfo request_info_[rtc::KT_LAST];
+  int refill_cpu_budget_percent_;
 };
 
 }  // namespace webrtc
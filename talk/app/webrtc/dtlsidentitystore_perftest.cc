@@ -0,0 +1,107 @@
+/*
+ * libjingle
+ * Copyright 2015 Google Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Requests identities for 100 PeerConnections back to back, each of which
+// needs one identity, with and without a pool big enough for all of them.
+// ECDSA is used to keep the run short; RSA generation is much slower, which
+// only makes the pool more useful.
+
+#include "talk/app/webrtc/dtlsidentitystore.h"
+
+#include <vector>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/base/gunit.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/ssladapter.h"
+#include "webrtc/base/timeutils.h"
+
+using webrtc::DtlsIdentityStoreImpl;
+
+static const int kTimeoutMs = 10000;
+
+class CountingDtlsIdentityRequestObserver
+    : public webrtc::DtlsIdentityRequestObserver {
+ public:
+  CountingDtlsIdentityRequestObserver() : succeeded_(false) {}
+  void OnFailure(int error) override {}
+  void OnSuccess(const std::string& der_cert,
+                 const std::string& der_private_key) override {}
+  void OnSuccess(rtc::scoped_ptr<rtc::SSLIdentity> identity) override {
+    succeeded_ = true;
+  }
+
+  bool succeeded() const { return succeeded_; }
+
+ private:
+  bool succeeded_;
+};
+
+class DtlsIdentityStorePerfTest : public testing::Test {
+ protected:
+  DtlsIdentityStorePerfTest() : worker_thread_(new rtc::Thread()) {
+    CHECK(worker_thread_->Start());
+  }
+
+  static void SetUpTestCase() {
+    rtc::InitializeSSL();
+  }
+  static void TearDownTestCase() {
+    rtc::CleanupSSL();
+  }
+
+  rtc::scoped_ptr<rtc::Thread> worker_thread_;
+};
+
+TEST_F(DtlsIdentityStorePerfTest, BurstOfRequests) {
+  const size_t kNumRequests = 100;
+  for (size_t pool_size : {static_cast<size_t>(0), kNumRequests}) {
+    DtlsIdentityStoreImpl store(rtc::Thread::Current(), worker_thread_.get());
+    store.SetPoolSize(rtc::KT_ECDSA, pool_size);
+    EXPECT_EQ_WAIT(pool_size,
+                   store.FreeIdentityCountForTesting(rtc::KT_ECDSA),
+                   kTimeoutMs);
+
+    std::vector<rtc::scoped_refptr<CountingDtlsIdentityRequestObserver>>
+        observers;
+    uint32 start = rtc::Time();
+    for (size_t i = 0; i < kNumRequests; ++i) {
+      observers.push_back(
+          new rtc::RefCountedObject<CountingDtlsIdentityRequestObserver>());
+      store.RequestIdentity(rtc::KT_ECDSA, observers.back().get());
+    }
+    EXPECT_TRUE_WAIT(observers.back()->succeeded(), kTimeoutMs);
+    int elapsed_ms = rtc::TimeSince(start);
+
+    DtlsIdentityStoreImpl::Stats stats = store.GetStats(rtc::KT_ECDSA);
+    EXPECT_EQ(static_cast<int>(kNumRequests), stats.requests);
+    LOG(LS_INFO) << "Pool size " << pool_size << ": " << kNumRequests
+                 << " requests answered in " << elapsed_ms << " ms, "
+                 << stats.pool_hits << " pool hits, max "
+                 << stats.max_generation_time_ms << " ms per generation";
+  }
+}
@@ -150,3 +150,28 @@ TEST_F(DtlsIdentityStoreTest, DeleteStoreEarlyNoCrashECDSA) {
   EXPECT_FALSE(observer_->call_back_called());
 }
 
+TEST_F(DtlsIdentityStoreTest, PoolIsRefilledAfterRequest) {
+  store_->SetPoolSize(rtc::KT_ECDSA, 3);
+  EXPECT_EQ_WAIT(3u, store_->FreeIdentityCountForTesting(rtc::KT_ECDSA),
+                 kTimeoutMs);
+
+  store_->RequestIdentity(rtc::KT_ECDSA, observer_.get());
+  EXPECT_TRUE_WAIT(observer_->LastRequestSucceeded(), kTimeoutMs);
+  EXPECT_EQ_WAIT(3u, store_->FreeIdentityCountForTesting(rtc::KT_ECDSA),
+                 kTimeoutMs);
+
+  DtlsIdentityStoreImpl::Stats stats = store_->GetStats(rtc::KT_ECDSA);
+  EXPECT_EQ(1, stats.requests);
+  EXPECT_EQ(1, stats.pool_hits);
+  EXPECT_EQ(4, stats.generated);
+  EXPECT_EQ(0, stats.failed);
+  EXPECT_GE(stats.total_generation_time_ms, stats.max_generation_time_ms);
+}
+
+TEST_F(DtlsIdentityStoreTest, ShrinkingPoolDropsFreeIdentities) {
+  store_->SetPoolSize(rtc::KT_ECDSA, 2);
+  EXPECT_EQ_WAIT(2u, store_->FreeIdentityCountForTesting(rtc::KT_ECDSA),
+                 kTimeoutMs);
+  store_->SetPoolSize(rtc::KT_ECDSA, 0);
+  EXPECT_EQ(0u, store_->FreeIdentityCountForTesting(rtc::KT_ECDSA));
+}
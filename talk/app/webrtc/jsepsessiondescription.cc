@@ -180,11 +180,13 @@ bool JsepSessionDescription::GetMediasectionIndex(
     return false;
   }
   *index = static_cast<size_t>(candidate->sdp_mline_index());
-  if (description_ && !candidate->sdp_mid().empty()) {
+  // sdp_mid() returns by value; look it up once rather than per content.
+  const std::string sdp_mid = candidate->sdp_mid();
+  if (description_ && !sdp_mid.empty()) {
     bool found = false;
     // Try to match the sdp_mid with content name.
     for (size_t i = 0; i < description_->contents().size(); ++i) {
-      if (candidate->sdp_mid() == description_->contents().at(i).name) {
+      if (sdp_mid == description_->contents().at(i).name) {
         *index = i;
         found = true;
         break;
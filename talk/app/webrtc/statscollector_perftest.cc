@@ -0,0 +1,157 @@
+/*
+ * libjingle
+ * Copyright 2015 Google Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Measures UpdateStats + GetStats, as done by a client polling stats, on a
+// session with many outgoing video streams.
+
+#include "talk/app/webrtc/statscollector.h"
+
+#include "talk/app/webrtc/mediastream.h"
+#include "talk/app/webrtc/test/fakemediastreamsignaling.h"
+#include "talk/app/webrtc/videotrack.h"
+#include "talk/media/base/fakemediaengine.h"
+#include "talk/media/devices/fakedevicemanager.h"
+#include "talk/session/media/channelmanager.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/gunit.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/timeutils.h"
+
+using testing::_;
+using testing::DoAll;
+using testing::Return;
+using testing::ReturnNull;
+using testing::SetArgPointee;
+
+namespace webrtc {
+namespace {
+
+const char kTrackId[] = "track_id";
+const char kVideoChannelName[] = "video";
+const uint32 kFirstSsrc = 1234;
+
+class MockWebRtcSession : public webrtc::WebRtcSession {
+ public:
+  explicit MockWebRtcSession(cricket::ChannelManager* channel_manager)
+      : WebRtcSession(channel_manager, rtc::Thread::Current(),
+                      rtc::Thread::Current(), NULL, NULL) {}
+  MOCK_METHOD0(voice_channel, cricket::VoiceChannel*());
+  MOCK_METHOD0(video_channel, cricket::VideoChannel*());
+  MOCK_CONST_METHOD0(mediastream_signaling, const MediaStreamSignaling*());
+  MOCK_METHOD2(GetLocalTrackIdBySsrc, bool(uint32, std::string*));
+  MOCK_METHOD2(GetRemoteTrackIdBySsrc, bool(uint32, std::string*));
+  MOCK_METHOD1(GetTransportStats, bool(cricket::SessionStats*));
+  MOCK_METHOD1(GetTransport, cricket::Transport*(const std::string&));
+};
+
+class MockVideoMediaChannel : public cricket::FakeVideoMediaChannel {
+ public:
+  MockVideoMediaChannel() : cricket::FakeVideoMediaChannel(NULL) {}
+  MOCK_METHOD1(GetStats, bool(cricket::VideoMediaInfo*));
+};
+
+}  // namespace
+
+class StatsCollectorPerfTest : public testing::Test {
+ protected:
+  StatsCollectorPerfTest()
+      : media_engine_(new cricket::FakeMediaEngine()),
+        channel_manager_(
+            new cricket::ChannelManager(media_engine_,
+                                        new cricket::FakeDeviceManager(),
+                                        rtc::Thread::Current())),
+        session_(channel_manager_.get()),
+        signaling_(channel_manager_.get()) {
+    EXPECT_CALL(session_, mediastream_signaling())
+        .WillRepeatedly(Return(&signaling_));
+  }
+
+  cricket::FakeMediaEngine* media_engine_;
+  rtc::scoped_ptr<cricket::ChannelManager> channel_manager_;
+  MockWebRtcSession session_;
+  FakeMediaStreamSignaling signaling_;
+};
+
+TEST_F(StatsCollectorPerfTest, GetStatsWithManyStreams) {
+  const std::string kTransportName("trspname");
+  cricket::TransportStats transport_stats;
+  cricket::TransportChannelStats channel_stats;
+  channel_stats.component = 1;
+  transport_stats.content_name = kTransportName;
+  transport_stats.channel_stats.push_back(channel_stats);
+  cricket::SessionStats session_stats;
+  session_stats.transport_stats[kTransportName] = transport_stats;
+  session_stats.proxy_to_transport[kVideoChannelName] = kTransportName;
+  EXPECT_CALL(session_, GetTransportStats(_))
+      .WillRepeatedly(DoAll(SetArgPointee<0>(session_stats), Return(true)));
+  EXPECT_CALL(session_, GetTransport(_))
+      .WillRepeatedly(Return(static_cast<cricket::Transport*>(NULL)));
+
+  MockVideoMediaChannel* media_channel = new MockVideoMediaChannel();
+  cricket::VideoChannel video_channel(rtc::Thread::Current(), media_channel,
+                                      NULL, kVideoChannelName, false);
+  EXPECT_CALL(session_, video_channel()).WillRepeatedly(Return(&video_channel));
+  EXPECT_CALL(session_, voice_channel()).WillRepeatedly(ReturnNull());
+
+  rtc::scoped_refptr<MediaStream> stream(MediaStream::Create("streamlabel"));
+  stream->AddTrack(VideoTrack::Create(kTrackId, NULL));
+  EXPECT_CALL(session_, GetLocalTrackIdBySsrc(_, _))
+      .WillRepeatedly(DoAll(SetArgPointee<1>(kTrackId), Return(true)));
+
+  const int kNumStreams[] = {10, 100, 500};
+  const int kNumIterations = 100;
+  for (int num_streams : kNumStreams) {
+    StatsCollector stats(&session_);
+    stats.AddStream(stream);
+
+    cricket::VideoMediaInfo stats_read;
+    for (int i = 0; i < num_streams; ++i) {
+      cricket::VideoSenderInfo video_sender_info;
+      video_sender_info.add_ssrc(kFirstSsrc + i);
+      video_sender_info.bytes_sent = 1000 * i;
+      stats_read.senders.push_back(video_sender_info);
+    }
+    EXPECT_CALL(*media_channel, GetStats(_))
+        .WillRepeatedly(DoAll(SetArgPointee<0>(stats_read), Return(true)));
+
+    uint64 start = rtc::TimeMicros();
+    for (int i = 0; i < kNumIterations; ++i) {
+      stats.ClearUpdateStatsCacheForTest();
+      stats.UpdateStats(PeerConnectionInterface::kStatsOutputLevelStandard);
+      StatsReports reports;
+      stats.GetStats(NULL, &reports);
+      EXPECT_LE(static_cast<size_t>(num_streams), reports.size());
+    }
+    uint64 elapsed = rtc::TimeMicros() - start;
+
+    LOG(LS_INFO) << "Average UpdateStats+GetStats time for " << num_streams
+                 << " streams: " << elapsed / kNumIterations << " us";
+  }
+}
+
+}  // namespace webrtc
@@ -1710,4 +1710,30 @@ TEST_F(StatsCollectorTest, TwoLocalTracksWithSameSsrc) {
       media_channel, &new_voice_sender_info, NULL, &new_stats_read, &reports);
 }
 
+// Verifies that ReplaceOrAddNew() keeps the report object alive, carries over
+// unchanged values and drops values that were not added again.
+TEST(StatsCollectionTest, ReplaceOrAddNewReusesReport) {
+  StatsCollection reports;
+  StatsReport::Id id(StatsReport::NewTypedId(
+      StatsReport::kStatsReportTypeTrack, kLocalTrackId));
+  StatsReport* report = reports.InsertNew(id);
+  report->AddString(StatsReport::kStatsValueNameTrackId, kLocalTrackId);
+  report->AddInt(StatsReport::kStatsValueNameBytesSent, 10);
+  const StatsReport::Value* track_id_value =
+      report->FindValue(StatsReport::kStatsValueNameTrackId);
+
+  StatsReport* replaced = reports.ReplaceOrAddNew(StatsReport::NewTypedId(
+      StatsReport::kStatsReportTypeTrack, kLocalTrackId));
+  EXPECT_EQ(report, replaced);
+  EXPECT_EQ(1u, reports.size());
+  EXPECT_TRUE(replaced->empty());
+
+  replaced->AddString(StatsReport::kStatsValueNameTrackId, kLocalTrackId);
+  EXPECT_EQ(track_id_value,
+            replaced->FindValue(StatsReport::kStatsValueNameTrackId));
+  EXPECT_EQ(nullptr,
+            replaced->FindValue(StatsReport::kStatsValueNameBytesSent));
+  EXPECT_EQ(1u, replaced->values().size());
+}
+
 }  // namespace webrtc
@@ -45,6 +45,21 @@ namespace {
 // The id of StatsReport of type kStatsReportTypeBwe.
 const char kStatsReportVideoBweId[] = "bweforvideo";
 
+// Mixes |value| into |seed| (same scheme as boost::hash_combine).
+size_t HashCombine(size_t seed, size_t value) {
+  return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+// FNV-1a over the characters of |str|, mixed into |seed|.
+size_t HashCombine(size_t seed, const std::string& str) {
+  uint32 hash = 2166136261u;
+  for (char c : str) {
+    hash ^= static_cast<uint8>(c);
+    hash *= 16777619u;
+  }
+  return HashCombine(seed, static_cast<size_t>(hash));
+}
+
 // NOTE: These names need to be consistent with an external
 // specification (W3C Stats Identifiers).
 const char* InternalTypeToString(StatsReport::StatsType type) {
@@ -95,6 +110,10 @@ class TypedId : public StatsReport::IdBase {
            static_cast<const TypedId&>(other).id_ == id_;
   }
 
+  size_t Hash() const override {
+    return HashCombine(IdBase::Hash(), id_);
+  }
+
   std::string ToString() const override {
     return std::string(InternalTypeToString(type_)) + kSeparator + id_;
   }
@@ -113,6 +132,10 @@ class TypedIntId : public StatsReport::IdBase {
            static_cast<const TypedIntId&>(other).id_ == id_;
   }
 
+  size_t Hash() const override {
+    return HashCombine(IdBase::Hash(), static_cast<size_t>(id_));
+  }
+
   std::string ToString() const override {
     return std::string(InternalTypeToString(type_)) +
            kSeparator +
@@ -171,6 +194,11 @@ class ComponentId : public StatsReport::IdBase {
         static_cast<const ComponentId&>(other).content_name_ == content_name_;
   }
 
+  size_t Hash() const override {
+    return HashCombine(HashCombine(IdBase::Hash(), content_name_),
+                       static_cast<size_t>(component_));
+  }
+
   std::string ToString() const override {
     return ToString("Channel-");
   }
@@ -207,6 +235,10 @@ class CandidatePairId : public ComponentId {
         static_cast<const CandidatePairId&>(other).index_ == index_;
   }
 
+  size_t Hash() const override {
+    return HashCombine(ComponentId::Hash(), static_cast<size_t>(index_));
+  }
+
   std::string ToString() const override {
     std::string ret(ComponentId::ToString("Conn-"));
     ret += '-';
@@ -218,6 +250,14 @@ class CandidatePairId : public ComponentId {
   const int index_;
 };
 
+template <typename Container>
+auto LowerBound(Container& values, StatsReport::StatsValueName name)
+    -> decltype(values.begin()) {
+  return std::lower_bound(values.begin(), values.end(), name,
+      [](const StatsReport::Values::value_type& v,
+         StatsReport::StatsValueName n) { return v.first < n; });
+}
+
 }  // namespace
 
 StatsReport::IdBase::IdBase(StatsType type) : type_(type) {}
@@ -229,6 +269,10 @@ bool StatsReport::IdBase::Equals(const IdBase& other) const {
   return other.type_ == type_;
 }
 
+size_t StatsReport::IdBase::Hash() const {
+  return static_cast<size_t>(type_);
+}
+
 StatsReport::Value::Value(StatsValueName name, int64 value, Type int_type)
     : name(name), type_(int_type) {
   DCHECK(type_ == kInt || type_ == kInt64);
@@ -668,52 +712,80 @@ const char* StatsReport::TypeToString() const {
 
 void StatsReport::AddString(StatsReport::StatsValueName name,
                             const std::string& value) {
-  const Value* found = FindValue(name);
-  if (!found || !(*found == value))
-    values_[name] = ValuePtr(new Value(name, value));
+  if (!HasValue(name, value))
+    SetValue(new Value(name, value));
 }
 
 void StatsReport::AddString(StatsReport::StatsValueName name,
                             const char* value) {
-  const Value* found = FindValue(name);
-  if (!found || !(*found == value))
-    values_[name] = ValuePtr(new Value(name, value));
+  if (!HasValue(name, value))
+    SetValue(new Value(name, value));
 }
 
 void StatsReport::AddInt64(StatsReport::StatsValueName name, int64 value) {
-  const Value* found = FindValue(name);
-  if (!found || !(*found == value))
-    values_[name] = ValuePtr(new Value(name, value, Value::kInt64));
+  if (!HasValue(name, value))
+    SetValue(new Value(name, value, Value::kInt64));
 }
 
 void StatsReport::AddInt(StatsReport::StatsValueName name, int value) {
-  const Value* found = FindValue(name);
-  if (!found || !(*found == static_cast<int64>(value)))
-    values_[name] = ValuePtr(new Value(name, value, Value::kInt));
+  if (!HasValue(name, static_cast<int64>(value)))
+    SetValue(new Value(name, value, Value::kInt));
 }
 
 void StatsReport::AddFloat(StatsReport::StatsValueName name, float value) {
-  const Value* found = FindValue(name);
-  if (!found || !(*found == value))
-    values_[name] = ValuePtr(new Value(name, value));
+  if (!HasValue(name, value))
+    SetValue(new Value(name, value));
 }
 
 void StatsReport::AddBoolean(StatsReport::StatsValueName name, bool value) {
-  const Value* found = FindValue(name);
-  if (!found || !(*found == value))
-    values_[name] = ValuePtr(new Value(name, value));
+  if (!HasValue(name, value))
+    SetValue(new Value(name, value));
 }
 
 void StatsReport::AddId(StatsReport::StatsValueName name,
                         const Id& value) {
-  const Value* found = FindValue(name);
-  if (!found || !(*found == value))
-    values_[name] = ValuePtr(new Value(name, value));
+  if (!HasValue(name, value))
+    SetValue(new Value(name, value));
 }
 
 const StatsReport::Value* StatsReport::FindValue(StatsValueName name) const {
-  Values::const_iterator it = values_.find(name);
-  return it == values_.end() ? nullptr : it->second.get();
+  Values::const_iterator it = LowerBound(values_, name);
+  return (it == values_.end() || it->first != name) ? nullptr :
+                                                      it->second.get();
+}
+
+void StatsReport::ResetValues() {
+  previous_values_.swap(values_);
+  values_.clear();
+}
+
+template <typename T>
+bool StatsReport::HasValue(StatsValueName name, const T& value) {
+  Values::iterator it = LowerBound(values_, name);
+  if (it != values_.end() && it->first == name)
+    return *it->second == value;
+
+  if (previous_values_.empty())
+    return false;
+
+  Values::iterator previous = LowerBound(previous_values_, name);
+  if (previous == previous_values_.end() || previous->first != name ||
+      !previous->second.get() || !(*previous->second == value)) {
+    return false;
+  }
+
+  values_.insert(it, *previous);
+  previous->second = ValuePtr();
+  return true;
+}
+
+void StatsReport::SetValue(Value* value) {
+  Values::iterator it = LowerBound(values_, value->name);
+  if (it != values_.end() && it->first == value->name) {
+    it->second = ValuePtr(value);
+  } else {
+    values_.insert(it, std::make_pair(value->name, ValuePtr(value)));
+  }
 }
 
 StatsCollection::StatsCollection() {
@@ -745,6 +817,7 @@ StatsReport* StatsCollection::InsertNew(const StatsReport::Id& id) {
   DCHECK(Find(id) == nullptr);
   StatsReport* report = new StatsReport(id);
   list_.push_back(report);
+  index_.insert(std::make_pair(id->Hash(), report));
   return report;
 }
 
@@ -757,12 +830,10 @@ StatsReport* StatsCollection::FindOrAddNew(const StatsReport::Id& id) {
 StatsReport* StatsCollection::ReplaceOrAddNew(const StatsReport::Id& id) {
   DCHECK(thread_checker_.CalledOnValidThread());
   DCHECK(id.get());
-  Container::iterator it = std::find_if(list_.begin(), list_.end(),
-      [&id](const StatsReport* r)->bool { return r->id()->Equals(id); });
-  if (it != end()) {
-    StatsReport* report = new StatsReport((*it)->id());
-    delete *it;
-    *it = report;
+  StatsReport* report = Find(id);
+  if (report) {
+    report->ResetValues();
+    report->set_timestamp(0.0);
     return report;
   }
   return InsertNew(id);
@@ -772,9 +843,13 @@ StatsReport* StatsCollection::ReplaceOrAddNew(const StatsReport::Id& id) {
 // will be returned.
 StatsReport* StatsCollection::Find(const StatsReport::Id& id) {
   DCHECK(thread_checker_.CalledOnValidThread());
-  Container::iterator it = std::find_if(list_.begin(), list_.end(),
-      [&id](const StatsReport* r)->bool { return r->id()->Equals(id); });
-  return it == list_.end() ? nullptr : *it;
+  std::pair<Index::iterator, Index::iterator> range =
+      index_.equal_range(id->Hash());
+  Index::iterator it = std::find_if(range.first, range.second,
+      [&id](const Index::value_type& r)->bool {
+        return r.second->id()->Equals(id);
+      });
+  return it == range.second ? nullptr : it->second;
 }
 
 }  // namespace webrtc
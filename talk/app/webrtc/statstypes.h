@@ -32,9 +32,10 @@
 #define TALK_APP_WEBRTC_STATSTYPES_H_
 
 #include <algorithm>
-#include <list>
 #include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "webrtc/base/basictypes.h"
 #include "webrtc/base/common.h"
@@ -236,6 +237,10 @@ class StatsReport {
 
     virtual std::string ToString() const = 0;
 
+    // Returns a hash of the id. Ids that are Equals() always have the same
+    // hash, so this can be used to index reports without calling ToString().
+    virtual size_t Hash() const;
+
    protected:
     // Protected since users of the IdBase type will be using the Id typedef.
     virtual bool Equals(const IdBase& other) const;
@@ -327,7 +332,10 @@ class StatsReport {
   // TODO(tommi): Consider using a similar approach to how we store Ids using
   // scoped_refptr for values.
   typedef rtc::linked_ptr<Value> ValuePtr;
-  typedef std::map<StatsValueName, ValuePtr> Values;
+  // Values are kept in a flat vector that is sorted by name. Reports hold a
+  // few dozen values at most, so a binary search over contiguous storage is
+  // cheaper than a node based map, both for lookups and for iteration.
+  typedef std::vector<std::pair<StatsValueName, ValuePtr> > Values;
 
   // Ownership of |id| is passed to |this|.
   explicit StatsReport(const Id& id);
@@ -363,13 +371,31 @@ class StatsReport {
 
   const Value* FindValue(StatsValueName name) const;
 
+  // Clears the report so that it can be filled again with fresh values.
+  // Values that are added again with an unchanged value reuse the Value
+  // object from before the reset instead of allocating a new one. Values
+  // that are not added again are dropped.
+  void ResetValues();
+
  private:
+  // Returns true if |values_| holds a value for |name| that equals |value|.
+  // An equal value left over from before ResetValues() is moved back into
+  // |values_| as a side effect.
+  template <typename T>
+  bool HasValue(StatsValueName name, const T& value);
+
+  // Inserts |value| into |values_|, replacing any value with the same name.
+  void SetValue(Value* value);
+
   // The unique identifier for this object.
   // This is used as a key for this report in ordered containers,
   // so it must never be changed.
   const Id id_;
   double timestamp_;  // Time since 1970-01-01T00:00:00Z in milliseconds.
   Values values_;
+  // Values from before the last call to ResetValues() that have not been
+  // added again yet.
+  Values previous_values_;
 
   DISALLOW_COPY_AND_ASSIGN(StatsReport);
 };
@@ -384,12 +410,14 @@ typedef std::vector<const StatsReport*> StatsReports;
 // A map from the report id to the report.
 // This class wraps an STL container and provides a limited set of
 // functionality in order to keep things simple.
+// Reports are indexed by StatsReport::IdBase::Hash(), so lookups do not need
+// to compare against every report in the collection.
 class StatsCollection {
  public:
   StatsCollection();
   ~StatsCollection();
 
-  typedef std::list<StatsReport*> Container;
+  typedef std::vector<StatsReport*> Container;
   typedef Container::iterator iterator;
   typedef Container::const_iterator const_iterator;
 
@@ -401,6 +429,9 @@ class StatsCollection {
   // exist in the list of reports.
   StatsReport* InsertNew(const StatsReport::Id& id);
   StatsReport* FindOrAddNew(const StatsReport::Id& id);
+  // Returns an existing report with |id| after clearing its values, or a new
+  // report if there is none.  Existing reports are reused (see
+  // StatsReport::ResetValues()) so that pointers to them remain valid.
   StatsReport* ReplaceOrAddNew(const StatsReport::Id& id);
 
   // Looks for a report with the given |id|.  If one is not found, NULL
@@ -408,7 +439,10 @@ class StatsCollection {
   StatsReport* Find(const StatsReport::Id& id);
 
  private:
+  typedef std::multimap<size_t, StatsReport*> Index;
+
   Container list_;
+  Index index_;
   rtc::ThreadChecker thread_checker_;
 };
 
@@ -29,6 +29,7 @@
 
 #include <limits.h>
 #include <stdio.h>
+#include <string.h>
 #include <algorithm>
 #include <string>
 #include <vector>
@@ -451,7 +452,8 @@ static bool GetLine(const std::string& message,
   if (line_end > 0 && (message.at(line_end - 1) == kReturn)) {
     --line_end;
   }
-  *line = message.substr(line_begin, (line_end - line_begin));
+  // Reuse the capacity of |line| rather than allocating a new string per line.
+  line->assign(message, line_begin, line_end - line_begin);
   const char* cline = line->c_str();
   // RFC 4566
   // An SDP session description consists of a number of lines of text of
@@ -525,15 +527,31 @@ static bool HasAttribute(const std::string& line,
   return (line.compare(kLinePrefixLength, attribute.size(), attribute) == 0);
 }
 
+// Overload for the attribute name constants, which are tested against every
+// attribute line and would otherwise be converted to a std::string each time.
+static bool HasAttribute(const std::string& line, const char* attribute) {
+  return (line.compare(kLinePrefixLength, strlen(attribute), attribute) == 0);
+}
+
 static bool AddSsrcLine(uint32 ssrc_id, const std::string& attribute,
                         const std::string& value, std::string* message) {
   // RFC 5576
   // a=ssrc:<ssrc-id> <attribute>:<value>
-  std::ostringstream os;
-  InitAttrLine(kAttributeSsrc, &os);
-  os << kSdpDelimiterColon << ssrc_id << kSdpDelimiterSpace
-     << attribute << kSdpDelimiterColon << value;
-  return AddLine(os.str(), message);
+  // There are several of these per track, so append directly to |message|
+  // instead of going through an ostringstream.
+  if (!message)
+    return false;
+  message->push_back(kLineTypeAttributes);
+  message->push_back(kSdpDelimiterEqual);
+  message->append(kAttributeSsrc);
+  message->push_back(kSdpDelimiterColon);
+  message->append(rtc::ToString<uint32>(ssrc_id));
+  message->push_back(kSdpDelimiterSpace);
+  message->append(attribute);
+  message->push_back(kSdpDelimiterColon);
+  message->append(value);
+  message->append(kLineBreak);
+  return true;
 }
 
 // Get value only from <attribute>:<value>.
@@ -796,6 +814,10 @@ std::string SdpSerialize(const JsepSessionDescription& jdesc) {
   }
 
   std::string message;
+  // Every m-section takes upwards of half a kilobyte once candidates, codecs
+  // and ssrc lines are added; reserve for that up front so large bundles are
+  // not copied over and over as |message| grows.
+  message.reserve(512 * (desc->contents().size() + 1));
 
   // Session Description.
   AddLine(kSessionVersion, &message);
@@ -1438,7 +1460,6 @@ void BuildRtpContentAttributes(
       if (track->ssrc_groups[i].ssrcs.empty()) {
         continue;
       }
-      std::ostringstream os;
       InitAttrLine(kAttributeSsrcGroup, &os);
       os << kSdpDelimiterColon << track->ssrc_groups[i].semantics;
       std::vector<uint32>::const_iterator ssrc =
@@ -1461,7 +1482,6 @@ void BuildRtpContentAttributes(
       // The appdata consists of the "id" attribute of a MediaStreamTrack, which
       // is corresponding to the "name" attribute of StreamParams.
       std::string appdata = track->id;
-      std::ostringstream os;
       InitAttrLine(kAttributeSsrc, &os);
       os << kSdpDelimiterColon << ssrc << kSdpDelimiterSpace
          << kSsrcAttributeMsid << kSdpDelimiterColon << track->sync_label
@@ -1567,10 +1587,10 @@ void AddFmtpLine(const T& codec, std::string* message) {
 
 template <class T>
 void AddRtcpFbLines(const T& codec, std::string* message) {
+  std::ostringstream os;
   for (std::vector<cricket::FeedbackParam>::const_iterator iter =
            codec.feedback_params.params().begin();
        iter != codec.feedback_params.params().end(); ++iter) {
-    std::ostringstream os;
     WriteRtcpFbHeader(codec.id, &os);
     os << " " << iter->id();
     if (!iter->param().empty()) {
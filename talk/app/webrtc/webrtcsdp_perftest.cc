@@ -0,0 +1,140 @@
+/*
+ * libjingle
+ * Copyright 2015 Google Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Measures SdpSerialize and SdpDeserialize on bundled offers with 2, 50 and
+// 200 m-lines.
+
+#include <string>
+
+#include "talk/app/webrtc/jsepicecandidate.h"
+#include "talk/app/webrtc/jsepsessiondescription.h"
+#include "talk/app/webrtc/webrtcsdp.h"
+#include "talk/media/base/constants.h"
+#include "talk/session/media/mediasession.h"
+#include "webrtc/base/gunit.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/stringencode.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/p2p/base/constants.h"
+
+namespace webrtc {
+
+// Builds a bundled description with |num_mlines| alternating audio and video
+// m-lines, each with its own transport, two candidates, codecs and a
+// simulcast-like video stream.
+static void CreateLargeDescription(int num_mlines,
+                                   JsepSessionDescription* jdesc) {
+  cricket::SessionDescription* desc = new cricket::SessionDescription();
+  cricket::ContentGroup bundle(cricket::GROUP_TYPE_BUNDLE);
+  for (int i = 0; i < num_mlines; ++i) {
+    std::string name = "mid" + rtc::ToString(i);
+    cricket::StreamParams stream;
+    stream.id = "track" + rtc::ToString(i);
+    stream.cname = "stream_cname";
+    stream.sync_label = "stream_label";
+    stream.ssrcs.push_back(1000 + 3 * i);
+    if (i % 2 == 0) {
+      cricket::AudioContentDescription* audio =
+          new cricket::AudioContentDescription();
+      audio->set_protocol(cricket::kMediaProtocolSavpf);
+      audio->set_rtcp_mux(true);
+      audio->AddCodec(cricket::AudioCodec(111, "opus", 48000, 0, 2, 3));
+      audio->AddCodec(cricket::AudioCodec(103, "ISAC", 16000, 32000, 1, 2));
+      audio->AddCodec(cricket::AudioCodec(0, "PCMU", 8000, 64000, 1, 1));
+      audio->AddStream(stream);
+      desc->AddContent(name, cricket::NS_JINGLE_RTP, audio);
+    } else {
+      cricket::VideoContentDescription* video =
+          new cricket::VideoContentDescription();
+      video->set_protocol(cricket::kMediaProtocolSavpf);
+      video->set_rtcp_mux(true);
+      cricket::VideoCodec vp8(100, "VP8", 640, 480, 30, 0);
+      vp8.AddFeedbackParam(cricket::FeedbackParam("nack"));
+      vp8.AddFeedbackParam(cricket::FeedbackParam("ccm", "fir"));
+      vp8.AddFeedbackParam(cricket::FeedbackParam("goog-remb"));
+      video->AddCodec(vp8);
+      cricket::VideoCodec rtx(96, "rtx", 0, 0, 0, 0);
+      rtx.SetParam("apt", 100);
+      video->AddCodec(rtx);
+      stream.ssrcs.push_back(1001 + 3 * i);
+      stream.ssrcs.push_back(1002 + 3 * i);
+      stream.ssrc_groups.push_back(cricket::SsrcGroup("SIM", stream.ssrcs));
+      video->AddStream(stream);
+      desc->AddContent(name, cricket::NS_JINGLE_RTP, video);
+    }
+    desc->AddTransportInfo(cricket::TransportInfo(
+        name, cricket::TransportDescription("ufrag", "pwd")));
+    bundle.AddContentName(name);
+  }
+  desc->AddGroup(bundle);
+  ASSERT_TRUE(jdesc->Initialize(desc, "18446744069414584320", "1"));
+
+  for (int i = 0; i < num_mlines; ++i) {
+    rtc::SocketAddress address("192.168.1.5", 1234 + i);
+    cricket::Candidate host(cricket::ICE_CANDIDATE_COMPONENT_RTP, "udp",
+                            address, 2130706432U, "", "",
+                            cricket::LOCAL_PORT_TYPE, 2, "a0+B/1");
+    rtc::SocketAddress address_stun("74.125.127.126", 2345 + i);
+    cricket::Candidate stun(cricket::ICE_CANDIDATE_COMPONENT_RTP, "udp",
+                            address_stun, 2130706432U, "", "",
+                            cricket::STUN_PORT_TYPE, 2, "a0+B/3");
+    stun.set_related_address(address);
+    std::string name = "mid" + rtc::ToString(i);
+    JsepIceCandidate jhost(name, i, host);
+    JsepIceCandidate jstun(name, i, stun);
+    ASSERT_TRUE(jdesc->AddCandidate(&jhost));
+    ASSERT_TRUE(jdesc->AddCandidate(&jstun));
+  }
+}
+
+TEST(WebRtcSdpPerfTest, SerializeDeserialize) {
+  const int kIterations = 20;
+  for (int num_mlines : {2, 50, 200}) {
+    JsepSessionDescription jdesc("dummy");
+    CreateLargeDescription(num_mlines, &jdesc);
+    std::string sdp = SdpSerialize(jdesc);
+
+    uint64 start = rtc::TimeMicros();
+    for (int i = 0; i < kIterations; ++i) {
+      SdpSerialize(jdesc);
+    }
+    uint64 serialize_us = (rtc::TimeMicros() - start) / kIterations;
+
+    start = rtc::TimeMicros();
+    for (int i = 0; i < kIterations; ++i) {
+      JsepSessionDescription jdesc_output("dummy");
+      EXPECT_TRUE(SdpDeserialize(sdp, &jdesc_output, NULL));
+    }
+    uint64 deserialize_us = (rtc::TimeMicros() - start) / kIterations;
+
+    LOG(LS_INFO) << num_mlines << " m-lines (" << sdp.size()
+                 << " bytes): serialize " << serialize_us
+                 << " us, deserialize " << deserialize_us << " us";
+  }
+}
+
+}  // namespace webrtc
@@ -2671,3 +2671,83 @@ TEST_F(WebRtcSdpTest, MediaContentOrderMaintainedRoundTrip) {
     EXPECT_EQ(sdp_string, serialized_sdp);
   }
 }
+
+// Builds a bundled description with |num_mlines| alternating audio and video
+// m-lines, each with its own transport, two candidates, codecs and a
+// simulcast-like video stream, like a large bundled offer.
+static void CreateLargeDescription(int num_mlines,
+                                   JsepSessionDescription* jdesc) {
+  SessionDescription* desc = new SessionDescription();
+  ContentGroup bundle(cricket::GROUP_TYPE_BUNDLE);
+  for (int i = 0; i < num_mlines; ++i) {
+    std::string name = "mid" + rtc::ToString(i);
+    StreamParams stream;
+    stream.id = "track" + rtc::ToString(i);
+    stream.cname = kStream1Cname;
+    stream.sync_label = kStreamLabel1;
+    stream.ssrcs.push_back(1000 + 3 * i);
+    if (i % 2 == 0) {
+      AudioContentDescription* audio = new AudioContentDescription();
+      audio->set_protocol(cricket::kMediaProtocolSavpf);
+      audio->set_rtcp_mux(true);
+      audio->AddCodec(AudioCodec(111, "opus", 48000, 0, 2, 3));
+      audio->AddCodec(AudioCodec(103, "ISAC", 16000, 32000, 1, 2));
+      audio->AddCodec(AudioCodec(0, "PCMU", 8000, 64000, 1, 1));
+      audio->AddStream(stream);
+      desc->AddContent(name, NS_JINGLE_RTP, audio);
+    } else {
+      VideoContentDescription* video = new VideoContentDescription();
+      video->set_protocol(cricket::kMediaProtocolSavpf);
+      video->set_rtcp_mux(true);
+      VideoCodec vp8(100, "VP8", 640, 480, 30, 0);
+      vp8.AddFeedbackParam(cricket::FeedbackParam("nack"));
+      vp8.AddFeedbackParam(cricket::FeedbackParam("ccm", "fir"));
+      vp8.AddFeedbackParam(cricket::FeedbackParam("goog-remb"));
+      video->AddCodec(vp8);
+      VideoCodec rtx(96, "rtx", 0, 0, 0, 0);
+      rtx.SetParam("apt", 100);
+      video->AddCodec(rtx);
+      stream.ssrcs.push_back(1001 + 3 * i);
+      stream.ssrcs.push_back(1002 + 3 * i);
+      stream.ssrc_groups.push_back(cricket::SsrcGroup("SIM", stream.ssrcs));
+      video->AddStream(stream);
+      desc->AddContent(name, NS_JINGLE_RTP, video);
+    }
+    EXPECT_TRUE(desc->AddTransportInfo(TransportInfo(
+        name, TransportDescription(kCandidateUfragVideo, kCandidatePwdVideo))));
+    bundle.AddContentName(name);
+  }
+  desc->AddGroup(bundle);
+  ASSERT_TRUE(jdesc->Initialize(desc, kSessionId, kSessionVersion));
+
+  for (int i = 0; i < num_mlines; ++i) {
+    rtc::SocketAddress address("192.168.1.5", 1234 + i);
+    Candidate host(ICE_CANDIDATE_COMPONENT_RTP, "udp", address,
+                   kCandidatePriority, "", "", LOCAL_PORT_TYPE,
+                   kCandidateGeneration, kCandidateFoundation1);
+    rtc::SocketAddress address_stun("74.125.127.126", 2345 + i);
+    Candidate stun(ICE_CANDIDATE_COMPONENT_RTP, "udp", address_stun,
+                   kCandidatePriority, "", "", STUN_PORT_TYPE,
+                   kCandidateGeneration, kCandidateFoundation3);
+    stun.set_related_address(address);
+    std::string name = "mid" + rtc::ToString(i);
+    JsepIceCandidate jhost(name, i, host);
+    JsepIceCandidate jstun(name, i, stun);
+    ASSERT_TRUE(jdesc->AddCandidate(&jhost));
+    ASSERT_TRUE(jdesc->AddCandidate(&jstun));
+  }
+}
+
+TEST_F(WebRtcSdpTest, SerializeDeserializeLargeDescription) {
+  JsepSessionDescription jdesc(kDummyString);
+  CreateLargeDescription(200, &jdesc);
+  std::string sdp = webrtc::SdpSerialize(jdesc);
+
+  // The description must survive a round trip unchanged.
+  JsepSessionDescription parsed(kDummyString);
+  ASSERT_TRUE(SdpDeserialize(sdp, &parsed));
+  EXPECT_EQ(200u, parsed.description()->contents().size());
+  EXPECT_EQ(2u, parsed.candidates(0)->count());
+  EXPECT_EQ(2u, parsed.candidates(199)->count());
+  EXPECT_EQ(sdp, webrtc::SdpSerialize(parsed));
+}
@@ -247,6 +247,47 @@
         }],
       ],
     },  # target libjingle_peerconnection_unittest
+    {
+      # Benchmarks. They log their timings and are not run with the unit tests.
+      'target_name': 'libjingle_perf_tests',
+      'type': 'executable',
+      'dependencies': [
+        '<(DEPTH)/testing/gmock.gyp:gmock',
+        '<(webrtc_root)/base/base_tests.gyp:rtc_base_tests_utils',
+        '<(webrtc_root)/common.gyp:webrtc_common',
+        'libjingle.gyp:libjingle',
+        'libjingle.gyp:libjingle_media',
+        'libjingle.gyp:libjingle_p2p',
+        'libjingle.gyp:libjingle_peerconnection',
+        'libjingle_unittest_main',
+      ],
+      'sources': [
+        'app/webrtc/dtlsidentitystore_perftest.cc',
+        'app/webrtc/statscollector_perftest.cc',
+        'app/webrtc/webrtcsdp_perftest.cc',
+        'media/sctp/sctpdataengine_perftest.cc',
+        'session/media/srtpfilter_perftest.cc',
+      ],
+      'conditions': [
+        ['build_libsrtp==1', {
+          'dependencies': [
+            '<(DEPTH)/third_party/libsrtp/libsrtp.gyp:libsrtp',
+          ],
+        }],
+        ['OS=="ios"', {
+          'sources!': [
+            'media/sctp/sctpdataengine_perftest.cc',
+          ],
+        }],
+        ['OS=="android"', {
+          # See libjingle_peerconnection_unittest.
+          'defines': [
+            'GTEST_USE_OWN_TR1_TUPLE=1',
+            'GTEST_HAS_TR1_TUPLE=1',
+           ],
+        }],
+      ],
+    },  # target libjingle_perf_tests
   ],
   'conditions': [
     ['OS=="linux"', {
@@ -201,6 +201,8 @@ static int OnSctpOutboundPacket(void* addr, void* data, size_t length,
                   << "; set_df: " << std::hex << static_cast<int>(set_df);
 
   VerboseLogPacket(addr, length, SCTP_DUMP_OUTBOUND);
+  if (channel->OnOutboundPacketFromSctp(data, length))
+    return 0;
   // Note: We have to copy the data; the caller will delete it.
   auto* msg = new OutboundPacketMessage(
       new rtc::Buffer(reinterpret_cast<uint8_t*>(data), length));
@@ -229,12 +231,18 @@ static int OnSctpInboundPacket(struct socket* sock, union sctp_sockstore addr,
     LOG(LS_ERROR) << "Received an unknown PPID " << ppid
                   << " on an SCTP packet.  Dropping.";
   } else {
+    ReceiveDataParams params;
+    params.ssrc = rcv.rcv_sid;
+    params.seq_num = rcv.rcv_ssn;
+    params.timestamp = rcv.rcv_tsn;
+    params.type = type;
+    // The channel takes ownership of |data| if it accepts it.
+    if (channel->OnInboundDataFromSctp(data, length, params, flags))
+      return 1;
+
     SctpInboundPacket* packet = new SctpInboundPacket;
     packet->buffer.SetData(reinterpret_cast<uint8_t*>(data), length);
-    packet->params.ssrc = rcv.rcv_sid;
-    packet->params.seq_num = rcv.rcv_ssn;
-    packet->params.timestamp = rcv.rcv_tsn;
-    packet->params.type = type;
+    packet->params = params;
     packet->flags = flags;
     // The ownership of |packet| transfers to |msg|.
     InboundPacketMessage* msg = new InboundPacketMessage(packet);
@@ -369,11 +377,17 @@ SctpDataMediaChannel::SctpDataMediaChannel(rtc::Thread* thread)
       sock_(NULL),
       sending_(false),
       receiving_(false),
-      debug_name_("SctpDataMediaChannel") {
+      debug_name_("SctpDataMediaChannel"),
+      process_in_place_(false),
+      in_conninput_(false),
+      in_sendv_(false),
+      sending_queued_outbound_packets_(false) {
 }
 
 SctpDataMediaChannel::~SctpDataMediaChannel() {
   CloseSctpSocket();
+  for (const QueuedInboundData& queued : queued_inbound_data_)
+    free(queued.data);
 }
 
 void SctpDataMediaChannel::OnSendThresholdCallback() {
@@ -634,9 +648,11 @@ bool SctpDataMediaChannel::SendData(
   }
 
   // We don't fragment.
+  in_sendv_ = true;
   send_res = usrsctp_sendv(
       sock_, payload.data(), static_cast<size_t>(payload.size()), NULL, 0, &spa,
       rtc::checked_cast<socklen_t>(sizeof(spa)), SCTP_SENDV_SPA, 0);
+  in_sendv_ = false;
   if (send_res < 0) {
     if (errno == SCTP_EWOULDBLOCK) {
       *result = SDR_BLOCK;
@@ -646,8 +662,10 @@ bool SctpDataMediaChannel::SendData(
                           << "->SendData(...): "
                           << " usrsctp_sendv: ";
     }
+    SendQueuedOutboundPackets();
     return false;
   }
+  SendQueuedOutboundPackets();
   if (result) {
     // Only way out now is success.
     *result = SDR_SUCCESS;
@@ -670,47 +688,128 @@ void SctpDataMediaChannel::OnPacketReceived(
     // will be will be given to the global OnSctpInboundData, and then,
     // marshalled by a Post and handled with OnMessage.
     VerboseLogPacket(packet->data(), packet->size(), SCTP_DUMP_INBOUND);
+    in_conninput_ = true;
     usrsctp_conninput(this, packet->data(), packet->size(), 0);
+    in_conninput_ = false;
+    SendQueuedOutboundPackets();
+    DeliverQueuedInboundData();
   } else {
     // TODO(ldixon): Consider caching the packet for very slightly better
     // reliability.
   }
 }
 
+bool SctpDataMediaChannel::OnOutboundPacketFromSctp(const void* data,
+                                                    size_t length) {
+  // usrsctp also calls back from its timer thread. Check the thread first,
+  // since the flags below are only accessed on the worker thread.
+  // Packets from other usrsctp calls, such as usrsctp_connect, are posted as
+  // before, since nothing would send them after the call returns.
+  if (rtc::Thread::Current() != worker_thread_ || !process_in_place_ ||
+      !(in_sendv_ || in_conninput_)) {
+    return false;
+  }
+  // Sending from here could re-enter usrsctp, for instance if the network
+  // interface hands the packet straight to a peer whose answer comes back
+  // before SendPacket returns. The packet is sent once the usrsctp call
+  // returns instead. The caller frees |data| when we return, so it is copied.
+  queued_outbound_packets_.push_back(
+      rtc::Buffer(static_cast<const uint8*>(data), length));
+  return true;
+}
+
+bool SctpDataMediaChannel::OnInboundDataFromSctp(
+    void* data, size_t length, const ReceiveDataParams& params, int flags) {
+  // Data is only handled in place when it comes out of usrsctp_conninput;
+  // handing it to the upper layers from inside usrsctp_sendv (or any other
+  // usrsctp call) could re-enter usrsctp. The thread is checked first, as in
+  // OnOutboundPacketFromSctp().
+  if (rtc::Thread::Current() != worker_thread_ || !process_in_place_ ||
+      !in_conninput_) {
+    return false;
+  }
+  QueuedInboundData queued = {data, length, params, flags};
+  queued_inbound_data_.push_back(queued);
+  return true;
+}
+
+void SctpDataMediaChannel::DeliverQueuedInboundData() {
+  if (queued_inbound_data_.empty())
+    return;
+  // The signals below may lead to more data being queued, so deliver from a
+  // local copy.
+  std::vector<QueuedInboundData> queued;
+  queued.swap(queued_inbound_data_);
+  for (const QueuedInboundData& data : queued) {
+    OnInboundDataFromSctpToChannel(data.params, data.flags,
+                                   static_cast<const uint8*>(data.data),
+                                   data.length);
+    free(data.data);
+  }
+  // Keep the capacity of the queue for the next packet.
+  queued.clear();
+  if (queued_inbound_data_.empty())
+    queued_inbound_data_.swap(queued);
+}
+
+void SctpDataMediaChannel::SendQueuedOutboundPackets() {
+  if (sending_queued_outbound_packets_)
+    return;
+  sending_queued_outbound_packets_ = true;
+  // Sending may lead to more packets being queued, when the network interface
+  // delivers to a peer whose answer reaches OnPacketReceived synchronously.
+  while (!queued_outbound_packets_.empty()) {
+    std::vector<rtc::Buffer> packets;
+    packets.swap(queued_outbound_packets_);
+    for (rtc::Buffer& packet : packets)
+      OnPacketFromSctpToNetwork(&packet);
+  }
+  sending_queued_outbound_packets_ = false;
+}
+
 void SctpDataMediaChannel::OnInboundPacketFromSctpToChannel(
     SctpInboundPacket* packet) {
-  LOG(LS_VERBOSE) << debug_name_ << "->OnInboundPacketFromSctpToChannel(...): "
+  OnInboundDataFromSctpToChannel(packet->params, packet->flags,
+                                 packet->buffer.data(), packet->buffer.size());
+}
+
+void SctpDataMediaChannel::OnInboundDataFromSctpToChannel(
+    const ReceiveDataParams& params,
+    int flags,
+    const uint8* data,
+    size_t length) {
+  LOG(LS_VERBOSE) << debug_name_ << "->OnInboundDataFromSctpToChannel(...): "
                   << "Received SCTP data:"
-                  << " ssrc=" << packet->params.ssrc
-                  << " notification: " << (packet->flags & MSG_NOTIFICATION)
-                  << " length=" << packet->buffer.size();
+                  << " ssrc=" << params.ssrc
+                  << " notification: " << (flags & MSG_NOTIFICATION)
+                  << " length=" << length;
   // Sending a packet with data == NULL (no data) is SCTPs "close the
   // connection" message. This sets sock_ = NULL;
-  if (!packet->buffer.size() || !packet->buffer.data()) {
-    LOG(LS_INFO) << debug_name_ << "->OnInboundPacketFromSctpToChannel(...): "
+  if (!length || !data) {
+    LOG(LS_INFO) << debug_name_ << "->OnInboundDataFromSctpToChannel(...): "
                                    "No data, closing.";
     return;
   }
-  if (packet->flags & MSG_NOTIFICATION) {
-    OnNotificationFromSctp(&packet->buffer);
+  if (flags & MSG_NOTIFICATION) {
+    OnNotificationFromSctp(data, length);
   } else {
-    OnDataFromSctpToChannel(packet->params, &packet->buffer);
+    OnDataFromSctpToChannel(params, data, length);
   }
 }
 
 void SctpDataMediaChannel::OnDataFromSctpToChannel(
-    const ReceiveDataParams& params, rtc::Buffer* buffer) {
+    const ReceiveDataParams& params, const uint8* data, size_t length) {
   if (receiving_) {
     LOG(LS_VERBOSE) << debug_name_ << "->OnDataFromSctpToChannel(...): "
-                    << "Posting with length: " << buffer->size()
+                    << "Posting with length: " << length
                     << " on stream " << params.ssrc;
     // Reports all received messages to upper layers, no matter whether the sid
     // is known.
-    SignalDataReceived(params, buffer->data<char>(), buffer->size());
+    SignalDataReceived(params, reinterpret_cast<const char*>(data), length);
   } else {
     LOG(LS_WARNING) << debug_name_ << "->OnDataFromSctpToChannel(...): "
                     << "Not receiving packet with sid=" << params.ssrc
-                    << " len=" << buffer->size() << " before SetReceive(true).";
+                    << " len=" << length << " before SetReceive(true).";
   }
 }
 
@@ -767,10 +866,11 @@ bool SctpDataMediaChannel::ResetStream(uint32 ssrc) {
   return true;
 }
 
-void SctpDataMediaChannel::OnNotificationFromSctp(rtc::Buffer* buffer) {
+void SctpDataMediaChannel::OnNotificationFromSctp(const uint8* data,
+                                                  size_t length) {
   const sctp_notification& notification =
-      reinterpret_cast<const sctp_notification&>(*buffer->data());
-  ASSERT(notification.sn_header.sn_length == buffer->size());
+      reinterpret_cast<const sctp_notification&>(*data);
+  ASSERT(notification.sn_header.sn_length == length);
 
   // TODO(ldixon): handle notifications appropriately.
   switch (notification.sn_header.sn_type) {
@@ -90,6 +90,15 @@ class SctpDataMediaChannel;
 //  14. SctpDataMediaChannel::SignalDataReceived(data)
 // [from the same thread, methods registered/connected to
 //  SctpDataMediaChannel are called with the recieved data]
+//
+// When SctpDataMediaChannel::set_process_in_place(true) has been called, the
+// callbacks that usrsctp makes on the worker thread itself skip the posted
+// messages: the packets from step 3 are sent (steps 5-6) as soon as
+// usrsctp_sendv or usrsctp_conninput returns, and the data from step 10 is
+// handed to steps 12-14 as soon as usrsctp_conninput returns, without being
+// copied. Nothing is sent or signaled from inside a usrsctp call, since the
+// network interface or the upper layers may call back into usrsctp.
+// Callbacks made by usrsctp's own timer thread are still posted.
 class SctpDataEngine : public DataEngineInterface, public sigslot::has_slots<> {
  public:
   SctpDataEngine();
@@ -190,6 +199,23 @@ class SctpDataMediaChannel : public DataMediaChannel,
   virtual void OnReadyToSend(bool ready) {}
 
   void OnSendThresholdCallback();
+
+  // Processes the packets and data that usrsctp produces while it is called
+  // on the worker thread without posting them to the worker thread first.
+  // Meant for bulk transfers, where the per-message thread hops and copies
+  // dominate. Off by default. Must be set on the worker thread.
+  void set_process_in_place(bool process_in_place) {
+    process_in_place_ = process_in_place;
+  }
+  bool process_in_place() const { return process_in_place_; }
+
+  // Called by the usrsctp callbacks. Return false if the packet or data has
+  // to be posted to the worker thread instead. OnInboundDataFromSctp takes
+  // ownership of |data|, which must have been allocated with malloc.
+  bool OnOutboundPacketFromSctp(const void* data, size_t length);
+  bool OnInboundDataFromSctp(void* data, size_t length,
+                             const ReceiveDataParams& params, int flags);
+
   // Helper for debugging.
   void set_debug_name(const std::string& debug_name) {
     debug_name_ = debug_name;
@@ -222,9 +248,18 @@ class SctpDataMediaChannel : public DataMediaChannel,
   void OnPacketFromSctpToNetwork(rtc::Buffer* buffer);
   // Called by OnMessage to decide what to do with the packet.
   void OnInboundPacketFromSctpToChannel(SctpInboundPacket* packet);
+  void OnInboundDataFromSctpToChannel(const ReceiveDataParams& params,
+                                      int flags,
+                                      const uint8* data,
+                                      size_t length);
   void OnDataFromSctpToChannel(const ReceiveDataParams& params,
-                               rtc::Buffer* buffer);
-  void OnNotificationFromSctp(rtc::Buffer* buffer);
+                               const uint8* data,
+                               size_t length);
+  void OnNotificationFromSctp(const uint8* data, size_t length);
+  // Hands the data queued by OnInboundDataFromSctp to the channel.
+  void DeliverQueuedInboundData();
+  // Sends the packets queued by OnOutboundPacketFromSctp.
+  void SendQueuedOutboundPackets();
   void OnNotificationAssocChange(const sctp_assoc_change& change);
 
   void OnStreamResetEvent(const struct sctp_stream_reset_event* evt);
@@ -258,6 +293,28 @@ class SctpDataMediaChannel : public DataMediaChannel,
 
   // A human-readable name for debugging messages.
   std::string debug_name_;
+
+  // See set_process_in_place().
+  struct QueuedInboundData {
+    void* data;
+    size_t length;
+    ReceiveDataParams params;
+    int flags;
+  };
+  // Only accessed on the worker thread, like the members below.
+  bool process_in_place_;
+  // True while usrsctp_conninput runs; the data it delivers is queued in
+  // |queued_inbound_data_| until it returns.
+  bool in_conninput_;
+  std::vector<QueuedInboundData> queued_inbound_data_;
+  // True while usrsctp_sendv runs. The packets that usrsctp produces during
+  // usrsctp_sendv or usrsctp_conninput are queued in
+  // |queued_outbound_packets_| until the call returns.
+  bool in_sendv_;
+  std::vector<rtc::Buffer> queued_outbound_packets_;
+  // True while SendQueuedOutboundPackets() runs, so that packets queued by a
+  // nested call go out after the ones queued before them.
+  bool sending_queued_outbound_packets_;
 };
 
 }  // namespace cricket
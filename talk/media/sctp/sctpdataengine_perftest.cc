@@ -0,0 +1,234 @@
+/*
+ * libjingle
+ * Copyright 2015 Google Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Measures the throughput and the latency of messages between two local
+// SctpDataMediaChannels, with usrsctp's callbacks posted to the worker thread
+// and with them processed in place.
+
+#include <algorithm>
+#include <vector>
+
+#include "talk/media/base/mediachannel.h"
+#include "talk/media/sctp/sctpdataengine.h"
+#include "webrtc/base/buffer.h"
+#include "webrtc/base/gunit.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/messagehandler.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/thread.h"
+#include "webrtc/base/timeutils.h"
+
+#ifdef HAVE_NSS_SSL_H
+// TODO(thorcarpenter): Remove after webrtc switches over to BoringSSL.
+#include "webrtc/base/nssstreamadapter.h"
+#endif  // HAVE_NSS_SSL_H
+
+namespace cricket {
+namespace {
+
+enum {
+  MSG_PACKET = 1,
+};
+
+// Delivers each packet to |dest_| from a posted message, like a network
+// would.
+class LoopbackNetworkInterface : public MediaChannel::NetworkInterface,
+                                 public rtc::MessageHandler {
+ public:
+  explicit LoopbackNetworkInterface(rtc::Thread* thread)
+      : thread_(thread), dest_(NULL) {}
+
+  void SetDestination(DataMediaChannel* dest) { dest_ = dest; }
+
+ protected:
+  bool SendPacket(rtc::Buffer* packet, rtc::DiffServCodePoint dscp) override {
+    rtc::Buffer* buffer = new rtc::Buffer(packet->data(), packet->size());
+    thread_->Post(this, MSG_PACKET, rtc::WrapMessageData(buffer));
+    return true;
+  }
+  bool SendRtcp(rtc::Buffer* packet, rtc::DiffServCodePoint dscp) override {
+    return false;
+  }
+  int SetOption(SocketType type, rtc::Socket::Option opt,
+                int option) override {
+    return 0;
+  }
+
+  void OnMessage(rtc::Message* msg) override {
+    rtc::scoped_ptr<rtc::Buffer> buffer(
+        static_cast<rtc::TypedMessageData<rtc::Buffer*>*>(
+            msg->pdata)->data());
+    if (dest_) {
+      dest_->OnPacketReceived(buffer.get(), rtc::PacketTime());
+    }
+    delete msg->pdata;
+  }
+
+ private:
+  rtc::Thread* thread_;
+  DataMediaChannel* dest_;
+};
+
+class MessageCounter : public sigslot::has_slots<> {
+ public:
+  MessageCounter() : num_messages_(0) {}
+
+  void OnDataReceived(const ReceiveDataParams& params,
+                      const char* data,
+                      size_t length) {
+    ++num_messages_;
+  }
+
+  size_t num_messages() const { return num_messages_; }
+
+ private:
+  size_t num_messages_;
+};
+
+}  // namespace
+
+class SctpDataMediaChannelPerfTest : public testing::Test {
+ protected:
+  static void SetUpTestCase() {
+#ifdef HAVE_NSS_SSL_H
+    // TODO(thorcarpenter): Remove after webrtc switches over to BoringSSL.
+    if (!rtc::NSSContext::InitializeSSL(NULL)) {
+      LOG(LS_WARNING) << "Unabled to initialize NSS.";
+    }
+#endif  // HAVE_NSS_SSL_H
+  }
+
+  void SetUp() override {
+    engine_.reset(new SctpDataEngine());
+    net1_.reset(new LoopbackNetworkInterface(rtc::Thread::Current()));
+    net2_.reset(new LoopbackNetworkInterface(rtc::Thread::Current()));
+    chan1_.reset(CreateChannel(net1_.get(), &counter1_));
+    chan2_.reset(CreateChannel(net2_.get(), &counter2_));
+    net1_->SetDestination(chan2_.get());
+    net2_->SetDestination(chan1_.get());
+
+    StreamParams stream(StreamParams::CreateLegacy(1));
+    chan1_->AddSendStream(stream);
+    chan1_->AddRecvStream(stream);
+    chan2_->AddSendStream(stream);
+    chan2_->AddRecvStream(stream);
+
+    chan1_->SetReceive(true);
+    chan2_->SetReceive(true);
+    chan2_->SetSend(true);
+    ProcessMessagesUntilIdle();
+    chan1_->SetSend(true);
+  }
+
+  void TearDown() override {
+    chan1_->SetSend(false);
+    chan2_->SetSend(false);
+    ProcessMessagesUntilIdle();
+  }
+
+  SctpDataMediaChannel* CreateChannel(LoopbackNetworkInterface* net,
+                                      MessageCounter* counter) {
+    SctpDataMediaChannel* channel = static_cast<SctpDataMediaChannel*>(
+        engine_->CreateChannel(DCT_SCTP));
+    channel->SetInterface(net);
+    channel->SignalDataReceived.connect(counter,
+                                        &MessageCounter::OnDataReceived);
+    return channel;
+  }
+
+  void ProcessMessagesUntilIdle() {
+    rtc::Thread* thread = rtc::Thread::Current();
+    while (!thread->empty()) {
+      rtc::Message msg;
+      if (thread->Get(&msg, rtc::Thread::kForever)) {
+        thread->Dispatch(&msg);
+      }
+    }
+  }
+
+  // Sends |num_messages| messages of |size| bytes from chan1_ to chan2_,
+  // keeping the SCTP send buffer full. Returns the number of milliseconds
+  // until the last one was received, or -1 if that took too long.
+  int SendAndReceive(size_t size, size_t num_messages) {
+    const int kTimeoutMs = 20000;
+    std::vector<char> data(size, 'x');
+    rtc::Buffer payload(&data[0], data.size());
+    SendDataParams params;
+    params.ssrc = 1;
+    size_t expected = counter2_.num_messages() + num_messages;
+    size_t sent = 0;
+    uint32 start = rtc::Time();
+    while (counter2_.num_messages() < expected) {
+      SendDataResult result = SDR_SUCCESS;
+      while (sent < num_messages && result == SDR_SUCCESS) {
+        if (chan1_->SendData(params, payload, &result))
+          ++sent;
+      }
+      if (rtc::TimeSince(start) > kTimeoutMs)
+        return -1;
+      rtc::Thread::Current()->ProcessMessages(1);
+    }
+    return rtc::TimeSince(start);
+  }
+
+  rtc::scoped_ptr<SctpDataEngine> engine_;
+  rtc::scoped_ptr<LoopbackNetworkInterface> net1_;
+  rtc::scoped_ptr<LoopbackNetworkInterface> net2_;
+  MessageCounter counter1_;
+  MessageCounter counter2_;
+  rtc::scoped_ptr<SctpDataMediaChannel> chan1_;
+  rtc::scoped_ptr<SctpDataMediaChannel> chan2_;
+};
+
+TEST_F(SctpDataMediaChannelPerfTest, ThroughputAndLatency) {
+  const size_t kBytesPerRun = 4 * 1024 * 1024;
+  const size_t kNumLatencyMessages = 100;
+  const size_t kMessageSizes[] = {1024, 64 * 1024};
+
+  for (int in_place = 0; in_place < 2; ++in_place) {
+    chan1_->set_process_in_place(in_place != 0);
+    chan2_->set_process_in_place(in_place != 0);
+    for (size_t size : kMessageSizes) {
+      int elapsed_ms = SendAndReceive(size, kBytesPerRun / size);
+      ASSERT_GE(elapsed_ms, 0);
+      double mbps = kBytesPerRun / 1000.0 / std::max(elapsed_ms, 1);
+
+      int latency_ms = 0;
+      for (size_t i = 0; i < kNumLatencyMessages; ++i) {
+        int message_ms = SendAndReceive(size, 1);
+        ASSERT_GE(message_ms, 0);
+        latency_ms += message_ms;
+      }
+      LOG(LS_INFO) << (in_place ? "In place" : "Posted") << ", " << size
+                   << " byte messages: " << mbps << " MB/s, "
+                   << static_cast<double>(latency_ms) / kNumLatencyMessages
+                   << " ms average latency";
+    }
+  }
+}
+
+}  // namespace cricket
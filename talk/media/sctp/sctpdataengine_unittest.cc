@@ -43,6 +43,7 @@
 #include "webrtc/base/messagequeue.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/ssladapter.h"
+#include "webrtc/base/stringencode.h"
 #include "webrtc/base/thread.h"
 
 #ifdef HAVE_NSS_SSL_H
@@ -61,17 +62,30 @@ class SctpFakeNetworkInterface : public cricket::MediaChannel::NetworkInterface,
  public:
   explicit SctpFakeNetworkInterface(rtc::Thread* thread)
     : thread_(thread),
-      dest_(NULL) {
+      dest_(NULL),
+      deliver_synchronously_(false) {
   }
 
   void SetDestination(cricket::DataMediaChannel* dest) { dest_ = dest; }
 
+  // Hands packets to the destination before SendPacket returns, instead of
+  // posting them, like a transport that loops back to a local peer.
+  void set_deliver_synchronously(bool deliver_synchronously) {
+    deliver_synchronously_ = deliver_synchronously;
+  }
+
  protected:
   // Called to send raw packet down the wire (e.g. SCTP an packet).
   virtual bool SendPacket(rtc::Buffer* packet,
                           rtc::DiffServCodePoint dscp) {
     LOG(LS_VERBOSE) << "SctpFakeNetworkInterface::SendPacket";
 
+    if (deliver_synchronously_) {
+      if (dest_)
+        dest_->OnPacketReceived(packet, rtc::PacketTime());
+      return true;
+    }
+
     // TODO(ldixon): Can/should we use Buffer.TransferTo here?
     // Note: this assignment does a deep copy of data from packet.
     rtc::Buffer* buffer = new rtc::Buffer(packet->data(), packet->size());
@@ -115,6 +129,7 @@ class SctpFakeNetworkInterface : public cricket::MediaChannel::NetworkInterface,
   // Not owned by this class.
   rtc::Thread* thread_;
   cricket::DataMediaChannel* dest_;
+  bool deliver_synchronously_;
 };
 
 // This is essentially a buffer to hold recieved data. It stores only the last
@@ -335,6 +350,8 @@ class SctpDataMediaChannelTest : public testing::Test,
   cricket::SctpDataMediaChannel* channel2() { return chan2_.get(); }
   SctpFakeDataReceiver* receiver1() { return recv1_.get(); }
   SctpFakeDataReceiver* receiver2() { return recv2_.get(); }
+  SctpFakeNetworkInterface* network1() { return net1_.get(); }
+  SctpFakeNetworkInterface* network2() { return net2_.get(); }
 
   int channel1_ready_to_send_count() { return chan1_ready_to_send_count_; }
   int channel2_ready_to_send_count() { return chan2_ready_to_send_count_; }
@@ -415,6 +432,45 @@ TEST_F(SctpDataMediaChannelTest, SendData) {
                   << ", recv1.last_data=" << receiver1()->last_data();
 }
 
+TEST_F(SctpDataMediaChannelTest, SendDataProcessedInPlace) {
+  SetupConnectedChannels();
+  channel1()->set_process_in_place(true);
+  channel2()->set_process_in_place(true);
+
+  cricket::SendDataResult result;
+  ASSERT_TRUE(SendData(channel1(), 1, "hello?", &result));
+  EXPECT_EQ(cricket::SDR_SUCCESS, result);
+  EXPECT_TRUE_WAIT(ReceivedData(receiver2(), 1, "hello?"), 1000);
+  ASSERT_TRUE(SendData(channel2(), 2, "hi chan1", &result));
+  EXPECT_EQ(cricket::SDR_SUCCESS, result);
+  EXPECT_TRUE_WAIT(ReceivedData(receiver1(), 2, "hi chan1"), 1000);
+}
+
+// Test that in-place processing works with a network interface that delivers
+// packets before SendPacket returns. Each channel's packets then reach the
+// peer's usrsctp_conninput, whose SACKs come straight back. Packets are only
+// sent after usrsctp_sendv or usrsctp_conninput has returned, so this never
+// calls into usrsctp from inside a usrsctp callback.
+TEST_F(SctpDataMediaChannelTest, SendDataProcessedInPlaceWithSyncNetwork) {
+  SetupConnectedChannels();
+  channel1()->set_process_in_place(true);
+  channel2()->set_process_in_place(true);
+  network1()->set_deliver_synchronously(true);
+  network2()->set_deliver_synchronously(true);
+
+  cricket::SendDataResult result;
+  for (int i = 0; i < 20; ++i) {
+    std::string msg = "hello " + rtc::ToString(i);
+    ASSERT_TRUE(SendData(channel1(), 1, msg, &result));
+    EXPECT_EQ(cricket::SDR_SUCCESS, result);
+    EXPECT_TRUE(ReceivedData(receiver2(), 1, msg));
+    msg = "hi chan1 " + rtc::ToString(i);
+    ASSERT_TRUE(SendData(channel2(), 2, msg, &result));
+    EXPECT_EQ(cricket::SDR_SUCCESS, result);
+    EXPECT_TRUE(ReceivedData(receiver1(), 2, msg));
+  }
+}
+
 // Sends a lot of large messages at once and verifies SDR_BLOCK is returned.
 TEST_F(SctpDataMediaChannelTest, SendDataBlocked) {
   SetupConnectedChannels();
@@ -39,6 +39,7 @@
 #include "webrtc/base/helpers.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/sslstreamadapter.h"
 #include "webrtc/base/stringutils.h"
 #include "webrtc/p2p/base/constants.h"
 
@@ -170,6 +171,16 @@ void GetSupportedDataCryptoSuites(
   GetSupportedDefaultCryptoSuites(crypto_suites);
 }
 
+void GetSupportedGcmCryptoSuites(
+    std::vector<std::string>* crypto_suites) {
+#if defined(HAVE_SRTP) && defined(HAVE_SRTP_AES_GCM)
+  if (rtc::SSLStreamAdapter::HaveDtlsSrtpGcm()) {
+    crypto_suites->push_back(CS_AEAD_AES_256_GCM);
+    crypto_suites->push_back(CS_AEAD_AES_128_GCM);
+  }
+#endif
+}
+
 void GetSupportedDefaultCryptoSuites(
     std::vector<std::string>* crypto_suites) {
 #ifdef HAVE_SRTP
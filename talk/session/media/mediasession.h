@@ -550,6 +550,9 @@ const DataContentDescription* GetFirstDataContentDescription(
 void GetSupportedAudioCryptoSuites(std::vector<std::string>* crypto_suites);
 void GetSupportedVideoCryptoSuites(std::vector<std::string>* crypto_suites);
 void GetSupportedDataCryptoSuites(std::vector<std::string>* crypto_suites);
+// AEAD suites usable with DTLS-SRTP. Empty unless libsrtp and the DTLS
+// implementation both support them.
+void GetSupportedGcmCryptoSuites(std::vector<std::string>* crypto_suites);
 void GetSupportedDefaultCryptoSuites(std::vector<std::string>* crypto_suites);
 }  // namespace cricket
 
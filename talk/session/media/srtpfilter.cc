@@ -75,9 +75,31 @@ namespace cricket {
 
 const char CS_AES_CM_128_HMAC_SHA1_80[] = "AES_CM_128_HMAC_SHA1_80";
 const char CS_AES_CM_128_HMAC_SHA1_32[] = "AES_CM_128_HMAC_SHA1_32";
+const char CS_AEAD_AES_128_GCM[] = "AEAD_AES_128_GCM";
+const char CS_AEAD_AES_256_GCM[] = "AEAD_AES_256_GCM";
 const int SRTP_MASTER_KEY_BASE64_LEN = SRTP_MASTER_KEY_LEN * 4 / 3;
 const int SRTP_MASTER_KEY_KEY_LEN = 16;
 const int SRTP_MASTER_KEY_SALT_LEN = 14;
+// The AEAD suites use a 96-bit salt (RFC 7714, section 12).
+static const int SRTP_AEAD_SALT_LEN = 12;
+
+bool GetSrtpKeyAndSaltLengths(const std::string& cs,
+                              int* key_length,
+                              int* salt_length) {
+  if (cs == CS_AES_CM_128_HMAC_SHA1_80 || cs == CS_AES_CM_128_HMAC_SHA1_32) {
+    *key_length = SRTP_MASTER_KEY_KEY_LEN;
+    *salt_length = SRTP_MASTER_KEY_SALT_LEN;
+  } else if (cs == CS_AEAD_AES_128_GCM) {
+    *key_length = 16;
+    *salt_length = SRTP_AEAD_SALT_LEN;
+  } else if (cs == CS_AEAD_AES_256_GCM) {
+    *key_length = 32;
+    *salt_length = SRTP_AEAD_SALT_LEN;
+  } else {
+    return false;
+  }
+  return true;
+}
 
 #ifndef HAVE_SRTP
 
@@ -263,6 +285,15 @@ bool SrtpFilter::UnprotectRtcp(void* p, int in_len, int* out_len) {
   }
 }
 
+bool SrtpFilter::IsExternalAuthActive() const {
+  if (!IsActive()) {
+    return false;
+  }
+
+  ASSERT(send_session_ != NULL);
+  return send_session_->IsExternalAuthActive();
+}
+
 bool SrtpFilter::GetRtpAuthParams(uint8** key, int* key_len, int* tag_len) {
   if (!IsActive()) {
     LOG(LS_WARNING) << "Failed to GetRtpAuthParams: SRTP not active";
@@ -482,6 +513,7 @@ SrtpSession::SrtpSession()
     : session_(NULL),
       rtp_auth_tag_len_(0),
       rtcp_auth_tag_len_(0),
+      external_auth_active_(false),
       srtp_stat_(new SrtpStat()),
       last_send_seq_num_(-1) {
   {
@@ -609,6 +641,13 @@ bool SrtpSession::UnprotectRtcp(void* p, int in_len, int* out_len) {
 bool SrtpSession::GetRtpAuthParams(uint8** key, int* key_len,
                                    int* tag_len) {
 #if defined(ENABLE_EXTERNAL_AUTH)
+  // The AEAD suites authenticate inside libsrtp, so rtp_auth->state is not an
+  // ExternalHmacContext and must not be handed out.
+  if (!external_auth_active_) {
+    LOG(LS_WARNING) << "Failed to get auth keys: external auth not in use.";
+    return false;
+  }
+
   ExternalHmacContext* external_hmac = NULL;
   // stream_template will be the reference context for other streams.
   // Let's use it for getting the keys.
@@ -669,13 +708,24 @@ bool SrtpSession::SetKey(int type, const std::string& cs,
   } else if (cs == CS_AES_CM_128_HMAC_SHA1_32) {
     crypto_policy_set_aes_cm_128_hmac_sha1_32(&policy.rtp);   // rtp is 32,
     crypto_policy_set_aes_cm_128_hmac_sha1_80(&policy.rtcp);  // rtcp still 80
+#if defined(HAVE_SRTP_AES_GCM)
+  } else if (cs == CS_AEAD_AES_128_GCM) {
+    crypto_policy_set_aes_gcm_128_16_auth(&policy.rtp);
+    crypto_policy_set_aes_gcm_128_16_auth(&policy.rtcp);
+  } else if (cs == CS_AEAD_AES_256_GCM) {
+    crypto_policy_set_aes_gcm_256_16_auth(&policy.rtp);
+    crypto_policy_set_aes_gcm_256_16_auth(&policy.rtcp);
+#endif  // HAVE_SRTP_AES_GCM
   } else {
     LOG(LS_WARNING) << "Failed to create SRTP session: unsupported"
                     << " cipher_suite " << cs.c_str();
     return false;
   }
 
-  if (!key || len != SRTP_MASTER_KEY_LEN) {
+  int key_length;
+  int salt_length;
+  if (!key || !GetSrtpKeyAndSaltLengths(cs, &key_length, &salt_length) ||
+      len != key_length + salt_length) {
     LOG(LS_WARNING) << "Failed to create SRTP session: invalid key";
     return false;
   }
@@ -691,8 +741,9 @@ bool SrtpSession::SetKey(int type, const std::string& cs,
   // We want to set this option only for rtp packets.
   // By default policy structure is initialized to HMAC_SHA1.
 #if defined(ENABLE_EXTERNAL_AUTH)
-  // Enable external HMAC authentication only for outgoing streams.
-  if (type == ssrc_any_outbound) {
+  // Enable external HMAC authentication only for outgoing streams. The AEAD
+  // suites have no HMAC to replace.
+  if (type == ssrc_any_outbound && policy.rtp.auth_type == HMAC_SHA1) {
     policy.rtp.auth_type = EXTERNAL_HMAC_SHA1;
   }
 #endif
@@ -705,9 +756,11 @@ bool SrtpSession::SetKey(int type, const std::string& cs,
     return false;
   }
 
-
   rtp_auth_tag_len_ = policy.rtp.auth_tag_len;
   rtcp_auth_tag_len_ = policy.rtcp.auth_tag_len;
+#if defined(ENABLE_EXTERNAL_AUTH)
+  external_auth_active_ = (policy.rtp.auth_type == EXTERNAL_HMAC_SHA1);
+#endif
   return true;
 }
 
@@ -794,7 +847,7 @@ std::list<SrtpSession*>* SrtpSession::sessions() {
 
 // On some systems, SRTP is not (yet) available.
 
-SrtpSession::SrtpSession() {
+SrtpSession::SrtpSession() : external_auth_active_(false) {
   LOG(WARNING) << "SRTP implementation is missing.";
 }
 
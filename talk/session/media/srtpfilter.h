@@ -54,6 +54,12 @@ namespace cricket {
 extern const char CS_AES_CM_128_HMAC_SHA1_80[];
 // 128-bit AES with 32-bit SHA-1 HMAC.
 extern const char CS_AES_CM_128_HMAC_SHA1_32[];
+// 128-bit and 256-bit AES-GCM with a 128-bit tag (RFC 7714). These are only
+// negotiated through DTLS-SRTP, and only when libsrtp is built with
+// HAVE_SRTP_AES_GCM. The AEAD does encryption and authentication in one
+// pass, so there's no separate HMAC over each packet.
+extern const char CS_AEAD_AES_128_GCM[];
+extern const char CS_AEAD_AES_256_GCM[];
 // Key is 128 bits and salt is 112 bits == 30 bytes. B64 bloat => 40 bytes.
 extern const int SRTP_MASTER_KEY_BASE64_LEN;
 
@@ -61,6 +67,12 @@ extern const int SRTP_MASTER_KEY_BASE64_LEN;
 extern const int SRTP_MASTER_KEY_KEY_LEN;
 extern const int SRTP_MASTER_KEY_SALT_LEN;
 
+// Gets the master key and salt lengths, in bytes, for the cipher suite |cs|.
+// Returns false for unknown suites.
+bool GetSrtpKeyAndSaltLengths(const std::string& cs,
+                              int* key_length,
+                              int* salt_length);
+
 class SrtpSession;
 class SrtpStat;
 
@@ -131,7 +143,12 @@ class SrtpFilter {
   bool UnprotectRtp(void* data, int in_len, int* out_len);
   bool UnprotectRtcp(void* data, int in_len, int* out_len);
 
-  // Returns rtp auth params from srtp context.
+  // Returns true if outgoing RTP packets are left for the external HMAC
+  // module to authenticate, which is never the case for the AEAD suites.
+  bool IsExternalAuthActive() const;
+
+  // Returns rtp auth params from srtp context. Fails if external auth isn't
+  // active.
   bool GetRtpAuthParams(uint8** key, int* key_len, int* tag_len);
 
   // Update the silent threshold (in ms) for signaling errors.
@@ -215,6 +232,9 @@ class SrtpSession {
   bool UnprotectRtp(void* data, int in_len, int* out_len);
   bool UnprotectRtcp(void* data, int in_len, int* out_len);
 
+  // Returns true if the send key was set up with the external HMAC module.
+  bool IsExternalAuthActive() const { return external_auth_active_; }
+
   // Helper method to get authentication params.
   bool GetRtpAuthParams(uint8** key, int* key_len, int* tag_len);
 
@@ -241,6 +261,7 @@ class SrtpSession {
   srtp_ctx_t* session_;
   int rtp_auth_tag_len_;
   int rtcp_auth_tag_len_;
+  bool external_auth_active_;
   rtc::scoped_ptr<SrtpStat> srtp_stat_;
   static bool inited_;
   static rtc::GlobalLockPod lock_;
@@ -0,0 +1,89 @@
+/*
+ * libjingle
+ * Copyright 2015 Google Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Measures SRTP protect plus unprotect throughput for video-sized packets
+// with each supported cipher suite.
+
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "talk/media/base/fakertp.h"
+#include "talk/session/media/srtpfilter.h"
+#include "webrtc/base/byteorder.h"
+#include "webrtc/base/gunit.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/timeutils.h"
+
+namespace cricket {
+
+// Long enough for AES-256-GCM; the other suites use a prefix of it.
+static const uint8 kTestKey[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ1234567890abcdefgh";
+static const int kTestKeyLen = 30;
+static const int kTestKeyGcm128Len = 28;
+static const int kTestKeyGcm256Len = 44;
+
+TEST(SrtpSessionPerfTest, ProtectUnprotect) {
+  const int kPayloadLen = 1200;
+  const int kNumPackets = 10000;
+  std::vector<std::pair<std::string, int>> suites;
+  suites.push_back(std::make_pair(CS_AES_CM_128_HMAC_SHA1_80, kTestKeyLen));
+  suites.push_back(std::make_pair(CS_AES_CM_128_HMAC_SHA1_32, kTestKeyLen));
+#if defined(HAVE_SRTP_AES_GCM)
+  suites.push_back(std::make_pair(CS_AEAD_AES_128_GCM, kTestKeyGcm128Len));
+  suites.push_back(std::make_pair(CS_AEAD_AES_256_GCM, kTestKeyGcm256Len));
+#endif
+  for (const auto& suite : suites) {
+    SrtpSession sender;
+    SrtpSession receiver;
+    ASSERT_TRUE(sender.SetSend(suite.first, kTestKey, suite.second));
+    ASSERT_TRUE(receiver.SetRecv(suite.first, kTestKey, suite.second));
+
+    char packet[kPayloadLen + 16];
+    memset(packet, 0xab, sizeof(packet));
+    memcpy(packet, kPcmuFrame, 12);  // RTP header.
+    uint32 start = rtc::Time();
+    for (int i = 0; i < kNumPackets; ++i) {
+      rtc::SetBE16(packet + 2, static_cast<uint16>(i));
+      int len = 0;
+      ASSERT_TRUE(sender.ProtectRtp(packet, kPayloadLen, sizeof(packet),
+                                    &len));
+      ASSERT_TRUE(receiver.UnprotectRtp(packet, len, &len));
+      ASSERT_EQ(kPayloadLen, len);
+    }
+    int elapsed_ms = std::max(1, rtc::TimeSince(start));
+    LOG(LS_INFO) << suite.first << ": " << kNumPackets << " packets of "
+                 << kPayloadLen << " bytes in " << elapsed_ms << " ms, "
+                 << kNumPackets * kPayloadLen / 1000 / elapsed_ms
+                 << " MB/s";
+  }
+}
+
+}  // namespace cricket
@@ -42,6 +42,8 @@ extern "C" {
 
 using cricket::CS_AES_CM_128_HMAC_SHA1_80;
 using cricket::CS_AES_CM_128_HMAC_SHA1_32;
+using cricket::CS_AEAD_AES_128_GCM;
+using cricket::CS_AEAD_AES_256_GCM;
 using cricket::CryptoParams;
 using cricket::CS_LOCAL;
 using cricket::CS_REMOTE;
@@ -49,6 +51,10 @@ using cricket::CS_REMOTE;
 static const uint8 kTestKey1[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ1234";
 static const uint8 kTestKey2[] = "4321ZYXWVUTSRQPONMLKJIHGFEDCBA";
 static const int kTestKeyLen = 30;
+static const uint8 kTestKeyGcm256[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZ1234567890abcdefgh";
+static const int kTestKeyGcm128Len = 28;
+static const int kTestKeyGcm256Len = 44;
 static const std::string kTestKeyParams1 =
     "inline:WVNfX19zZW1jdGwgKCkgewkyMjA7fQp9CnVubGVz";
 static const std::string kTestKeyParams2 =
@@ -62,11 +68,16 @@ static const cricket::CryptoParams kTestCryptoParams1(
 static const cricket::CryptoParams kTestCryptoParams2(
     1, "AES_CM_128_HMAC_SHA1_80", kTestKeyParams2, "");
 
+static bool IsGcmCipherSuite(const std::string& cs) {
+  return cs == CS_AEAD_AES_128_GCM || cs == CS_AEAD_AES_256_GCM;
+}
 static int rtp_auth_tag_len(const std::string& cs) {
+  if (IsGcmCipherSuite(cs))
+    return 16;
   return (cs == CS_AES_CM_128_HMAC_SHA1_32) ? 4 : 10;
 }
 static int rtcp_auth_tag_len(const std::string& cs) {
-  return 10;
+  return IsGcmCipherSuite(cs) ? 16 : 10;
 }
 
 class SrtpFilterTest : public testing::Test {
@@ -564,6 +575,26 @@ TEST_F(SrtpFilterTest, TestSetParamsKeyTooShort) {
                                  kTestKey1, kTestKeyLen - 1));
 }
 
+TEST_F(SrtpFilterTest, TestGetSrtpKeyAndSaltLengths) {
+  int key_len;
+  int salt_len;
+  EXPECT_TRUE(cricket::GetSrtpKeyAndSaltLengths(CS_AES_CM_128_HMAC_SHA1_80,
+                                                &key_len, &salt_len));
+  EXPECT_EQ(kTestKeyLen, key_len + salt_len);
+  EXPECT_TRUE(cricket::GetSrtpKeyAndSaltLengths(CS_AES_CM_128_HMAC_SHA1_32,
+                                                &key_len, &salt_len));
+  EXPECT_EQ(kTestKeyLen, key_len + salt_len);
+  EXPECT_TRUE(cricket::GetSrtpKeyAndSaltLengths(CS_AEAD_AES_128_GCM,
+                                                &key_len, &salt_len));
+  EXPECT_EQ(16, key_len);
+  EXPECT_EQ(12, salt_len);
+  EXPECT_TRUE(cricket::GetSrtpKeyAndSaltLengths(CS_AEAD_AES_256_GCM,
+                                                &key_len, &salt_len));
+  EXPECT_EQ(32, key_len);
+  EXPECT_EQ(12, salt_len);
+  EXPECT_FALSE(cricket::GetSrtpKeyAndSaltLengths("FOO", &key_len, &salt_len));
+}
+
 #if defined(ENABLE_EXTERNAL_AUTH)
 TEST_F(SrtpFilterTest, TestGetSendAuthParams) {
   EXPECT_TRUE(f1_.SetRtpParams(CS_AES_CM_128_HMAC_SHA1_32,
@@ -576,12 +607,43 @@ TEST_F(SrtpFilterTest, TestGetSendAuthParams) {
                                 kTestKey2, kTestKeyLen));
   uint8* auth_key = NULL;
   int auth_key_len = 0, auth_tag_len = 0;
+  EXPECT_TRUE(f1_.IsExternalAuthActive());
   EXPECT_TRUE(f1_.GetRtpAuthParams(&auth_key, &auth_key_len, &auth_tag_len));
   EXPECT_TRUE(auth_key != NULL);
   EXPECT_EQ(20, auth_key_len);
   EXPECT_EQ(4, auth_tag_len);
 }
-#endif
+
+#if defined(HAVE_SRTP_AES_GCM)
+// Test that the AEAD suites keep authenticating inside libsrtp, so there are
+// no auth params for the socket and the GCM tag is left as written.
+TEST_F(SrtpFilterTest, TestNoSendAuthParamsForGcm) {
+  EXPECT_TRUE(f1_.SetRtpParams(CS_AEAD_AES_128_GCM,
+                               kTestKeyGcm256, kTestKeyGcm128Len,
+                               CS_AEAD_AES_128_GCM,
+                               kTestKeyGcm256, kTestKeyGcm128Len));
+  EXPECT_TRUE(f2_.SetRtpParams(CS_AEAD_AES_128_GCM,
+                               kTestKeyGcm256, kTestKeyGcm128Len,
+                               CS_AEAD_AES_128_GCM,
+                               kTestKeyGcm256, kTestKeyGcm128Len));
+  EXPECT_FALSE(f1_.IsExternalAuthActive());
+  uint8* auth_key = NULL;
+  int auth_key_len = 0, auth_tag_len = 0;
+  EXPECT_FALSE(f1_.GetRtpAuthParams(&auth_key, &auth_key_len, &auth_tag_len));
+
+  char rtp_packet[sizeof(kPcmuFrame) + 16];
+  int rtp_len = sizeof(kPcmuFrame), out_len = 0;
+  memcpy(rtp_packet, kPcmuFrame, rtp_len);
+  int64 index = -1;
+  EXPECT_TRUE(f1_.ProtectRtp(rtp_packet, rtp_len, sizeof(rtp_packet),
+                             &out_len, &index));
+  EXPECT_EQ(rtp_len + 16, out_len);
+  EXPECT_TRUE(f2_.UnprotectRtp(rtp_packet, out_len, &out_len));
+  EXPECT_EQ(rtp_len, out_len);
+  EXPECT_EQ(0, memcmp(rtp_packet, kPcmuFrame, rtp_len));
+}
+#endif  // HAVE_SRTP_AES_GCM
+#endif  // ENABLE_EXTERNAL_AUTH
 
 class SrtpSessionTest : public testing::Test {
  protected:
@@ -621,8 +683,9 @@ class SrtpSessionTest : public testing::Test {
   }
   cricket::SrtpSession s1_;
   cricket::SrtpSession s2_;
-  char rtp_packet_[sizeof(kPcmuFrame) + 10];
-  char rtcp_packet_[sizeof(kRtcpReport) + 4 + 10];
+  // Room for the largest (AEAD) authentication tag.
+  char rtp_packet_[sizeof(kPcmuFrame) + 16];
+  char rtcp_packet_[sizeof(kRtcpReport) + 4 + 16];
   int rtp_len_;
   int rtcp_len_;
 };
@@ -667,6 +730,39 @@ TEST_F(SrtpSessionTest, TestProtect_AES_CM_128_HMAC_SHA1_32) {
   TestUnprotectRtcp(CS_AES_CM_128_HMAC_SHA1_32);
 }
 
+#if defined(HAVE_SRTP_AES_GCM)
+// Test that we can encrypt and decrypt RTP/RTCP using AEAD_AES_128_GCM.
+TEST_F(SrtpSessionTest, TestProtect_AEAD_AES_128_GCM) {
+  EXPECT_TRUE(s1_.SetSend(CS_AEAD_AES_128_GCM, kTestKeyGcm256,
+                          kTestKeyGcm128Len));
+  EXPECT_TRUE(s2_.SetRecv(CS_AEAD_AES_128_GCM, kTestKeyGcm256,
+                          kTestKeyGcm128Len));
+  TestProtectRtp(CS_AEAD_AES_128_GCM);
+  TestProtectRtcp(CS_AEAD_AES_128_GCM);
+  TestUnprotectRtp(CS_AEAD_AES_128_GCM);
+  TestUnprotectRtcp(CS_AEAD_AES_128_GCM);
+}
+
+// Test that we can encrypt and decrypt RTP/RTCP using AEAD_AES_256_GCM.
+TEST_F(SrtpSessionTest, TestProtect_AEAD_AES_256_GCM) {
+  EXPECT_TRUE(s1_.SetSend(CS_AEAD_AES_256_GCM, kTestKeyGcm256,
+                          kTestKeyGcm256Len));
+  EXPECT_TRUE(s2_.SetRecv(CS_AEAD_AES_256_GCM, kTestKeyGcm256,
+                          kTestKeyGcm256Len));
+  TestProtectRtp(CS_AEAD_AES_256_GCM);
+  TestProtectRtcp(CS_AEAD_AES_256_GCM);
+  TestUnprotectRtp(CS_AEAD_AES_256_GCM);
+  TestUnprotectRtcp(CS_AEAD_AES_256_GCM);
+}
+#endif  // HAVE_SRTP_AES_GCM
+
+// Test that a GCM key isn't accepted for an HMAC suite and vice versa.
+TEST_F(SrtpSessionTest, TestKeyLengthMustMatchCipherSuite) {
+  EXPECT_FALSE(s1_.SetSend(CS_AES_CM_128_HMAC_SHA1_80, kTestKeyGcm256,
+                           kTestKeyGcm128Len));
+  EXPECT_FALSE(s2_.SetSend(CS_AEAD_AES_128_GCM, kTestKey1, kTestKeyLen));
+}
+
 TEST_F(SrtpSessionTest, TestGetSendStreamPacketIndex) {
   EXPECT_TRUE(s1_.SetSend(CS_AES_CM_128_HMAC_SHA1_32, kTestKey1, kTestKeyLen));
   int64 index;
@@ -42,6 +42,15 @@ class AtomicOps {
                                         new_value,
                                         old_value);
   }
+  // Pointer variants.
+  template <typename T>
+  static T* AcquireLoadPtr(T* volatile const* ptr) {
+    return *ptr;
+  }
+  template <typename T>
+  static void ReleaseStorePtr(T* volatile* ptr, T* value) {
+    *ptr = value;
+  }
 #else
   static int Increment(volatile int* i) {
     return __sync_add_and_fetch(i, 1);
@@ -58,6 +67,15 @@ class AtomicOps {
   static int CompareAndSwap(volatile int* i, int old_value, int new_value) {
     return __sync_val_compare_and_swap(i, old_value, new_value);
   }
+  // Pointer variants.
+  template <typename T>
+  static T* AcquireLoadPtr(T* volatile const* ptr) {
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+  }
+  template <typename T>
+  static void ReleaseStorePtr(T* volatile* ptr, T* value) {
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+  }
 #endif
 };
 
@@ -59,6 +59,8 @@
         'md5.h',
         'md5digest.cc',
         'md5digest.h',
+        'memory_mapped_file.cc',
+        'memory_mapped_file.h',
         'platform_file.cc',
         'platform_file.h',
         'platform_thread.cc',
@@ -70,6 +70,7 @@
           'ipaddress_unittest.cc',
           'logging_unittest.cc',
           'md5digest_unittest.cc',
+          'memory_mapped_file_unittest.cc',
           'messagedigest_unittest.cc',
           'messagequeue_unittest.cc',
           'multipart_unittest.cc',
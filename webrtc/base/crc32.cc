@@ -11,20 +11,30 @@
 #include "webrtc/base/crc32.h"
 
 #include "webrtc/base/basicdefs.h"
+#include "webrtc/base/byteorder.h"
 
 namespace rtc {
 
-// This implementation is based on the sample implementation in RFC 1952.
+// This implementation is based on the sample implementation in RFC 1952,
+// extended to the "slice-by-8" scheme: eight lookup tables let the main loop
+// consume 8 bytes per iteration with independent table lookups, instead of
+// one byte per iteration with a serial dependency on the previous lookup.
+// Note that the SSE4.2 CRC32 instruction can't be used here, since it
+// implements the Castagnoli polynomial rather than the one used by STUN,
+// gzip etc.
 
 // CRC32 polynomial, in reversed form.
 // See RFC 1952, or http://en.wikipedia.org/wiki/Cyclic_redundancy_check
 static const uint32 kCrc32Polynomial = 0xEDB88320;
-static uint32 kCrc32Table[256] = { 0 };
+static const size_t kCrc32Slices = 8;
+// kCrc32Table[0] is the classic byte-at-a-time table. kCrc32Table[k][i] is
+// the CRC of byte |i| followed by |k| zero bytes.
+static uint32 kCrc32Table[kCrc32Slices][256] = { { 0 } };
 
 static void EnsureCrc32TableInited() {
-  if (kCrc32Table[ARRAY_SIZE(kCrc32Table) - 1])
+  if (kCrc32Table[kCrc32Slices - 1][ARRAY_SIZE(kCrc32Table[0]) - 1])
     return;  // already inited
-  for (uint32 i = 0; i < ARRAY_SIZE(kCrc32Table); ++i) {
+  for (uint32 i = 0; i < ARRAY_SIZE(kCrc32Table[0]); ++i) {
     uint32 c = i;
     for (size_t j = 0; j < 8; ++j) {
       if (c & 1) {
@@ -33,7 +43,14 @@ static void EnsureCrc32TableInited() {
         c >>= 1;
       }
     }
-    kCrc32Table[i] = c;
+    kCrc32Table[0][i] = c;
+  }
+  for (uint32 i = 0; i < ARRAY_SIZE(kCrc32Table[0]); ++i) {
+    uint32 c = kCrc32Table[0][i];
+    for (size_t k = 1; k < kCrc32Slices; ++k) {
+      c = kCrc32Table[0][c & 0xFF] ^ (c >> 8);
+      kCrc32Table[k][i] = c;
+    }
   }
 }
 
@@ -42,8 +59,20 @@ uint32 UpdateCrc32(uint32 start, const void* buf, size_t len) {
 
   uint32 c = start ^ 0xFFFFFFFF;
   const uint8* u = static_cast<const uint8*>(buf);
+  for (; len >= kCrc32Slices; len -= kCrc32Slices, u += kCrc32Slices) {
+    uint32 lo = GetLE32(u) ^ c;
+    uint32 hi = GetLE32(u + 4);
+    c = kCrc32Table[7][lo & 0xFF] ^
+        kCrc32Table[6][(lo >> 8) & 0xFF] ^
+        kCrc32Table[5][(lo >> 16) & 0xFF] ^
+        kCrc32Table[4][lo >> 24] ^
+        kCrc32Table[3][hi & 0xFF] ^
+        kCrc32Table[2][(hi >> 8) & 0xFF] ^
+        kCrc32Table[1][(hi >> 16) & 0xFF] ^
+        kCrc32Table[0][hi >> 24];
+  }
   for (size_t i = 0; i < len; ++i) {
-    c = kCrc32Table[(c ^ u[i]) & 0xFF] ^ (c >> 8);
+    c = kCrc32Table[0][(c ^ u[i]) & 0xFF] ^ (c >> 8);
   }
   return c ^ 0xFFFFFFFF;
 }
@@ -32,4 +32,20 @@ TEST(Crc32Test, TestMultipleUpdates) {
   EXPECT_EQ(0x171A3F5FU, c);
 }
 
+TEST(Crc32Test, TestUnalignedLengthsAndOffsets) {
+  // Compare against a byte-at-a-time computation, to cover the
+  // 8-bytes-at-a-time path with every offset and leftover length.
+  std::string input;
+  for (int i = 0; i < 100; ++i)
+    input.push_back(static_cast<char>(i * 37 + 11));
+  for (size_t offset = 0; offset < 8; ++offset) {
+    for (size_t len = 0; offset + len <= input.size(); ++len) {
+      uint32 expected = 0;
+      for (size_t i = 0; i < len; ++i)
+        expected = UpdateCrc32(expected, &input[offset + i], 1);
+      EXPECT_EQ(expected, ComputeCrc32(input.data() + offset, len));
+    }
+  }
+}
+
 }  // namespace rtc
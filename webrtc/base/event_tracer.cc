@@ -10,6 +10,26 @@
 
 #include "webrtc/base/event_tracer.h"
 
+#if defined(WEBRTC_POSIX)
+#include <pthread.h>
+#endif
+#include <string.h>
+
+#include <cmath>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/bytebuffer.h"
+#include "webrtc/base/checks.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/base/thread_annotations.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/base/trace_event.h"
+
 namespace webrtc {
 
 namespace {
@@ -17,6 +37,459 @@ namespace {
 GetCategoryEnabledPtr g_get_category_enabled_ptr = 0;
 AddTraceEventPtr g_add_trace_event_ptr = 0;
 
+// Binary capture format. All integers are in network byte order.
+//
+//   header: "WRTCTRC1"
+//   records, each starting with a one-byte tag:
+//     'S' string:  uint32 id, uint32 length, bytes. Ids count up from 0.
+//     'T' thread:  uint32 thread id, uint32 dropped events. Applies to the
+//                  events that follow.
+//     'E' event:   uint8 phase, uint8 flags, uint8 num_args,
+//                  uint32 category string id, uint32 name string id,
+//                  uint64 timestamp in microseconds,
+//                  uint64 id (only if flags has TRACE_EVENT_FLAG_HAS_ID),
+//                  num_args * (uint32 name string id, uint8 type,
+//                              uint64 value or string id for string types).
+const char kTraceMagic[] = "WRTCTRC1";
+const size_t kTraceMagicLength = sizeof(kTraceMagic) - 1;
+const uint8 kStringTag = 'S';
+const uint8 kThreadTag = 'T';
+const uint8 kEventTag = 'E';
+
+const int kMaxArgs = 2;
+const int kMaxCategories = 128;
+const int kEventsPerChunk = 4096;
+const int kMaxChunksPerThread = 64;
+const char kDisabledByDefaultPrefix[] = "disabled-by-default-";
+
+// |enabled| must be the first member: TRACE_EVENT call sites hold a pointer
+// to it, which the tracer casts back to the Category.
+struct Category {
+  unsigned char enabled;
+  const char* name;
+};
+
+// Call sites keep pointers into this array for the life of the process, so it
+// outlives the tracer.
+Category g_categories[kMaxCategories];
+int g_num_categories = 0;
+
+struct TraceRecord {
+  uint64 timestamp_us;
+  unsigned long long id;
+  unsigned long long arg_values[kMaxArgs];
+  const char* category;
+  const char* name;
+  const char* arg_names[kMaxArgs];
+  unsigned char arg_types[kMaxArgs];
+  char phase;
+  unsigned char flags;
+  unsigned char num_args;
+};
+
+const char* CopyString(const char* str) {
+  size_t length = strlen(str) + 1;
+  char* copy = new char[length];
+  memcpy(copy, str, length);
+  return copy;
+}
+
+bool IsStringType(unsigned char type) {
+  return type == TRACE_VALUE_TYPE_STRING ||
+         type == TRACE_VALUE_TYPE_COPY_STRING;
+}
+
+const char* ArgValueAsString(unsigned long long value) {
+  const char* str =
+      reinterpret_cast<const char*>(static_cast<uintptr_t>(value));
+  return str ? str : "";
+}
+
+// Events recorded by one thread. Only the owning thread appends, and it
+// publishes |size| with a release store after writing each event, so a reader
+// that acquire-loads |size| only sees complete records. The buffer belongs to
+// the capture |generation|; only the owning thread resets it for a newer one.
+// When the owning thread exits the buffer is marked retired, and the tracer
+// frees it once its events are no longer needed.
+class ThreadBuffer {
+ public:
+  ThreadBuffer(rtc::PlatformThreadId thread_id, int generation)
+      : thread_id_(thread_id),
+        size_(0),
+        dropped_(0),
+        generation_(generation),
+        retired_(0) {
+    memset(chunks_, 0, sizeof(chunks_));
+  }
+
+  // Must only be called by the owning thread, or once the buffer is retired.
+  ~ThreadBuffer() {
+    Reset(generation_);
+    for (int i = 0; i < kMaxChunksPerThread; ++i)
+      delete[] chunks_[i];
+  }
+
+  // Returns the slot for the next event, or NULL if the buffer is full.
+  TraceRecord* Next() {
+    int chunk = size_ / kEventsPerChunk;
+    if (chunk >= kMaxChunksPerThread) {
+      ++dropped_;
+      return NULL;
+    }
+    if (!chunks_[chunk])
+      chunks_[chunk] = new TraceRecord[kEventsPerChunk];
+    return &chunks_[chunk][size_ % kEventsPerChunk];
+  }
+
+  void Commit() { rtc::AtomicOps::ReleaseStore(&size_, size_ + 1); }
+
+  int size() const { return rtc::AtomicOps::AcquireLoad(&size_); }
+  int generation() const { return rtc::AtomicOps::AcquireLoad(&generation_); }
+  int dropped() const { return dropped_; }
+  rtc::PlatformThreadId thread_id() const { return thread_id_; }
+
+  // Called on the owning thread as it exits; it records nothing afterwards.
+  void Retire() { rtc::AtomicOps::ReleaseStore(&retired_, 1); }
+  bool retired() const { return rtc::AtomicOps::AcquireLoad(&retired_) != 0; }
+  const TraceRecord& at(int i) const {
+    return chunks_[i / kEventsPerChunk][i % kEventsPerChunk];
+  }
+
+  // Frees the strings copied for TRACE_EVENT_COPY_* events, empties the
+  // buffer and moves it to |generation|. Must only be called by the owning
+  // thread.
+  void Reset(int generation) {
+    for (int i = 0; i < size_; ++i) {
+      const TraceRecord& record = at(i);
+      for (int j = 0; j < record.num_args; ++j) {
+        if (record.flags & TRACE_EVENT_FLAG_COPY)
+          delete[] record.arg_names[j];
+        if (record.arg_types[j] == TRACE_VALUE_TYPE_COPY_STRING)
+          delete[] ArgValueAsString(record.arg_values[j]);
+      }
+      if (record.flags & TRACE_EVENT_FLAG_COPY)
+        delete[] record.name;
+    }
+    rtc::AtomicOps::ReleaseStore(&size_, 0);
+    dropped_ = 0;
+    rtc::AtomicOps::ReleaseStore(&generation_, generation);
+  }
+
+ private:
+  const rtc::PlatformThreadId thread_id_;
+  TraceRecord* chunks_[kMaxChunksPerThread];
+  volatile int size_;
+  int dropped_;
+  volatile int generation_;
+  volatile int retired_;
+};
+
+// Never deleted: a thread may still be recording an event when the tracer is
+// shut down, so the tracer and the buffers of live threads last for the rest
+// of the process and are reused if the tracer is set up again.
+class InternalTracer {
+ public:
+  InternalTracer() : capturing_(false), generation_(0) {
+#if defined(WEBRTC_WIN)
+    // Unlike TLS slots, fiber local storage slots run a callback when the
+    // thread exits.
+    tls_key_ = FlsAlloc(&OnThreadExit);
+#elif defined(WEBRTC_POSIX)
+    pthread_key_create(&tls_key_, &OnThreadExit);
+#endif
+  }
+
+  const unsigned char* GetCategoryEnabled(const char* name) {
+    rtc::CritScope cs(&crit_);
+    for (int i = 0; i < g_num_categories; ++i) {
+      if (strcmp(g_categories[i].name, name) == 0)
+        return &g_categories[i].enabled;
+    }
+    if (g_num_categories == kMaxCategories) {
+      LOG(LS_WARNING) << "Too many trace categories, ignoring " << name;
+      return reinterpret_cast<const unsigned char*>("\0");
+    }
+    Category* category = &g_categories[g_num_categories++];
+    category->name = name;
+    category->enabled = capturing_ && IsEnabledByDefault(name);
+    return &category->enabled;
+  }
+
+  void AddTraceEvent(char phase,
+                     const unsigned char* category_enabled,
+                     const char* name,
+                     unsigned long long id,
+                     int num_args,
+                     const char** arg_names,
+                     const unsigned char* arg_types,
+                     const unsigned long long* arg_values,
+                     unsigned char flags) {
+    // The category may have been disabled since the call site checked it.
+    if (!*category_enabled)
+      return;
+    ThreadBuffer* buffer = GetThreadBuffer();
+    // Events left over from an earlier capture are discarded by the thread
+    // that recorded them, the first time it records into a newer one.
+    int generation = rtc::AtomicOps::AcquireLoad(&generation_);
+    if (buffer->generation() != generation)
+      buffer->Reset(generation);
+    TraceRecord* record = buffer->Next();
+    if (!record)
+      return;
+    record->timestamp_us = rtc::TimeMicros();
+    record->id = id;
+    record->category =
+        reinterpret_cast<const Category*>(category_enabled)->name;
+    record->name = (flags & TRACE_EVENT_FLAG_COPY) ? CopyString(name) : name;
+    record->phase = phase;
+    record->flags = flags;
+    record->num_args = static_cast<unsigned char>(num_args);
+    for (int i = 0; i < num_args; ++i) {
+      record->arg_names[i] = (flags & TRACE_EVENT_FLAG_COPY)
+                                 ? CopyString(arg_names[i])
+                                 : arg_names[i];
+      record->arg_types[i] = arg_types[i];
+      record->arg_values[i] = arg_values[i];
+      if (arg_types[i] == TRACE_VALUE_TYPE_COPY_STRING) {
+        record->arg_values[i] = reinterpret_cast<uintptr_t>(
+            CopyString(ArgValueAsString(arg_values[i])));
+      }
+    }
+    buffer->Commit();
+  }
+
+  void Start() {
+    rtc::CritScope cs(&crit_);
+    // Writing threads may still be appending, so their buffers are only
+    // marked stale here; see AddTraceEvent().
+    rtc::AtomicOps::Increment(&generation_);
+    FreeRetiredBuffers();
+    capturing_ = true;
+    for (int i = 0; i < g_num_categories; ++i)
+      g_categories[i].enabled = IsEnabledByDefault(g_categories[i].name);
+  }
+
+  void Stop() {
+    rtc::CritScope cs(&crit_);
+    capturing_ = false;
+    for (int i = 0; i < g_num_categories; ++i)
+      g_categories[i].enabled = 0;
+  }
+
+  // Stops recording and discards the captured events.
+  void Discard() {
+    rtc::CritScope cs(&crit_);
+    Stop();
+    rtc::AtomicOps::Increment(&generation_);
+    FreeRetiredBuffers();
+  }
+
+  bool Write(FILE* file) {
+    rtc::CritScope cs(&crit_);
+    if (capturing_) {
+      LOG(LS_ERROR) << "Can't write a trace while capturing.";
+      return false;
+    }
+    std::map<std::string, uint32> string_ids;
+    rtc::ByteBuffer out;
+    out.WriteBytes(kTraceMagic, kTraceMagicLength);
+    auto intern = [&string_ids, &out](const char* str) {
+      auto it = string_ids.find(str);
+      if (it != string_ids.end())
+        return it->second;
+      uint32 id = static_cast<uint32>(string_ids.size());
+      string_ids[str] = id;
+      size_t length = strlen(str);
+      out.WriteUInt8(kStringTag);
+      out.WriteUInt32(id);
+      out.WriteUInt32(static_cast<uint32>(length));
+      out.WriteBytes(str, length);
+      return id;
+    };
+    int generation = rtc::AtomicOps::AcquireLoad(&generation_);
+    for (ThreadBuffer* buffer : buffers_) {
+      // Skip buffers still holding an earlier capture.
+      if (buffer->generation() != generation)
+        continue;
+      int size = buffer->size();
+      if (size == 0 && buffer->dropped() == 0)
+        continue;
+      if (buffer->dropped() > 0) {
+        LOG(LS_WARNING) << "Thread " << buffer->thread_id() << " dropped "
+                        << buffer->dropped() << " trace events.";
+      }
+      out.WriteUInt8(kThreadTag);
+      out.WriteUInt32(static_cast<uint32>(buffer->thread_id()));
+      out.WriteUInt32(static_cast<uint32>(buffer->dropped()));
+      for (int i = 0; i < size; ++i) {
+        const TraceRecord& record = buffer->at(i);
+        // Strings are interned before the event so that their records
+        // precede it.
+        uint32 category_id = intern(record.category);
+        uint32 name_id = intern(record.name);
+        uint32 arg_name_ids[kMaxArgs];
+        uint64 arg_values[kMaxArgs];
+        for (int j = 0; j < record.num_args; ++j) {
+          arg_name_ids[j] = intern(record.arg_names[j]);
+          arg_values[j] = IsStringType(record.arg_types[j])
+                              ? intern(ArgValueAsString(record.arg_values[j]))
+                              : record.arg_values[j];
+        }
+        out.WriteUInt8(kEventTag);
+        out.WriteUInt8(static_cast<uint8>(record.phase));
+        out.WriteUInt8(record.flags);
+        out.WriteUInt8(record.num_args);
+        out.WriteUInt32(category_id);
+        out.WriteUInt32(name_id);
+        out.WriteUInt64(record.timestamp_us);
+        if (record.flags & TRACE_EVENT_FLAG_HAS_ID)
+          out.WriteUInt64(record.id);
+        for (int j = 0; j < record.num_args; ++j) {
+          out.WriteUInt32(arg_name_ids[j]);
+          out.WriteUInt8(record.arg_types[j]);
+          out.WriteUInt64(arg_values[j]);
+        }
+      }
+      if (fwrite(out.Data(), 1, out.Length(), file) != out.Length())
+        return false;
+      out.Consume(out.Length());
+    }
+    if (fwrite(out.Data(), 1, out.Length(), file) != out.Length())
+      return false;
+    return fflush(file) == 0;
+  }
+
+ private:
+  static bool IsEnabledByDefault(const char* name) {
+    return strncmp(name, kDisabledByDefaultPrefix,
+                   sizeof(kDisabledByDefaultPrefix) - 1) != 0;
+  }
+
+#if defined(WEBRTC_WIN)
+  static void NTAPI OnThreadExit(void* buffer) {
+#elif defined(WEBRTC_POSIX)
+  static void OnThreadExit(void* buffer) {
+#endif
+    if (buffer)
+      static_cast<ThreadBuffer*>(buffer)->Retire();
+  }
+
+  // Deletes the buffers of exited threads. Their events belong to a capture
+  // that has just been discarded, so nothing reads them anymore.
+  void FreeRetiredBuffers() EXCLUSIVE_LOCKS_REQUIRED(crit_) {
+    size_t kept = 0;
+    for (ThreadBuffer* buffer : buffers_) {
+      if (buffer->retired())
+        delete buffer;
+      else
+        buffers_[kept++] = buffer;
+    }
+    buffers_.resize(kept);
+  }
+
+  ThreadBuffer* GetThreadBuffer() {
+#if defined(WEBRTC_WIN)
+    ThreadBuffer* buffer = static_cast<ThreadBuffer*>(FlsGetValue(tls_key_));
+#elif defined(WEBRTC_POSIX)
+    ThreadBuffer* buffer =
+        static_cast<ThreadBuffer*>(pthread_getspecific(tls_key_));
+#endif
+    if (buffer)
+      return buffer;
+    // First event on this thread. The buffer is kept after the thread exits
+    // so that its events can still be written, until the next Start() or
+    // Discard().
+    buffer = new ThreadBuffer(rtc::CurrentThreadId(),
+                              rtc::AtomicOps::AcquireLoad(&generation_));
+    {
+      rtc::CritScope cs(&crit_);
+      buffers_.push_back(buffer);
+    }
+#if defined(WEBRTC_WIN)
+    FlsSetValue(tls_key_, buffer);
+#elif defined(WEBRTC_POSIX)
+    pthread_setspecific(tls_key_, buffer);
+#endif
+    return buffer;
+  }
+
+  rtc::CriticalSection crit_;
+  bool capturing_ GUARDED_BY(crit_);
+  std::vector<ThreadBuffer*> buffers_ GUARDED_BY(crit_);
+  // Bumped by every Start() and Discard().
+  volatile int generation_;
+#if defined(WEBRTC_WIN)
+  DWORD tls_key_;
+#elif defined(WEBRTC_POSIX)
+  pthread_key_t tls_key_;
+#endif
+};
+
+InternalTracer* g_internal_tracer = NULL;
+
+const unsigned char* InternalGetCategoryEnabled(const char* name) {
+  return g_internal_tracer->GetCategoryEnabled(name);
+}
+
+void InternalAddTraceEvent(char phase,
+                           const unsigned char* category_enabled,
+                           const char* name,
+                           unsigned long long id,
+                           int num_args,
+                           const char** arg_names,
+                           const unsigned char* arg_types,
+                           const unsigned long long* arg_values,
+                           unsigned char flags) {
+  g_internal_tracer->AddTraceEvent(phase, category_enabled, name, id, num_args,
+                                   arg_names, arg_types, arg_values, flags);
+}
+
+void WriteJsonString(FILE* json, const std::string& str) {
+  fputc('"', json);
+  for (char c : str) {
+    if (c == '"' || c == '\\')
+      fprintf(json, "\\%c", c);
+    else if (static_cast<unsigned char>(c) < 0x20)
+      fprintf(json, "\\u%04x", c);
+    else
+      fputc(c, json);
+  }
+  fputc('"', json);
+}
+
+void WriteJsonArgValue(FILE* json,
+                       uint8 type,
+                       uint64 value,
+                       const std::vector<std::string>& strings) {
+  switch (type) {
+    case TRACE_VALUE_TYPE_BOOL:
+      fputs(value ? "true" : "false", json);
+      break;
+    case TRACE_VALUE_TYPE_UINT:
+      fprintf(json, "%llu", static_cast<unsigned long long>(value));
+      break;
+    case TRACE_VALUE_TYPE_INT:
+      fprintf(json, "%lld", static_cast<long long>(value));
+      break;
+    case TRACE_VALUE_TYPE_DOUBLE: {
+      double d;
+      memcpy(&d, &value, sizeof(d));
+      if (std::isfinite(d))
+        fprintf(json, "%.17g", d);
+      else
+        fprintf(json, "\"%f\"", d);
+      break;
+    }
+    case TRACE_VALUE_TYPE_STRING:
+    case TRACE_VALUE_TYPE_COPY_STRING:
+      WriteJsonString(json, strings[value]);
+      break;
+    default:
+      fprintf(json, "\"0x%llx\"", static_cast<unsigned long long>(value));
+      break;
+  }
+}
+
 }  // namespace
 
 void SetupEventTracer(GetCategoryEnabledPtr get_category_enabled_ptr,
@@ -57,4 +530,123 @@ void EventTracer::AddTraceEvent(char phase,
   }
 }
 
+void SetupInternalTracer() {
+  if (!g_internal_tracer)
+    g_internal_tracer = new InternalTracer();
+  SetupEventTracer(&InternalGetCategoryEnabled, &InternalAddTraceEvent);
+}
+
+void ShutdownInternalTracer() {
+  SetupEventTracer(NULL, NULL);
+  // Other threads may still be inside InternalAddTraceEvent(), so the tracer
+  // is kept; see InternalTracer.
+  if (g_internal_tracer)
+    g_internal_tracer->Discard();
+}
+
+void StartInternalCapture() {
+  DCHECK(g_internal_tracer);
+  g_internal_tracer->Start();
+}
+
+void StopInternalCapture() {
+  DCHECK(g_internal_tracer);
+  g_internal_tracer->Stop();
+}
+
+bool WriteInternalCapture(FILE* file) {
+  DCHECK(g_internal_tracer);
+  return g_internal_tracer->Write(file);
+}
+
+bool ConvertTraceToJson(FILE* binary, FILE* json) {
+  std::string data;
+  char chunk[4096];
+  size_t read;
+  while ((read = fread(chunk, 1, sizeof(chunk), binary)) > 0)
+    data.append(chunk, read);
+
+  rtc::ByteBuffer in(data.data(), data.size());
+  std::string magic;
+  if (!in.ReadString(&magic, kTraceMagicLength) || magic != kTraceMagic) {
+    LOG(LS_ERROR) << "Not a binary trace.";
+    return false;
+  }
+
+  std::vector<std::string> strings;
+  uint32 thread_id = 0;
+  bool first_event = true;
+  fputs("{\"traceEvents\":[", json);
+  while (in.Length() > 0) {
+    uint8 tag;
+    in.ReadUInt8(&tag);
+    if (tag == kStringTag) {
+      uint32 id;
+      uint32 length;
+      std::string str;
+      if (!in.ReadUInt32(&id) || id != strings.size() ||
+          !in.ReadUInt32(&length) || !in.ReadString(&str, length)) {
+        return false;
+      }
+      strings.push_back(str);
+    } else if (tag == kThreadTag) {
+      uint32 dropped;
+      if (!in.ReadUInt32(&thread_id) || !in.ReadUInt32(&dropped))
+        return false;
+    } else if (tag == kEventTag) {
+      uint8 phase;
+      uint8 flags;
+      uint8 num_args;
+      uint32 category_id;
+      uint32 name_id;
+      uint64 timestamp_us;
+      if (!in.ReadUInt8(&phase) || !in.ReadUInt8(&flags) ||
+          !in.ReadUInt8(&num_args) || num_args > kMaxArgs ||
+          !in.ReadUInt32(&category_id) || category_id >= strings.size() ||
+          !in.ReadUInt32(&name_id) || name_id >= strings.size() ||
+          !in.ReadUInt64(&timestamp_us)) {
+        return false;
+      }
+      fputs(first_event ? "\n{" : ",\n{", json);
+      first_event = false;
+      fputs("\"name\":", json);
+      WriteJsonString(json, strings[name_id]);
+      fputs(",\"cat\":", json);
+      WriteJsonString(json, strings[category_id]);
+      fprintf(json, ",\"ph\":\"%c\",\"ts\":%llu,\"pid\":0,\"tid\":%u",
+              phase, static_cast<unsigned long long>(timestamp_us),
+              thread_id);
+      if (flags & TRACE_EVENT_FLAG_HAS_ID) {
+        uint64 id;
+        if (!in.ReadUInt64(&id))
+          return false;
+        fprintf(json, ",\"id\":\"0x%llx\"",
+                static_cast<unsigned long long>(id));
+      }
+      fputs(",\"args\":{", json);
+      for (int i = 0; i < num_args; ++i) {
+        uint32 arg_name_id;
+        uint8 type;
+        uint64 value;
+        if (!in.ReadUInt32(&arg_name_id) || arg_name_id >= strings.size() ||
+            !in.ReadUInt8(&type) || !in.ReadUInt64(&value) ||
+            (IsStringType(type) && value >= strings.size())) {
+          return false;
+        }
+        if (i > 0)
+          fputc(',', json);
+        WriteJsonString(json, strings[arg_name_id]);
+        fputc(':', json);
+        WriteJsonArgValue(json, type, value, strings);
+      }
+      fputs("}}", json);
+    } else {
+      LOG(LS_ERROR) << "Unknown record in binary trace: " << tag;
+      return false;
+    }
+  }
+  fputs("]}\n", json);
+  return fflush(json) == 0;
+}
+
 }  // namespace webrtc
@@ -22,10 +22,17 @@
 //   provided.
 //
 // Parameters for the above two functions are described in trace_event.h.
+//
+// Alternatively, SetupInternalTracer() installs a built-in tracer that records
+// events into per-thread buffers while a capture is running. A capture is
+// saved in a compact binary format with WriteInternalCapture() and can be
+// turned into Chrome's trace JSON (chrome://tracing) with ConvertTraceToJson().
 
 #ifndef WEBRTC_BASE_EVENT_TRACER_H_
 #define WEBRTC_BASE_EVENT_TRACER_H_
 
+#include <stdio.h>
+
 namespace webrtc {
 
 typedef const unsigned char* (*GetCategoryEnabledPtr)(const char* name);
@@ -66,6 +73,36 @@ class EventTracer {
       unsigned char flags);
 };
 
+// Installs the built-in tracer with SetupEventTracer(). Like
+// SetupEventTracer(), this must be called before any WebRTC methods, since
+// each TRACE_EVENT call site caches its category state on first use.
+void SetupInternalTracer();
+
+// Stops any running capture, discards its events and uninstalls the built-in
+// tracer. Other threads may still be recording an event, so the tracer and
+// the buffers of running threads are kept and reused by the next
+// SetupInternalTracer(). Buffers of exited threads are freed.
+void ShutdownInternalTracer();
+
+// Discards previously captured events and starts recording. Each thread
+// drops its old events itself when it next records one. All categories
+// are enabled except those prefixed with "disabled-by-default-". Recording
+// doesn't take locks; each thread appends to its own bounded buffer, and
+// events beyond a thread's capacity are dropped.
+void StartInternalCapture();
+
+// Stops recording. The captured events are kept until the next
+// StartInternalCapture() or ShutdownInternalTracer().
+void StopInternalCapture();
+
+// Writes the events from the last capture to |file| in binary form. Must not
+// be called while a capture is running.
+bool WriteInternalCapture(FILE* file);
+
+// Reads a binary capture from |binary| and writes it to |json| in the Chrome
+// trace event format.
+bool ConvertTraceToJson(FILE* binary, FILE* json);
+
 }  // namespace webrtc
 
 #endif  // WEBRTC_BASE_EVENT_TRACER_H_
@@ -0,0 +1,69 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/base/event_tracer.h"
+
+#include <stdio.h>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/system_wrappers/interface/trace_event.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+
+// Measures the cost of a scoped trace event with no tracer, with the internal
+// tracer installed but not capturing, and while capturing.
+TEST(EventTracerPerfTest, InternalTracer) {
+  const int kNumEvents = 100000;
+  SetupEventTracer(NULL, NULL);
+  uint64 start = rtc::TimeMicros();
+  for (int i = 0; i < kNumEvents; ++i) {
+    TRACE_EVENT0("webrtc", "NoTracer");
+  }
+  uint64 no_tracer_us = rtc::TimeMicros() - start;
+
+  SetupInternalTracer();
+  start = rtc::TimeMicros();
+  for (int i = 0; i < kNumEvents; ++i) {
+    TRACE_EVENT0("webrtc", "NotCapturing");
+  }
+  uint64 not_capturing_us = rtc::TimeMicros() - start;
+
+  StartInternalCapture();
+  start = rtc::TimeMicros();
+  for (int i = 0; i < kNumEvents; ++i) {
+    TRACE_EVENT1("webrtc", "Capturing", "i", i);
+  }
+  uint64 capturing_us = rtc::TimeMicros() - start;
+  StopInternalCapture();
+
+  FILE* binary = tmpfile();
+  ASSERT_TRUE(binary != NULL);
+  EXPECT_TRUE(WriteInternalCapture(binary));
+  long binary_size = ftell(binary);
+  fclose(binary);
+  ShutdownInternalTracer();
+
+  test::PrintResult("scoped_trace_event", "", "no_tracer",
+                    static_cast<size_t>(no_tracer_us * 1000 / kNumEvents),
+                    "ns/event", true);
+  test::PrintResult("scoped_trace_event", "", "not_capturing",
+                    static_cast<size_t>(not_capturing_us * 1000 / kNumEvents),
+                    "ns/event", true);
+  test::PrintResult("scoped_trace_event", "", "capturing",
+                    static_cast<size_t>(capturing_us * 1000 / kNumEvents),
+                    "ns/event", true);
+  test::PrintResult("scoped_trace_event", "", "binary_trace_size",
+                    static_cast<size_t>(binary_size / (2 * kNumEvents)),
+                    "bytes/event", true);
+}
+
+}  // namespace webrtc
@@ -10,7 +10,12 @@
 
 #include "webrtc/base/event_tracer.h"
 
+#include <stdio.h>
+
+#include <string>
+
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/thread.h"
 #include "webrtc/system_wrappers/interface/static_instance.h"
 #include "webrtc/system_wrappers/interface/trace_event.h"
 
@@ -58,6 +63,42 @@ static void AddTraceEventHandler(char phase,
   TestStatistics::Get()->Increment();
 }
 
+static void TraceOnWorker() {
+  TRACE_EVENT_INSTANT0("webrtc", "OnWorker");
+}
+
+static void TraceOnExitingWorker() {
+  TRACE_EVENT_COPY_INSTANT1("webrtc", "OnExitingWorker", "str",
+                            TRACE_STR_COPY("copied"));
+}
+
+static std::string ReadAll(FILE* file) {
+  std::string str;
+  char chunk[1024];
+  size_t read;
+  rewind(file);
+  while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    str.append(chunk, read);
+  return str;
+}
+
+// Writes the internal tracer's last capture as trace JSON.
+static std::string CaptureToJson() {
+  std::string str;
+  FILE* binary = tmpfile();
+  FILE* json = tmpfile();
+  if (binary && json && webrtc::WriteInternalCapture(binary)) {
+    rewind(binary);
+    if (webrtc::ConvertTraceToJson(binary, json))
+      str = ReadAll(json);
+  }
+  if (binary)
+    fclose(binary);
+  if (json)
+    fclose(json);
+  return str;
+}
+
 }  // namespace
 
 namespace webrtc {
@@ -79,4 +120,116 @@ TEST(EventTracerTest, ScopedTraceEvent) {
   TestStatistics::Get()->Reset();
 }
 
+TEST(EventTracerTest, InternalCaptureConvertsToJson) {
+  SetupInternalTracer();
+  StartInternalCapture();
+  {
+    TRACE_EVENT1("webrtc", "Scoped", "value", 42);
+    TRACE_COUNTER1("webrtc", "Counter", -7);
+    TRACE_EVENT_COPY_INSTANT1("webrtc", std::string("Copied").c_str(), "str",
+                              TRACE_STR_COPY(std::string("a\"b").c_str()));
+    TRACE_EVENT_INSTANT0("disabled-by-default-webrtc", "Hidden");
+  }
+  rtc::Thread worker;
+  worker.Start();
+  worker.Invoke<void>(&TraceOnWorker);
+  worker.Stop();
+  StopInternalCapture();
+  // Not recorded once the capture has stopped.
+  TRACE_EVENT_INSTANT0("webrtc", "AfterStop");
+
+  FILE* binary = tmpfile();
+  FILE* json = tmpfile();
+  ASSERT_TRUE(binary && json);
+  EXPECT_TRUE(WriteInternalCapture(binary));
+  ShutdownInternalTracer();
+  rewind(binary);
+  EXPECT_TRUE(ConvertTraceToJson(binary, json));
+  std::string str = ReadAll(json);
+  fclose(binary);
+  fclose(json);
+
+  EXPECT_EQ(0u, str.find("{\"traceEvents\":["));
+  EXPECT_NE(std::string::npos,
+            str.find("\"name\":\"Scoped\",\"cat\":\"webrtc\",\"ph\":\"B\""));
+  EXPECT_NE(std::string::npos, str.find("\"args\":{\"value\":42}"));
+  EXPECT_NE(std::string::npos,
+            str.find("\"name\":\"Scoped\",\"cat\":\"webrtc\",\"ph\":\"E\""));
+  EXPECT_NE(std::string::npos, str.find("\"ph\":\"C\""));
+  EXPECT_NE(std::string::npos, str.find("\"args\":{\"value\":-7}"));
+  EXPECT_NE(std::string::npos, str.find("\"name\":\"Copied\""));
+  EXPECT_NE(std::string::npos, str.find("\"str\":\"a\\\"b\""));
+  EXPECT_NE(std::string::npos, str.find("\"name\":\"OnWorker\""));
+  EXPECT_EQ(std::string::npos, str.find("Hidden"));
+  EXPECT_EQ(std::string::npos, str.find("AfterStop"));
+}
+
+// Test that a new capture drops what another thread recorded in the previous
+// one, and that the tracer can be set up again after a shutdown.
+TEST(EventTracerTest, InternalCaptureRestartsPerThread) {
+  rtc::Thread worker;
+  worker.Start();
+  SetupInternalTracer();
+  StartInternalCapture();
+  worker.Invoke<void>(&TraceOnWorker);
+  StopInternalCapture();
+  StartInternalCapture();
+  TRACE_EVENT_INSTANT0("webrtc", "SecondCapture");
+  StopInternalCapture();
+  std::string str = CaptureToJson();
+  EXPECT_NE(std::string::npos, str.find("\"name\":\"SecondCapture\""));
+  EXPECT_EQ(std::string::npos, str.find("OnWorker"));
+
+  ShutdownInternalTracer();
+  SetupInternalTracer();
+  StartInternalCapture();
+  worker.Invoke<void>(&TraceOnWorker);
+  StopInternalCapture();
+  worker.Stop();
+  str = CaptureToJson();
+  EXPECT_NE(std::string::npos, str.find("\"name\":\"OnWorker\""));
+  EXPECT_EQ(std::string::npos, str.find("SecondCapture"));
+  ShutdownInternalTracer();
+}
+
+// Test that events of threads that have exited are still written, and that
+// their buffers are freed by the next capture without losing live threads'
+// events.
+TEST(EventTracerTest, InternalCaptureFreesExitedThreads) {
+  rtc::Thread live_worker;
+  live_worker.Start();
+  SetupInternalTracer();
+  for (int i = 0; i < 3; ++i) {
+    StartInternalCapture();
+    live_worker.Invoke<void>(&TraceOnWorker);
+    rtc::Thread exiting_worker;
+    exiting_worker.Start();
+    exiting_worker.Invoke<void>(&TraceOnExitingWorker);
+    exiting_worker.Stop();
+    StopInternalCapture();
+    std::string str = CaptureToJson();
+    EXPECT_NE(std::string::npos, str.find("\"name\":\"OnWorker\""));
+    EXPECT_NE(std::string::npos, str.find("\"name\":\"OnExitingWorker\""));
+  }
+  StartInternalCapture();
+  live_worker.Invoke<void>(&TraceOnWorker);
+  StopInternalCapture();
+  std::string str = CaptureToJson();
+  EXPECT_NE(std::string::npos, str.find("\"name\":\"OnWorker\""));
+  EXPECT_EQ(std::string::npos, str.find("OnExitingWorker"));
+  live_worker.Stop();
+  ShutdownInternalTracer();
+}
+
+TEST(EventTracerTest, ConvertRejectsGarbage) {
+  FILE* binary = tmpfile();
+  FILE* json = tmpfile();
+  ASSERT_TRUE(binary && json);
+  fputs("not a trace", binary);
+  rewind(binary);
+  EXPECT_FALSE(ConvertTraceToJson(binary, json));
+  fclose(binary);
+  fclose(json);
+}
+
 }  // namespace webrtc
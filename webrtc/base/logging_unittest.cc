@@ -8,11 +8,14 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include "webrtc/base/event.h"
 #include "webrtc/base/fileutils.h"
 #include "webrtc/base/gunit.h"
 #include "webrtc/base/logging.h"
+#include "webrtc/base/logsinks.h"
 #include "webrtc/base/pathutils.h"
 #include "webrtc/base/stream.h"
+#include "webrtc/base/stringencode.h"
 #include "webrtc/base/thread.h"
 #include "webrtc/test/testsupport/gtest_disable.h"
 
@@ -153,4 +156,100 @@ TEST(LogTest, Perf) {
   LOG(LS_INFO) << "Average log time: " << TimeDiff(finish, start) << " us";
 }
 
+TEST(LogTest, AsyncSinkDeliversInOrder) {
+  std::string str;
+  LogSinkImpl<StringStream> stream(&str);
+  AsyncLogSink async_stream(&stream, 64 * 1024);
+  LogMessage::AddLogToStream(&async_stream, LS_INFO);
+
+  for (int i = 0; i < 100; ++i) {
+    LOG(LS_INFO) << "line " << i;
+  }
+  async_stream.Flush();
+  LogMessage::RemoveLogToStream(&async_stream);
+
+  size_t pos = 0;
+  for (int i = 0; i < 100; ++i) {
+    std::string line = "line " + ToString(i) + "\n";
+    pos = str.find(line, pos);
+    ASSERT_NE(std::string::npos, pos) << line;
+  }
+  EXPECT_EQ(0u, async_stream.dropped_messages());
+}
+
+// A sink that blocks in OnLogMessage until released.
+class BlockingLogSink : public LogSink {
+ public:
+  BlockingLogSink() : entered_(false, false), release_(true, false) {}
+  void OnLogMessage(const std::string& message) override {
+    entered_.Set();
+    release_.Wait(Event::kForever);
+    str_.append(message);
+  }
+  Event entered_;
+  Event release_;
+  std::string str_;
+};
+
+TEST(LogTest, AsyncSinkDropsWhenFull) {
+  BlockingLogSink stream;
+  AsyncLogSink async_stream(&stream, 100);
+  LogMessage::AddLogToStream(&async_stream, LS_INFO);
+
+  // The first message occupies the writer; the next ones overflow the buffer.
+  LOG(LS_INFO) << "first";
+  EXPECT_TRUE(stream.entered_.Wait(1000));
+  for (int i = 0; i < 10; ++i) {
+    LOG(LS_INFO) << std::string(40, 'X');
+  }
+  LogMessage::RemoveLogToStream(&async_stream);
+  size_t dropped = async_stream.dropped_messages();
+  EXPECT_GE(dropped, 8u);
+
+  stream.release_.Set();
+  async_stream.Flush();
+  EXPECT_NE(std::string::npos,
+            stream.str_.find("dropped " + ToString(dropped) + " messages"));
+}
+
+// Logs a line and flushes |sink| in a loop.
+class FlushingRunnable : public Runnable {
+ public:
+  FlushingRunnable(AsyncLogSink* sink, int iterations)
+      : sink_(sink), iterations_(iterations), done_(true, false) {}
+  void Run(Thread* thread) override {
+    for (int i = 0; i < iterations_; ++i) {
+      sink_->OnLogMessage("line\n");
+      sink_->Flush();
+    }
+    done_.Set();
+  }
+  AsyncLogSink* const sink_;
+  const int iterations_;
+  Event done_;
+};
+
+// Test that concurrent flushes all return, including while the writer is
+// busy when they start.
+TEST(LogTest, AsyncSinkFlushesFromTwoThreads) {
+  BlockingLogSink stream;
+  AsyncLogSink async_stream(&stream, 64 * 1024);
+  async_stream.OnLogMessage("first\n");
+  EXPECT_TRUE(stream.entered_.Wait(1000));
+
+  const int kIterations = 1000;
+  FlushingRunnable flusher1(&async_stream, kIterations);
+  FlushingRunnable flusher2(&async_stream, kIterations);
+  Thread thread1;
+  Thread thread2;
+  thread1.Start(&flusher1);
+  thread2.Start(&flusher2);
+  EXPECT_FALSE(flusher1.done_.Wait(10));
+  stream.release_.Set();
+  EXPECT_TRUE(flusher1.done_.Wait(10000));
+  EXPECT_TRUE(flusher2.done_.Wait(10000));
+  thread1.Stop();
+  thread2.Stop();
+}
+
 }  // namespace rtc
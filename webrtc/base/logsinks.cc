@@ -14,6 +14,7 @@
 #include <string>
 
 #include "webrtc/base/checks.h"
+#include "webrtc/base/stringencode.h"
 
 namespace rtc {
 
@@ -61,4 +62,99 @@ CallSessionFileRotatingLogSink::CallSessionFileRotatingLogSink(
 CallSessionFileRotatingLogSink::~CallSessionFileRotatingLogSink() {
 }
 
+AsyncLogSink::AsyncLogSink(LogSink* sink, size_t max_buffered_bytes)
+    : sink_(sink),
+      max_buffered_bytes_(max_buffered_bytes),
+      dropped_(0),
+      dropped_total_(0),
+      writing_(false),
+      stopping_(false),
+      wake_(false, false),
+      idle_(true, true) {
+  DCHECK(sink);
+  thread_.SetName("AsyncLogSink", this);
+  thread_.Start(this);
+}
+
+AsyncLogSink::~AsyncLogSink() {
+  {
+    CritScope cs(&crit_);
+    stopping_ = true;
+  }
+  wake_.Set();
+  thread_.Stop();
+}
+
+void AsyncLogSink::OnLogMessage(const std::string& message) {
+  bool was_empty;
+  {
+    CritScope cs(&crit_);
+    if (buffer_.size() + message.size() > max_buffered_bytes_) {
+      ++dropped_;
+      ++dropped_total_;
+      return;
+    }
+    was_empty = buffer_.empty();
+    buffer_.append(message);
+  }
+  // The writer drains the whole buffer each time it wakes, so it only needs
+  // waking for the first message of a batch.
+  if (was_empty)
+    wake_.Set();
+}
+
+void AsyncLogSink::Flush() {
+  while (true) {
+    {
+      CritScope cs(&crit_);
+      if (buffer_.empty() && !writing_)
+        return;
+      // The writer sets |idle_| under |crit_| too, so it can't be set between
+      // the check above and this reset without this flusher seeing it.
+      idle_.Reset();
+    }
+    wake_.Set();
+    idle_.Wait(Event::kForever);
+  }
+}
+
+size_t AsyncLogSink::dropped_messages() const {
+  CritScope cs(&crit_);
+  return dropped_total_;
+}
+
+void AsyncLogSink::Run(Thread* thread) {
+  std::string batch;
+  while (true) {
+    wake_.Wait(Event::kForever);
+    size_t dropped;
+    {
+      CritScope cs(&crit_);
+      batch.swap(buffer_);
+      dropped = dropped_;
+      dropped_ = 0;
+      writing_ = !batch.empty();
+    }
+    // |batch| and |buffer_| trade storage each round, so steady-state
+    // logging doesn't reallocate.
+    if (!batch.empty()) {
+      sink_->OnLogMessage(batch);
+      batch.clear();
+    }
+    if (dropped) {
+      sink_->OnLogMessage("[AsyncLogSink dropped " + ToString(dropped) +
+                          " messages]\n");
+    }
+    bool done;
+    {
+      CritScope cs(&crit_);
+      writing_ = false;
+      done = stopping_ && buffer_.empty();
+      idle_.Set();
+    }
+    if (done)
+      return;
+  }
+}
+
 }  // namespace rtc
@@ -14,9 +14,12 @@
 #include <string>
 
 #include "webrtc/base/constructormagic.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/event.h"
 #include "webrtc/base/filerotatingstream.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/thread.h"
 
 namespace rtc {
 
@@ -63,6 +66,57 @@ class CallSessionFileRotatingLogSink : public FileRotatingLogSink {
   DISALLOW_COPY_AND_ASSIGN(CallSessionFileRotatingLogSink);
 };
 
+// Log sink that hands messages to another sink on a background thread, so
+// that a thread that logs only pays for formatting and a buffer append
+// instead of the file write. Typically wraps a FileRotatingLogSink:
+//
+//   FileRotatingLogSink file_sink(dir, "webrtc_log", 1024 * 1024, 10);
+//   file_sink.Init();
+//   AsyncLogSink async_sink(&file_sink, 256 * 1024);
+//   LogMessage::AddLogToStream(&async_sink, LS_INFO);
+//
+// Messages keep their order, but are delivered to the wrapped sink in
+// batches, several per OnLogMessage call. If the writer falls more than
+// |max_buffered_bytes| behind, new messages are dropped, and a line saying
+// how many were lost is written once it catches up.
+class AsyncLogSink : public LogSink, public Runnable {
+ public:
+  // |sink| is not owned and must outlive this object.
+  AsyncLogSink(LogSink* sink, size_t max_buffered_bytes);
+  // Writes out everything still buffered before returning.
+  ~AsyncLogSink() override;
+
+  void OnLogMessage(const std::string& message) override;
+
+  // Blocks until everything logged so far has been handed to the sink.
+  void Flush();
+
+  // Number of messages dropped because the buffer was full.
+  size_t dropped_messages() const;
+
+ private:
+  void Run(Thread* thread) override;
+
+  LogSink* const sink_;
+  const size_t max_buffered_bytes_;
+
+  mutable CriticalSection crit_;
+  std::string buffer_ GUARDED_BY(crit_);
+  size_t dropped_ GUARDED_BY(crit_);
+  size_t dropped_total_ GUARDED_BY(crit_);
+  bool writing_ GUARDED_BY(crit_);
+  bool stopping_ GUARDED_BY(crit_);
+
+  // |wake_| is set when there is work for the writer; |idle_| each time the
+  // writer has drained the buffer. |idle_| is manual-reset, so that it wakes
+  // every waiting Flush() call, each of which resets it before waiting.
+  Event wake_;
+  Event idle_;
+  Thread thread_;
+
+  DISALLOW_COPY_AND_ASSIGN(AsyncLogSink);
+};
+
 }  // namespace rtc
 
 #endif  // WEBRTC_BASE_FILE_ROTATING_LOG_SINK_H_
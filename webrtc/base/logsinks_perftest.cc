@@ -0,0 +1,76 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/base/logsinks.h"
+
+#include <string>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/fileutils.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/pathutils.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace rtc {
+
+// Compares the cost on the logging thread of writing 1000 80-character logs
+// to a FileRotatingLogSink directly and through an AsyncLogSink, and the cost
+// of a log statement below the enabled severity.
+TEST(AsyncLogSinkPerfTest, CostOnLoggingThread) {
+  Pathname path;
+  ASSERT_TRUE(Filesystem::GetAppTempFolder(&path));
+  path.AppendFolder("async_log_sink_perf");
+  ASSERT_TRUE(Filesystem::CreateFolder(path));
+
+  const int kNumLogs = 1000;
+  std::string message(80, 'X');
+  uint64 elapsed_us[2];
+  for (int async = 0; async < 2; ++async) {
+    FileRotatingLogSink file_sink(path.pathname(), "log", 1024 * 1024, 2);
+    ASSERT_TRUE(file_sink.Init());
+    ASSERT_TRUE(file_sink.DisableBuffering());
+    AsyncLogSink async_sink(&file_sink, 1024 * 1024);
+    LogSink* sink = async ? static_cast<LogSink*>(&async_sink) : &file_sink;
+    LogMessage::AddLogToStream(sink, LS_SENSITIVE);
+
+    uint64 start = TimeMicros();
+    for (int i = 0; i < kNumLogs; ++i) {
+      LOG(LS_SENSITIVE) << message;
+    }
+    elapsed_us[async] = TimeMicros() - start;
+
+    LogMessage::RemoveLogToStream(sink);
+    async_sink.Flush();
+    EXPECT_EQ(0u, async_sink.dropped_messages());
+  }
+
+  uint64 start = TimeMicros();
+  for (int i = 0; i < kNumLogs; ++i) {
+    LOG(LS_SENSITIVE) << message;
+  }
+  uint64 disabled_us = TimeMicros() - start;
+
+  Filesystem::DeleteFolderAndContents(path);
+
+  webrtc::test::PrintResult("log_statement", "", "file_sink",
+                            static_cast<size_t>(elapsed_us[0] * 1000 /
+                                                kNumLogs),
+                            "ns/log", true);
+  webrtc::test::PrintResult("log_statement", "", "async_file_sink",
+                            static_cast<size_t>(elapsed_us[1] * 1000 /
+                                                kNumLogs),
+                            "ns/log", true);
+  webrtc::test::PrintResult("log_statement", "", "disabled",
+                            static_cast<size_t>(disabled_us * 1000 / kNumLogs),
+                            "ns/log", true);
+}
+
+}  // namespace rtc
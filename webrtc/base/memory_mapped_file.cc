@@ -0,0 +1,120 @@
+/*
+ *  Copyright 2015 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/base/memory_mapped_file.h"
+
+#if defined(WEBRTC_POSIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace rtc {
+
+MemoryMappedFile::MemoryMappedFile()
+    : is_open_(false),
+      data_(NULL),
+      size_(0) {
+#if defined(WEBRTC_WIN)
+  file_ = kInvalidPlatformFileValue;
+  mapping_ = NULL;
+#endif
+}
+
+MemoryMappedFile::~MemoryMappedFile() {
+  Close();
+}
+
+#if defined(WEBRTC_WIN)
+bool MemoryMappedFile::Open(const std::string& filename) {
+  Close();
+  file_ = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  LARGE_INTEGER file_size;
+  if (file_ == kInvalidPlatformFileValue ||
+      !GetFileSizeEx(file_, &file_size)) {
+    Close();
+    return false;
+  }
+  size_ = static_cast<size_t>(file_size.QuadPart);
+  if (size_ > 0) {
+    mapping_ = CreateFileMapping(file_, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping_ != NULL) {
+      data_ = static_cast<const uint8_t*>(
+          MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    }
+    if (data_ == NULL) {
+      Close();
+      return false;
+    }
+  }
+  is_open_ = true;
+  return true;
+}
+
+void MemoryMappedFile::AdviseSequential() {
+}
+
+void MemoryMappedFile::Close() {
+  if (data_ != NULL)
+    UnmapViewOfFile(data_);
+  if (mapping_ != NULL)
+    CloseHandle(mapping_);
+  if (file_ != kInvalidPlatformFileValue)
+    ClosePlatformFile(file_);
+  file_ = kInvalidPlatformFileValue;
+  mapping_ = NULL;
+  is_open_ = false;
+  data_ = NULL;
+  size_ = 0;
+}
+#else
+bool MemoryMappedFile::Open(const std::string& filename) {
+  Close();
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    close(fd);
+    return false;
+  }
+  size_ = static_cast<size_t>(file_stat.st_size);
+  if (size_ > 0) {
+    void* data = mmap(NULL, size_, PROT_READ, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+      close(fd);
+      size_ = 0;
+      return false;
+    }
+    data_ = static_cast<const uint8_t*>(data);
+  }
+  // The mapping stays valid after the file is closed.
+  close(fd);
+  is_open_ = true;
+  return true;
+}
+
+void MemoryMappedFile::AdviseSequential() {
+  if (data_ != NULL)
+    madvise(const_cast<uint8_t*>(data_), size_, MADV_SEQUENTIAL);
+}
+
+void MemoryMappedFile::Close() {
+  if (data_ != NULL)
+    munmap(const_cast<uint8_t*>(data_), size_);
+  is_open_ = false;
+  data_ = NULL;
+  size_ = 0;
+}
+#endif
+
+}  // namespace rtc
@@ -0,0 +1,60 @@
+/*
+ *  Copyright 2015 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_BASE_MEMORY_MAPPED_FILE_H_
+#define WEBRTC_BASE_MEMORY_MAPPED_FILE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/platform_file.h"
+
+namespace rtc {
+
+// Maps a whole file into memory for reading. The contents are paged in by the
+// OS as they are accessed, so large recordings can be read, and revisited at
+// random positions, without copying them through a read buffer.
+class MemoryMappedFile {
+ public:
+  MemoryMappedFile();
+  ~MemoryMappedFile();
+
+  // Maps |filename|, unmapping any file mapped before. Returns false if the
+  // file can't be opened or mapped. An empty file is mapped with size() 0.
+  bool Open(const std::string& filename);
+  void Close();
+
+  // Hints to the OS that the file will mostly be read front to back, so that
+  // it reads ahead more aggressively. Has no effect where unsupported.
+  void AdviseSequential();
+
+  bool IsOpen() const { return is_open_; }
+  // NULL if the mapped file is empty.
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  bool is_open_;
+  const uint8_t* data_;
+  size_t size_;
+#if defined(WEBRTC_WIN)
+  PlatformFile file_;
+  HANDLE mapping_;
+#endif
+
+  DISALLOW_COPY_AND_ASSIGN(MemoryMappedFile);
+};
+
+}  // namespace rtc
+
+#endif  // WEBRTC_BASE_MEMORY_MAPPED_FILE_H_
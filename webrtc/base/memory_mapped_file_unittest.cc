@@ -0,0 +1,74 @@
+/*
+ *  Copyright 2015 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "webrtc/base/fileutils.h"
+#include "webrtc/base/gunit.h"
+#include "webrtc/base/memory_mapped_file.h"
+#include "webrtc/base/pathutils.h"
+
+namespace rtc {
+
+class MemoryMappedFileTest : public testing::Test {
+ public:
+  MemoryMappedFileTest() {
+    Pathname dir;
+    EXPECT_TRUE(Filesystem::GetTemporaryFolder(dir, true, NULL));
+    test_file_ = Filesystem::TempFilename(dir, ".testfile");
+  }
+  ~MemoryMappedFileTest() {
+    remove(test_file_.c_str());
+  }
+
+ protected:
+  void WriteTestFile(const std::string& contents) {
+    FILE* file = fopen(test_file_.c_str(), "wb");
+    ASSERT_TRUE(file != NULL);
+    EXPECT_EQ(contents.size(),
+              fwrite(contents.data(), 1, contents.size(), file));
+    fclose(file);
+  }
+
+  std::string test_file_;
+};
+
+TEST_F(MemoryMappedFileTest, MapsFileContents) {
+  const std::string kContents = "#!rtpplay1.0 127.0.0.1/5000\n";
+  WriteTestFile(kContents);
+  MemoryMappedFile file;
+  ASSERT_TRUE(file.Open(test_file_));
+  EXPECT_TRUE(file.IsOpen());
+  ASSERT_EQ(kContents.size(), file.size());
+  file.AdviseSequential();
+  EXPECT_EQ(0, memcmp(kContents.data(), file.data(), kContents.size()));
+
+  file.Close();
+  EXPECT_FALSE(file.IsOpen());
+  EXPECT_EQ(0u, file.size());
+}
+
+TEST_F(MemoryMappedFileTest, MapsEmptyFile) {
+  WriteTestFile("");
+  MemoryMappedFile file;
+  ASSERT_TRUE(file.Open(test_file_));
+  EXPECT_TRUE(file.IsOpen());
+  EXPECT_EQ(0u, file.size());
+  EXPECT_TRUE(file.data() == NULL);
+}
+
+TEST_F(MemoryMappedFileTest, FailsForMissingFile) {
+  MemoryMappedFile file;
+  EXPECT_FALSE(file.Open(test_file_ + ".missing"));
+  EXPECT_FALSE(file.IsOpen());
+}
+
+}  // namespace rtc
@@ -11,6 +11,8 @@
 #ifndef WEBRTC_BASE_MESSAGEHANDLER_H_
 #define WEBRTC_BASE_MESSAGEHANDLER_H_
 
+#include <vector>
+
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/base/scoped_ptr.h"
 
@@ -77,6 +79,23 @@ class FunctorMessageHandler<void, FunctorT> : public MessageHandler {
   FunctorT functor_;
 };
 
+// Helper class to facilitate executing several functors on a thread in one
+// message. The functors are run in order, through a const reference, and
+// their results are discarded. |functors| must outlive the handler.
+template <class FunctorT>
+class FunctorBatchMessageHandler : public MessageHandler {
+ public:
+  explicit FunctorBatchMessageHandler(const std::vector<FunctorT>& functors)
+      : functors_(functors) {}
+  virtual void OnMessage(Message* msg) {
+    for (const FunctorT& functor : functors_)
+      functor();
+  }
+
+ private:
+  const std::vector<FunctorT>& functors_;
+};
+
 } // namespace rtc
 
 #endif // WEBRTC_BASE_MESSAGEHANDLER_H_
@@ -208,12 +208,13 @@ bool MessageQueue::Get(Message *pmsg, int cmsWait, bool process_io) {
         if (first_pass) {
           first_pass = false;
           while (!dmsgq_.empty()) {
-            if (TimeIsLater(msCurrent, dmsgq_.top().msTrigger_)) {
-              cmsDelayNext = TimeDiff(dmsgq_.top().msTrigger_, msCurrent);
+            const DelayedMessage& dmsg = *dmsgq_.begin();
+            if (TimeIsLater(msCurrent, dmsg.msTrigger_)) {
+              cmsDelayNext = TimeDiff(dmsg.msTrigger_, msCurrent);
               break;
             }
-            msgq_.push_back(dmsgq_.top().msg_);
-            dmsgq_.pop();
+            msgq_.push_back(dmsg.msg_);
+            PopDelayed();
           }
         }
         // Pull a message off the message queue, if available.
@@ -326,14 +327,18 @@ void MessageQueue::DoDelayPost(int cmsDelay, uint32 tstamp,
   msg.message_id = id;
   msg.pdata = pdata;
   DelayedMessage dmsg(cmsDelay, tstamp, dmsgq_next_num_, msg);
-  dmsgq_.push(dmsg);
-  // If this message queue processes 1 message every millisecond for 50 days,
-  // we will wrap this number.  Even then, only messages with identical times
-  // will be misordered, and then only briefly.  This is probably ok.
-  VERIFY(0 != ++dmsgq_next_num_);
+  DelayedMessageSet::iterator it = dmsgq_.insert(dmsg).first;
+  dmsgq_index_[std::make_pair(phandler, dmsgq_next_num_)] = it;
+  ++dmsgq_next_num_;
   ss_->WakeUp();
 }
 
+void MessageQueue::PopDelayed() {
+  DelayedMessageSet::iterator it = dmsgq_.begin();
+  dmsgq_index_.erase(std::make_pair(it->msg_.phandler, it->num_));
+  dmsgq_.erase(it);
+}
+
 int MessageQueue::GetDelay() {
   CritScope cs(&crit_);
 
@@ -341,7 +346,7 @@ int MessageQueue::GetDelay() {
     return 0;
 
   if (!dmsgq_.empty()) {
-    int delay = TimeUntil(dmsgq_.top().msTrigger_);
+    int delay = TimeUntil(dmsgq_.begin()->msTrigger_);
     if (delay < 0)
       delay = 0;
     return delay;
@@ -365,38 +370,46 @@ void MessageQueue::Clear(MessageHandler *phandler, uint32 id,
     fPeekKeep_ = false;
   }
 
-  // Remove from ordered message queue
+  // Remove from ordered message queue, compacting it in one pass
 
-  for (MessageList::iterator it = msgq_.begin(); it != msgq_.end();) {
+  MessageDeque::iterator new_end = msgq_.begin();
+  for (MessageDeque::iterator it = new_end; it != msgq_.end(); ++it) {
     if (it->Match(phandler, id)) {
       if (removed) {
         removed->push_back(*it);
       } else {
         delete it->pdata;
       }
-      it = msgq_.erase(it);
     } else {
-      ++it;
+      *new_end++ = *it;
     }
   }
+  msgq_.erase(new_end, msgq_.end());
 
-  // Remove from priority queue. Not directly iterable, so use this approach
+  // Remove from the delayed messages. With a handler, only its own entries
+  // in the index are visited; otherwise every message has to be matched.
 
-  PriorityQueue::container_type::iterator new_end = dmsgq_.container().begin();
-  for (PriorityQueue::container_type::iterator it = new_end;
-       it != dmsgq_.container().end(); ++it) {
-    if (it->msg_.Match(phandler, id)) {
+  DelayedMessageIndex::iterator begin = dmsgq_index_.begin();
+  DelayedMessageIndex::iterator end = dmsgq_index_.end();
+  if (phandler) {
+    begin = dmsgq_index_.lower_bound(std::make_pair(phandler, uint64(0)));
+    end = dmsgq_index_.upper_bound(
+        std::make_pair(phandler, static_cast<uint64>(-1)));
+  }
+  for (DelayedMessageIndex::iterator it = begin; it != end;) {
+    const Message& msg = it->second->msg_;
+    if (msg.Match(phandler, id)) {
       if (removed) {
-        removed->push_back(it->msg_);
+        removed->push_back(msg);
       } else {
-        delete it->msg_.pdata;
+        delete msg.pdata;
       }
+      dmsgq_.erase(it->second);
+      dmsgq_index_.erase(it++);
     } else {
-      *new_end++ = *it;
+      ++it;
     }
   }
-  dmsgq_.container().erase(new_end, dmsgq_.container().end());
-  dmsgq_.reheap();
 }
 
 void MessageQueue::Dispatch(Message *pmsg) {
@@ -14,8 +14,11 @@
 #include <string.h>
 
 #include <algorithm>
+#include <deque>
 #include <list>
-#include <queue>
+#include <map>
+#include <set>
+#include <utility>
 #include <vector>
 
 #include "webrtc/base/basictypes.h"
@@ -144,12 +147,12 @@ struct Message {
 
 typedef std::list<Message> MessageList;
 
-// DelayedMessage goes into a priority queue, sorted by trigger time.  Messages
+// DelayedMessage goes into an ordered set, sorted by trigger time.  Messages
 // with the same trigger time are processed in num_ (FIFO) order.
 
 class DelayedMessage {
  public:
-  DelayedMessage(int delay, uint32 trigger, uint32 num, const Message& msg)
+  DelayedMessage(int delay, uint32 trigger, uint64 num, const Message& msg)
   : cmsDelay_(delay), msTrigger_(trigger), num_(num), msg_(msg) { }
 
   bool operator< (const DelayedMessage& dmsg) const {
@@ -159,10 +162,18 @@ class DelayedMessage {
 
   int cmsDelay_;  // for debugging
   uint32 msTrigger_;
-  uint32 num_;
+  uint64 num_;
   Message msg_;
 };
 
+// Orders DelayedMessages soonest first. operator< above is reversed, as it
+// was written for a max-heap.
+struct DelayedMessageEarlier {
+  bool operator()(const DelayedMessage& a, const DelayedMessage& b) const {
+    return b < a;
+  }
+};
+
 class MessageQueue {
  public:
   static const int kForever = -1;
@@ -226,15 +237,19 @@ class MessageQueue {
   sigslot::signal0<> SignalQueueDestroyed;
 
  protected:
-  class PriorityQueue : public std::priority_queue<DelayedMessage> {
-   public:
-    container_type& container() { return c; }
-    void reheap() { make_heap(c.begin(), c.end(), comp); }
-  };
+  typedef std::deque<Message> MessageDeque;
+  typedef std::set<DelayedMessage, DelayedMessageEarlier> DelayedMessageSet;
+  // Delayed messages keyed by handler and num_, so that Clear() for one
+  // handler only visits that handler's messages.
+  typedef std::map<std::pair<MessageHandler*, uint64>,
+                   DelayedMessageSet::iterator> DelayedMessageIndex;
 
   void DoDelayPost(int cmsDelay, uint32 tstamp, MessageHandler *phandler,
                    uint32 id, MessageData* pdata);
 
+  // Removes the earliest delayed message and its index entry.
+  void PopDelayed();
+
   // The SocketServer is not owned by MessageQueue.
   SocketServer* ss_;
   // If a server isn't supplied in the constructor, use this one.
@@ -242,9 +257,11 @@ class MessageQueue {
   bool fStop_;
   bool fPeekKeep_;
   Message msgPeek_;
-  MessageList msgq_;
-  PriorityQueue dmsgq_;
-  uint32 dmsgq_next_num_;
+  MessageDeque msgq_;
+  DelayedMessageSet dmsgq_;
+  DelayedMessageIndex dmsgq_index_;
+  // 64 bits, so that it never wraps onto a message that is still queued.
+  uint64 dmsgq_next_num_;
   mutable CriticalSection crit_;
 
  private:
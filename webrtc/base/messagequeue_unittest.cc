@@ -139,3 +139,60 @@ TEST(MessageQueueManager, Clear) {
   EXPECT_TRUE(deleted);
   EXPECT_FALSE(MessageQueueManager::IsInitialized());
 }
+
+class CountingMessageHandler : public MessageHandler {
+ public:
+  CountingMessageHandler() : count_(0) {}
+  void OnMessage(Message* msg) override { ++count_; }
+  int count() const { return count_; }
+ private:
+  int count_;
+};
+
+TEST_F(MessageQueueTest, ClearRemovesOnlyMatchingDelayedMessages) {
+  NullSocketServer nullss;
+  MessageQueue q(&nullss);
+  CountingMessageHandler a, b;
+  q.PostDelayed(0, &a, 1);
+  q.PostDelayed(0, &b, 1);
+  q.PostDelayed(0, &a, 2);
+  q.PostDelayed(1000, &a, 1);
+  EXPECT_EQ(4u, q.size());
+
+  MessageList removed;
+  q.Clear(&a, 1, &removed);
+  EXPECT_EQ(2u, removed.size());
+  EXPECT_EQ(2u, q.size());
+
+  Message msg;
+  ASSERT_TRUE(q.Get(&msg, 0));
+  EXPECT_EQ(&b, msg.phandler);
+  ASSERT_TRUE(q.Get(&msg, 0));
+  EXPECT_EQ(&a, msg.phandler);
+  EXPECT_EQ(2u, msg.message_id);
+  EXPECT_FALSE(q.Get(&msg, 0));
+}
+
+// Test that messages posted as the sequence number passes 32 bits still run
+// in FIFO order, and that none of them is lost from the handler index.
+TEST_F(MessageQueueTest, DelayedPostsPastThirtyTwoBitSequenceNumbers) {
+  CountingMessageHandler a;
+  dmsgq_next_num_ = static_cast<uint32>(-1) - 1;
+  TimeStamp now = Time();
+  for (uint32 id = 0; id < 4; ++id)
+    PostAt(now, &a, id);
+  EXPECT_EQ(4u, size());
+
+  Message msg;
+  ASSERT_TRUE(Get(&msg, 0));
+  EXPECT_EQ(0u, msg.message_id);
+  ASSERT_TRUE(Get(&msg, 0));
+  EXPECT_EQ(1u, msg.message_id);
+
+  MessageList removed;
+  Clear(&a, MQID_ANY, &removed);
+  ASSERT_EQ(2u, removed.size());
+  EXPECT_EQ(2u, removed.front().message_id);
+  EXPECT_EQ(3u, removed.back().message_id);
+  EXPECT_TRUE(empty());
+}
@@ -1093,6 +1093,10 @@ bool NSSStreamAdapter::HaveDtlsSrtp() {
 #endif
 }
 
+bool NSSStreamAdapter::HaveDtlsSrtpGcm() {
+  return false;
+}
+
 bool NSSStreamAdapter::HaveExporter() {
   return true;
 }
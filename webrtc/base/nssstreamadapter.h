@@ -90,6 +90,7 @@ class NSSStreamAdapter : public SSLStreamAdapterHelper {
   // Capabilities interfaces
   static bool HaveDtls();
   static bool HaveDtlsSrtp();
+  static bool HaveDtlsSrtpGcm();
   static bool HaveExporter();
   static std::string GetDefaultSslCipher(SSLProtocolVersion version,
                                          KeyType key_type);
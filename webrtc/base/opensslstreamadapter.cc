@@ -53,6 +53,10 @@ struct SrtpCipherMapEntry {
 static SrtpCipherMapEntry SrtpCipherMap[] = {
   {"AES_CM_128_HMAC_SHA1_80", "SRTP_AES128_CM_SHA1_80"},
   {"AES_CM_128_HMAC_SHA1_32", "SRTP_AES128_CM_SHA1_32"},
+#ifdef SRTP_AEAD_AES_128_GCM
+  {"AEAD_AES_128_GCM", "SRTP_AEAD_AES_128_GCM"},
+  {"AEAD_AES_256_GCM", "SRTP_AEAD_AES_256_GCM"},
+#endif
   {NULL, NULL}
 };
 #endif
@@ -1117,6 +1121,14 @@ bool OpenSSLStreamAdapter::HaveDtlsSrtp() {
 #endif
 }
 
+bool OpenSSLStreamAdapter::HaveDtlsSrtpGcm() {
+#if defined(HAVE_DTLS_SRTP) && defined(SRTP_AEAD_AES_128_GCM)
+  return true;
+#else
+  return false;
+#endif
+}
+
 bool OpenSSLStreamAdapter::HaveExporter() {
 #ifdef HAVE_DTLS_SRTP
   return true;
@@ -109,6 +109,7 @@ class OpenSSLStreamAdapter : public SSLStreamAdapter {
   // Capabilities interfaces
   static bool HaveDtls();
   static bool HaveDtlsSrtp();
+  static bool HaveDtlsSrtpGcm();
   static bool HaveExporter();
   static std::string GetDefaultSslCipher(SSLProtocolVersion version,
                                          KeyType key_type);
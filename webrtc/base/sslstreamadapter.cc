@@ -71,6 +71,7 @@ bool SSLStreamAdapter::GetDtlsSrtpCipher(std::string* cipher) {
 #if SSL_USE_SCHANNEL
 bool SSLStreamAdapter::HaveDtls() { return false; }
 bool SSLStreamAdapter::HaveDtlsSrtp() { return false; }
+bool SSLStreamAdapter::HaveDtlsSrtpGcm() { return false; }
 bool SSLStreamAdapter::HaveExporter() { return false; }
 std::string SSLStreamAdapter::GetDefaultSslCipher(SSLProtocolVersion version,
                                                   KeyType key_type) {
@@ -83,6 +84,9 @@ bool SSLStreamAdapter::HaveDtls() {
 bool SSLStreamAdapter::HaveDtlsSrtp() {
   return OpenSSLStreamAdapter::HaveDtlsSrtp();
 }
+bool SSLStreamAdapter::HaveDtlsSrtpGcm() {
+  return OpenSSLStreamAdapter::HaveDtlsSrtpGcm();
+}
 bool SSLStreamAdapter::HaveExporter() {
   return OpenSSLStreamAdapter::HaveExporter();
 }
@@ -97,6 +101,9 @@ bool SSLStreamAdapter::HaveDtls() {
 bool SSLStreamAdapter::HaveDtlsSrtp() {
   return NSSStreamAdapter::HaveDtlsSrtp();
 }
+bool SSLStreamAdapter::HaveDtlsSrtpGcm() {
+  return NSSStreamAdapter::HaveDtlsSrtpGcm();
+}
 bool SSLStreamAdapter::HaveExporter() {
   return NSSStreamAdapter::HaveExporter();
 }
@@ -163,6 +163,9 @@ class SSLStreamAdapter : public StreamAdapterInterface {
   // Capabilities testing
   static bool HaveDtls();
   static bool HaveDtlsSrtp();
+  // True if the AEAD_AES_128_GCM and AEAD_AES_256_GCM DTLS-SRTP profiles
+  // (RFC 7714) can be negotiated.
+  static bool HaveDtlsSrtpGcm();
   static bool HaveExporter();
 
   // Returns the default Ssl cipher used between streams of this class
@@ -31,6 +31,8 @@ using ::testing::tuple;
 static const int kBlockSize = 4096;
 static const char kAES_CM_HMAC_SHA1_80[] = "AES_CM_128_HMAC_SHA1_80";
 static const char kAES_CM_HMAC_SHA1_32[] = "AES_CM_128_HMAC_SHA1_32";
+static const char kAEAD_AES_128_GCM[] = "AEAD_AES_128_GCM";
+static const char kAEAD_AES_256_GCM[] = "AEAD_AES_256_GCM";
 static const char kExporterLabel[] = "label";
 static const unsigned char kExporterContext[] = "context";
 static int kExporterContextLen = sizeof(kExporterContext);
@@ -893,6 +895,47 @@ TEST_P(SSLStreamAdapterTestDTLS, TestDTLSSrtpMixed) {
   ASSERT_EQ(client_cipher, kAES_CM_HMAC_SHA1_80);
 };
 
+// Test DTLS-SRTP with the AEAD profiles offered first -- should select GCM
+TEST_P(SSLStreamAdapterTestDTLS, TestDTLSSrtpGcm) {
+  MAYBE_SKIP_TEST(HaveDtlsSrtpGcm);
+  std::vector<std::string> ciphers;
+  ciphers.push_back(kAEAD_AES_256_GCM);
+  ciphers.push_back(kAEAD_AES_128_GCM);
+  ciphers.push_back(kAES_CM_HMAC_SHA1_80);
+  SetDtlsSrtpCiphers(ciphers, true);
+  SetDtlsSrtpCiphers(ciphers, false);
+  TestHandshake();
+
+  std::string client_cipher;
+  ASSERT_TRUE(GetDtlsSrtpCipher(true, &client_cipher));
+  std::string server_cipher;
+  ASSERT_TRUE(GetDtlsSrtpCipher(false, &server_cipher));
+
+  ASSERT_EQ(client_cipher, server_cipher);
+  ASSERT_EQ(client_cipher, kAEAD_AES_256_GCM);
+};
+
+// Test DTLS-SRTP with GCM on one side only -- should fall back to HMAC
+TEST_P(SSLStreamAdapterTestDTLS, TestDTLSSrtpGcmFallback) {
+  MAYBE_SKIP_TEST(HaveDtlsSrtpGcm);
+  std::vector<std::string> gcm;
+  gcm.push_back(kAEAD_AES_128_GCM);
+  gcm.push_back(kAES_CM_HMAC_SHA1_80);
+  std::vector<std::string> high;
+  high.push_back(kAES_CM_HMAC_SHA1_80);
+  SetDtlsSrtpCiphers(gcm, true);
+  SetDtlsSrtpCiphers(high, false);
+  TestHandshake();
+
+  std::string client_cipher;
+  ASSERT_TRUE(GetDtlsSrtpCipher(true, &client_cipher));
+  std::string server_cipher;
+  ASSERT_TRUE(GetDtlsSrtpCipher(false, &server_cipher));
+
+  ASSERT_EQ(client_cipher, server_cipher);
+  ASSERT_EQ(client_cipher, kAES_CM_HMAC_SHA1_80);
+};
+
 // Test an exporter
 TEST_P(SSLStreamAdapterTestDTLS, TestDTLSExporter) {
   MAYBE_SKIP_TEST(HaveExporter);
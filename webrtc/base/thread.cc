@@ -403,8 +403,15 @@ void Thread::Send(MessageHandler *phandler, uint32 id, MessageData *pdata) {
 
   AssertBlockingIsAllowedOnCurrentThread();
 
-  AutoThread thread;
+  // Only wrap the calling thread if it isn't already; constructing a Thread
+  // creates a socket server and registers a queue, which would otherwise be
+  // paid on every cross-thread Send.
+  scoped_ptr<AutoThread> auto_thread;
   Thread *current_thread = Thread::Current();
+  if (!current_thread) {
+    auto_thread.reset(new AutoThread());
+    current_thread = Thread::Current();
+  }
   ASSERT(current_thread != NULL);  // AutoThread ensures this
 
   bool ready = false;
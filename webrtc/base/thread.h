@@ -174,6 +174,19 @@ class Thread : public MessageQueue {
     return handler.result();
   }
 
+  // Like Invoke(), but invokes each of |functors| in order and blocks the
+  // current thread once for the whole batch rather than once per functor.
+  // Their return values are discarded.
+  // NOTE: This function can only be called when synchronous calls are allowed.
+  // See ScopedDisallowBlockingCalls for details.
+  template <class FunctorT>
+  void InvokeBatch(const std::vector<FunctorT>& functors) {
+    InvokeBegin();
+    FunctorBatchMessageHandler<FunctorT> handler(functors);
+    Send(&handler);
+    InvokeEnd();
+  }
+
   // From MessageQueue
   void Clear(MessageHandler* phandler,
              uint32 id = MQID_ANY,
@@ -0,0 +1,189 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures the latency and heap allocations per call of the ways to run a
+// call on another rtc::Thread. This is its own executable rather than part of
+// webrtc_perf_tests because it replaces the global operator new to count
+// allocations.
+
+#include <stdlib.h>
+
+#include <new>
+#include <sstream>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/asyncinvoker.h"
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/bind.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/thread.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace {
+// Counts every heap allocation made in the process, on any thread, so that
+// the allocations per call can be reported.
+volatile int g_num_allocations = 0;
+}  // namespace
+
+void* operator new(size_t size) {
+  rtc::AtomicOps::Increment(&g_num_allocations);
+  void* p = malloc(size ? size : 1);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void* p) throw() {
+  free(p);
+}
+
+namespace rtc {
+namespace {
+
+const int kNumCalls = 10000;
+const int kBatchSize = 10;
+
+class Counter {
+ public:
+  Counter() : count_(0) {}
+  void Increment() { ++count_; }
+  int count() const { return count_; }
+
+ private:
+  int count_;
+};
+
+// Latency and heap allocations of kNumCalls calls.
+struct CallCost {
+  CallCost() : elapsed_us(0), num_allocations(0) {}
+  uint64 elapsed_us;
+  int num_allocations;
+};
+
+class CostMeter {
+ public:
+  CostMeter()
+      : start_us_(TimeMicros()),
+        start_allocations_(AtomicOps::AcquireLoad(&g_num_allocations)) {}
+
+  CallCost Stop() const {
+    CallCost cost;
+    cost.elapsed_us = TimeMicros() - start_us_;
+    cost.num_allocations =
+        AtomicOps::AcquireLoad(&g_num_allocations) - start_allocations_;
+    return cost;
+  }
+
+ private:
+  const uint64 start_us_;
+  const int start_allocations_;
+};
+
+void PrintCost(const std::string& trace, const CallCost& cost) {
+  webrtc::test::PrintResult("thread_invoke_latency", "", trace,
+                            static_cast<size_t>(cost.elapsed_us * 1000 /
+                                                kNumCalls),
+                            "ns/call", true);
+  std::ostringstream allocations;
+  allocations << static_cast<double>(cost.num_allocations) / kNumCalls;
+  webrtc::test::PrintResult("thread_invoke_allocations", "", trace,
+                            allocations.str(), "allocations/call", true);
+}
+
+// Invokes calls on |thread_| from a thread that is not an rtc::Thread, which
+// makes Send() set up and tear down a Thread for the caller on every call.
+class UnwrappedCaller {
+ public:
+  explicit UnwrappedCaller(Thread* thread) : thread_(thread) {}
+
+  static bool Run(void* obj) {
+    static_cast<UnwrappedCaller*>(obj)->InvokeAll();
+    return false;
+  }
+
+  void InvokeAll() {
+    EXPECT_TRUE(Thread::Current() == NULL);
+    CostMeter meter;
+    for (int i = 0; i < kNumCalls; ++i)
+      thread_->Invoke<void>(Bind(&Counter::Increment, &counter_));
+    cost_ = meter.Stop();
+    EXPECT_EQ(kNumCalls, counter_.count());
+  }
+
+  const CallCost& cost() const { return cost_; }
+
+ private:
+  Thread* const thread_;
+  Counter counter_;
+  CallCost cost_;
+};
+
+}  // namespace
+
+TEST(ThreadInvokePerfTest, InvokeFromUnwrappedThread) {
+  Thread thread;
+  thread.Start();
+  UnwrappedCaller caller(&thread);
+  rtc::scoped_ptr<webrtc::ThreadWrapper> caller_thread(
+      webrtc::ThreadWrapper::CreateThread(&UnwrappedCaller::Run, &caller,
+                                          "UnwrappedCaller"));
+  ASSERT_TRUE(caller_thread->Start());
+  ASSERT_TRUE(caller_thread->Stop());
+  PrintCost("invoke_from_unwrapped_thread", caller.cost());
+}
+
+TEST(ThreadInvokePerfTest, Invoke) {
+  AutoThread current;
+  Thread thread;
+  thread.Start();
+  Counter counter;
+  CostMeter meter;
+  for (int i = 0; i < kNumCalls; ++i)
+    thread.Invoke<void>(Bind(&Counter::Increment, &counter));
+  const CallCost cost = meter.Stop();
+  EXPECT_EQ(kNumCalls, counter.count());
+  PrintCost("invoke", cost);
+}
+
+TEST(ThreadInvokePerfTest, InvokeBatch) {
+  AutoThread current;
+  Thread thread;
+  thread.Start();
+  Counter counter;
+  std::vector<MethodFunctor0<Counter, void (Counter::*)(), void>> calls(
+      kBatchSize, Bind(&Counter::Increment, &counter));
+  CostMeter meter;
+  for (int i = 0; i < kNumCalls / kBatchSize; ++i)
+    thread.InvokeBatch(calls);
+  const CallCost cost = meter.Stop();
+  EXPECT_EQ(kNumCalls, counter.count());
+  PrintCost("invoke_batch_of_10", cost);
+}
+
+TEST(ThreadInvokePerfTest, AsyncInvoke) {
+  AutoThread current;
+  Thread thread;
+  thread.Start();
+  Counter counter;
+  AsyncInvoker invoker;
+  CostMeter meter;
+  for (int i = 0; i < kNumCalls; ++i)
+    invoker.AsyncInvoke<void>(&thread, Bind(&Counter::Increment, &counter));
+  // Flush runs whatever is still pending and returns once all calls ran.
+  invoker.Flush(&thread);
+  const CallCost cost = meter.Stop();
+  EXPECT_EQ(kNumCalls, counter.count());
+  PrintCost("async_invoke", cost);
+}
+
+}  // namespace rtc
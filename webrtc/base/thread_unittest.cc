@@ -279,6 +279,33 @@ TEST(ThreadTest, Invoke) {
   thread.Invoke<void>(&LocalFuncs::Func2);
 }
 
+TEST(ThreadTest, InvokeBatch) {
+  Thread thread;
+  thread.Start();
+  struct Append {
+    Append(Thread* thread, std::vector<int>* values, int value)
+        : thread(thread), values(values), value(value) {}
+    void operator()() const {
+      EXPECT_TRUE(thread->IsCurrent());
+      values->push_back(value);
+    }
+    Thread* thread;
+    std::vector<int>* values;
+    int value;
+  };
+  std::vector<int> values;
+  std::vector<Append> calls;
+  for (int i = 0; i < 5; ++i)
+    calls.push_back(Append(&thread, &values, i));
+  thread.InvokeBatch(calls);
+  ASSERT_EQ(5u, values.size());
+  for (int i = 0; i < 5; ++i)
+    EXPECT_EQ(i, values[i]);
+
+  thread.InvokeBatch(std::vector<Append>());
+  EXPECT_EQ(5u, values.size());
+}
+
 // Verifies that two threads calling Invoke on each other at the same time does
 // not deadlock.
 TEST(ThreadTest, TwoThreadsInvokeNoDeadlock) {
@@ -533,6 +533,14 @@
         category, name, id, TRACE_EVENT_FLAG_COPY, \
         arg1_name, arg1_val, arg2_name, arg2_val)
 
+// Sets |*ret| to whether the category is enabled, so that arguments which are
+// expensive to compute are only computed when they will be recorded.
+#define TRACE_EVENT_CATEGORY_GROUP_ENABLED(category, ret) \
+    do { \
+      INTERNAL_TRACE_EVENT_GET_CATEGORY_INFO(category); \
+      *(ret) = *INTERNAL_TRACE_EVENT_UID(catstatic) != 0; \
+    } while (0)
+
 
 ////////////////////////////////////////////////////////////////////////////////
 // Implementation specific tracing API definitions.
@@ -44,11 +44,13 @@
         'incoming_video_stream.cc',
         'interface/i420_buffer_pool.h',
         'interface/incoming_video_stream.h',
+        'interface/render_scheduler.h',
         'interface/video_frame_buffer.h',
         'libyuv/include/scaler.h',
         'libyuv/include/webrtc_libyuv.h',
         'libyuv/scaler.cc',
         'libyuv/webrtc_libyuv.cc',
+        'render_scheduler.cc',
         'video_frame_buffer.cc',
         'video_render_frames.cc',
         'video_render_frames.h',
@@ -10,8 +10,6 @@
 
 #include "webrtc/common_video/interface/incoming_video_stream.h"
 
-#include <assert.h>
-
 #if defined(_WIN32)
 #include <windows.h>
 #elif defined(WEBRTC_LINUX)
@@ -24,24 +22,29 @@
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
 #include "webrtc/common_video/video_render_frames.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
-#include "webrtc/system_wrappers/interface/event_wrapper.h"
-#include "webrtc/system_wrappers/interface/thread_wrapper.h"
-#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/system_wrappers/interface/clock.h"
 #include "webrtc/system_wrappers/interface/trace.h"
 
 namespace webrtc {
 
 IncomingVideoStream::IncomingVideoStream(uint32_t stream_id)
+    : IncomingVideoStream(stream_id, nullptr) {
+}
+
+IncomingVideoStream::IncomingVideoStream(uint32_t stream_id,
+                                         RenderScheduler* render_scheduler)
     : stream_id_(stream_id),
       stream_critsect_(CriticalSectionWrapper::CreateCriticalSection()),
       thread_critsect_(CriticalSectionWrapper::CreateCriticalSection()),
       buffer_critsect_(CriticalSectionWrapper::CreateCriticalSection()),
-      incoming_render_thread_(),
-      deliver_buffer_event_(EventTimerWrapper::Create()),
+      own_render_scheduler_(render_scheduler ? nullptr : new RenderScheduler()),
+      render_scheduler_(render_scheduler ? render_scheduler
+                                         : own_render_scheduler_.get()),
+      clock_(render_scheduler_->clock()),
       running_(false),
       external_callback_(nullptr),
       render_callback_(nullptr),
-      render_buffers_(new VideoRenderFrames()),
+      render_buffers_(new VideoRenderFrames(clock_)),
       incoming_rate_(0),
       last_rate_calculation_time_ms_(0),
       num_frames_since_last_calculation_(0),
@@ -71,7 +74,7 @@ int32_t IncomingVideoStream::RenderFrame(const uint32_t stream_id,
 
   // Rate statistics.
   num_frames_since_last_calculation_++;
-  int64_t now_ms = TickTime::MillisecondTimestamp();
+  int64_t now_ms = clock_->TimeInMilliseconds();
   if (now_ms >= last_rate_calculation_time_ms_ + kFrameRatePeriodMs) {
     incoming_rate_ =
         static_cast<uint32_t>(1000 * num_frames_since_last_calculation_ /
@@ -83,27 +86,41 @@ int32_t IncomingVideoStream::RenderFrame(const uint32_t stream_id,
   // Insert frame.
   CriticalSectionScoped csB(buffer_critsect_.get());
   if (render_buffers_->AddFrame(video_frame) == 1)
-    deliver_buffer_event_->Set();
+    render_scheduler_->WakeUp(this);
 
   return 0;
 }
 
 int32_t IncomingVideoStream::SetStartImage(const VideoFrame& video_frame) {
-  CriticalSectionScoped csS(thread_critsect_.get());
-  return start_image_.CopyFrame(video_frame);
+  int32_t ret;
+  {
+    CriticalSectionScoped csS(thread_critsect_.get());
+    ret = start_image_.CopyFrame(video_frame);
+  }
+  // Make sure the image gets rendered while no frames are coming in.
+  render_scheduler_->WakeUp(this);
+  return ret;
 }
 
 int32_t IncomingVideoStream::SetTimeoutImage(const VideoFrame& video_frame,
                                              const uint32_t timeout) {
-  CriticalSectionScoped csS(thread_critsect_.get());
-  timeout_time_ = timeout;
-  return timeout_image_.CopyFrame(video_frame);
+  int32_t ret;
+  {
+    CriticalSectionScoped csS(thread_critsect_.get());
+    timeout_time_ = timeout;
+    ret = timeout_image_.CopyFrame(video_frame);
+  }
+  render_scheduler_->WakeUp(this);
+  return ret;
 }
 
 void IncomingVideoStream::SetRenderCallback(
     VideoRenderCallback* render_callback) {
-  CriticalSectionScoped cs(thread_critsect_.get());
-  render_callback_ = render_callback;
+  {
+    CriticalSectionScoped cs(thread_critsect_.get());
+    render_callback_ = render_callback;
+  }
+  render_scheduler_->WakeUp(this);
 }
 
 int32_t IncomingVideoStream::SetExpectedRenderDelay(
@@ -128,21 +145,9 @@ int32_t IncomingVideoStream::Start() {
     return 0;
   }
 
-  CriticalSectionScoped csT(thread_critsect_.get());
-  assert(incoming_render_thread_ == NULL);
-
-  incoming_render_thread_ = ThreadWrapper::CreateThread(
-      IncomingVideoStreamThreadFun, this, "IncomingVideoStreamThread");
-  if (!incoming_render_thread_) {
-    return -1;
-  }
-
-  if (incoming_render_thread_->Start()) {
-  } else {
-    return -1;
-  }
-  incoming_render_thread_->SetPriority(kRealtimePriority);
-  deliver_buffer_event_->StartTimer(false, kEventStartupTimeMs);
+  if (own_render_scheduler_)
+    own_render_scheduler_->Start();
+  render_scheduler_->RegisterClient(this);
 
   running_ = true;
   return 0;
@@ -155,26 +160,11 @@ int32_t IncomingVideoStream::Stop() {
     return 0;
   }
 
-  ThreadWrapper* thread = NULL;
-  {
-    CriticalSectionScoped cs_thread(thread_critsect_.get());
-    if (incoming_render_thread_) {
-      // Setting the incoming render thread to NULL marks that we're performing
-      // a shutdown and will make IncomingVideoStreamProcess abort after wakeup.
-      thread = incoming_render_thread_.release();
-      deliver_buffer_event_->StopTimer();
-      // Set the event to allow the thread to wake up and shut down without
-      // waiting for a timeout.
-      deliver_buffer_event_->Set();
-    }
-  }
-  if (thread) {
-    if (thread->Stop()) {
-      delete thread;
-    } else {
-      assert(false);
-    }
-  }
+  // Waits for an ongoing Process() call to return, after which no more calls
+  // will be made.
+  render_scheduler_->DeregisterClient(this);
+  if (own_render_scheduler_)
+    own_render_scheduler_->Stop();
   running_ = false;
   return 0;
 }
@@ -194,63 +184,59 @@ uint32_t IncomingVideoStream::IncomingRate() const {
   return incoming_rate_;
 }
 
-bool IncomingVideoStream::IncomingVideoStreamThreadFun(void* obj) {
-  return static_cast<IncomingVideoStream*>(obj)->IncomingVideoStreamProcess();
-}
+int64_t IncomingVideoStream::Process() {
+  CriticalSectionScoped cs(thread_critsect_.get());
+  // Get a new frame to render and the time for the frame after this one.
+  VideoFrame frame_to_render;
+  uint32_t wait_time;
+  bool has_pending_frames;
+  {
+    CriticalSectionScoped cs(buffer_critsect_.get());
+    frame_to_render = render_buffers_->FrameToRender();
+    wait_time = render_buffers_->TimeToNextFrameRelease();
+    has_pending_frames = render_buffers_->HasPendingFrames();
+  }
 
-bool IncomingVideoStream::IncomingVideoStreamProcess() {
-  if (kEventError != deliver_buffer_event_->Wait(kEventMaxWaitTimeMs)) {
-    CriticalSectionScoped cs(thread_critsect_.get());
-    if (incoming_render_thread_ == NULL) {
-      // Terminating
-      return false;
-    }
-    // Get a new frame to render and the time for the frame after this one.
-    VideoFrame frame_to_render;
-    uint32_t wait_time;
-    {
-      CriticalSectionScoped cs(buffer_critsect_.get());
-      frame_to_render = render_buffers_->FrameToRender();
-      wait_time = render_buffers_->TimeToNextFrameRelease();
-    }
+  // Run again when the next frame is due. Without frames, only poll if there
+  // is a start or timeout image that may need to be rendered; otherwise the
+  // next incoming frame wakes us up.
+  const int64_t now_ms = clock_->TimeInMilliseconds();
+  int64_t next_process_time_ms = -1;
+  if (has_pending_frames) {
+    next_process_time_ms = now_ms + wait_time;
+  } else if (render_callback_ &&
+             (!start_image_.IsZeroSize() || !timeout_image_.IsZeroSize())) {
+    next_process_time_ms = now_ms + kEventMaxWaitTimeMs;
+  }
 
-    // Set timer for next frame to render.
-    if (wait_time > kEventMaxWaitTimeMs) {
-      wait_time = kEventMaxWaitTimeMs;
-    }
-    deliver_buffer_event_->StartTimer(false, wait_time);
-
-    if (frame_to_render.IsZeroSize()) {
-      if (render_callback_) {
-        if (last_render_time_ms_ == 0 && !start_image_.IsZeroSize()) {
-          // We have not rendered anything and have a start image.
-          temp_frame_.CopyFrame(start_image_);
-          render_callback_->RenderFrame(stream_id_, temp_frame_);
-        } else if (!timeout_image_.IsZeroSize() &&
-                   last_render_time_ms_ + timeout_time_ <
-                       TickTime::MillisecondTimestamp()) {
-          // Render a timeout image.
-          temp_frame_.CopyFrame(timeout_image_);
-          render_callback_->RenderFrame(stream_id_, temp_frame_);
-        }
+  if (frame_to_render.IsZeroSize()) {
+    if (render_callback_) {
+      if (last_render_time_ms_ == 0 && !start_image_.IsZeroSize()) {
+        // We have not rendered anything and have a start image.
+        temp_frame_.CopyFrame(start_image_);
+        render_callback_->RenderFrame(stream_id_, temp_frame_);
+      } else if (!timeout_image_.IsZeroSize() &&
+                 last_render_time_ms_ + timeout_time_ < now_ms) {
+        // Render a timeout image.
+        temp_frame_.CopyFrame(timeout_image_);
+        render_callback_->RenderFrame(stream_id_, temp_frame_);
       }
-
-      // No frame.
-      return true;
     }
 
-    // Send frame for rendering.
-    if (external_callback_) {
-      external_callback_->RenderFrame(stream_id_, frame_to_render);
-    } else if (render_callback_) {
-      render_callback_->RenderFrame(stream_id_, frame_to_render);
-    }
+    // No frame.
+    return next_process_time_ms;
+  }
 
-    // We're done with this frame.
-    if (!frame_to_render.IsZeroSize())
-      last_render_time_ms_ = frame_to_render.render_time_ms();
+  // Send frame for rendering.
+  if (external_callback_) {
+    external_callback_->RenderFrame(stream_id_, frame_to_render);
+  } else if (render_callback_) {
+    render_callback_->RenderFrame(stream_id_, frame_to_render);
   }
-  return true;
+
+  // We're done with this frame.
+  last_render_time_ms_ = frame_to_render.render_time_ms();
+  return next_process_time_ms;
 }
 
 }  // namespace webrtc
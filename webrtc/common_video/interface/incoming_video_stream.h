@@ -13,12 +13,12 @@
 
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/thread_annotations.h"
+#include "webrtc/common_video/interface/render_scheduler.h"
 #include "webrtc/common_video/video_render_frames.h"
 
 namespace webrtc {
+class Clock;
 class CriticalSectionWrapper;
-class EventTimerWrapper;
-class ThreadWrapper;
 
 class VideoRenderCallback {
  public:
@@ -29,9 +29,14 @@ class VideoRenderCallback {
   virtual ~VideoRenderCallback() {}
 };
 
-class IncomingVideoStream : public VideoRenderCallback {
+class IncomingVideoStream : public VideoRenderCallback,
+                            public RenderScheduler::Client {
  public:
+  // Frames are rendered on a thread of the stream's own.
   explicit IncomingVideoStream(uint32_t stream_id);
+  // Frames are rendered on |render_scheduler|, which is shared with other
+  // streams and has to outlive this stream.
+  IncomingVideoStream(uint32_t stream_id, RenderScheduler* render_scheduler);
   ~IncomingVideoStream();
 
   // Get callback to deliver frames to the module.
@@ -64,11 +69,10 @@ class IncomingVideoStream : public VideoRenderCallback {
   int32_t SetExpectedRenderDelay(int32_t delay_ms);
 
  protected:
-  static bool IncomingVideoStreamThreadFun(void* obj);
-  bool IncomingVideoStreamProcess();
+  // Implements RenderScheduler::Client.
+  int64_t Process() override;
 
  private:
-  enum { kEventStartupTimeMs = 10 };
   enum { kEventMaxWaitTimeMs = 100 };
   enum { kFrameRatePeriodMs = 1000 };
 
@@ -77,9 +81,11 @@ class IncomingVideoStream : public VideoRenderCallback {
   const rtc::scoped_ptr<CriticalSectionWrapper> stream_critsect_;
   const rtc::scoped_ptr<CriticalSectionWrapper> thread_critsect_;
   const rtc::scoped_ptr<CriticalSectionWrapper> buffer_critsect_;
-  rtc::scoped_ptr<ThreadWrapper> incoming_render_thread_
-      GUARDED_BY(thread_critsect_);
-  rtc::scoped_ptr<EventTimerWrapper> deliver_buffer_event_;
+  // Set if the stream renders on a thread of its own.
+  const rtc::scoped_ptr<RenderScheduler> own_render_scheduler_;
+  RenderScheduler* const render_scheduler_;
+  // The clock of |render_scheduler_|.
+  Clock* const clock_;
 
   bool running_ GUARDED_BY(stream_critsect_);
   VideoRenderCallback* external_callback_ GUARDED_BY(thread_critsect_);
@@ -0,0 +1,107 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_COMMON_VIDEO_INTERFACE_RENDER_SCHEDULER_H_
+#define WEBRTC_COMMON_VIDEO_INTERFACE_RENDER_SCHEDULER_H_
+
+#include <functional>
+#include <map>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/thread_annotations.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+class Clock;
+class CriticalSectionWrapper;
+class EventWrapper;
+class ThreadWrapper;
+
+// Runs the render loop of any number of clients, typically
+// IncomingVideoStreams, on a single thread. Clients are kept in a heap ordered
+// by the time they next need to run, and the thread sleeps until the earliest
+// of them is due, so idle clients cost neither a thread nor periodic wakeups.
+class RenderScheduler {
+ public:
+  class Client {
+   public:
+    // Called on the scheduler thread when the client is due. Returns the time,
+    // in clock() milliseconds, at which the client wants to run next, or -1 if
+    // it doesn't need to run until WakeUp() is called.
+    virtual int64_t Process() = 0;
+
+   protected:
+    virtual ~Client() {}
+  };
+
+  RenderScheduler();
+  // Schedules clients on |clock| and waits for them on |wake_up|, which lets
+  // tests run the scheduler on simulated time.
+  RenderScheduler(Clock* clock, rtc::scoped_ptr<EventWrapper> wake_up);
+  ~RenderScheduler();
+
+  void Start();
+  void Stop();
+
+  // Registered clients are run as soon as possible.
+  void RegisterClient(Client* client);
+  // Blocks until an ongoing Process() call on |client| has returned. May be
+  // called from within Process().
+  void DeregisterClient(Client* client);
+
+  // Runs |client| as soon as possible. Allowed to be called on any thread.
+  void WakeUp(Client* client);
+
+  // Number of times the scheduler thread has woken up since it was created.
+  int64_t NumWakeUps() const;
+
+  Clock* clock() const { return clock_; }
+
+ private:
+  friend class RenderSchedulerTest;
+
+  // Time to run and client, ordered earliest first in |heap_|.
+  typedef std::pair<int64_t, Client*> ScheduledClient;
+
+  static bool Run(void* obj);
+  bool Process();
+
+  // Schedules |client| to run at |run_at_ms| unless it's already scheduled to
+  // run earlier. Returns true if |client| is now due before all others.
+  bool ScheduleLocked(Client* client, int64_t run_at_ms)
+      EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  Clock* const clock_;
+  // Held while calling out to clients, so that DeregisterClient() can wait for
+  // an ongoing call. Taken before |lock_|.
+  const rtc::scoped_ptr<CriticalSectionWrapper> process_lock_;
+  const rtc::scoped_ptr<CriticalSectionWrapper> lock_;
+  const rtc::scoped_ptr<EventWrapper> wake_up_;
+  rtc::scoped_ptr<ThreadWrapper> thread_;
+
+  // Registered clients and the time each one is scheduled at, or -1 if not
+  // scheduled. Entries in |heap_| that don't match this time are stale and
+  // skipped when popped, rather than searched for and removed.
+  std::map<Client*, int64_t> run_at_ms_ GUARDED_BY(lock_);
+  std::priority_queue<ScheduledClient,
+                      std::vector<ScheduledClient>,
+                      std::greater<ScheduledClient>> heap_ GUARDED_BY(lock_);
+  bool stop_ GUARDED_BY(lock_);
+  int64_t num_wake_ups_ GUARDED_BY(lock_);
+  // Only accessed on the scheduler thread.
+  std::vector<Client*> due_clients_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_COMMON_VIDEO_INTERFACE_RENDER_SCHEDULER_H_
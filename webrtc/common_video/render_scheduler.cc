@@ -0,0 +1,176 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_video/interface/render_scheduler.h"
+
+#include <algorithm>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/event_wrapper.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+
+namespace webrtc {
+namespace {
+// Upper bound on how long the thread sleeps when no client is scheduled.
+const int64_t kMaxWaitTimeMs = 60 * 1000;
+}  // namespace
+
+RenderScheduler::RenderScheduler()
+    : RenderScheduler(Clock::GetRealTimeClock(),
+                      rtc::scoped_ptr<EventWrapper>(EventWrapper::Create())) {
+}
+
+RenderScheduler::RenderScheduler(Clock* clock,
+                                 rtc::scoped_ptr<EventWrapper> wake_up)
+    : clock_(clock),
+      process_lock_(CriticalSectionWrapper::CreateCriticalSection()),
+      lock_(CriticalSectionWrapper::CreateCriticalSection()),
+      wake_up_(wake_up.Pass()),
+      stop_(false),
+      num_wake_ups_(0) {
+}
+
+RenderScheduler::~RenderScheduler() {
+  DCHECK(!thread_.get());
+}
+
+void RenderScheduler::Start() {
+  DCHECK(!thread_.get());
+  thread_ = ThreadWrapper::CreateThread(&RenderScheduler::Run, this,
+                                        "IncomingVideoStreamThread");
+  CHECK(thread_->Start());
+  thread_->SetPriority(kRealtimePriority);
+}
+
+void RenderScheduler::Stop() {
+  if (!thread_.get())
+    return;
+  {
+    CriticalSectionScoped cs(lock_.get());
+    stop_ = true;
+  }
+  wake_up_->Set();
+  CHECK(thread_->Stop());
+  thread_.reset();
+  CriticalSectionScoped cs(lock_.get());
+  stop_ = false;
+}
+
+void RenderScheduler::RegisterClient(Client* client) {
+  DCHECK(client);
+  {
+    CriticalSectionScoped cs(lock_.get());
+    DCHECK(run_at_ms_.find(client) == run_at_ms_.end());
+    run_at_ms_[client] = -1;
+    if (!ScheduleLocked(client, clock_->TimeInMilliseconds()))
+      return;
+  }
+  wake_up_->Set();
+}
+
+void RenderScheduler::DeregisterClient(Client* client) {
+  CriticalSectionScoped process_cs(process_lock_.get());
+  CriticalSectionScoped cs(lock_.get());
+  run_at_ms_.erase(client);
+}
+
+void RenderScheduler::WakeUp(Client* client) {
+  {
+    CriticalSectionScoped cs(lock_.get());
+    if (!ScheduleLocked(client, clock_->TimeInMilliseconds()))
+      return;
+  }
+  wake_up_->Set();
+}
+
+int64_t RenderScheduler::NumWakeUps() const {
+  CriticalSectionScoped cs(lock_.get());
+  return num_wake_ups_;
+}
+
+bool RenderScheduler::ScheduleLocked(Client* client, int64_t run_at_ms) {
+  std::map<Client*, int64_t>::iterator it = run_at_ms_.find(client);
+  if (it == run_at_ms_.end())
+    return false;
+  if (it->second != -1 && it->second <= run_at_ms)
+    return false;
+  // Only wake the thread up if it would otherwise sleep past |run_at_ms|.
+  const bool earliest = heap_.empty() || run_at_ms < heap_.top().first;
+  it->second = run_at_ms;
+  heap_.push(ScheduledClient(run_at_ms, client));
+  return earliest;
+}
+
+// static
+bool RenderScheduler::Run(void* obj) {
+  return static_cast<RenderScheduler*>(obj)->Process();
+}
+
+bool RenderScheduler::Process() {
+  const int64_t now_ms = clock_->TimeInMilliseconds();
+  due_clients_.clear();
+  {
+    CriticalSectionScoped cs(lock_.get());
+    if (stop_)
+      return false;
+    ++num_wake_ups_;
+    while (!heap_.empty() && heap_.top().first <= now_ms) {
+      const ScheduledClient scheduled = heap_.top();
+      heap_.pop();
+      std::map<Client*, int64_t>::iterator it =
+          run_at_ms_.find(scheduled.second);
+      if (it == run_at_ms_.end() || it->second != scheduled.first)
+        continue;
+      // Cleared before running, so that a WakeUp() during Process() schedules
+      // the client again.
+      it->second = -1;
+      due_clients_.push_back(scheduled.second);
+    }
+  }
+
+  for (Client* client : due_clients_) {
+    CriticalSectionScoped process_cs(process_lock_.get());
+    {
+      CriticalSectionScoped cs(lock_.get());
+      // Deregistered after being popped.
+      if (run_at_ms_.find(client) == run_at_ms_.end())
+        continue;
+    }
+    const int64_t next_run_ms = client->Process();
+    if (next_run_ms != -1) {
+      CriticalSectionScoped cs(lock_.get());
+      ScheduleLocked(client, next_run_ms);
+    }
+  }
+
+  int64_t wait_time_ms = kMaxWaitTimeMs;
+  {
+    CriticalSectionScoped cs(lock_.get());
+    // Drop stale entries so they don't cause wakeups.
+    while (!heap_.empty()) {
+      std::map<Client*, int64_t>::iterator it =
+          run_at_ms_.find(heap_.top().second);
+      if (it != run_at_ms_.end() && it->second == heap_.top().first)
+        break;
+      heap_.pop();
+    }
+    if (!heap_.empty()) {
+      wait_time_ms = std::min(
+          wait_time_ms, heap_.top().first - clock_->TimeInMilliseconds());
+    }
+  }
+  if (wait_time_ms > 0)
+    wake_up_->Wait(static_cast<unsigned long>(wait_time_ms));
+  return true;
+}
+
+}  // namespace webrtc
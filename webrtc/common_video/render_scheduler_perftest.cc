@@ -0,0 +1,143 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/common_video/interface/incoming_video_stream.h"
+#include "webrtc/common_video/interface/render_scheduler.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/sleep.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+// Records the latest a frame is rendered compared to its render time.
+class LatenessRecorder : public VideoRenderCallback {
+ public:
+  LatenessRecorder()
+      : crit_(CriticalSectionWrapper::CreateCriticalSection()),
+        num_frames_(0),
+        max_lateness_ms_(0) {}
+
+  int32_t RenderFrame(const uint32_t stream_id,
+                      const VideoFrame& video_frame) override {
+    CriticalSectionScoped cs(crit_.get());
+    max_lateness_ms_ = std::max(
+        max_lateness_ms_, Clock::GetRealTimeClock()->TimeInMilliseconds() -
+                              video_frame.render_time_ms());
+    ++num_frames_;
+    return 0;
+  }
+
+  int num_frames() const {
+    CriticalSectionScoped cs(crit_.get());
+    return num_frames_;
+  }
+  int64_t max_lateness_ms() const {
+    CriticalSectionScoped cs(crit_.get());
+    return max_lateness_ms_;
+  }
+
+ private:
+  const rtc::scoped_ptr<CriticalSectionWrapper> crit_;
+  int num_frames_;
+  int64_t max_lateness_ms_;
+};
+
+// Feeds |streams| with frames at |fps| for |duration_ms|, each to be rendered
+// |delay_ms| after it was inserted. Returns the number of frames fed to each
+// stream.
+int FeedFrames(const std::vector<IncomingVideoStream*>& streams,
+               int fps,
+               int64_t duration_ms,
+               int64_t delay_ms) {
+  Clock* clock = Clock::GetRealTimeClock();
+  const int64_t start_ms = clock->TimeInMilliseconds();
+  int64_t next_frame_ms = start_ms;
+  int num_frames = 0;
+  while (next_frame_ms < start_ms + duration_ms) {
+    for (IncomingVideoStream* stream : streams) {
+      VideoFrame frame;
+      frame.CreateEmptyFrame(16, 16, 16, 8, 8);
+      frame.set_render_time_ms(next_frame_ms + delay_ms);
+      stream->RenderFrame(0, frame);
+    }
+    ++num_frames;
+    next_frame_ms += 1000 / fps;
+    const int64_t sleep_ms = next_frame_ms - clock->TimeInMilliseconds();
+    if (sleep_ms > 0)
+      SleepMs(static_cast<int>(sleep_ms));
+  }
+  return num_frames;
+}
+
+// Renders 50 streams at 30 fps, as in a large gallery view, either with a
+// scheduler, and thread, per stream or with all streams on one scheduler.
+void RunFiftyStreams(bool shared) {
+  const int kNumStreams = 50;
+  const int kFps = 30;
+  const int64_t kDurationMs = 2000;
+  std::vector<RenderScheduler*> schedulers(shared ? 1 : kNumStreams);
+  for (RenderScheduler*& scheduler : schedulers) {
+    scheduler = new RenderScheduler();
+    scheduler->Start();
+  }
+  std::vector<IncomingVideoStream*> streams;
+  std::vector<LatenessRecorder> renderers(kNumStreams);
+  for (int i = 0; i < kNumStreams; ++i) {
+    streams.push_back(
+        new IncomingVideoStream(i, schedulers[i % schedulers.size()]));
+    streams[i]->SetExternalCallback(&renderers[i]);
+    streams[i]->Start();
+  }
+
+  const int frames_per_stream = FeedFrames(streams, kFps, kDurationMs, 50);
+  SleepMs(100);
+
+  int64_t max_lateness_ms = 0;
+  int num_frames = 0;
+  for (int i = 0; i < kNumStreams; ++i) {
+    streams[i]->Stop();
+    delete streams[i];
+    max_lateness_ms = std::max(max_lateness_ms, renderers[i].max_lateness_ms());
+    num_frames += renderers[i].num_frames();
+  }
+  int64_t num_wake_ups = 0;
+  for (RenderScheduler* scheduler : schedulers) {
+    scheduler->Stop();
+    num_wake_ups += scheduler->NumWakeUps();
+    delete scheduler;
+  }
+  EXPECT_EQ(kNumStreams * frames_per_stream, num_frames);
+
+  const char* trace = shared ? "shared_scheduler" : "scheduler_per_stream";
+  test::PrintResult("render_scheduler_wakeups", "", trace,
+                    static_cast<size_t>(num_wake_ups * 1000 / kDurationMs),
+                    "wakeups/s", true);
+  test::PrintResult("render_scheduler_max_lateness", "", trace,
+                    static_cast<size_t>(std::max<int64_t>(max_lateness_ms, 0)),
+                    "ms", false);
+}
+}  // namespace
+
+TEST(RenderSchedulerPerfTest, FiftyStreamsWithSchedulerPerStream) {
+  RunFiftyStreams(false);
+}
+
+TEST(RenderSchedulerPerfTest, FiftyStreamsWithSharedScheduler) {
+  RunFiftyStreams(true);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,275 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_video/interface/render_scheduler.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/common_video/interface/incoming_video_stream.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/event_wrapper.h"
+
+namespace webrtc {
+namespace {
+const int kTimeoutMs = 5000;
+const int64_t kStartTimeMs = 12345;
+
+class IdleClient : public RenderScheduler::Client {
+ public:
+  IdleClient() : num_calls_(0) {}
+  int64_t Process() override {
+    ++num_calls_;
+    return -1;
+  }
+  int num_calls_;
+};
+
+class PeriodicClient : public RenderScheduler::Client {
+ public:
+  PeriodicClient(Clock* clock, int64_t period_ms)
+      : clock_(clock), period_ms_(period_ms), num_calls_(0) {}
+  int64_t Process() override {
+    ++num_calls_;
+    return clock_->TimeInMilliseconds() + period_ms_;
+  }
+  Clock* const clock_;
+  const int64_t period_ms_;
+  int num_calls_;
+};
+
+// Stands in for the wake-up event of the scheduler thread. Wait() returns at
+// once and records when the thread would have woken up, so that the test can
+// run the scheduler at that time on a simulated clock.
+class FakeEvent : public EventWrapper {
+ public:
+  explicit FakeEvent(Clock* clock)
+      : clock_(clock),
+        signaled_(false),
+        num_sets_(0),
+        wake_up_time_ms_(clock->TimeInMilliseconds()) {}
+
+  bool Set() override {
+    signaled_ = true;
+    ++num_sets_;
+    return true;
+  }
+
+  EventTypeWrapper Wait(unsigned long max_time) override {
+    wake_up_time_ms_ = clock_->TimeInMilliseconds();
+    if (signaled_) {
+      signaled_ = false;
+      return kEventSignaled;
+    }
+    wake_up_time_ms_ += max_time;
+    return kEventTimeout;
+  }
+
+  Clock* const clock_;
+  bool signaled_;
+  int num_sets_;
+  int64_t wake_up_time_ms_;
+};
+
+// Records how late each frame is rendered compared to its render time.
+class LatenessRecorder : public VideoRenderCallback {
+ public:
+  explicit LatenessRecorder(Clock* clock)
+      : clock_(clock), num_frames_(0), max_lateness_ms_(0),
+        min_lateness_ms_(0) {}
+
+  int32_t RenderFrame(const uint32_t stream_id,
+                      const VideoFrame& video_frame) override {
+    const int64_t lateness_ms =
+        clock_->TimeInMilliseconds() - video_frame.render_time_ms();
+    if (num_frames_ == 0 || lateness_ms > max_lateness_ms_)
+      max_lateness_ms_ = lateness_ms;
+    if (num_frames_ == 0 || lateness_ms < min_lateness_ms_)
+      min_lateness_ms_ = lateness_ms;
+    ++num_frames_;
+    return 0;
+  }
+
+  Clock* const clock_;
+  int num_frames_;
+  int64_t max_lateness_ms_;
+  int64_t min_lateness_ms_;
+};
+
+class FrameWaiter : public VideoRenderCallback {
+ public:
+  FrameWaiter() : rendered_(EventWrapper::Create()) {}
+
+  int32_t RenderFrame(const uint32_t stream_id,
+                      const VideoFrame& video_frame) override {
+    rendered_->Set();
+    return 0;
+  }
+
+  bool WaitForFrame() { return rendered_->Wait(kTimeoutMs) == kEventSignaled; }
+
+ private:
+  const rtc::scoped_ptr<EventWrapper> rendered_;
+};
+
+VideoFrame CreateFrame(int64_t render_time_ms) {
+  VideoFrame frame;
+  frame.CreateEmptyFrame(16, 16, 16, 8, 8);
+  frame.set_render_time_ms(render_time_ms);
+  return frame;
+}
+}  // namespace
+
+// Runs the scheduler on a simulated clock, without its thread, by running an
+// iteration of the thread loop whenever the thread would have woken up.
+class RenderSchedulerTest : public ::testing::Test {
+ protected:
+  RenderSchedulerTest()
+      : clock_(kStartTimeMs * 1000),
+        wake_up_(new FakeEvent(&clock_)),
+        scheduler_(&clock_, rtc::scoped_ptr<EventWrapper>(wake_up_)) {}
+
+  void AdvanceTimeMilliseconds(int64_t time_ms) {
+    const int64_t end_ms = clock_.TimeInMilliseconds() + time_ms;
+    while (true) {
+      const int64_t now_ms = clock_.TimeInMilliseconds();
+      int64_t wake_up_ms = wake_up_->wake_up_time_ms_;
+      if (wake_up_->signaled_) {
+        wake_up_->signaled_ = false;
+        wake_up_ms = now_ms;
+      }
+      if (wake_up_ms > end_ms)
+        break;
+      clock_.AdvanceTimeMilliseconds(std::max<int64_t>(wake_up_ms - now_ms, 0));
+      // Loops again right away unless Process() waits.
+      wake_up_->wake_up_time_ms_ = clock_.TimeInMilliseconds();
+      EXPECT_TRUE(scheduler_.Process());
+    }
+    clock_.AdvanceTimeMilliseconds(end_ms - clock_.TimeInMilliseconds());
+  }
+
+  SimulatedClock clock_;
+  // Owned by |scheduler_|.
+  FakeEvent* const wake_up_;
+  RenderScheduler scheduler_;
+};
+
+TEST_F(RenderSchedulerTest, DoesNotWakeUpForIdleClients) {
+  std::vector<IdleClient> clients(10);
+  for (IdleClient& client : clients)
+    scheduler_.RegisterClient(&client);
+  // Only the first client is due before all others.
+  EXPECT_EQ(1, wake_up_->num_sets_);
+  AdvanceTimeMilliseconds(0);
+  for (IdleClient& client : clients)
+    EXPECT_EQ(1, client.num_calls_);
+
+  const int64_t num_wake_ups = scheduler_.NumWakeUps();
+  AdvanceTimeMilliseconds(10000);
+  EXPECT_EQ(num_wake_ups, scheduler_.NumWakeUps());
+
+  scheduler_.WakeUp(&clients[0]);
+  AdvanceTimeMilliseconds(0);
+  EXPECT_EQ(num_wake_ups + 1, scheduler_.NumWakeUps());
+  EXPECT_EQ(2, clients[0].num_calls_);
+  EXPECT_EQ(1, clients[1].num_calls_);
+
+  for (IdleClient& client : clients)
+    scheduler_.DeregisterClient(&client);
+}
+
+TEST_F(RenderSchedulerTest, SleepsUntilEarliestClientIsDue) {
+  PeriodicClient client_30ms(&clock_, 30);
+  PeriodicClient client_50ms(&clock_, 50);
+  scheduler_.RegisterClient(&client_30ms);
+  scheduler_.RegisterClient(&client_50ms);
+  AdvanceTimeMilliseconds(0);
+  EXPECT_EQ(1, client_30ms.num_calls_);
+  EXPECT_EQ(1, client_50ms.num_calls_);
+
+  AdvanceTimeMilliseconds(29);
+  EXPECT_EQ(1, client_30ms.num_calls_);
+  AdvanceTimeMilliseconds(1);
+  EXPECT_EQ(2, client_30ms.num_calls_);
+  EXPECT_EQ(1, client_50ms.num_calls_);
+  AdvanceTimeMilliseconds(20);
+  EXPECT_EQ(2, client_30ms.num_calls_);
+  EXPECT_EQ(2, client_50ms.num_calls_);
+
+  // Runs at 60, 90, 100, 120 and 150 ms.
+  AdvanceTimeMilliseconds(100);
+  EXPECT_EQ(6, client_30ms.num_calls_);
+  EXPECT_EQ(4, client_50ms.num_calls_);
+  EXPECT_EQ(8, scheduler_.NumWakeUps());
+
+  scheduler_.DeregisterClient(&client_30ms);
+  scheduler_.DeregisterClient(&client_50ms);
+}
+
+TEST_F(RenderSchedulerTest, DoesNotRunDeregisteredClients) {
+  IdleClient client;
+  scheduler_.RegisterClient(&client);
+  scheduler_.DeregisterClient(&client);
+  AdvanceTimeMilliseconds(0);
+  EXPECT_EQ(0, client.num_calls_);
+
+  const int num_sets = wake_up_->num_sets_;
+  scheduler_.WakeUp(&client);
+  EXPECT_EQ(num_sets, wake_up_->num_sets_);
+  AdvanceTimeMilliseconds(0);
+  EXPECT_EQ(0, client.num_calls_);
+}
+
+TEST_F(RenderSchedulerTest, RendersFramesOfAllStreamsAtRenderTime) {
+  const int kNumStreams = 4;
+  const int kNumFrames = 15;
+  const int64_t kFrameIntervalMs = 33;
+  const int64_t kRenderDelayMs = 10;
+  std::vector<IncomingVideoStream*> streams;
+  std::vector<LatenessRecorder> renderers(kNumStreams,
+                                          LatenessRecorder(&clock_));
+  for (int i = 0; i < kNumStreams; ++i) {
+    streams.push_back(new IncomingVideoStream(i, &scheduler_));
+    streams[i]->SetExternalCallback(&renderers[i]);
+    EXPECT_EQ(0, streams[i]->SetExpectedRenderDelay(kRenderDelayMs));
+    EXPECT_EQ(0, streams[i]->Start());
+  }
+
+  for (int i = 0; i < kNumFrames; ++i) {
+    for (IncomingVideoStream* stream : streams)
+      stream->RenderFrame(0, CreateFrame(clock_.TimeInMilliseconds() + 100));
+    AdvanceTimeMilliseconds(kFrameIntervalMs);
+  }
+  AdvanceTimeMilliseconds(100);
+
+  for (int i = 0; i < kNumStreams; ++i) {
+    EXPECT_EQ(0, streams[i]->Stop());
+    delete streams[i];
+    EXPECT_EQ(kNumFrames, renderers[i].num_frames_);
+    // Frames are released |kRenderDelayMs| ahead of their render time.
+    EXPECT_EQ(-kRenderDelayMs, renderers[i].min_lateness_ms_);
+    EXPECT_EQ(-kRenderDelayMs, renderers[i].max_lateness_ms_);
+  }
+}
+
+TEST(RenderSchedulerThreadTest, StreamRendersOnItsOwnThreadWithoutScheduler) {
+  IncomingVideoStream stream(0);
+  FrameWaiter renderer;
+  stream.SetExternalCallback(&renderer);
+  EXPECT_EQ(0, stream.Start());
+  stream.RenderFrame(
+      0, CreateFrame(Clock::GetRealTimeClock()->TimeInMilliseconds()));
+  EXPECT_TRUE(renderer.WaitForFrame());
+  EXPECT_EQ(0, stream.Stop());
+}
+
+}  // namespace webrtc
@@ -13,7 +13,7 @@
 #include <assert.h>
 
 #include "webrtc/modules/interface/module_common_types.h"
-#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/system_wrappers/interface/clock.h"
 #include "webrtc/system_wrappers/interface/trace.h"
 
 namespace webrtc {
@@ -22,12 +22,13 @@ const uint32_t KEventMaxWaitTimeMs = 200;
 const uint32_t kMinRenderDelayMs = 10;
 const uint32_t kMaxRenderDelayMs= 500;
 
-VideoRenderFrames::VideoRenderFrames()
-    : render_delay_ms_(10) {
+VideoRenderFrames::VideoRenderFrames(Clock* clock)
+    : clock_(clock),
+      render_delay_ms_(10) {
 }
 
 int32_t VideoRenderFrames::AddFrame(const VideoFrame& new_frame) {
-  const int64_t time_now = TickTime::MillisecondTimestamp();
+  const int64_t time_now = clock_->TimeInMilliseconds();
 
   // Drop old frames only when there are other frames in the queue, otherwise, a
   // really slow system never renders any frames.
@@ -74,7 +75,7 @@ uint32_t VideoRenderFrames::TimeToNextFrameRelease() {
   }
   const int64_t time_to_release = incoming_frames_.front().render_time_ms() -
                                   render_delay_ms_ -
-                                  TickTime::MillisecondTimestamp();
+                                  clock_->TimeInMilliseconds();
   return time_to_release < 0 ? 0u : static_cast<uint32_t>(time_to_release);
 }
 
@@ -18,11 +18,12 @@
 #include "webrtc/video_frame.h"
 
 namespace webrtc {
+class Clock;
 
 // Class definitions
 class VideoRenderFrames {
  public:
-  VideoRenderFrames();
+  explicit VideoRenderFrames(Clock* clock);
 
   // Add a frame to the render queue
   int32_t AddFrame(const VideoFrame& new_frame);
@@ -36,6 +37,8 @@ class VideoRenderFrames {
   // Returns the number of ms to next frame to render
   uint32_t TimeToNextFrameRelease();
 
+  bool HasPendingFrames() const { return !incoming_frames_.empty(); }
+
   // Sets estimates delay in renderer
   int32_t SetRenderDelay(const uint32_t render_delay);
 
@@ -47,6 +50,8 @@ class VideoRenderFrames {
   // Don't render frames with timestamp more than 10s into the future.
   enum { KFutureRenderTimestampMS = 10000 };
 
+  Clock* const clock_;
+
   // Sorted list with framed to be rendered, oldest first.
   std::list<VideoFrame> incoming_frames_;
 
@@ -33,6 +33,7 @@
 #include "webrtc/modules/audio_coding/neteq/tools/packet.h"
 #include "webrtc/modules/audio_coding/neteq/tools/rtp_file_source.h"
 #include "webrtc/modules/interface/module_common_types.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
 #include "webrtc/system_wrappers/interface/trace.h"
 #include "webrtc/test/testsupport/fileutils.h"
 #include "webrtc/typedefs.h"
@@ -486,6 +487,9 @@ int main(int argc, char* argv[]) {
     next_output_time_ms +=
         kOutputBlockSizeMs - time_now_ms % kOutputBlockSizeMs;
   }
+  // The simulation runs as fast as possible; measure how fast that is.
+  const int64_t wall_clock_start_ms = webrtc::TickTime::MillisecondTimestamp();
+  int num_packets = 0;
   while (packet_available) {
     // Check if it is time to insert packet.
     while (time_now_ms >= next_input_time_ms && packet_available) {
@@ -510,6 +514,7 @@ int main(int argc, char* argv[]) {
                               payload_ptr,
                               payload_len,
                               packet->time_ms() * sample_rate_hz / 1000);
+      ++num_packets;
       if (error != NetEq::kOK) {
         if (neteq->LastError() == NetEq::kUnknownRtpPayloadType) {
           std::cerr << "RTP Payload type "
@@ -585,6 +590,12 @@ int main(int argc, char* argv[]) {
 
   printf("Simulation done\n");
   printf("Produced %i ms of audio\n", time_now_ms - start_time_ms);
+  const int64_t wall_clock_ms = std::max<int64_t>(
+      webrtc::TickTime::MillisecondTimestamp() - wall_clock_start_ms, 1);
+  printf("Inserted %d packets in %d ms (%d packets/s, %.1f times real time)\n",
+         num_packets, static_cast<int>(wall_clock_ms),
+         static_cast<int>(num_packets * 1000 / wall_clock_ms),
+         static_cast<double>(time_now_ms - start_time_ms) / wall_clock_ms);
 
   delete neteq;
   webrtc::Trace::ReturnTrace();
@@ -35,6 +35,8 @@ class BitrateControllerImpl : public BitrateController {
 
   RtcpBandwidthObserver* CreateRtcpBandwidthObserver() override;
 
+  void UpdateDelayBasedEstimate(uint32_t bitrate_bps) override;
+
   void SetStartBitrate(int start_bitrate_bps) override;
   void SetMinMaxBitrate(int min_bitrate_bps,
                                 int max_bitrate_bps) override;
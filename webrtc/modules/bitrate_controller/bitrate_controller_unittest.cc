@@ -395,3 +395,35 @@ TEST_F(BitrateControllerTest, SetReservedBitrate) {
   bandwidth_observer_->OnReceivedEstimatedBitrate(1);
   EXPECT_EQ(100000, bitrate_observer_.last_bitrate_);
 }
+
+TEST_F(BitrateControllerTest, DelayBasedEstimateCapsLossBasedEstimate) {
+  int64_t time_ms = 1001;
+  webrtc::ReportBlockList report_blocks;
+  report_blocks.push_back(CreateReportBlock(1, 2, 0, 1));
+  bandwidth_observer_->OnReceivedRtcpReceiverReport(report_blocks, 50, time_ms);
+
+  // A lower delay-based estimate applies immediately.
+  controller_->UpdateDelayBasedEstimate(150000);
+  EXPECT_EQ(150000, bitrate_observer_.last_bitrate_);
+
+  // No packet loss would increase the bitrate, but not above the delay-based
+  // estimate.
+  time_ms += 2000;
+  report_blocks.clear();
+  report_blocks.push_back(CreateReportBlock(1, 2, 0, 21));
+  bandwidth_observer_->OnReceivedRtcpReceiverReport(report_blocks, 50, time_ms);
+  EXPECT_EQ(150000, bitrate_observer_.last_bitrate_);
+
+  // Once the delay-based estimate goes up, the bitrate can ramp again, and the
+  // lowest of the delay-based estimate and REMB applies.
+  controller_->UpdateDelayBasedEstimate(400000);
+  bandwidth_observer_->OnReceivedEstimatedBitrate(250000);
+  time_ms += 1000;
+  report_blocks.clear();
+  report_blocks.push_back(CreateReportBlock(1, 2, 0, 41));
+  bandwidth_observer_->OnReceivedRtcpReceiverReport(report_blocks, 50, time_ms);
+  EXPECT_EQ(163000, bitrate_observer_.last_bitrate_);
+
+  controller_->UpdateDelayBasedEstimate(1000);
+  EXPECT_EQ(100000, bitrate_observer_.last_bitrate_);  // Min cap.
+}
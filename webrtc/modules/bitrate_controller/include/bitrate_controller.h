@@ -53,6 +53,10 @@ class BitrateController : public Module {
 
   virtual RtcpBandwidthObserver* CreateRtcpBandwidthObserver() = 0;
 
+  // Caps the send-side estimate by the estimate of a delay-based estimator
+  // running on the sender (see DelayBasedBwe), in addition to REMB/TMMBR.
+  virtual void UpdateDelayBasedEstimate(uint32_t bitrate_bps) = 0;
+
   virtual void SetStartBitrate(int start_bitrate_bps) = 0;
   virtual void SetMinMaxBitrate(int min_bitrate_bps, int max_bitrate_bps) = 0;
 
@@ -32,6 +32,9 @@ class SendSideBandwidthEstimation {
   // Call when we receive a RTCP message with TMMBR or REMB.
   void UpdateReceiverEstimate(int64_t now_ms, uint32_t bandwidth);
 
+  // Call when the send-side delay-based estimator has a new estimate.
+  void UpdateDelayBasedEstimate(int64_t now_ms, uint32_t bitrate_bps);
+
   // Call when we receive a RTCP message with a ReceiveBlock.
   void UpdateReceiverBlock(uint8_t fraction_loss,
                            int64_t rtt,
@@ -50,7 +53,7 @@ class SendSideBandwidthEstimation {
   void UpdateUmaStats(int64_t now_ms, int64_t rtt, int lost_packets);
 
   // Returns the input bitrate capped to the thresholds defined by the max,
-  // min and incoming bandwidth.
+  // min, incoming and delay-based bandwidth.
   uint32_t CapBitrateToThresholds(int64_t now_ms, uint32_t bitrate);
 
   // Updates history of min bitrates.
@@ -74,6 +77,7 @@ class SendSideBandwidthEstimation {
   int64_t last_round_trip_time_ms_;
 
   uint32_t bwe_incoming_;
+  uint32_t delay_based_bitrate_bps_;
   int64_t time_last_decrease_ms_;
   int64_t first_report_time_ms_;
   int initially_lost_packets_;
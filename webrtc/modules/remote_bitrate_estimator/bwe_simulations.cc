@@ -445,6 +445,14 @@ TEST_P(BweSimulation, GccComparisonChoke) {
   gcc_test.RunChoke(kFullSendSideEstimator, capacities_kbps);
 }
 
+// Compares ramp-up time and queueing delay against REMB on the same link.
+TEST_P(BweSimulation, RembComparisonRampUp) {
+  const int kCapacityKbps = 2000;
+  RunRampUp(GetParam(), kCapacityKbps);
+  BweTest remb_test(false);
+  remb_test.RunRampUp(kRembEstimator, kCapacityKbps);
+}
+
 #endif  // BWE_TEST_LOGGING_COMPILE_TIME_ENABLE
 }  // namespace bwe
 }  // namespace testing
@@ -0,0 +1,114 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/remote_bitrate_estimator/delay_based_bwe.h"
+
+#include "webrtc/base/checks.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+
+namespace webrtc {
+namespace {
+// Send times are fed to the inter-arrival filter in milliseconds.
+const int kTimestampGroupLengthMs = 5;
+const double kTimestampToMs = 1.0;
+}  // namespace
+
+DelayBasedBwe::DelayBasedBwe(Clock* clock, uint32_t min_bitrate_bps)
+    : clock_(clock),
+      crit_sect_(CriticalSectionWrapper::CreateCriticalSection()),
+      inter_arrival_(kTimestampGroupLengthMs, kTimestampToMs, true),
+      estimator_(OverUseDetectorOptions()),
+      detector_(OverUseDetectorOptions()),
+      incoming_bitrate_(kBitrateWindowMs, 8000),
+      last_arrival_time_ms_(-1),
+      rate_control_(min_bitrate_bps),
+      last_update_ms_(-1) {
+  DCHECK(clock_);
+}
+
+DelayBasedBwe::~DelayBasedBwe() {}
+
+void DelayBasedBwe::SetStartBitrate(uint32_t start_bitrate_bps) {
+  CriticalSectionScoped cs(crit_sect_.get());
+  rate_control_.SetEstimate(start_bitrate_bps, clock_->TimeInMilliseconds());
+}
+
+bool DelayBasedBwe::IncomingPacketFeedbackVector(
+    const std::vector<PacketInfo>& packet_feedback_vector,
+    uint32_t* target_bitrate_bps) {
+  CriticalSectionScoped cs(crit_sect_.get());
+  bool overuse_detected = false;
+  for (const PacketInfo& packet_info : packet_feedback_vector)
+    overuse_detected |= IncomingPacketInfo(packet_info);
+  if (last_arrival_time_ms_ < 0)
+    return false;
+
+  const int64_t now_ms = clock_->TimeInMilliseconds();
+  const uint32_t incoming_bitrate_bps =
+      incoming_bitrate_.Rate(last_arrival_time_ms_);
+  // Same policy as on the receive side: react immediately to a new over-use,
+  // or to a continued over-use when the target is far off what gets through,
+  // and otherwise update at the interval REMB would be sent at.
+  bool update_estimate =
+      last_update_ms_ < 0 ||
+      now_ms - last_update_ms_ >= rate_control_.GetFeedbackInterval();
+  if (detector_.State() == kBwOverusing &&
+      (overuse_detected ||
+       rate_control_.TimeToReduceFurther(now_ms, incoming_bitrate_bps))) {
+    update_estimate = true;
+  }
+  if (!update_estimate)
+    return false;
+
+  const RateControlInput input(detector_.State(), incoming_bitrate_bps,
+                               estimator_.var_noise());
+  rate_control_.Update(&input, now_ms);
+  const uint32_t target_bitrate = rate_control_.UpdateBandwidthEstimate(now_ms);
+  last_update_ms_ = now_ms;
+  if (!rate_control_.ValidEstimate())
+    return false;
+  *target_bitrate_bps = target_bitrate;
+  return true;
+}
+
+bool DelayBasedBwe::IncomingPacketInfo(const PacketInfo& packet_info) {
+  incoming_bitrate_.Update(packet_info.payload_size,
+                           packet_info.arrival_time_ms);
+  last_arrival_time_ms_ = packet_info.arrival_time_ms;
+  const BandwidthUsage prior_state = detector_.State();
+
+  uint32_t ts_delta = 0;
+  int64_t t_delta = 0;
+  int size_delta = 0;
+  if (inter_arrival_.ComputeDeltas(
+          static_cast<uint32_t>(packet_info.send_time_ms),
+          packet_info.arrival_time_ms, packet_info.payload_size, &ts_delta,
+          &t_delta, &size_delta)) {
+    const double ts_delta_ms = ts_delta * kTimestampToMs;
+    estimator_.Update(t_delta, ts_delta_ms, size_delta, detector_.State());
+    detector_.Detect(estimator_.offset(), ts_delta_ms,
+                     estimator_.num_of_deltas(), packet_info.arrival_time_ms);
+  }
+  return prior_state != kBwOverusing && detector_.State() == kBwOverusing;
+}
+
+void DelayBasedBwe::OnRttUpdate(int64_t rtt_ms) {
+  CriticalSectionScoped cs(crit_sect_.get());
+  rate_control_.SetRtt(rtt_ms);
+}
+
+bool DelayBasedBwe::LatestEstimate(uint32_t* bitrate_bps) const {
+  CriticalSectionScoped cs(crit_sect_.get());
+  if (!rate_control_.ValidEstimate())
+    return false;
+  *bitrate_bps = rate_control_.LatestEstimate();
+  return true;
+}
+}  // namespace webrtc
@@ -0,0 +1,78 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_DELAY_BASED_BWE_H_
+#define WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_DELAY_BASED_BWE_H_
+
+#include <vector>
+
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/thread_annotations.h"
+#include "webrtc/modules/remote_bitrate_estimator/aimd_rate_control.h"
+#include "webrtc/modules/remote_bitrate_estimator/include/remote_bitrate_estimator.h"
+#include "webrtc/modules/remote_bitrate_estimator/inter_arrival.h"
+#include "webrtc/modules/remote_bitrate_estimator/overuse_detector.h"
+#include "webrtc/modules/remote_bitrate_estimator/overuse_estimator.h"
+#include "webrtc/modules/remote_bitrate_estimator/rate_statistics.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+
+namespace webrtc {
+
+class Clock;
+
+// Send-side delay-based bandwidth estimator. Runs the same inter-arrival
+// grouping, over-use estimator/detector and AIMD rate control as
+// RemoteBitrateEstimatorAbsSendTime, but on the sender, fed with per-packet
+// arrival feedback from the receiver. Send times are taken from the sender's
+// own SendTimeHistory in milliseconds, so they don't have to go through the
+// 24-bit abs-send-time format.
+class DelayBasedBwe {
+ public:
+  DelayBasedBwe(Clock* clock, uint32_t min_bitrate_bps);
+  ~DelayBasedBwe();
+
+  // Seeds the rate control with the bitrate the sender starts at, so that a
+  // valid estimate exists before the first over-use has been detected.
+  void SetStartBitrate(uint32_t start_bitrate_bps);
+
+  // Updates the estimate with a batch of feedback, in the order the packets
+  // were sent. |arrival_time_ms| is in the receiver's time base and
+  // |send_time_ms| in the sender's. Returns true and sets |target_bitrate_bps|
+  // when a new estimate is available.
+  bool IncomingPacketFeedbackVector(
+      const std::vector<PacketInfo>& packet_feedback_vector,
+      uint32_t* target_bitrate_bps);
+
+  void OnRttUpdate(int64_t rtt_ms);
+
+  // Returns true and sets |bitrate_bps| if a valid estimate exists.
+  bool LatestEstimate(uint32_t* bitrate_bps) const;
+
+ private:
+  // Returns true if an over-use was detected within this packet.
+  bool IncomingPacketInfo(const PacketInfo& packet_info)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
+
+  Clock* const clock_;
+  rtc::scoped_ptr<CriticalSectionWrapper> crit_sect_;
+  InterArrival inter_arrival_ GUARDED_BY(crit_sect_.get());
+  OveruseEstimator estimator_ GUARDED_BY(crit_sect_.get());
+  OveruseDetector detector_ GUARDED_BY(crit_sect_.get());
+  // Receive rate of the acknowledged packets, in the receiver's time base.
+  RateStatistics incoming_bitrate_ GUARDED_BY(crit_sect_.get());
+  int64_t last_arrival_time_ms_ GUARDED_BY(crit_sect_.get());
+  AimdRateControl rate_control_ GUARDED_BY(crit_sect_.get());
+  int64_t last_update_ms_ GUARDED_BY(crit_sect_.get());
+
+  DISALLOW_IMPLICIT_CONSTRUCTORS(DelayBasedBwe);
+};
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_DELAY_BASED_BWE_H_
@@ -0,0 +1,125 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/remote_bitrate_estimator/delay_based_bwe.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+
+namespace webrtc {
+
+namespace {
+const int64_t kStartTimeMs = 100000;
+const uint32_t kMinBitrateBps = 30000;
+const size_t kPacketSizeBytes = 1200;
+const int64_t kOneWayDelayMs = 50;
+const int64_t kFeedbackIntervalMs = 50;
+}  // namespace
+
+// Sends packets at the latest estimate over a single bottleneck link and
+// feeds the arrival times back to the estimator every kFeedbackIntervalMs,
+// the same way a transport-wide feedback receiver would.
+class DelayBasedBweTest : public ::testing::Test {
+ protected:
+  DelayBasedBweTest()
+      : clock_(kStartTimeMs * 1000),
+        bwe_(&clock_, kMinBitrateBps),
+        sequence_number_(0),
+        next_send_time_ms_(kStartTimeMs),
+        link_free_time_ms_(kStartTimeMs),
+        next_feedback_ms_(kStartTimeMs),
+        max_queueing_delay_ms_(0) {}
+
+  // Runs for |duration_ms| over a link of |capacity_bps| and returns the
+  // latest estimate.
+  uint32_t RunFor(int64_t duration_ms, uint32_t capacity_bps) {
+    const double kPacketSizeBits = 8.0 * kPacketSizeBytes;
+    const int64_t end_ms = clock_.TimeInMilliseconds() + duration_ms;
+    while (clock_.TimeInMilliseconds() < end_ms) {
+      const int64_t now_ms = clock_.TimeInMilliseconds();
+      uint32_t send_bitrate_bps = 0;
+      EXPECT_TRUE(bwe_.LatestEstimate(&send_bitrate_bps));
+      while (next_send_time_ms_ <= now_ms) {
+        double transmit_start_ms =
+            std::max(link_free_time_ms_, static_cast<double>(now_ms));
+        link_free_time_ms_ =
+            transmit_start_ms + 1000.0 * kPacketSizeBits / capacity_bps;
+        max_queueing_delay_ms_ =
+            std::max(max_queueing_delay_ms_,
+                     static_cast<int64_t>(transmit_start_ms) - now_ms);
+        in_flight_.push_back(PacketInfo(
+            static_cast<int64_t>(link_free_time_ms_) + kOneWayDelayMs, now_ms,
+            sequence_number_++, kPacketSizeBytes, true));
+        next_send_time_ms_ += 1000.0 * kPacketSizeBits / send_bitrate_bps;
+      }
+      if (now_ms >= next_feedback_ms_) {
+        std::vector<PacketInfo> feedback;
+        while (!in_flight_.empty() &&
+               in_flight_.front().arrival_time_ms <= now_ms) {
+          feedback.push_back(in_flight_.front());
+          in_flight_.pop_front();
+        }
+        uint32_t target_bitrate_bps = 0;
+        bwe_.IncomingPacketFeedbackVector(feedback, &target_bitrate_bps);
+        next_feedback_ms_ = now_ms + kFeedbackIntervalMs;
+      }
+      clock_.AdvanceTimeMilliseconds(1);
+    }
+    uint32_t bitrate_bps = 0;
+    EXPECT_TRUE(bwe_.LatestEstimate(&bitrate_bps));
+    return bitrate_bps;
+  }
+
+  SimulatedClock clock_;
+  DelayBasedBwe bwe_;
+  uint16_t sequence_number_;
+  double next_send_time_ms_;
+  double link_free_time_ms_;
+  int64_t next_feedback_ms_;
+  int64_t max_queueing_delay_ms_;
+  std::deque<PacketInfo> in_flight_;
+};
+
+TEST_F(DelayBasedBweTest, NoEstimateUntilStartBitrateIsSet) {
+  uint32_t bitrate_bps = 0;
+  EXPECT_FALSE(bwe_.LatestEstimate(&bitrate_bps));
+  std::vector<PacketInfo> empty_feedback;
+  EXPECT_FALSE(bwe_.IncomingPacketFeedbackVector(empty_feedback, &bitrate_bps));
+
+  // The rate control may add its minimum increase on top of the start bitrate.
+  bwe_.SetStartBitrate(300000);
+  EXPECT_TRUE(bwe_.LatestEstimate(&bitrate_bps));
+  EXPECT_NEAR(300000, static_cast<int>(bitrate_bps), 1000);
+}
+
+TEST_F(DelayBasedBweTest, IncreasesWhileNoQueueBuildsUp) {
+  const uint32_t kStartBitrateBps = 300000;
+  bwe_.SetStartBitrate(kStartBitrateBps);
+  uint32_t bitrate_bps = RunFor(10000, 5000000);
+  EXPECT_GT(bitrate_bps, kStartBitrateBps);
+  EXPECT_LT(max_queueing_delay_ms_, 10);
+}
+
+TEST_F(DelayBasedBweTest, BacksOffBelowCapacityWhenQueueBuildsUp) {
+  const uint32_t kCapacityBps = 500000;
+  bwe_.SetStartBitrate(2 * kCapacityBps);
+  RunFor(10000, kCapacityBps);
+  // Once the queue has been drained the estimate should stay around the
+  // capacity without building up a standing queue.
+  max_queueing_delay_ms_ = 0;
+  uint32_t bitrate_bps = RunFor(20000, kCapacityBps);
+  EXPECT_LE(bitrate_bps, kCapacityBps * 11 / 10);
+  EXPECT_GE(bitrate_bps, kCapacityBps / 2);
+  EXPECT_LT(max_queueing_delay_ms_, 200);
+}
+}  // namespace webrtc
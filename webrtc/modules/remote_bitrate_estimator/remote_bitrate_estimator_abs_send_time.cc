@@ -42,10 +42,11 @@ static const double kTimestampToMs = 1000.0 /
 
 // Removes the entries at |index| of |time| and |value|, if time[index] is
 // smaller than or equal to |deadline|. |time| must be sorted ascendingly.
+template <typename TimeContainer, typename ValueContainer>
 static void RemoveStaleEntries(
-    std::vector<int64_t>* time, std::vector<int>* value, int64_t deadline) {
+    TimeContainer* time, ValueContainer* value, int64_t deadline) {
   assert(time->size() == value->size());
-  std::vector<int64_t>::iterator end_of_removal = std::upper_bound(
+  typename TimeContainer::iterator end_of_removal = std::upper_bound(
       time->begin(), time->end(), deadline);
   size_t end_of_removal_index = end_of_removal - time->begin();
 
@@ -75,7 +76,7 @@ bool RemoteBitrateEstimatorAbsSendTime::IsWithinClusterBounds(
   }
 
   void RemoteBitrateEstimatorAbsSendTime::AddCluster(
-      std::list<Cluster>* clusters,
+      std::vector<Cluster>* clusters,
       Cluster* cluster) {
     cluster->send_mean_ms /= static_cast<float>(cluster->count);
     cluster->recv_mean_ms /= static_cast<float>(cluster->count);
@@ -103,6 +104,9 @@ bool RemoteBitrateEstimatorAbsSendTime::IsWithinClusterBounds(
         last_process_time_(-1),
         process_interval_ms_(kProcessIntervalMs),
         total_propagation_delta_ms_(0),
+        probes_(kMaxProbePackets + 1, Probe(0, 0, 0)),
+        probes_start_(0),
+        num_probes_(0),
         total_probes_received_(0),
         first_packet_time_ms_(-1) {
   assert(observer_);
@@ -110,43 +114,69 @@ bool RemoteBitrateEstimatorAbsSendTime::IsWithinClusterBounds(
   LOG(LS_INFO) << "RemoteBitrateEstimatorAbsSendTime: Instantiating.";
 }
 
-void RemoteBitrateEstimatorAbsSendTime::ComputeClusters(
-    std::list<Cluster>* clusters) const {
-  Cluster current;
-  int64_t prev_send_time = -1;
-  int64_t prev_recv_time = -1;
-  for (std::list<Probe>::const_iterator it = probes_.begin();
-       it != probes_.end();
-       ++it) {
-    if (prev_send_time >= 0) {
-      int send_delta_ms = it->send_time_ms - prev_send_time;
-      int recv_delta_ms = it->recv_time_ms - prev_recv_time;
-      if (send_delta_ms >= 1 && recv_delta_ms >= 1) {
-        ++current.num_above_min_delta;
-      }
-      if (!IsWithinClusterBounds(send_delta_ms, current)) {
-        if (current.count >= kMinClusterSize)
-          AddCluster(clusters, &current);
-        current = Cluster();
-      }
-      current.send_mean_ms += send_delta_ms;
-      current.recv_mean_ms += recv_delta_ms;
-      current.mean_size += it->payload_size;
-      ++current.count;
+void RemoteBitrateEstimatorAbsSendTime::AddProbe(const Probe& probe) {
+  if (num_probes_ > 0) {
+    const Probe& prev =
+        probes_[(probes_start_ + num_probes_ - 1) % probes_.size()];
+    int send_delta_ms = probe.send_time_ms - prev.send_time_ms;
+    int recv_delta_ms = probe.recv_time_ms - prev.recv_time_ms;
+    if (send_delta_ms >= 1 && recv_delta_ms >= 1) {
+      ++current_cluster_.num_above_min_delta;
     }
-    prev_send_time = it->send_time_ms;
-    prev_recv_time = it->recv_time_ms;
+    if (!IsWithinClusterBounds(send_delta_ms, current_cluster_)) {
+      if (current_cluster_.count >= kMinClusterSize)
+        AddCluster(&clusters_, &current_cluster_);
+      current_cluster_ = Cluster();
+    }
+    current_cluster_.send_mean_ms += send_delta_ms;
+    current_cluster_.recv_mean_ms += recv_delta_ms;
+    current_cluster_.mean_size += probe.payload_size;
+    ++current_cluster_.count;
+  }
+  if (num_probes_ == probes_.size()) {
+    probes_[probes_start_] = probe;
+    probes_start_ = (probes_start_ + 1) % probes_.size();
+  } else {
+    probes_[(probes_start_ + num_probes_) % probes_.size()] = probe;
+    ++num_probes_;
   }
-  if (current.count >= kMinClusterSize)
+}
+
+void RemoteBitrateEstimatorAbsSendTime::RemoveOldestProbe() {
+  // Only valid before any cluster has formed, see |probes_|.
+  assert(clusters_.empty());
+  size_t remaining = num_probes_ - 1;
+  probes_start_ = (probes_start_ + 1) % probes_.size();
+  num_probes_ = 0;
+  current_cluster_ = Cluster();
+  // Re-adding the probes in order writes each one back to the slot it is read
+  // from, so this rebuilds the clusters in place.
+  for (size_t i = 0; i < remaining; ++i)
+    AddProbe(probes_[(probes_start_ + i) % probes_.size()]);
+}
+
+void RemoteBitrateEstimatorAbsSendTime::ClearProbes() {
+  probes_start_ = 0;
+  num_probes_ = 0;
+  clusters_.clear();
+  current_cluster_ = Cluster();
+}
+
+void RemoteBitrateEstimatorAbsSendTime::ComputeClusters(
+    std::vector<Cluster>* clusters) const {
+  *clusters = clusters_;
+  if (current_cluster_.count >= kMinClusterSize) {
+    Cluster current = current_cluster_;
     AddCluster(clusters, &current);
+  }
 }
 
-std::list<Cluster>::const_iterator
+std::vector<Cluster>::const_iterator
 RemoteBitrateEstimatorAbsSendTime::FindBestProbe(
-    const std::list<Cluster>& clusters) const {
+    const std::vector<Cluster>& clusters) const {
   int highest_probe_bitrate_bps = 0;
-  std::list<Cluster>::const_iterator best_it = clusters.end();
-  for (std::list<Cluster>::const_iterator it = clusters.begin();
+  std::vector<Cluster>::const_iterator best_it = clusters.end();
+  for (std::vector<Cluster>::const_iterator it = clusters.begin();
        it != clusters.end();
        ++it) {
     if (it->send_mean_ms == 0 || it->recv_mean_ms == 0)
@@ -175,17 +205,17 @@ RemoteBitrateEstimatorAbsSendTime::FindBestProbe(
 }
 
 void RemoteBitrateEstimatorAbsSendTime::ProcessClusters(int64_t now_ms) {
-  std::list<Cluster> clusters;
+  std::vector<Cluster> clusters;
   ComputeClusters(&clusters);
   if (clusters.empty()) {
     // If we reach the max number of probe packets and still have no clusters,
     // we will remove the oldest one.
-    if (probes_.size() >= kMaxProbePackets)
-      probes_.pop_front();
+    if (num_probes_ >= kMaxProbePackets)
+      RemoveOldestProbe();
     return;
   }
 
-  std::list<Cluster>::const_iterator best_it = FindBestProbe(clusters);
+  std::vector<Cluster>::const_iterator best_it = FindBestProbe(clusters);
   if (best_it != clusters.end()) {
     int probe_bitrate_bps =
         std::min(best_it->GetSendBitrateBps(), best_it->GetRecvBitrateBps());
@@ -206,7 +236,7 @@ void RemoteBitrateEstimatorAbsSendTime::ProcessClusters(int64_t now_ms) {
   // Not probing and received non-probe packet, or finished with current set
   // of probes.
   if (clusters.size() >= kExpectedNumberOfProbes)
-    probes_.clear();
+    ClearProbes();
 }
 
 bool RemoteBitrateEstimatorAbsSendTime::IsBitrateImproving(
@@ -264,7 +294,7 @@ void RemoteBitrateEstimatorAbsSendTime::IncomingPacketInfo(
   const BandwidthUsage prior_state = detector_.State();
 
   if (first_packet_time_ms_ == -1)
-    first_packet_time_ms_ = clock_->TimeInMilliseconds();
+    first_packet_time_ms_ = now_ms;
 
   uint32_t ts_delta = 0;
   int64_t t_delta = 0;
@@ -280,16 +310,18 @@ void RemoteBitrateEstimatorAbsSendTime::IncomingPacketInfo(
     if (total_probes_received_ < kMaxProbePackets) {
       int send_delta_ms = -1;
       int recv_delta_ms = -1;
-      if (!probes_.empty()) {
-        send_delta_ms = send_time_ms - probes_.back().send_time_ms;
-        recv_delta_ms = arrival_time_ms - probes_.back().recv_time_ms;
+      if (num_probes_ > 0) {
+        const Probe& last_probe =
+            probes_[(probes_start_ + num_probes_ - 1) % probes_.size()];
+        send_delta_ms = send_time_ms - last_probe.send_time_ms;
+        recv_delta_ms = arrival_time_ms - last_probe.recv_time_ms;
       }
       LOG(LS_INFO) << "Probe packet received: send time=" << send_time_ms
                    << " ms, recv time=" << arrival_time_ms
                    << " ms, send delta=" << send_delta_ms
                    << " ms, recv delta=" << recv_delta_ms << " ms.";
     }
-    probes_.push_back(Probe(send_time_ms, arrival_time_ms, payload_size));
+    AddProbe(Probe(send_time_ms, arrival_time_ms, payload_size));
     ++total_probes_received_;
     ProcessClusters(now_ms);
   }
@@ -405,8 +437,11 @@ bool RemoteBitrateEstimatorAbsSendTime::GetStats(
     ReceiveBandwidthEstimatorStats* output) const {
   {
     CriticalSectionScoped cs(crit_sect_.get());
-    output->recent_propagation_time_delta_ms = recent_propagation_delta_ms_;
-    output->recent_arrival_time_ms = recent_update_time_ms_;
+    output->recent_propagation_time_delta_ms.assign(
+        recent_propagation_delta_ms_.begin(),
+        recent_propagation_delta_ms_.end());
+    output->recent_arrival_time_ms.assign(recent_update_time_ms_.begin(),
+                                          recent_update_time_ms_.end());
     output->total_propagation_time_delta_ms = total_propagation_delta_ms_;
   }
   RemoveStaleEntries(
@@ -422,8 +457,8 @@ void RemoteBitrateEstimatorAbsSendTime::UpdateStats(int propagation_delta_ms,
 
   // Remove the oldest entry if the size limit is reached.
   if (recent_update_time_ms_.size() == kPropagationDeltaQueueMaxSize) {
-    recent_update_time_ms_.erase(recent_update_time_ms_.begin());
-    recent_propagation_delta_ms_.erase(recent_propagation_delta_ms_.begin());
+    recent_update_time_ms_.pop_front();
+    recent_propagation_delta_ms_.pop_front();
   }
 
   recent_propagation_delta_ms_.push_back(propagation_delta_ms);
@@ -11,7 +11,7 @@
 #ifndef WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_REMOTE_BITRATE_ESTIMATOR_ABS_SEND_TIME_H_
 #define WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_REMOTE_BITRATE_ESTIMATOR_ABS_SEND_TIME_H_
 
-#include <list>
+#include <deque>
 #include <map>
 #include <vector>
 
@@ -24,6 +24,7 @@
 #include "webrtc/modules/remote_bitrate_estimator/overuse_estimator.h"
 #include "webrtc/modules/remote_bitrate_estimator/rate_statistics.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/test/testsupport/gtest_prod_util.h"
 
 namespace webrtc {
 
@@ -95,7 +96,7 @@ class RemoteBitrateEstimatorAbsSendTime : public RemoteBitrateEstimator {
   static bool IsWithinClusterBounds(int send_delta_ms,
                                     const Cluster& cluster_aggregate);
 
-  static void AddCluster(std::list<Cluster>* clusters, Cluster* cluster);
+  static void AddCluster(std::vector<Cluster>* clusters, Cluster* cluster);
 
   int Id() const;
 
@@ -115,10 +116,22 @@ class RemoteBitrateEstimatorAbsSendTime : public RemoteBitrateEstimator {
   void UpdateStats(int propagation_delta_ms, int64_t now_ms)
       EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
 
-  void ComputeClusters(std::list<Cluster>* clusters) const;
+  // Appends |probe| to |probes_| and folds it into the clusters, completing
+  // |current_cluster_| if the probe falls outside of its bounds.
+  void AddProbe(const Probe& probe) EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
 
-  std::list<Cluster>::const_iterator FindBestProbe(
-      const std::list<Cluster>& clusters) const
+  // Drops the oldest probe and rebuilds the clusters from the rest.
+  void RemoveOldestProbe() EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
+
+  void ClearProbes() EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
+
+  // Returns the completed clusters followed by the current one, if it has
+  // enough probes to count as a cluster.
+  void ComputeClusters(std::vector<Cluster>* clusters) const
+      EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
+
+  std::vector<Cluster>::const_iterator FindBestProbe(
+      const std::vector<Cluster>& clusters) const
       EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
 
   void ProcessClusters(int64_t now_ms)
@@ -137,15 +150,29 @@ class RemoteBitrateEstimatorAbsSendTime : public RemoteBitrateEstimator {
   RateStatistics incoming_bitrate_ GUARDED_BY(crit_sect_.get());
   AimdRateControl remote_rate_ GUARDED_BY(crit_sect_.get());
   int64_t last_process_time_;
-  std::vector<int> recent_propagation_delta_ms_ GUARDED_BY(crit_sect_.get());
-  std::vector<int64_t> recent_update_time_ms_ GUARDED_BY(crit_sect_.get());
+  std::deque<int> recent_propagation_delta_ms_ GUARDED_BY(crit_sect_.get());
+  std::deque<int64_t> recent_update_time_ms_ GUARDED_BY(crit_sect_.get());
   int64_t process_interval_ms_ GUARDED_BY(crit_sect_.get());
   int total_propagation_delta_ms_ GUARDED_BY(crit_sect_.get());
 
-  std::list<Probe> probes_;
+  // Ring buffer of the latest probes, the oldest at |probes_start_|. While no
+  // cluster has formed, the clusters are computed over up to kMaxProbePackets
+  // probes and the oldest one is then dropped, like the list this replaced.
+  // The ring has room for one more so that adding a probe never drops one on
+  // its own. Once a cluster has formed the probes are no longer needed, so
+  // older ones may be overwritten.
+  std::vector<Probe> probes_ GUARDED_BY(crit_sect_.get());
+  size_t probes_start_ GUARDED_BY(crit_sect_.get());
+  size_t num_probes_ GUARDED_BY(crit_sect_.get());
+  // Clusters completed since the probes were last cleared, and the running
+  // sums of the cluster the latest probes are part of.
+  std::vector<Cluster> clusters_ GUARDED_BY(crit_sect_.get());
+  Cluster current_cluster_ GUARDED_BY(crit_sect_.get());
   size_t total_probes_received_;
   int64_t first_packet_time_ms_;
 
+  FRIEND_TEST_ALL_PREFIXES(RemoteBitrateEstimatorAbsSendTimeTest,
+                           ProbeWindowSize);
   DISALLOW_IMPLICIT_CONSTRUCTORS(RemoteBitrateEstimatorAbsSendTime);
 };
 
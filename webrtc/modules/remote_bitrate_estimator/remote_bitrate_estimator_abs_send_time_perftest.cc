@@ -0,0 +1,64 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <vector>
+
+#include "webrtc/modules/remote_bitrate_estimator/remote_bitrate_estimator_abs_send_time.h"
+#include "webrtc/modules/remote_bitrate_estimator/remote_bitrate_estimator_unittest_helper.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+
+class RemoteBitrateEstimatorAbsSendTimePerfTest
+    : public RemoteBitrateEstimatorTest {
+ public:
+  void SetUp() override {
+    bitrate_estimator_.reset(new RemoteBitrateEstimatorAbsSendTime(
+        bitrate_observer_.get(), &clock_, 30000));
+  }
+};
+
+// Feeds a simulated minute of 20 Mbps spread over 30 streams of paced 1200
+// byte packets through the estimator, which includes the initial probing
+// interval where every packet is a probe candidate, and reports the wall
+// clock time spent per packet.
+TEST_F(RemoteBitrateEstimatorAbsSendTimePerfTest, ThirtyStreams) {
+  const int kNumStreams = 30;
+  const int kBitrateBps = 20000000;
+  const size_t kPacketSize = 1200;
+  const int64_t kDurationUs = 60 * 1000000;
+  const int64_t kPacketIntervalUs = kPacketSize * 8 * 1000000 / kBitrateBps;
+  Clock* real_clock = Clock::GetRealTimeClock();
+
+  int num_packets = 0;
+  int64_t send_time_us = 0;
+  int64_t start_us = real_clock->TimeInMicroseconds();
+  while (send_time_us < kDurationUs) {
+    clock_.AdvanceTimeMicroseconds(kPacketIntervalUs);
+    send_time_us += kPacketIntervalUs;
+    IncomingPacket(num_packets % kNumStreams, kPacketSize,
+                   clock_.TimeInMilliseconds(), 90 * send_time_us / 1000,
+                   AbsSendTime(send_time_us, 1000000), true);
+    if (bitrate_estimator_->TimeUntilNextProcess() <= 0)
+      bitrate_estimator_->Process();
+    ++num_packets;
+  }
+  int64_t elapsed_us = real_clock->TimeInMicroseconds() - start_us;
+
+  std::vector<unsigned int> ssrcs;
+  unsigned int bitrate_bps = 0;
+  EXPECT_TRUE(bitrate_estimator_->LatestEstimate(&ssrcs, &bitrate_bps));
+  EXPECT_EQ(static_cast<size_t>(kNumStreams), ssrcs.size());
+  test::PrintResult("abs_send_time_incoming_packet", "", "thirty_streams",
+                    static_cast<size_t>(elapsed_us * 1000 / num_packets),
+                    "ns/packet", true);
+}
+
+}  // namespace webrtc
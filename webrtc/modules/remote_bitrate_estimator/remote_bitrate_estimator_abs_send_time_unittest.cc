@@ -8,6 +8,8 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <algorithm>
+
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/modules/remote_bitrate_estimator/remote_bitrate_estimator_abs_send_time.h"
 #include "webrtc/modules/remote_bitrate_estimator/remote_bitrate_estimator_unittest_helper.h"
@@ -291,4 +293,66 @@ TEST_F(RemoteBitrateEstimatorAbsSendTimeTest, ProbingIgnoresSmallPackets) {
   EXPECT_TRUE(bitrate_observer_->updated());
   EXPECT_NEAR(bitrate_observer_->latest_bitrate(), 800000u, 10000);
 }
+
+TEST_F(RemoteBitrateEstimatorAbsSendTimeTest,
+       TestProbeDetectionAfterUnclusteredProbes) {
+  // Paced packets with send deltas alternating between 2 and 20 ms never form
+  // a cluster, so the oldest probes keep being dropped and the clusters
+  // rebuilt from the remaining ones, wrapping around the probe buffer.
+  int64_t send_time_ms = 0;
+  for (int i = 0; i < 40; ++i) {
+    int64_t delta_ms = (i % 2 == 0) ? 2 : 20;
+    clock_.AdvanceTimeMilliseconds(delta_ms);
+    send_time_ms += delta_ms;
+    IncomingPacket(0, 1000, clock_.TimeInMilliseconds(), 90 * send_time_ms,
+                   AbsSendTime(send_time_ms, 1000), true);
+  }
+
+  EXPECT_EQ(0, bitrate_estimator_->Process());
+  EXPECT_FALSE(bitrate_observer_->updated());
+
+  // A burst sent at 8 * 1000 / 10 = 800 kbps should still be detected.
+  for (int i = 0; i < 5; ++i) {
+    clock_.AdvanceTimeMilliseconds(10);
+    send_time_ms += 10;
+    IncomingPacket(0, 1000, clock_.TimeInMilliseconds(), 90 * send_time_ms,
+                   AbsSendTime(send_time_ms, 1000), true);
+  }
+
+  // Wait long enough so that we can call Process again.
+  clock_.AdvanceTimeMilliseconds(1000);
+
+  EXPECT_EQ(0, bitrate_estimator_->Process());
+  EXPECT_TRUE(bitrate_observer_->updated());
+  EXPECT_NEAR(bitrate_observer_->latest_bitrate(), 800000u, 10000);
+}
+
+TEST_F(RemoteBitrateEstimatorAbsSendTimeTest, ProbeWindowSize) {
+  RemoteBitrateEstimatorAbsSendTime* estimator =
+      static_cast<RemoteBitrateEstimatorAbsSendTime*>(bitrate_estimator_.get());
+  // Unclustered probes are searched for clusters 15 at a time, after which the
+  // oldest is dropped, so only the latest 14 are kept between packets.
+  const size_t kProbeWindow = 14;
+  const int kNumProbes = 20;
+  int64_t arrival_times_ms[kNumProbes];
+  int64_t send_time_ms = 0;
+  for (int i = 0; i < kNumProbes; ++i) {
+    int64_t delta_ms = (i % 2 == 0) ? 2 : 20;
+    clock_.AdvanceTimeMilliseconds(delta_ms);
+    send_time_ms += delta_ms;
+    arrival_times_ms[i] = clock_.TimeInMilliseconds();
+    IncomingPacket(0, 1000, arrival_times_ms[i], 90 * send_time_ms,
+                   AbsSendTime(send_time_ms, 1000), true);
+    EXPECT_EQ(std::min<size_t>(i + 1, kProbeWindow), estimator->num_probes_);
+  }
+  EXPECT_TRUE(estimator->clusters_.empty());
+  // The kept probes span from the oldest one in the window to the newest.
+  const Probe& oldest = estimator->probes_[estimator->probes_start_];
+  const Probe& newest = estimator->probes_[
+      (estimator->probes_start_ + kProbeWindow - 1) %
+      estimator->probes_.size()];
+  EXPECT_EQ(arrival_times_ms[kNumProbes - 1] -
+                arrival_times_ms[kNumProbes - kProbeWindow],
+            newest.recv_time_ms - oldest.recv_time_ms);
+}
 }  // namespace webrtc
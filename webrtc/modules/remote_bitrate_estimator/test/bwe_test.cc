@@ -433,6 +433,43 @@ void BweTest::RunChoke(BandwidthEstimatorType bwe_type,
   // receiver.PlotObjectiveHistogram(title, bwe_names[bwe_type], 1);
 }
 
+// Starts a single paced flow at 300 kbps on an otherwise idle bottleneck and
+// reports the time it takes to reach 90% of the capacity (capped at
+// kMaxRampUpTimeMs), together with the end-to-end delay while ramping up and
+// over the whole run.
+void BweTest::RunRampUp(BandwidthEstimatorType bwe_type, int capacity_kbps) {
+  const int kFlowId = bwe_type;
+  const int64_t kStepMs = 100;
+  const int64_t kMaxRampUpTimeMs = 30 * 1000;
+  const int64_t kRunTimeMs = 60 * 1000;
+
+  AdaptiveVideoSource source(kFlowId, 30, 300, 0, 0);
+  PacedVideoSender sender(&uplink_, &source, bwe_type);
+  DefaultEvaluationFilter filter(&uplink_, kFlowId);
+  PacketReceiver receiver(&uplink_, kFlowId, bwe_type, true, true);
+  filter.choke.set_capacity_kbps(capacity_kbps);
+
+  int64_t elapsed_ms = 0;
+  while (elapsed_ms < kMaxRampUpTimeMs &&
+         source.bits_per_second() < 900u * capacity_kbps) {
+    RunFor(kStepMs);
+    elapsed_ms += kStepMs;
+  }
+  Stats<double> ramp_up_delay_ms = receiver.GetDelayStats();
+  RunFor(kRunTimeMs - elapsed_ms);
+
+  const std::string name = bwe_names[bwe_type];
+  webrtc::test::PrintResult("BwePerformance", GetTestName(),
+                            "Ramp-up time " + name,
+                            static_cast<size_t>(elapsed_ms), "ms", false);
+  webrtc::test::PrintResultMeanAndError(
+      "BwePerformance", GetTestName(), "Ramp-up delay " + name,
+      ramp_up_delay_ms.AsString(), "ms", false);
+  webrtc::test::PrintResultMeanAndError(
+      "BwePerformance", GetTestName(), "Delay " + name,
+      receiver.GetDelayStats().AsString(), "ms", false);
+}
+
 // 5.1. Single Video and Audio media traffic, forward direction.
 void BweTest::RunVariableCapacity1SingleFlow(BandwidthEstimatorType bwe_type) {
   const int kFlowId = 0;  // Arbitrary value.
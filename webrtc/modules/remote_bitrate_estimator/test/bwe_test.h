@@ -73,6 +73,8 @@ class BweTest {
   void RunChoke(BandwidthEstimatorType bwe_type,
                 std::vector<int> capacities_kbps);
 
+  void RunRampUp(BandwidthEstimatorType bwe_type, int capacity_kbps);
+
   void RunVariableCapacity1SingleFlow(BandwidthEstimatorType bwe_type);
   void RunVariableCapacity2MultipleFlows(BandwidthEstimatorType bwe_type,
                                          size_t num_flows);
@@ -11,7 +11,6 @@
 #include "webrtc/modules/remote_bitrate_estimator/test/estimators/send_side.h"
 
 #include "webrtc/base/logging.h"
-#include "webrtc/modules/remote_bitrate_estimator/remote_bitrate_estimator_abs_send_time.h"
 #include "webrtc/modules/remote_bitrate_estimator/test/bwe_test_logging.h"
 
 namespace webrtc {
@@ -23,9 +22,7 @@ const int kFeedbackIntervalMs = 50;
 FullBweSender::FullBweSender(int kbps, BitrateObserver* observer, Clock* clock)
     : bitrate_controller_(
           BitrateController::CreateBitrateController(clock, observer)),
-      rbe_(new RemoteBitrateEstimatorAbsSendTime(this,
-                                                 clock,
-                                                 1000 * kMinBitrateKbps)),
+      delay_based_bwe_(clock, 1000 * kMinBitrateKbps),
       feedback_observer_(bitrate_controller_->CreateRtcpBandwidthObserver()),
       clock_(clock),
       send_time_history_(10000),
@@ -34,6 +31,7 @@ FullBweSender::FullBweSender(int kbps, BitrateObserver* observer, Clock* clock)
   assert(kbps >= kMinBitrateKbps);
   assert(kbps <= kMaxBitrateKbps);
   bitrate_controller_->SetStartBitrate(1000 * kbps);
+  delay_based_bwe_.SetStartBitrate(1000 * kbps);
   bitrate_controller_->SetMinMaxBitrate(1000 * kMinBitrateKbps,
                                         1000 * kMaxBitrateKbps);
 }
@@ -59,10 +57,14 @@ void FullBweSender::GiveFeedback(const FeedbackPacket& feedback) {
 
   int64_t rtt_ms =
       clock_->TimeInMilliseconds() - feedback.latest_send_time_ms();
-  rbe_->OnRttUpdate(rtt_ms, rtt_ms);
+  delay_based_bwe_.OnRttUpdate(rtt_ms);
   BWE_TEST_LOGGING_PLOT(1, "RTT", clock_->TimeInMilliseconds(), rtt_ms);
 
-  rbe_->IncomingPacketFeedbackVector(packet_feedback_vector);
+  uint32_t delay_based_bitrate_bps = 0;
+  if (delay_based_bwe_.IncomingPacketFeedbackVector(packet_feedback_vector,
+                                                    &delay_based_bitrate_bps)) {
+    bitrate_controller_->UpdateDelayBasedEstimate(delay_based_bitrate_bps);
+  }
   if (has_received_ack_) {
     int expected_packets = fb.packet_feedback_vector().back().sequence_number -
                            last_acked_seq_num_;
@@ -101,18 +103,11 @@ void FullBweSender::OnPacketsSent(const Packets& packets) {
   }
 }
 
-void FullBweSender::OnReceiveBitrateChanged(
-    const std::vector<unsigned int>& ssrcs,
-    unsigned int bitrate) {
-  feedback_observer_->OnReceivedEstimatedBitrate(bitrate);
-}
-
 int64_t FullBweSender::TimeUntilNextProcess() {
   return bitrate_controller_->TimeUntilNextProcess();
 }
 
 int FullBweSender::Process() {
-  rbe_->Process();
   return bitrate_controller_->Process();
 }
 
@@ -13,6 +13,7 @@
 
 #include <vector>
 
+#include "webrtc/modules/remote_bitrate_estimator/delay_based_bwe.h"
 #include "webrtc/modules/remote_bitrate_estimator/include/send_time_history.h"
 #include "webrtc/modules/remote_bitrate_estimator/test/bwe.h"
 
@@ -20,7 +21,7 @@ namespace webrtc {
 namespace testing {
 namespace bwe {
 
-class FullBweSender : public BweSender, public RemoteBitrateObserver {
+class FullBweSender : public BweSender {
  public:
   FullBweSender(int kbps, BitrateObserver* observer, Clock* clock);
   virtual ~FullBweSender();
@@ -28,14 +29,12 @@ class FullBweSender : public BweSender, public RemoteBitrateObserver {
   int GetFeedbackIntervalMs() const override;
   void GiveFeedback(const FeedbackPacket& feedback) override;
   void OnPacketsSent(const Packets& packets) override;
-  void OnReceiveBitrateChanged(const std::vector<unsigned int>& ssrcs,
-                               unsigned int bitrate) override;
   int64_t TimeUntilNextProcess() override;
   int Process() override;
 
  protected:
   rtc::scoped_ptr<BitrateController> bitrate_controller_;
-  rtc::scoped_ptr<RemoteBitrateEstimator> rbe_;
+  DelayBasedBwe delay_based_bwe_;
   rtc::scoped_ptr<RtcpBandwidthObserver> feedback_observer_;
 
  private:
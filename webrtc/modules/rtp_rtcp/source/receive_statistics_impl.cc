@@ -12,6 +12,7 @@
 
 #include <math.h>
 
+#include "webrtc/base/atomicops.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/modules/rtp_rtcp/source/bitrate.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_utility.h"
@@ -54,14 +55,23 @@ StreamStatisticianImpl::StreamStatisticianImpl(
 void StreamStatisticianImpl::IncomingPacket(const RTPHeader& header,
                                             size_t packet_length,
                                             bool retransmitted) {
-  UpdateCounters(header, packet_length, retransmitted);
-  NotifyRtpCallback();
+  // Copy the counters under the same lock as the update rather than locking
+  // a second time for the callback.
+  StreamDataCounters data;
+  uint32_t ssrc;
+  {
+    CriticalSectionScoped cs(stream_lock_.get());
+    UpdateCounters(header, packet_length, retransmitted);
+    data = receive_counters_;
+    ssrc = ssrc_;
+  }
+  rtp_callback_->DataCountersUpdated(data, ssrc);
 }
 
 void StreamStatisticianImpl::UpdateCounters(const RTPHeader& header,
                                             size_t packet_length,
                                             bool retransmitted) {
-  CriticalSectionScoped cs(stream_lock_.get());
+  int64_t now_ms = clock_->TimeInMilliseconds();
   bool in_order = InOrderPacketInternal(header.sequenceNumber);
   ssrc_ = header.ssrc;
   incoming_bitrate_.Update(packet_length);
@@ -72,7 +82,7 @@ void StreamStatisticianImpl::UpdateCounters(const RTPHeader& header,
 
   if (receive_counters_.transmitted.packets == 1) {
     received_seq_first_ = header.sequenceNumber;
-    receive_counters_.first_packet_time_ms = clock_->TimeInMilliseconds();
+    receive_counters_.first_packet_time_ms = now_ms;
   }
 
   // Count only the new packets received. That is, if packets 1, 2, 3, 5, 4, 6
@@ -102,7 +112,7 @@ void StreamStatisticianImpl::UpdateCounters(const RTPHeader& header,
     last_received_timestamp_ = header.timestamp;
     last_receive_time_secs_ = receive_time_secs;
     last_receive_time_frac_ = receive_time_frac;
-    last_receive_time_ms_ = clock_->TimeInMilliseconds();
+    last_receive_time_ms_ = now_ms;
   }
 
   size_t packet_oh = header.headerLength + header.paddingLength;
@@ -154,17 +164,6 @@ void StreamStatisticianImpl::UpdateJitter(const RTPHeader& header,
   }
 }
 
-void StreamStatisticianImpl::NotifyRtpCallback() {
-  StreamDataCounters data;
-  uint32_t ssrc;
-  {
-    CriticalSectionScoped cs(stream_lock_.get());
-    data = receive_counters_;
-    ssrc = ssrc_;
-  }
-  rtp_callback_->DataCountersUpdated(data, ssrc);
-}
-
 void StreamStatisticianImpl::NotifyRtcpCallback() {
   RtcpStatistics data;
   uint32_t ssrc;
@@ -178,11 +177,15 @@ void StreamStatisticianImpl::NotifyRtcpCallback() {
 
 void StreamStatisticianImpl::FecPacketReceived(const RTPHeader& header,
                                                size_t packet_length) {
+  StreamDataCounters data;
+  uint32_t ssrc;
   {
     CriticalSectionScoped cs(stream_lock_.get());
     receive_counters_.fec.AddPacket(packet_length, header);
+    data = receive_counters_;
+    ssrc = ssrc_;
   }
-  NotifyRtpCallback();
+  rtp_callback_->DataCountersUpdated(data, ssrc);
 }
 
 void StreamStatisticianImpl::SetMaxReorderingThreshold(
@@ -384,16 +387,25 @@ ReceiveStatistics* ReceiveStatistics::Create(Clock* clock) {
 
 ReceiveStatisticsImpl::ReceiveStatisticsImpl(Clock* clock)
     : clock_(clock),
+      statisticians_lock_(RWLockWrapper::CreateRWLock()),
       receive_statistics_lock_(CriticalSectionWrapper::CreateCriticalSection()),
       last_rate_update_ms_(0),
       rtcp_stats_callback_(NULL),
       rtp_stats_callback_(NULL) {}
 
 ReceiveStatisticsImpl::~ReceiveStatisticsImpl() {
-  while (!statisticians_.empty()) {
-    delete statisticians_.begin()->second;
-    statisticians_.erase(statisticians_.begin());
-  }
+  for (const auto& it : statisticians_)
+    delete it.second;
+}
+
+StreamStatisticianImpl* ReceiveStatisticsImpl::FindStatistician(
+    uint32_t ssrc) const {
+  StatisticianImplList::const_iterator it = std::lower_bound(
+      statisticians_.begin(), statisticians_.end(),
+      std::make_pair(ssrc, static_cast<StreamStatisticianImpl*>(NULL)));
+  if (it == statisticians_.end() || it->first != ssrc)
+    return NULL;
+  return it->second;
 }
 
 void ReceiveStatisticsImpl::IncomingPacket(const RTPHeader& header,
@@ -401,43 +413,49 @@ void ReceiveStatisticsImpl::IncomingPacket(const RTPHeader& header,
                                            bool retransmitted) {
   StreamStatisticianImpl* impl;
   {
-    CriticalSectionScoped cs(receive_statistics_lock_.get());
-    StatisticianImplMap::iterator it = statisticians_.find(header.ssrc);
-    if (it != statisticians_.end()) {
-      impl = it->second;
-    } else {
+    ReadLockScoped rl(*statisticians_lock_);
+    impl = FindStatistician(header.ssrc);
+  }
+  if (!impl) {
+    WriteLockScoped wl(*statisticians_lock_);
+    // Another thread may have added the SSRC since the lookup above.
+    impl = FindStatistician(header.ssrc);
+    if (!impl) {
       impl = new StreamStatisticianImpl(clock_, this, this);
-      statisticians_[header.ssrc] = impl;
+      statisticians_.insert(
+          std::lower_bound(statisticians_.begin(), statisticians_.end(),
+                           std::make_pair(header.ssrc, impl)),
+          std::make_pair(header.ssrc, impl));
     }
   }
   // StreamStatisticianImpl instance is created once and only destroyed when
   // this whole ReceiveStatisticsImpl is destroyed. StreamStatisticianImpl has
-  // it's own locking so don't hold receive_statistics_lock_ (potential
-  // deadlock).
+  // it's own locking so don't hold statisticians_lock_ (potential deadlock).
   impl->IncomingPacket(header, packet_length, retransmitted);
 }
 
 void ReceiveStatisticsImpl::FecPacketReceived(const RTPHeader& header,
                                               size_t packet_length) {
-  CriticalSectionScoped cs(receive_statistics_lock_.get());
-  StatisticianImplMap::iterator it = statisticians_.find(header.ssrc);
-  // Ignore FEC if it is the first packet.
-  if (it != statisticians_.end()) {
-    it->second->FecPacketReceived(header, packet_length);
+  StreamStatisticianImpl* impl;
+  {
+    ReadLockScoped rl(*statisticians_lock_);
+    impl = FindStatistician(header.ssrc);
   }
+  // Ignore FEC if it is the first packet.
+  if (impl)
+    impl->FecPacketReceived(header, packet_length);
 }
 
 StatisticianMap ReceiveStatisticsImpl::GetActiveStatisticians() const {
-  CriticalSectionScoped cs(receive_statistics_lock_.get());
+  ReadLockScoped rl(*statisticians_lock_);
   StatisticianMap active_statisticians;
-  for (StatisticianImplMap::const_iterator it = statisticians_.begin();
-       it != statisticians_.end(); ++it) {
+  int64_t now_ms = clock_->CurrentNtpInMilliseconds();
+  for (const auto& it : statisticians_) {
     uint32_t secs;
     uint32_t frac;
-    it->second->LastReceiveTimeNtp(&secs, &frac);
-    if (clock_->CurrentNtpInMilliseconds() -
-        Clock::NtpToMs(secs, frac) < kStatisticsTimeoutMs) {
-      active_statisticians[it->first] = it->second;
+    it.second->LastReceiveTimeNtp(&secs, &frac);
+    if (now_ms - Clock::NtpToMs(secs, frac) < kStatisticsTimeoutMs) {
+      active_statisticians.insert(active_statisticians.end(), it);
     }
   }
   return active_statisticians;
@@ -445,28 +463,24 @@ StatisticianMap ReceiveStatisticsImpl::GetActiveStatisticians() const {
 
 StreamStatistician* ReceiveStatisticsImpl::GetStatistician(
     uint32_t ssrc) const {
-  CriticalSectionScoped cs(receive_statistics_lock_.get());
-  StatisticianImplMap::const_iterator it = statisticians_.find(ssrc);
-  if (it == statisticians_.end())
-    return NULL;
-  return it->second;
+  ReadLockScoped rl(*statisticians_lock_);
+  return FindStatistician(ssrc);
 }
 
 void ReceiveStatisticsImpl::SetMaxReorderingThreshold(
     int max_reordering_threshold) {
-  CriticalSectionScoped cs(receive_statistics_lock_.get());
-  for (StatisticianImplMap::iterator it = statisticians_.begin();
-       it != statisticians_.end(); ++it) {
-    it->second->SetMaxReorderingThreshold(max_reordering_threshold);
-  }
+  ReadLockScoped rl(*statisticians_lock_);
+  for (const auto& it : statisticians_)
+    it.second->SetMaxReorderingThreshold(max_reordering_threshold);
 }
 
 int32_t ReceiveStatisticsImpl::Process() {
-  CriticalSectionScoped cs(receive_statistics_lock_.get());
-  for (StatisticianImplMap::iterator it = statisticians_.begin();
-       it != statisticians_.end(); ++it) {
-    it->second->ProcessBitrate();
+  {
+    ReadLockScoped rl(*statisticians_lock_);
+    for (const auto& it : statisticians_)
+      it.second->ProcessBitrate();
   }
+  CriticalSectionScoped cs(receive_statistics_lock_.get());
   last_rate_update_ms_ = clock_->TimeInMilliseconds();
   return 0;
 }
@@ -502,18 +516,17 @@ void ReceiveStatisticsImpl::CNameChanged(const char* cname, uint32_t ssrc) {
 
 void ReceiveStatisticsImpl::RegisterRtpStatisticsCallback(
     StreamDataCountersCallback* callback) {
-  CriticalSectionScoped cs(receive_statistics_lock_.get());
   if (callback != NULL)
-    assert(rtp_stats_callback_ == NULL);
-  rtp_stats_callback_ = callback;
+    assert(rtc::AtomicOps::AcquireLoadPtr(&rtp_stats_callback_) == NULL);
+  rtc::AtomicOps::ReleaseStorePtr(&rtp_stats_callback_, callback);
 }
 
 void ReceiveStatisticsImpl::DataCountersUpdated(const StreamDataCounters& stats,
                                                 uint32_t ssrc) {
-  CriticalSectionScoped cs(receive_statistics_lock_.get());
-  if (rtp_stats_callback_) {
-    rtp_stats_callback_->DataCountersUpdated(stats, ssrc);
-  }
+  StreamDataCountersCallback* callback =
+      rtc::AtomicOps::AcquireLoadPtr(&rtp_stats_callback_);
+  if (callback)
+    callback->DataCountersUpdated(stats, ssrc);
 }
 
 void NullReceiveStatistics::IncomingPacket(const RTPHeader& rtp_header,
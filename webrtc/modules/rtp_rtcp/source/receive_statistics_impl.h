@@ -14,10 +14,13 @@
 #include "webrtc/modules/rtp_rtcp/interface/receive_statistics.h"
 
 #include <algorithm>
+#include <utility>
+#include <vector>
 
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/modules/rtp_rtcp/source/bitrate.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/rw_lock_wrapper.h"
 
 namespace webrtc {
 
@@ -56,8 +59,8 @@ class StreamStatisticianImpl : public StreamStatistician {
                     uint32_t receive_time_frac);
   void UpdateCounters(const RTPHeader& rtp_header,
                       size_t packet_length,
-                      bool retransmitted);
-  void NotifyRtpCallback() LOCKS_EXCLUDED(stream_lock_.get());
+                      bool retransmitted)
+      EXCLUSIVE_LOCKS_REQUIRED(stream_lock_.get());
   void NotifyRtcpCallback() LOCKS_EXCLUDED(stream_lock_.get());
 
   Clock* clock_;
@@ -129,15 +132,28 @@ class ReceiveStatisticsImpl : public ReceiveStatistics,
   void DataCountersUpdated(const StreamDataCounters& counters,
                            uint32_t ssrc) override;
 
-  typedef std::map<uint32_t, StreamStatisticianImpl*> StatisticianImplMap;
+  // Sorted by SSRC. Statisticians are only added, and only deleted along
+  // with this object, so a pointer found under the read lock stays valid.
+  typedef std::vector<std::pair<uint32_t, StreamStatisticianImpl*>>
+      StatisticianImplList;
+
+  StreamStatisticianImpl* FindStatistician(uint32_t ssrc) const
+      SHARED_LOCKS_REQUIRED(statisticians_lock_.get());
 
   Clock* clock_;
-  rtc::scoped_ptr<CriticalSectionWrapper> receive_statistics_lock_;
-  int64_t last_rate_update_ms_;
-  StatisticianImplMap statisticians_;
+  // Taken exclusively only when a new SSRC shows up. Packets for known SSRCs
+  // take it shared, and otherwise only take their own statistician's lock.
+  rtc::scoped_ptr<RWLockWrapper> statisticians_lock_;
+  StatisticianImplList statisticians_ GUARDED_BY(statisticians_lock_.get());
 
-  RtcpStatisticsCallback* rtcp_stats_callback_;
-  StreamDataCountersCallback* rtp_stats_callback_;
+  rtc::scoped_ptr<CriticalSectionWrapper> receive_statistics_lock_;
+  int64_t last_rate_update_ms_ GUARDED_BY(receive_statistics_lock_.get());
+  RtcpStatisticsCallback* rtcp_stats_callback_
+      GUARDED_BY(receive_statistics_lock_.get());
+  // Called for every packet, so it is read without a lock. It is registered
+  // before packets are received, and may be called once more after it has
+  // been unregistered if packets are received concurrently.
+  StreamDataCountersCallback* volatile rtp_stats_callback_;
 };
 }  // namespace webrtc
 #endif  // WEBRTC_MODULES_RTP_RTCP_SOURCE_RECEIVE_STATISTICS_IMPL_H_
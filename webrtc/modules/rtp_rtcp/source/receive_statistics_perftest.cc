@@ -0,0 +1,174 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/rtp_rtcp/interface/receive_statistics.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+const size_t kPacketSize = 100;
+const uint32_t kFirstSsrc = 1;
+
+class CountingDataCountersCallback : public StreamDataCountersCallback {
+ public:
+  CountingDataCountersCallback() : num_calls_(0) {}
+
+  void DataCountersUpdated(const StreamDataCounters& counters,
+                           uint32_t ssrc) override {
+    rtc::AtomicOps::Increment(&num_calls_);
+  }
+
+  volatile int num_calls_;
+};
+
+// Receives |num_packets| packets on one SSRC from its own thread.
+class PacketReceiverThread {
+ public:
+  PacketReceiverThread(ReceiveStatistics* receive_statistics,
+                       uint32_t ssrc,
+                       int num_packets)
+      : receive_statistics_(receive_statistics),
+        num_packets_(num_packets),
+        thread_(ThreadWrapper::CreateThread(Run, this, "PacketReceiver")) {
+    memset(&header_, 0, sizeof(header_));
+    header_.ssrc = ssrc;
+    header_.sequenceNumber = 100;
+    header_.headerLength = 12;
+    header_.payload_type_frequency = 90000;
+  }
+
+  void Start() { EXPECT_TRUE(thread_->Start()); }
+  void Stop() { EXPECT_TRUE(thread_->Stop()); }
+
+ private:
+  static bool Run(void* obj) {
+    PacketReceiverThread* self = static_cast<PacketReceiverThread*>(obj);
+    for (int i = 0; i < self->num_packets_; ++i) {
+      self->receive_statistics_->IncomingPacket(self->header_, kPacketSize,
+                                                false);
+      ++self->header_.sequenceNumber;
+      self->header_.timestamp += 90;
+    }
+    return false;
+  }
+
+  ReceiveStatistics* const receive_statistics_;
+  const int num_packets_;
+  RTPHeader header_;
+  rtc::scoped_ptr<ThreadWrapper> thread_;
+};
+
+}  // namespace
+
+// Measures the cost of IncomingPacket with a data counters callback
+// registered, for a single SSRC and for 200 SSRCs received round robin.
+// Once per simulated second the statistics are processed and an RTCP report
+// is generated for every active stream, like the RTP/RTCP module does.
+TEST(ReceiveStatisticsPerfTest, IncomingPacket) {
+  const int kNumPackets = 200000;
+  const int64_t kPacketIntervalUs = 50;
+  Clock* real_clock = Clock::GetRealTimeClock();
+
+  for (uint32_t num_ssrcs : {1u, 200u}) {
+    SimulatedClock clock(0);
+    rtc::scoped_ptr<ReceiveStatistics> receive_statistics(
+        ReceiveStatistics::Create(&clock));
+    CountingDataCountersCallback callback;
+    receive_statistics->RegisterRtpStatisticsCallback(&callback);
+    std::vector<RTPHeader> headers(num_ssrcs);
+    for (uint32_t i = 0; i < num_ssrcs; ++i) {
+      memset(&headers[i], 0, sizeof(headers[i]));
+      headers[i].ssrc = kFirstSsrc + i;
+      headers[i].sequenceNumber = 100;
+      headers[i].headerLength = 12;
+      headers[i].payload_type_frequency = 90000;
+    }
+
+    int64_t next_report_ms = clock.TimeInMilliseconds() + 1000;
+    int num_reports = 0;
+    int64_t start_us = real_clock->TimeInMicroseconds();
+    for (int i = 0; i < kNumPackets; ++i) {
+      RTPHeader& header = headers[i % num_ssrcs];
+      receive_statistics->IncomingPacket(header, kPacketSize, false);
+      ++header.sequenceNumber;
+      header.timestamp += 90;
+      clock.AdvanceTimeMicroseconds(kPacketIntervalUs);
+      if (clock.TimeInMilliseconds() >= next_report_ms) {
+        receive_statistics->Process();
+        StatisticianMap statisticians =
+            receive_statistics->GetActiveStatisticians();
+        for (const auto& it : statisticians) {
+          RtcpStatistics statistics;
+          if (it.second->GetStatistics(&statistics, true))
+            ++num_reports;
+        }
+        next_report_ms += 1000;
+      }
+    }
+    int64_t elapsed_us = real_clock->TimeInMicroseconds() - start_us;
+
+    EXPECT_EQ(kNumPackets, callback.num_calls_);
+    EXPECT_EQ(static_cast<int>(num_ssrcs) *
+                  (kNumPackets * kPacketIntervalUs / 1000000),
+              num_reports);
+    test::PrintResult("receive_statistics_incoming_packet", "",
+                      num_ssrcs == 1 ? "one_ssrc" : "many_ssrcs",
+                      static_cast<size_t>(elapsed_us * 1000 / kNumPackets),
+                      "ns/packet", true);
+  }
+}
+
+// Measures IncomingPacket with four threads each receiving its own SSRC on a
+// shared ReceiveStatistics, as when streams are received on different
+// network threads. Packets for different SSRCs should not contend on a
+// shared lock.
+TEST(ReceiveStatisticsPerfTest, IncomingPacketOnFourThreads) {
+  const int kNumThreads = 4;
+  const int kNumPacketsPerThread = 50000;
+  Clock* clock = Clock::GetRealTimeClock();
+  rtc::scoped_ptr<ReceiveStatistics> receive_statistics(
+      ReceiveStatistics::Create(clock));
+  CountingDataCountersCallback callback;
+  receive_statistics->RegisterRtpStatisticsCallback(&callback);
+  std::vector<PacketReceiverThread*> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.push_back(new PacketReceiverThread(
+        receive_statistics.get(), kFirstSsrc + i, kNumPacketsPerThread));
+  }
+
+  int64_t start_us = clock->TimeInMicroseconds();
+  for (PacketReceiverThread* thread : threads)
+    thread->Start();
+  for (PacketReceiverThread* thread : threads) {
+    thread->Stop();
+    delete thread;
+  }
+  int64_t elapsed_us = clock->TimeInMicroseconds() - start_us;
+
+  const int kNumPackets = kNumThreads * kNumPacketsPerThread;
+  EXPECT_EQ(kNumPackets, callback.num_calls_);
+  EXPECT_EQ(static_cast<size_t>(kNumThreads),
+            receive_statistics->GetActiveStatisticians().size());
+  test::PrintResult("receive_statistics_incoming_packet", "", "four_threads",
+                    static_cast<size_t>(elapsed_us * 1000 / kNumPackets),
+                    "ns/packet", true);
+}
+
+}  // namespace webrtc
@@ -781,6 +781,10 @@ bool SenderReport::WithReportBlock(const ReportBlock& block) {
     LOG(LS_WARNING) << "Max report blocks reached.";
     return false;
   }
+  // Allocate room for the maximum number of blocks once, rather than growing
+  // the vector block by block.
+  if (report_blocks_.empty())
+    report_blocks_.reserve(kMaxNumberOfReportBlocks);
   report_blocks_.push_back(block.report_block_);
   sr_.NumberOfReportBlocks = report_blocks_.size();
   return true;
@@ -805,6 +809,10 @@ bool ReceiverReport::WithReportBlock(const ReportBlock& block) {
     LOG(LS_WARNING) << "Max report blocks reached.";
     return false;
   }
+  // Allocate room for the maximum number of blocks once, rather than growing
+  // the vector block by block.
+  if (report_blocks_.empty())
+    report_blocks_.reserve(kMaxNumberOfReportBlocks);
   report_blocks_.push_back(block.report_block_);
   rr_.NumberOfReportBlocks = report_blocks_.size();
   return true;
@@ -0,0 +1,174 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <set>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/rtp_rtcp/interface/receive_statistics.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_receiver.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_sender.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_rtcp_impl.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+const uint32_t kSenderSsrc = 0x10203;
+const uint32_t kFirstSourceSsrc = 0x40506;
+const uint32_t kNumSourceSsrcs = 10;
+const int kNackListLength = 30;
+const int kNumPackets = 20000;
+
+// Counts outgoing RTCP packets without looking at them.
+class CountingTransport : public Transport {
+ public:
+  CountingTransport() : num_rtcp_packets_(0) {}
+
+  int SendPacket(int /*ch*/, const void* /*data*/, size_t /*len*/) override {
+    return -1;
+  }
+  int SendRTCPPacket(int /*ch*/, const void* /*data*/, size_t len) override {
+    ++num_rtcp_packets_;
+    return static_cast<int>(len);
+  }
+
+  int num_rtcp_packets_;
+};
+
+void FillNackList(uint16_t* nack_list) {
+  for (int i = 0; i < kNackListLength; ++i)
+    nack_list[i] = static_cast<uint16_t>(100 + 3 * i);
+}
+
+}  // namespace
+
+// Measures building compound packets with a sender report carrying ten report
+// blocks, SDES, a REMB and a 30-entry NACK, as sent by a video sender that
+// also receives ten streams.
+TEST(RtcpPerfTest, SendCompoundSrRembNack) {
+  SimulatedClock clock(1335900000);
+  rtc::scoped_ptr<ReceiveStatistics> receive_statistics(
+      ReceiveStatistics::Create(&clock));
+  CountingTransport transport;
+  RtpRtcp::Configuration configuration;
+  configuration.clock = &clock;
+  configuration.outgoing_transport = &transport;
+  ModuleRtpRtcpImpl rtp_rtcp(configuration);
+  RTCPSender rtcp_sender(0, false, &clock, receive_statistics.get(), nullptr);
+  rtcp_sender.SetSSRC(kSenderSsrc);
+  EXPECT_EQ(0, rtcp_sender.RegisterSendTransport(&transport));
+  rtcp_sender.SetRTCPStatus(kRtcpCompound);
+  EXPECT_EQ(0, rtcp_sender.SetSendingStatus(rtp_rtcp.GetFeedbackState(),
+                                            true));
+
+  std::vector<uint32_t> remote_ssrcs;
+  for (uint32_t i = 0; i < kNumSourceSsrcs; ++i)
+    remote_ssrcs.push_back(kFirstSourceSsrc + i);
+  rtcp_sender.SetRemoteSSRC(kFirstSourceSsrc);
+  rtcp_sender.SetREMBStatus(true);
+  rtcp_sender.SetREMBData(1000000, remote_ssrcs);
+  uint16_t nack_list[kNackListLength];
+  FillNackList(nack_list);
+
+  Clock* real_clock = Clock::GetRealTimeClock();
+  int64_t elapsed_us = 0;
+  RTPHeader header;
+  header.timestamp = 12345;
+  header.headerLength = 12;
+  for (int i = 0; i < kNumPackets; ++i) {
+    header.sequenceNumber = static_cast<uint16_t>(i);
+    for (uint32_t ssrc : remote_ssrcs) {
+      header.ssrc = ssrc;
+      receive_statistics->IncomingPacket(header, 100, false);
+    }
+    clock.AdvanceTimeMilliseconds(5);
+    RTCPSender::FeedbackState state = rtp_rtcp.GetFeedbackState();
+
+    int64_t start_us = real_clock->TimeInMicroseconds();
+    EXPECT_EQ(0, rtcp_sender.SendRTCP(state, kRtcpNack, kNackListLength,
+                                      nack_list));
+    elapsed_us += real_clock->TimeInMicroseconds() - start_us;
+  }
+
+  EXPECT_EQ(kNumPackets, transport.num_rtcp_packets_);
+  test::PrintResult("rtcp_compound_sr_remb_nack", "", "build",
+                    static_cast<size_t>(elapsed_us * 1000 / kNumPackets),
+                    "ns/packet", true);
+}
+
+// Measures parsing and handling of the same kind of compound packet, as
+// received from a remote video sender that also receives ten of our streams.
+TEST(RtcpPerfTest, ParseCompoundSrRembNack) {
+  SimulatedClock clock(1335900000);
+  CountingTransport transport;
+  RtpRtcp::Configuration configuration;
+  configuration.clock = &clock;
+  configuration.outgoing_transport = &transport;
+  ModuleRtpRtcpImpl rtp_rtcp(configuration);
+  RTCPReceiver rtcp_receiver(0, &clock, false, NULL, NULL, NULL, &rtp_rtcp);
+
+  std::set<uint32_t> ssrcs;
+  for (uint32_t i = 0; i < kNumSourceSsrcs; ++i)
+    ssrcs.insert(kFirstSourceSsrc + i);
+  rtcp_receiver.SetSsrcs(kFirstSourceSsrc, ssrcs);
+  rtcp_receiver.SetRemoteSSRC(kSenderSsrc);
+
+  rtcp::SenderReport sr;
+  sr.From(kSenderSsrc);
+  for (uint32_t ssrc : ssrcs) {
+    rtcp::ReportBlock rb;
+    rb.To(ssrc);
+    rb.WithExtHighestSeqNum(1000);
+    rb.WithFractionLost(10);
+    rb.WithCumulativeLost(5);
+    rb.WithJitter(30);
+    sr.WithReportBlock(rb);
+  }
+  rtcp::Remb remb;
+  remb.From(kSenderSsrc);
+  for (uint32_t ssrc : ssrcs)
+    remb.AppliesTo(ssrc);
+  remb.WithBitrateBps(1000000);
+  uint16_t nack_list[kNackListLength];
+  FillNackList(nack_list);
+  rtcp::Nack nack;
+  nack.From(kSenderSsrc);
+  nack.To(kFirstSourceSsrc);
+  nack.WithList(nack_list, kNackListLength);
+  sr.Append(&remb);
+  sr.Append(&nack);
+  rtc::scoped_ptr<rtcp::RawPacket> packet(sr.Build());
+
+  Clock* real_clock = Clock::GetRealTimeClock();
+  int64_t start_us = real_clock->TimeInMicroseconds();
+  for (int i = 0; i < kNumPackets; ++i) {
+    RTCPUtility::RTCPParserV2 rtcp_parser(packet->Buffer(), packet->Length(),
+                                          true);
+    RTCPHelp::RTCPPacketInformation rtcp_packet_information;
+    EXPECT_EQ(0, rtcp_receiver.IncomingRTCPPacket(rtcp_packet_information,
+                                                  &rtcp_parser));
+    rtcp_receiver.TriggerCallbacksFromRTCPPacket(rtcp_packet_information);
+    clock.AdvanceTimeMilliseconds(5);
+  }
+  int64_t elapsed_us = real_clock->TimeInMicroseconds() - start_us;
+
+  std::vector<RTCPReportBlock> received_blocks;
+  rtcp_receiver.StatisticsReceived(&received_blocks);
+  EXPECT_EQ(kNumSourceSsrcs, received_blocks.size());
+  test::PrintResult("rtcp_compound_sr_remb_nack", "", "parse_and_handle",
+                    static_cast<size_t>(elapsed_us * 1000 / kNumPackets),
+                    "ns/packet", true);
+}
+
+}  // namespace webrtc
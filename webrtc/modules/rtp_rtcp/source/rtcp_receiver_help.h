@@ -12,6 +12,8 @@
 #define WEBRTC_MODULES_RTP_RTCP_SOURCE_RTCP_RECEIVER_HELP_H_
 
 
+#include <vector>
+
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/modules/rtp_rtcp/interface/rtp_rtcp_defines.h"  // RTCPReportBlock
@@ -60,7 +62,7 @@ public:
     uint32_t  rtcpPacketTypeFlags; // RTCPPacketTypeFlags bit field
     uint32_t  remoteSSRC;
 
-    std::list<uint16_t> nackSequenceNumbers;
+    std::vector<uint16_t> nackSequenceNumbers;
 
     uint8_t   applicationSubType;
     uint32_t  applicationName;
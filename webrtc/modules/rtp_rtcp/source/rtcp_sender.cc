@@ -171,7 +171,9 @@ RTCPSender::RTCPSender(
       app_length_(0),
 
       xr_send_receiver_reference_time_enabled_(false),
-      packet_type_counter_observer_(packet_type_counter_observer) {
+      packet_type_counter_observer_(packet_type_counter_observer),
+      report_flags_(0),
+      volatile_report_flags_(0) {
   memset(last_send_report_, 0, sizeof(last_send_report_));
   memset(last_rtcp_time_, 0, sizeof(last_rtcp_time_));
 
@@ -463,7 +465,18 @@ int32_t RTCPSender::AddReportBlock(const RTCPReportBlock& report_block) {
     LOG(LS_WARNING) << "Too many report blocks.";
     return -1;
   }
-  rtcp::ReportBlock* block = &report_blocks_[report_block.remoteSSRC];
+  rtcp::ReportBlock* block = nullptr;
+  for (auto& it : report_blocks_) {
+    if (it.first == report_block.remoteSSRC) {
+      block = &it.second;
+      break;
+    }
+  }
+  if (!block) {
+    report_blocks_.push_back(
+        std::make_pair(report_block.remoteSSRC, rtcp::ReportBlock()));
+    block = &report_blocks_.back().second;
+  }
   block->To(report_block.remoteSSRC);
   block->WithFractionLost(report_block.fractionLost);
   block->WithCumulativeLost(report_block.cumulativeLost);
@@ -502,7 +515,7 @@ RTCPSender::BuildResult RTCPSender::BuildSR(RtcpContext* ctx) {
   report.WithPacketCount(ctx->feedback_state.packets_sent);
   report.WithOctetCount(ctx->feedback_state.media_bytes_sent);
 
-  for (auto it : report_blocks_)
+  for (const auto& it : report_blocks_)
     report.WithReportBlock(it.second);
 
   PacketBuiltCallback callback(ctx);
@@ -533,7 +546,7 @@ RTCPSender::BuildResult RTCPSender::BuildSDES(RtcpContext* ctx) {
 RTCPSender::BuildResult RTCPSender::BuildRR(RtcpContext* ctx) {
   rtcp::ReceiverReport report;
   report.From(ssrc_);
-  for (auto it : report_blocks_)
+  for (const auto& it : report_blocks_)
     report.WithReportBlock(it.second);
 
   PacketBuiltCallback callback(ctx);
@@ -808,17 +821,23 @@ RTCPSender::BuildResult RTCPSender::BuildNACK(RtcpContext* ctx) {
     LOG(LS_WARNING) << "Nack list too large for one packet.";
 
   // Report stats.
-  NACKStringBuilder stringBuilder;
-  for (int idx = 0; idx < i; ++idx) {
-    stringBuilder.PushNACK(ctx->nack_list[idx]);
+  for (int idx = 0; idx < i; ++idx)
     nack_stats_.ReportRequest(ctx->nack_list[idx]);
-  }
   packet_type_counter_.nack_requests = nack_stats_.requests();
   packet_type_counter_.unique_nack_requests = nack_stats_.unique_requests();
 
-  TRACE_EVENT_INSTANT1(TRACE_DISABLED_BY_DEFAULT("webrtc_rtp"),
-                       "RTCPSender::NACK", "nacks",
-                       TRACE_STR_COPY(stringBuilder.GetResult().c_str()));
+  // Only format the NACK list when it will actually be traced.
+  bool trace_nacks = false;
+  TRACE_EVENT_CATEGORY_GROUP_ENABLED(TRACE_DISABLED_BY_DEFAULT("webrtc_rtp"),
+                                     &trace_nacks);
+  if (trace_nacks) {
+    NACKStringBuilder stringBuilder;
+    for (int idx = 0; idx < i; ++idx)
+      stringBuilder.PushNACK(ctx->nack_list[idx]);
+    TRACE_EVENT_INSTANT1(TRACE_DISABLED_BY_DEFAULT("webrtc_rtp"),
+                         "RTCPSender::NACK", "nacks",
+                         TRACE_STR_COPY(stringBuilder.GetResult().c_str()));
+  }
   ++packet_type_counter_.nack_packets;
   TRACE_COUNTER_ID1(TRACE_DISABLED_BY_DEFAULT("webrtc_rtp"), "RTCP_NACKCount",
                     ssrc_, packet_type_counter_.nack_packets);
@@ -926,9 +945,8 @@ int32_t RTCPSender::SendRTCP(const FeedbackState& feedback_state,
                              const uint16_t* nack_list,
                              bool repeat,
                              uint64_t pictureID) {
-  return SendCompoundRTCP(
-      feedback_state, std::set<RTCPPacketType>(&packetType, &packetType + 1),
-      nack_size, nack_list, repeat, pictureID);
+  return SendRTCPPackets(feedback_state, packetType, nack_size, nack_list,
+                         repeat, pictureID);
 }
 
 int32_t RTCPSender::SendCompoundRTCP(
@@ -938,6 +956,19 @@ int32_t RTCPSender::SendCompoundRTCP(
     const uint16_t* nack_list,
     bool repeat,
     uint64_t pictureID) {
+  uint32_t packet_types = 0;
+  for (RTCPPacketType type : packetTypes)
+    packet_types |= type;
+  return SendRTCPPackets(feedback_state, packet_types, nack_size, nack_list,
+                         repeat, pictureID);
+}
+
+int32_t RTCPSender::SendRTCPPackets(const FeedbackState& feedback_state,
+                                    uint32_t packet_types,
+                                    int32_t nack_size,
+                                    const uint16_t* nack_list,
+                                    bool repeat,
+                                    uint64_t pictureID) {
   {
     CriticalSectionScoped lock(critical_section_rtcp_sender_.get());
     if (method_ == kRtcpOff) {
@@ -947,7 +978,7 @@ int32_t RTCPSender::SendCompoundRTCP(
   }
   uint8_t rtcp_buffer[IP_PACKET_SIZE];
   int rtcp_length =
-      PrepareRTCP(feedback_state, packetTypes, nack_size, nack_list, repeat,
+      PrepareRTCP(feedback_state, packet_types, nack_size, nack_list, repeat,
                   pictureID, rtcp_buffer, IP_PACKET_SIZE);
 
   // Sanity don't send empty packets.
@@ -958,7 +989,7 @@ int32_t RTCPSender::SendCompoundRTCP(
 }
 
 int RTCPSender::PrepareRTCP(const FeedbackState& feedback_state,
-                            const std::set<RTCPPacketType>& packetTypes,
+                            uint32_t packet_types,
                             int32_t nack_size,
                             const uint16_t* nack_list,
                             bool repeat,
@@ -972,7 +1003,7 @@ int RTCPSender::PrepareRTCP(const FeedbackState& feedback_state,
 
   // Add all flags as volatile. Non volatile entries will not be overwritten
   // and all new volatile flags added will be consumed by the end of this call.
-  SetFlags(packetTypes, true);
+  SetFlags(packet_types, true);
 
   if (packet_type_counter_.first_packet_time_ms == -1)
     packet_type_counter_.first_packet_time_ms = clock_->TimeInMilliseconds();
@@ -1037,14 +1068,16 @@ int RTCPSender::PrepareRTCP(const FeedbackState& feedback_state,
     }
   }
 
-  auto it = report_flags_.begin();
-  while (it != report_flags_.end()) {
-    auto builder = builders_.find(it->type);
+  uint32_t remaining_flags = report_flags_;
+  while (remaining_flags != 0) {
+    // Lowest set bit first.
+    uint32_t type = remaining_flags & (~remaining_flags + 1);
+    remaining_flags &= ~type;
+    auto builder = builders_.find(static_cast<RTCPPacketType>(type));
     DCHECK(builder != builders_.end());
-    if (it->is_volatile) {
-      report_flags_.erase(it++);
-    } else {
-      ++it;
+    if (volatile_report_flags_ & type) {
+      report_flags_ &= ~type;
+      volatile_report_flags_ &= ~type;
     }
 
     uint32_t start_position = context.position;
@@ -1180,34 +1213,33 @@ int32_t RTCPSender::SetTMMBN(const TMMBRSet* boundingSet,
 }
 
 void RTCPSender::SetFlag(RTCPPacketType type, bool is_volatile) {
-  report_flags_.insert(ReportFlag(type, is_volatile));
+  SetFlags(type, is_volatile);
 }
 
-void RTCPSender::SetFlags(const std::set<RTCPPacketType>& types,
-                          bool is_volatile) {
-  for (RTCPPacketType type : types)
-    SetFlag(type, is_volatile);
+void RTCPSender::SetFlags(uint32_t types, bool is_volatile) {
+  // Flags that are already set keep their volatility.
+  uint32_t new_types = types & ~report_flags_;
+  report_flags_ |= new_types;
+  if (is_volatile)
+    volatile_report_flags_ |= new_types;
 }
 
 bool RTCPSender::IsFlagPresent(RTCPPacketType type) const {
-  return report_flags_.find(ReportFlag(type, false)) != report_flags_.end();
+  return (report_flags_ & type) != 0;
 }
 
 bool RTCPSender::ConsumeFlag(RTCPPacketType type, bool forced) {
-  auto it = report_flags_.find(ReportFlag(type, false));
-  if (it == report_flags_.end())
+  if (!IsFlagPresent(type))
     return false;
-  if (it->is_volatile || forced)
-    report_flags_.erase((it));
+  if ((volatile_report_flags_ & type) || forced) {
+    report_flags_ &= ~type;
+    volatile_report_flags_ &= ~type;
+  }
   return true;
 }
 
 bool RTCPSender::AllVolatileFlagsConsumed() const {
-  for (const ReportFlag& flag : report_flags_) {
-    if (flag.is_volatile)
-      return false;
-  }
-  return true;
+  return volatile_report_flags_ == 0;
 }
 
 }  // namespace webrtc
@@ -15,6 +15,8 @@
 #include <set>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/thread_annotations.h"
@@ -180,8 +182,16 @@ private:
                     StreamStatistician* statistician,
                     RTCPReportBlock* report_block);
 
+ // |packet_types| is a bitmask of RTCPPacketType values.
+ int32_t SendRTCPPackets(const FeedbackState& feedback_state,
+                         uint32_t packet_types,
+                         int32_t nack_size,
+                         const uint16_t* nack_list,
+                         bool repeat,
+                         uint64_t pictureID);
+
  int PrepareRTCP(const FeedbackState& feedback_state,
-                 const std::set<RTCPPacketType>& packetTypes,
+                 uint32_t packet_types,
                  int32_t nackSize,
                  const uint16_t* nackList,
                  bool repeat,
@@ -248,7 +258,9 @@ private:
 
  ReceiveStatistics* receive_statistics_
      GUARDED_BY(critical_section_rtcp_sender_);
- std::map<uint32_t, rtcp::ReportBlock> report_blocks_
+ // Report blocks to include in the next SR or RR, at most one per remote SSRC.
+ // Kept as a vector so that its capacity is reused between reports.
+ std::vector<std::pair<uint32_t, rtcp::ReportBlock>> report_blocks_
      GUARDED_BY(critical_section_rtcp_sender_);
  std::map<uint32_t, std::string> csrc_cnames_
      GUARDED_BY(critical_section_rtcp_sender_);
@@ -299,7 +311,7 @@ private:
 
  void SetFlag(RTCPPacketType type, bool is_volatile)
      EXCLUSIVE_LOCKS_REQUIRED(critical_section_rtcp_sender_);
- void SetFlags(const std::set<RTCPPacketType>& types, bool is_volatile)
+ void SetFlags(uint32_t types, bool is_volatile)
      EXCLUSIVE_LOCKS_REQUIRED(critical_section_rtcp_sender_);
  bool IsFlagPresent(RTCPPacketType type) const
      EXCLUSIVE_LOCKS_REQUIRED(critical_section_rtcp_sender_);
@@ -307,16 +319,11 @@ private:
      EXCLUSIVE_LOCKS_REQUIRED(critical_section_rtcp_sender_);
  bool AllVolatileFlagsConsumed() const
      EXCLUSIVE_LOCKS_REQUIRED(critical_section_rtcp_sender_);
- struct ReportFlag {
-   ReportFlag(RTCPPacketType type, bool is_volatile)
-       : type(type), is_volatile(is_volatile) {}
-   bool operator<(const ReportFlag& flag) const { return type < flag.type; }
-   bool operator==(const ReportFlag& flag) const { return type == flag.type; }
-   const RTCPPacketType type;
-   const bool is_volatile;
- };
-
- std::set<ReportFlag> report_flags_ GUARDED_BY(critical_section_rtcp_sender_);
+ // Bitmasks of RTCPPacketType values. Packets are built in increasing order
+ // of their type value. Volatile flags are cleared when the packet is built,
+ // the others stay set until explicitly consumed.
+ uint32_t report_flags_ GUARDED_BY(critical_section_rtcp_sender_);
+ uint32_t volatile_report_flags_ GUARDED_BY(critical_section_rtcp_sender_);
 
  typedef BuildResult (RTCPSender::*Builder)(RtcpContext*);
  std::map<RTCPPacketType, Builder> builders_;
@@ -11,7 +11,6 @@
 #ifndef WEBRTC_MODULES_RTP_RTCP_SOURCE_RTP_RTCP_IMPL_H_
 #define WEBRTC_MODULES_RTP_RTCP_SOURCE_RTP_RTCP_IMPL_H_
 
-#include <list>
 #include <vector>
 
 #include "webrtc/base/scoped_ptr.h"
@@ -322,7 +321,7 @@ class ModuleRtpRtcpImpl : public RtpRtcp {
   // Received a new reference frame.
   void OnReceivedReferencePictureSelectionIndication(uint64_t picture_id);
 
-  void OnReceivedNACK(const std::list<uint16_t>& nack_sequence_numbers);
+  void OnReceivedNACK(const std::vector<uint16_t>& nack_sequence_numbers);
 
   void OnRequestSendReport();
 
@@ -764,8 +764,9 @@ int RTPSender::SetSelectiveRetransmissions(uint8_t settings) {
   return 0;
 }
 
-void RTPSender::OnReceivedNACK(const std::list<uint16_t>& nack_sequence_numbers,
-                               int64_t avg_rtt) {
+void RTPSender::OnReceivedNACK(
+    const std::vector<uint16_t>& nack_sequence_numbers,
+    int64_t avg_rtt) {
   TRACE_EVENT2(TRACE_DISABLED_BY_DEFAULT("webrtc_rtp"),
                "RTPSender::OnReceivedNACK", "num_seqnum",
                nack_sequence_numbers.size(), "avg_rtt", avg_rtt);
@@ -780,8 +781,9 @@ void RTPSender::OnReceivedNACK(const std::list<uint16_t>& nack_sequence_numbers,
     return;
   }
 
-  for (std::list<uint16_t>::const_iterator it = nack_sequence_numbers.begin();
-      it != nack_sequence_numbers.end(); ++it) {
+  for (std::vector<uint16_t>::const_iterator it =
+           nack_sequence_numbers.begin();
+       it != nack_sequence_numbers.end(); ++it) {
     const int32_t bytes_sent = ReSendPacket(*it, 5 + avg_rtt);
     if (bytes_sent > 0) {
       bytes_re_sent += bytes_sent;
@@ -14,6 +14,7 @@
 #include <math.h>
 
 #include <map>
+#include <vector>
 
 #include "webrtc/base/thread_annotations.h"
 #include "webrtc/common_types.h"
@@ -214,7 +215,7 @@ class RTPSender : public RTPSenderInterface {
   // NACK.
   int SelectiveRetransmissions() const;
   int SetSelectiveRetransmissions(uint8_t settings);
-  void OnReceivedNACK(const std::list<uint16_t>& nack_sequence_numbers,
+  void OnReceivedNACK(const std::vector<uint16_t>& nack_sequence_numbers,
                       int64_t avg_rtt);
 
   void SetStorePacketsStatus(bool enable, uint16_t number_to_store);
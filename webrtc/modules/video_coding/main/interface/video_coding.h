@@ -421,6 +421,12 @@ public:
     //                     < 0,         on error.
     virtual int32_t Decode(uint16_t maxWaitTimeMs = 200) = 0;
 
+    // Like Decode(0), but doesn't wait for the next frame to be due for
+    // decoding either. If it isn't due yet, returns VCM_FRAME_NOT_READY and
+    // sets |next_decode_time_ms| to the time, in the module's clock, when it
+    // is. It's set to -1 if there is no frame to decode.
+    virtual int32_t DecodeIfDue(int64_t* next_decode_time_ms) = 0;
+
     // Registers a callback which conveys the size of the render buffer.
     virtual int RegisterRenderBufferSizeCallback(
         VCMRenderBufferSizeCallback* callback) = 0;
@@ -96,8 +96,11 @@ void VCMReceiver::TriggerDecoderShutdown() {
 
 VCMEncodedFrame* VCMReceiver::FrameForDecoding(uint16_t max_wait_time_ms,
                                                int64_t& next_render_time_ms,
-                                               bool render_timing) {
+                                               bool render_timing,
+                                               int64_t* next_decode_time_ms) {
   const int64_t start_time_ms = clock_->TimeInMilliseconds();
+  if (next_decode_time_ms)
+    *next_decode_time_ms = -1;
   uint32_t frame_timestamp = 0;
   // Exhaust wait time to get a complete frame for decoding.
   bool found_frame = jitter_buffer_.NextCompleteTimestamp(
@@ -146,9 +149,12 @@ VCMEncodedFrame* VCMReceiver::FrameForDecoding(uint16_t max_wait_time_ms,
         static_cast<int32_t>(clock_->TimeInMilliseconds() - start_time_ms);
     uint16_t new_max_wait_time = static_cast<uint16_t>(
         VCM_MAX(available_wait_time, 0));
-    uint32_t wait_time_ms = timing_->MaxWaitingTime(
-        next_render_time_ms, clock_->TimeInMilliseconds());
+    const int64_t wait_start_ms = clock_->TimeInMilliseconds();
+    uint32_t wait_time_ms =
+        timing_->MaxWaitingTime(next_render_time_ms, wait_start_ms);
     if (new_max_wait_time < wait_time_ms) {
+      if (next_decode_time_ms)
+        *next_decode_time_ms = wait_start_ms + wait_time_ms;
       // We're not allowed to wait until the frame is supposed to be rendered,
       // waiting as long as we're allowed to avoid busy looping, and then return
       // NULL. Next call to this function might return the frame.
@@ -45,9 +45,13 @@ class VCMReceiver {
   int32_t InsertPacket(const VCMPacket& packet,
                        uint16_t frame_width,
                        uint16_t frame_height);
+  // If |render_timing| is false and the next frame isn't due for decoding
+  // within |max_wait_time_ms|, returns NULL and sets |next_decode_time_ms|, if
+  // not NULL, to the time it's due. It's set to -1 when there is no frame.
   VCMEncodedFrame* FrameForDecoding(uint16_t max_wait_time_ms,
                                     int64_t& next_render_time_ms,
-                                    bool render_timing = true);
+                                    bool render_timing = true,
+                                    int64_t* next_decode_time_ms = NULL);
   void ReleaseFrame(VCMEncodedFrame* frame);
   void ReceiveStatistics(uint32_t* bitrate, uint32_t* framerate);
   uint32_t DiscardedPackets() const;
@@ -525,4 +525,55 @@ TEST_F(VCMReceiverTimingTest, FrameForDecoding) {
   }
 }
 
+// Test that VCMReceiver::FrameForDecoding reports when a frame that it's not
+// allowed to wait for is due, and that the frame is handed out at that time,
+// with exactly the decode time and render delay left until it's rendered.
+TEST_F(VCMReceiverTimingTest, FrameForDecodingReportsDecodeTime) {
+  const size_t kNumFrames = 100;
+  const int kFramePeriod = 40;
+  int64_t arrive_timestamps[kNumFrames];
+  int64_t render_timestamps[kNumFrames];
+  for (size_t i = 0; i < kNumFrames; i++) {
+    arrive_timestamps[i] = (i + 1) * kFramePeriod;
+    render_timestamps[i] = (i + 1) * kFramePeriod;
+  }
+  clock_.SetFrames(arrive_timestamps, render_timestamps, kNumFrames);
+
+  size_t num_frames_return = 0;
+  size_t num_frames_waited_for = 0;
+  bool waited_for_decode_time = false;
+  while (num_frames_return < kNumFrames) {
+    int64_t next_render_time;
+    int64_t next_decode_time;
+    VCMEncodedFrame* frame =
+        receiver_.FrameForDecoding(0, next_render_time, false,
+                                   &next_decode_time);
+    const int64_t now = clock_.TimeInMilliseconds();
+    if (frame) {
+      EXPECT_EQ(-1, next_decode_time);
+      if (waited_for_decode_time) {
+        int decode_ms, max_decode_ms, current_delay_ms, target_delay_ms,
+            jitter_buffer_ms, min_playout_delay_ms, render_delay_ms;
+        timing_.GetTimings(&decode_ms, &max_decode_ms, &current_delay_ms,
+                           &target_delay_ms, &jitter_buffer_ms,
+                           &min_playout_delay_ms, &render_delay_ms);
+        EXPECT_EQ(max_decode_ms + render_delay_ms, next_render_time - now);
+        ++num_frames_waited_for;
+      }
+      receiver_.ReleaseFrame(frame);
+      ++num_frames_return;
+      waited_for_decode_time = false;
+    } else if (next_decode_time == -1) {
+      // No frame yet, wait for one to arrive.
+      clock_.AdvanceTimeMilliseconds(kFramePeriod, true);
+      waited_for_decode_time = false;
+    } else {
+      EXPECT_GT(next_decode_time, now);
+      waited_for_decode_time =
+          !clock_.AdvanceTimeMilliseconds(next_decode_time - now, true);
+    }
+  }
+  EXPECT_GT(num_frames_waited_for, 0u);
+}
+
 }  // namespace webrtc
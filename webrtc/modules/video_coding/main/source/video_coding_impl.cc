@@ -247,6 +247,10 @@ class VideoCodingModuleImpl : public VideoCodingModule {
     return receiver_->Decode(maxWaitTimeMs);
   }
 
+  int32_t DecodeIfDue(int64_t* next_decode_time_ms) override {
+    return receiver_->DecodeIfDue(next_decode_time_ms);
+  }
+
   int32_t ResetDecoder() override { return receiver_->ResetDecoder(); }
 
   int32_t ReceiveCodec(VideoCodec* currentReceiveCodec) const override {
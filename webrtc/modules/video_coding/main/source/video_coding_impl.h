@@ -168,6 +168,7 @@ class VideoReceiver {
   int RegisterRenderBufferSizeCallback(VCMRenderBufferSizeCallback* callback);
 
   int32_t Decode(uint16_t maxWaitTimeMs);
+  int32_t DecodeIfDue(int64_t* next_decode_time_ms);
   int32_t ResetDecoder();
 
   int32_t ReceiveCodec(VideoCodec* currentReceiveCodec) const;
@@ -200,6 +201,9 @@ class VideoReceiver {
   void TriggerDecoderShutdown();
 
  protected:
+  // Sets |next_decode_time_ms|, if not null, as described for DecodeIfDue().
+  int32_t DecodeNextFrame(uint16_t max_wait_time_ms,
+                          int64_t* next_decode_time_ms);
   int32_t Decode(const webrtc::VCMEncodedFrame& frame)
       EXCLUSIVE_LOCKS_REQUIRED(_receiveCritSect);
   int32_t RequestKeyFrame();
@@ -281,6 +281,15 @@ void VideoReceiver::TriggerDecoderShutdown() {
 // Decode next frame, blocking.
 // Should be called as often as possible to get the most out of the decoder.
 int32_t VideoReceiver::Decode(uint16_t maxWaitTimeMs) {
+  return DecodeNextFrame(maxWaitTimeMs, nullptr);
+}
+
+int32_t VideoReceiver::DecodeIfDue(int64_t* next_decode_time_ms) {
+  return DecodeNextFrame(0, next_decode_time_ms);
+}
+
+int32_t VideoReceiver::DecodeNextFrame(uint16_t max_wait_time_ms,
+                                       int64_t* next_decode_time_ms) {
   int64_t nextRenderTimeMs;
   bool supports_render_scheduling;
   {
@@ -288,8 +297,10 @@ int32_t VideoReceiver::Decode(uint16_t maxWaitTimeMs) {
     supports_render_scheduling = _codecDataBase.SupportsRenderScheduling();
   }
 
-  VCMEncodedFrame* frame = _receiver.FrameForDecoding(
-      maxWaitTimeMs, nextRenderTimeMs, supports_render_scheduling);
+  VCMEncodedFrame* frame =
+      _receiver.FrameForDecoding(max_wait_time_ms, nextRenderTimeMs,
+                                 supports_render_scheduling,
+                                 next_decode_time_ms);
 
   if (frame == NULL) {
     return VCM_FRAME_NOT_READY;
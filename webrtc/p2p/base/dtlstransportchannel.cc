@@ -10,6 +10,8 @@
 
 #include "webrtc/p2p/base/dtlstransportchannel.h"
 
+#include <algorithm>
+
 #include "webrtc/p2p/base/common.h"
 #include "webrtc/base/buffer.h"
 #include "webrtc/base/checks.h"
@@ -42,7 +44,9 @@ static bool IsRtpPacket(const char* data, size_t len) {
 StreamInterfaceChannel::StreamInterfaceChannel(TransportChannel* channel)
     : channel_(channel),
       state_(rtc::SS_OPEN),
-      packets_(kMaxPendingPackets, kMaxDtlsPacketLen) {
+      packets_(kMaxPendingPackets, kMaxDtlsPacketLen),
+      pending_packet_(NULL),
+      pending_packet_size_(0) {
 }
 
 rtc::StreamResult StreamInterfaceChannel::Read(void* buffer,
@@ -54,6 +58,17 @@ rtc::StreamResult StreamInterfaceChannel::Read(void* buffer,
   if (state_ == rtc::SS_OPENING)
     return rtc::SR_BLOCK;
 
+  if (pending_packet_) {
+    // Like BufferQueue::ReadFront(), truncate packets that don't fit.
+    size_t size = std::min(buffer_len, pending_packet_size_);
+    memcpy(buffer, pending_packet_, size);
+    if (read) {
+      *read = size;
+    }
+    pending_packet_ = NULL;
+    return rtc::SR_SUCCESS;
+  }
+
   if (!packets_.ReadFront(buffer, buffer_len, read)) {
     return rtc::SR_BLOCK;
   }
@@ -77,6 +92,22 @@ rtc::StreamResult StreamInterfaceChannel::Write(const void* data,
 }
 
 bool StreamInterfaceChannel::OnPacketReceived(const char* data, size_t size) {
+  // The DTLS adapter normally reads the packet while handling SE_READ, so
+  // when nothing is queued, let it read from |data| directly and only queue
+  // the packet if it was left unread.
+  if (packets_.size() == 0 && !pending_packet_) {
+    pending_packet_ = data;
+    pending_packet_size_ = size;
+    SignalEvent(this, rtc::SE_READ, 0);
+    if (!pending_packet_) {
+      return true;
+    }
+    pending_packet_ = NULL;
+    bool ret = packets_.WriteBack(data, size, NULL);
+    CHECK(ret) << "Failed to write packet to queue.";
+    return ret;
+  }
+
   // We force a read event here to ensure that we don't overflow our queue.
   bool ret = packets_.WriteBack(data, size, NULL);
   CHECK(ret) << "Failed to write packet to queue.";
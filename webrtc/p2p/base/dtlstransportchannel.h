@@ -44,6 +44,11 @@ class StreamInterfaceChannel : public rtc::StreamInterface {
   TransportChannel* channel_;  // owned by DtlsTransportChannelWrapper
   rtc::StreamState state_;
   rtc::BufferQueue packets_;
+  // The packet being delivered by OnPacketReceived(), if the queue was empty.
+  // Read() takes it straight from the caller's buffer instead of copying it
+  // through |packets_| first.
+  const char* pending_packet_;
+  size_t pending_packet_size_;
 
   DISALLOW_COPY_AND_ASSIGN(StreamInterfaceChannel);
 };
@@ -927,8 +927,25 @@ void P2PTransportChannel::SortConnections() {
   // that amongst equal preference, writable connections, this will choose the
   // one whose estimated latency is lowest.  So it is the only one that we
   // need to consider switching to.
+  //
+  // |connections_| stays sorted between calls, and usually only a few
+  // connections have changed since the last sort, so an insertion sort is
+  // close to linear here and needs no temporary buffer.  If it turns out that
+  // many connections moved, fall back to a full stable sort.  Both are stable,
+  // so they produce the same order.
   ConnectionCompare cmp;
-  std::stable_sort(connections_.begin(), connections_.end(), cmp);
+  size_t moves = 0;
+  const size_t max_moves = 4 * connections_.size();
+  for (size_t i = 1; i < connections_.size() && moves <= max_moves; ++i) {
+    Connection* conn = connections_[i];
+    size_t j = i;
+    for (; j > 0 && cmp(conn, connections_[j - 1]); --j)
+      connections_[j] = connections_[j - 1];
+    connections_[j] = conn;
+    moves += i - j;
+  }
+  if (moves > max_moves)
+    std::stable_sort(connections_.begin(), connections_.end(), cmp);
   LOG(LS_VERBOSE) << "Sorting available connections:";
   for (uint32 i = 0; i < connections_.size(); ++i) {
     LOG(LS_VERBOSE) << connections_[i]->ToString();
@@ -995,22 +1012,22 @@ void P2PTransportChannel::PruneConnections() {
   // reconnecting a TCP connection and temporarily do not prune connections in
   // this network. See the big comment in CompareConnections.
 
-  // Get a list of the networks that we are using.
-  std::set<rtc::Network*> networks;
-  for (const Connection* conn : connections_) {
-    networks.insert(conn->port()->Network());
-  }
-  for (rtc::Network* network : networks) {
-    Connection* primier = GetBestConnectionOnNetwork(network);
-    if (!(primier && primier->writable() && primier->connected())) {
+  // Find the best connection on each network that we are using, in a single
+  // pass over the sorted connections (see GetBestConnectionOnNetwork).
+  std::map<rtc::Network*, Connection*> primiers;
+  if (best_connection_)
+    primiers[best_connection_->port()->Network()] = best_connection_;
+  for (Connection* conn : connections_)
+    primiers.insert(std::make_pair(conn->port()->Network(), conn));
+
+  for (Connection* conn : connections_) {
+    Connection* primier = primiers[conn->port()->Network()];
+    if (!(primier->writable() && primier->connected())) {
       continue;
     }
-
-    for (Connection* conn : connections_) {
-      if ((conn != primier) && (conn->port()->Network() == network) &&
-          (CompareConnectionCandidates(primier, conn) >= 0)) {
-        conn->Prune();
-      }
+    if ((conn != primier) &&
+        (CompareConnectionCandidates(primier, conn) >= 0)) {
+      conn->Prune();
     }
   }
 }
@@ -0,0 +1,138 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <set>
+#include <vector>
+
+#include "webrtc/base/gunit.h"
+#include "webrtc/base/physicalsocketserver.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/socketaddress.h"
+#include "webrtc/base/thread.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/base/virtualsocketserver.h"
+#include "webrtc/p2p/base/p2ptransportchannel.h"
+#include "webrtc/p2p/client/fakeportallocator.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace {
+
+const char kIceUfrag[] = "TESTICEUFRAG0000";
+const char kIcePwd[] = "TESTICEPWD00000000000000";
+const char kRemoteIceUfrag[] = "TESTICEUFRAG0001";
+const char kRemoteIcePwd[] = "TESTICEPWD00000000000001";
+
+}  // namespace
+
+class P2PTransportChannelPerfTest : public testing::Test,
+                                    public sigslot::has_slots<> {
+ public:
+  P2PTransportChannelPerfTest()
+      : pss_(new rtc::PhysicalSocketServer),
+        vss_(new rtc::VirtualSocketServer(pss_.get())),
+        ss_scope_(vss_.get()) {}
+
+ protected:
+  void PrepareChannel(cricket::P2PTransportChannel* ch) {
+    ch->SignalRequestSignaling.connect(
+        this, &P2PTransportChannelPerfTest::OnChannelRequestSignaling);
+    // The controlled side doesn't prune connections before one has been
+    // nominated, so all of them stay pingable.
+    ch->SetIceRole(cricket::ICEROLE_CONTROLLED);
+    ch->SetIceCredentials(kIceUfrag, kIcePwd);
+    ch->SetRemoteIceCredentials(kRemoteIceUfrag, kRemoteIcePwd);
+  }
+
+  void OnChannelRequestSignaling(cricket::TransportChannelImpl* channel) {
+    channel->OnSignalingReady();
+  }
+
+  cricket::Candidate CreateCandidate(const std::string& ip, int port,
+                                     int priority) {
+    cricket::Candidate c;
+    c.set_address(rtc::SocketAddress(ip, port));
+    c.set_component(1);
+    c.set_protocol(cricket::UDP_PROTOCOL_NAME);
+    c.set_priority(priority);
+    return c;
+  }
+
+  cricket::Connection* GetConnectionTo(cricket::P2PTransportChannel* ch,
+                                       const std::string& ip,
+                                       int port_num) {
+    if (ch->ports().empty()) {
+      return nullptr;
+    }
+    cricket::Port* port = static_cast<cricket::Port*>(ch->ports()[0]);
+    return port->GetConnection(rtc::SocketAddress(ip, port_num));
+  }
+
+ private:
+  rtc::scoped_ptr<rtc::PhysicalSocketServer> pss_;
+  rtc::scoped_ptr<rtc::VirtualSocketServer> vss_;
+  rtc::SocketServerScope ss_scope_;
+};
+
+// Measures how long the channel spends sorting and picking the next
+// connection to ping when there are many candidate pairs, as happens with
+// several network interfaces and TURN servers.
+TEST_F(P2PTransportChannelPerfTest, SortAndPingManyConnections) {
+  const int kNumCandidates = 250;
+  const int kNumPings = 1000;
+  cricket::FakePortAllocator pa(rtc::Thread::Current(), nullptr);
+  cricket::P2PTransportChannel ch("many connections", 1, nullptr, &pa);
+  PrepareChannel(&ch);
+  ch.Connect();
+  for (int i = 1; i <= kNumCandidates; ++i) {
+    ch.OnCandidate(CreateCandidate("1.1.1.1", i, i));
+  }
+  EXPECT_TRUE_WAIT(GetConnectionTo(&ch, "1.1.1.1", kNumCandidates) != nullptr,
+                   3000);
+
+  std::vector<cricket::Connection*> conns;
+  for (int i = 1; i <= kNumCandidates; ++i) {
+    cricket::Connection* conn = GetConnectionTo(&ch, "1.1.1.1", i);
+    ASSERT_TRUE(conn != nullptr);
+    conns.push_back(conn);
+  }
+
+  // Each state change schedules a re-sort of the connections. Once all are
+  // writable, the one with the highest priority is the best.
+  int64 start = rtc::TimeMicros();
+  for (cricket::Connection* conn : conns) {
+    conn->ReceivedPing();
+    conn->ReceivedPingResponse();
+    rtc::Thread::Current()->ProcessMessages(0);
+  }
+  int64 sort_us = rtc::TimeMicros() - start;
+  EXPECT_EQ(conns.back(), ch.best_connection());
+
+  // Pinging the selected connection each time must cycle through all of
+  // them, oldest ping first.
+  std::set<cricket::Connection*> pinged;
+  int64 ping_us = 0;
+  for (int i = 0; i < kNumPings; ++i) {
+    start = rtc::TimeMicros();
+    cricket::Connection* conn = ch.FindNextPingableConnection();
+    ping_us += rtc::TimeMicros() - start;
+    ASSERT_TRUE(conn != nullptr);
+    if (i < kNumCandidates)
+      EXPECT_TRUE(pinged.insert(conn).second);
+    conn->Ping(rtc::Time());
+  }
+  EXPECT_EQ(static_cast<size_t>(kNumCandidates), pinged.size());
+
+  webrtc::test::PrintResult("ice_connections", "", "state_change_and_sort",
+                            static_cast<size_t>(sort_us / kNumCandidates),
+                            "us/change", true);
+  webrtc::test::PrintResult("ice_connections", "", "find_next_pingable",
+                            static_cast<size_t>(ping_us * 1000 / kNumPings),
+                            "ns/ping", true);
+}
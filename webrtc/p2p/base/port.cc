@@ -327,9 +327,6 @@ size_t Port::AddPrflxCandidate(const Candidate& local) {
 bool Port::GetStunMessage(const char* data, size_t size,
                           const rtc::SocketAddress& addr,
                           IceMessage** out_msg, std::string* out_username) {
-  // NOTE: This could clearly be optimized to avoid allocating any memory.
-  //       However, at the data rates we'll be looking at on the client side,
-  //       this probably isn't worth worrying about.
   ASSERT(out_msg != NULL);
   ASSERT(out_username != NULL);
   *out_msg = NULL;
@@ -374,8 +371,10 @@ bool Port::GetStunMessage(const char* data, size_t size,
       return true;
     }
 
-    // If ICE, and the MESSAGE-INTEGRITY is bad, fail with a 401 Unauthorized
-    if (!stun_msg->ValidateMessageIntegrity(data, size, password_)) {
+    // If ICE, and the MESSAGE-INTEGRITY is bad, fail with a 401 Unauthorized.
+    // The HMAC is computed in place, with the key state cached per password.
+    integrity_key_.SetPassword(password_);
+    if (!StunMessage::ValidateMessageIntegrity(data, size, integrity_key_)) {
       LOG_J(LS_ERROR, this) << "Received STUN request with bad M-I "
                             << "from " << addr.ToSensitiveString()
                             << ", password_=" << password_;
@@ -562,7 +561,8 @@ void Port::SendBindingResponse(StunMessage* request,
 
   response.AddAttribute(
       new StunXorAddressAttribute(STUN_ATTR_XOR_MAPPED_ADDRESS, addr));
-  response.AddMessageIntegrity(password_);
+  integrity_key_.SetPassword(password_);
+  response.AddMessageIntegrity(integrity_key_);
   response.AddFingerprint();
 
   // The fact that we received a successful request means that this connection
@@ -616,8 +616,10 @@ void Port::SendBindingErrorResponse(StunMessage* request,
   // Per Section 10.1.2, certain error cases don't get a MESSAGE-INTEGRITY,
   // because we don't have enough information to determine the shared secret.
   if (error_code != STUN_ERROR_BAD_REQUEST &&
-      error_code != STUN_ERROR_UNAUTHORIZED)
-    response.AddMessageIntegrity(password_);
+      error_code != STUN_ERROR_UNAUTHORIZED) {
+    integrity_key_.SetPassword(password_);
+    response.AddMessageIntegrity(integrity_key_);
+  }
   response.AddFingerprint();
 
   // Send the response message.
@@ -740,7 +742,9 @@ class ConnectionRequest : public StunRequest {
         new StunUInt32Attribute(STUN_ATTR_PRIORITY, prflx_priority));
 
     // Adding Message Integrity attribute.
-    request->AddMessageIntegrity(connection_->remote_candidate().password());
+    connection_->remote_integrity_key_.SetPassword(
+        connection_->remote_candidate().password());
+    request->AddMessageIntegrity(connection_->remote_integrity_key_);
     // Adding Fingerprint.
     request->AddFingerprint();
   }
@@ -977,13 +981,16 @@ void Connection::OnReadPacket(
       // This doesn't just check, it makes callbacks if transaction
       // id's match.
       case STUN_BINDING_RESPONSE:
-      case STUN_BINDING_ERROR_RESPONSE:
-        if (msg->ValidateMessageIntegrity(
-                data, size, remote_candidate().password())) {
+      case STUN_BINDING_ERROR_RESPONSE: {
+        remote_integrity_key_.SetPassword(remote_candidate().password());
+        StunMessageView view;
+        if (view.Parse(data, size) &&
+            view.ValidateMessageIntegrity(remote_integrity_key_)) {
           requests_.CheckResponse(msg.get());
         }
         // Otherwise silently discard the response message.
         break;
+      }
 
       // Remote end point sent an STUN indication instead of regular
       // binding request. In this case |last_ping_received_| will be updated.
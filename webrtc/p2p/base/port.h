@@ -360,6 +360,9 @@ class Port : public PortInterface, public rtc::MessageHandler,
   // username_fragment().
   std::string ice_username_fragment_;
   std::string password_;
+  // HMAC key state for |password_|, used to check incoming requests and to
+  // sign our responses to them.
+  StunMessageIntegrityKey integrity_key_;
   std::vector<Candidate> candidates_;
   AddressMap connections_;
   int timeout_delay_;
@@ -591,6 +594,9 @@ class Connection : public rtc::MessageHandler,
   // the use_candidate attribute.
   bool nominated_;
   IceMode remote_ice_mode_;
+  // HMAC key state for the remote candidate's password, used to sign our
+  // pings and to check the responses to them.
+  StunMessageIntegrityKey remote_integrity_key_;
   StunRequestManager requests_;
   uint32 rtt_;
   uint32 last_ping_sent_;      // last time we sent a ping to the other side
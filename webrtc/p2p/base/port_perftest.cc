@@ -0,0 +1,95 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/bytebuffer.h"
+#include "webrtc/base/network.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/thread.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/p2p/base/basicpacketsocketfactory.h"
+#include "webrtc/p2p/base/port.h"
+#include "webrtc/p2p/base/stun.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace cricket {
+namespace {
+
+// A port that only handles incoming STUN messages.
+class StunOnlyPort : public Port {
+ public:
+  StunOnlyPort(rtc::Thread* thread,
+               rtc::PacketSocketFactory* factory,
+               rtc::Network* network,
+               const std::string& username_fragment,
+               const std::string& password)
+      : Port(thread, "test", factory, network, network->ip(), 0, 0,
+             username_fragment, password) {}
+
+  using Port::GetStunMessage;
+
+  void PrepareAddress() override {}
+  Connection* CreateConnection(const Candidate& remote_candidate,
+                               CandidateOrigin origin) override {
+    return NULL;
+  }
+  int SendTo(const void* data, size_t size, const rtc::SocketAddress& addr,
+             const rtc::PacketOptions& options, bool payload) override {
+    return static_cast<int>(size);
+  }
+  int SetOption(rtc::Socket::Option opt, int value) override { return 0; }
+  int GetOption(rtc::Socket::Option opt, int* value) override { return -1; }
+  int GetError() override { return 0; }
+};
+
+}  // namespace
+
+// Measures how many ICE binding requests, with USERNAME, PRIORITY,
+// ICE-CONTROLLING, MESSAGE-INTEGRITY and FINGERPRINT, GetStunMessage()
+// checks and parses per second.
+TEST(PortPerfTest, GetStunMessageForBindingRequests) {
+  rtc::AutoThread main;
+  rtc::Network network("unittest", "unittest", rtc::IPAddress(INADDR_ANY), 32);
+  network.AddIP(rtc::IPAddress(INADDR_ANY));
+  rtc::BasicPacketSocketFactory socket_factory(rtc::Thread::Current());
+  StunOnlyPort port(rtc::Thread::Current(), &socket_factory, &network,
+                    "rfrag", "rpass");
+
+  IceMessage request;
+  request.SetType(STUN_BINDING_REQUEST);
+  request.SetTransactionID("0123456789ab");
+  request.AddAttribute(
+      new StunByteStringAttribute(STUN_ATTR_USERNAME, "rfrag:lfrag"));
+  request.AddAttribute(new StunUInt32Attribute(STUN_ATTR_PRIORITY, 1234));
+  request.AddAttribute(new StunUInt64Attribute(STUN_ATTR_ICE_CONTROLLING, 1));
+  request.AddMessageIntegrity("rpass");
+  request.AddFingerprint();
+  rtc::ByteBuffer buf;
+  ASSERT_TRUE(request.Write(&buf));
+
+  const int kNumRequests = 100000;
+  rtc::SocketAddress addr("192.168.1.2", 0);
+  rtc::scoped_ptr<IceMessage> msg;
+  std::string username;
+  uint64 start = rtc::TimeMicros();
+  for (int i = 0; i < kNumRequests; ++i) {
+    ASSERT_TRUE(port.GetStunMessage(buf.Data(), buf.Length(), addr,
+                                    msg.accept(), &username));
+    ASSERT_TRUE(msg.get() != NULL);
+  }
+  uint64 elapsed_us = rtc::TimeMicros() - start;
+  EXPECT_EQ("lfrag", username);
+  webrtc::test::PrintResult("stun_binding_request", "", "get_stun_message",
+                            static_cast<size_t>(elapsed_us * 1000 /
+                                                kNumRequests),
+                            "ns/request", true);
+}
+
+}  // namespace cricket
@@ -1977,6 +1977,35 @@ TEST_F(PortTest, TestHandleStunBindingIndication) {
   EXPECT_GT(last_ping_received2, last_ping_received1);
 }
 
+// Test that a STUN binding indication with a valid FINGERPRINT but a
+// malformed attribute is not accepted.
+TEST_F(PortTest, TestHandleStunBindingIndicationWithBadAttribute) {
+  rtc::scoped_ptr<TestPort> port(
+      CreateTestPort(kLocalAddr2, "lfrag", "lpass"));
+  rtc::SocketAddress addr(kLocalAddr1);
+  rtc::scoped_ptr<IceMessage> out_msg;
+  std::string username;
+
+  // XOR-MAPPED-ADDRESS with a one byte value, followed by FINGERPRINT.
+  ByteBuffer buf;
+  buf.WriteUInt16(STUN_BINDING_INDICATION);
+  buf.WriteUInt16(16);
+  buf.WriteUInt32(kStunMagicCookie);
+  buf.WriteString("TESTTESTTEST");
+  buf.WriteUInt16(STUN_ATTR_XOR_MAPPED_ADDRESS);
+  buf.WriteUInt16(1);
+  buf.WriteUInt32(0x01000000);
+  uint32 crc = rtc::ComputeCrc32(buf.Data(), buf.Length()) ^ 0x5354554E;
+  buf.WriteUInt16(STUN_ATTR_FINGERPRINT);
+  buf.WriteUInt16(4);
+  buf.WriteUInt32(crc);
+  ASSERT_TRUE(StunMessage::ValidateFingerprint(buf.Data(), buf.Length()));
+
+  EXPECT_FALSE(port->GetStunMessage(buf.Data(), buf.Length(), addr,
+                                    out_msg.accept(), &username));
+  EXPECT_TRUE(out_msg.get() == NULL);
+}
+
 TEST_F(PortTest, TestComputeCandidatePriority) {
   rtc::scoped_ptr<TestPort> port(
       CreateTestPort(kLocalAddr1, "name", "pass"));
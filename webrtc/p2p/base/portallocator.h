@@ -53,6 +53,10 @@ enum {
   // Disallow use of UDP when connecting to a relay server. Since proxy servers
   // usually don't handle UDP, using UDP will leak the IP address.
   PORTALLOCATOR_DISABLE_UDP_RELAY = 0x1000,
+  // Run all allocation phases of a network at once instead of one per step
+  // delay, so that every kind of candidate, relay ones included, is signaled
+  // as soon as it has been gathered.
+  PORTALLOCATOR_ENABLE_PARALLEL_GATHERING = 0x2000,
 };
 
 const uint32 kDefaultPortAllocatorFlags = 0;
@@ -62,6 +66,9 @@ const uint32 kDefaultStepDelay = 1000;  // 1 sec step delay.
 // internal. Less than 20ms is not acceptable. We choose 50ms as our default.
 const uint32 kMinimumStepDelay = 50;
 
+// No limit on the number of networks gathering candidates at the same time.
+const int kUnlimitedGatheringConcurrency = 0;
+
 // CF = CANDIDATE FILTER
 enum {
   CF_NONE = 0x0,
@@ -125,7 +132,8 @@ class PortAllocator : public sigslot::has_slots<> {
       max_port_(0),
       step_delay_(kDefaultStepDelay),
       allow_tcp_listen_(true),
-      candidate_filter_(CF_ALL) {
+      candidate_filter_(CF_ALL),
+      gathering_concurrency_(kUnlimitedGatheringConcurrency) {
     // This will allow us to have old behavior on non webrtc clients.
   }
   virtual ~PortAllocator() {}
@@ -170,6 +178,13 @@ class PortAllocator : public sigslot::has_slots<> {
     allow_tcp_listen_ = allow_tcp_listen;
   }
 
+  // Gets/Sets the maximum number of networks that gather candidates at the
+  // same time. The remaining networks are started as earlier ones finish.
+  int gathering_concurrency() const { return gathering_concurrency_; }
+  void set_gathering_concurrency(int concurrency) {
+    gathering_concurrency_ = concurrency;
+  }
+
   uint32 candidate_filter() { return candidate_filter_; }
   bool set_candidate_filter(uint32 filter) {
     // TODO(mallinath) - Do transition check?
@@ -196,6 +211,7 @@ class PortAllocator : public sigslot::has_slots<> {
   uint32 step_delay_;
   bool allow_tcp_listen_;
   uint32 candidate_filter_;
+  int gathering_concurrency_;
   std::string origin_;
 };
 
@@ -10,6 +10,7 @@
 
 #include "webrtc/p2p/base/pseudotcp.h"
 
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -112,6 +113,8 @@ const uint32 DEF_ACK_DELAY = 100; // 100 milliseconds
 
 const uint8 FLAG_CTL = 0x02;
 const uint8 FLAG_RST = 0x04;
+// The payload of an ACK with this flag holds SACK blocks, not data.
+const uint8 FLAG_SACK = 0x08;
 
 const uint8 CTL_CONNECT = 0;
 
@@ -120,6 +123,16 @@ const uint8 TCP_OPT_EOL = 0;  // End of list.
 const uint8 TCP_OPT_NOOP = 1;  // No-op.
 const uint8 TCP_OPT_MSS = 2;  // Maximum segment size.
 const uint8 TCP_OPT_WND_SCALE = 3;  // Window scale factor.
+const uint8 TCP_OPT_SACK_PERMITTED = 4;  // Selective acknowledgement.
+
+// Each SACK block is a pair of 32-bit sequence numbers [left, right).
+const uint32 SACK_BLOCK_SIZE = 8;
+const uint32 MAX_SACK_BLOCKS = 4;
+
+// CUBIC constants (RFC 8312): multiplicative decrease factor and the
+// scaling constant C, in segments per second cubed.
+const double CUBIC_BETA = 0.7;
+const double CUBIC_C = 0.4;
 
 const long DEFAULT_TIMEOUT = 4000; // If there are no pending clocks, wake up every 4 seconds
 const long CLOSED_TIMEOUT = 60 * 1000; // If the connection is closed, once per minute
@@ -245,6 +258,14 @@ PseudoTcp::PseudoTcp(IPseudoTcpNotify* notify, uint32 conv)
   m_dup_acks = 0;
   m_recover = 0;
 
+  m_sack_permitted = false;
+  m_sack_high = m_rexmit_nxt = 0;
+
+  m_cc = CC_NEWRENO;
+  m_cubic_wmax = m_cubic_epoch = 0;
+
+  m_packet.reset(new uint8[MAX_PACKET]);
+
   m_ts_recent = m_ts_lastack = 0;
 
   m_rx_rto = DEF_RTO;
@@ -253,6 +274,7 @@ PseudoTcp::PseudoTcp(IPseudoTcpNotify* notify, uint32 conv)
   m_use_nagling = true;
   m_ack_delay = DEF_ACK_DELAY;
   m_support_wnd_scale = true;
+  m_support_sack = true;
 }
 
 PseudoTcp::~PseudoTcp() {
@@ -304,10 +326,13 @@ void PseudoTcp::NotifyClock(uint32 now) {
       }
 
       uint32 nInFlight = m_snd_nxt - m_snd_una;
-      m_ssthresh = std::max(nInFlight / 2, 2 * m_mss);
+      m_ssthresh = lossThreshold(nInFlight);
       //LOG(LS_INFO) << "m_ssthresh: " << m_ssthresh << "  nInFlight: " << nInFlight << "  m_mss: " << m_mss;
       m_cwnd = m_mss;
 
+      // Holes resent earlier in this episode may have been lost again.
+      m_rexmit_nxt = m_snd_una;
+
       // Back off retransmit timer.  Note: the limit is lower when connecting.
       uint32 rto_limit = (m_state < TCP_ESTABLISHED) ? DEF_RTO : MAX_RTO;
       m_rx_rto = std::min(rto_limit, m_rx_rto * 2);
@@ -371,6 +396,8 @@ void PseudoTcp::GetOption(Option opt, int* value) {
     *value = m_sbuf_len;
   } else if (opt == OPT_RCVBUF) {
     *value = m_rbuf_len;
+  } else if (opt == OPT_CONGESTION_CONTROL) {
+    *value = m_cc;
   } else {
     ASSERT(false);
   }
@@ -386,6 +413,10 @@ void PseudoTcp::SetOption(Option opt, int value) {
   } else if (opt == OPT_RCVBUF) {
     ASSERT(m_state == TCP_LISTEN);
     resizeReceiveBuffer(value);
+  } else if (opt == OPT_CONGESTION_CONTROL) {
+    ASSERT(value == CC_NEWRENO || value == CC_CUBIC);
+    m_cc = static_cast<CongestionControl>(value);
+    m_cubic_epoch = 0;
   } else {
     ASSERT(false);
   }
@@ -512,24 +543,47 @@ IPseudoTcpNotify::WriteResult PseudoTcp::packet(uint32 seq, uint8 flags,
 
   uint32 now = Now();
 
-  rtc::scoped_ptr<uint8[]> buffer(new uint8[MAX_PACKET]);
-  long_to_bytes(m_conv, buffer.get());
-  long_to_bytes(seq, buffer.get() + 4);
-  long_to_bytes(m_rcv_nxt, buffer.get() + 8);
+  uint8* buffer = m_packet.get();
+  long_to_bytes(m_conv, buffer);
+  long_to_bytes(seq, buffer + 4);
+  long_to_bytes(m_rcv_nxt, buffer + 8);
   buffer[12] = 0;
   buffer[13] = flags;
   short_to_bytes(
-      static_cast<uint16>(m_rcv_wnd >> m_rwnd_scale), buffer.get() + 14);
+      static_cast<uint16>(m_rcv_wnd >> m_rwnd_scale), buffer + 14);
 
   // Timestamp computations
-  long_to_bytes(now, buffer.get() + 16);
-  long_to_bytes(m_ts_recent, buffer.get() + 20);
+  long_to_bytes(now, buffer + 16);
+  long_to_bytes(m_ts_recent, buffer + 20);
   m_ts_lastack = m_rcv_nxt;
 
+  // A pure ACK reports the out-of-order data we hold, lowest blocks first
+  // since those are the holes the sender has to fill next.
+  uint32 sack_len = 0;
+  if (!len && m_sack_permitted && !m_rlist.empty()) {
+    RList::const_iterator it = m_rlist.begin();
+    while (it != m_rlist.end() &&
+           sack_len < MAX_SACK_BLOCKS * SACK_BLOCK_SIZE) {
+      uint32 left = it->seq;
+      uint32 right = it->seq + it->len;
+      for (++it; it != m_rlist.end() && it->seq <= right; ++it) {
+        right = std::max(right, it->seq + it->len);
+      }
+      if (right <= m_rcv_nxt)
+        continue;
+      long_to_bytes(std::max(left, m_rcv_nxt),
+                    buffer + HEADER_SIZE + sack_len);
+      long_to_bytes(right, buffer + HEADER_SIZE + sack_len + 4);
+      sack_len += SACK_BLOCK_SIZE;
+    }
+    if (sack_len)
+      buffer[13] |= FLAG_SACK;
+  }
+
   if (len) {
     size_t bytes_read = 0;
     rtc::StreamResult result = m_sbuf.ReadOffset(
-        buffer.get() + HEADER_SIZE, len, offset, &bytes_read);
+        buffer + HEADER_SIZE, len, offset, &bytes_read);
     RTC_UNUSED(result);
     ASSERT(result == rtc::SR_SUCCESS);
     ASSERT(static_cast<uint32>(bytes_read) == len);
@@ -547,7 +601,7 @@ IPseudoTcpNotify::WriteResult PseudoTcp::packet(uint32 seq, uint8 flags,
 #endif // _DEBUGMSG
 
   IPseudoTcpNotify::WriteResult wres = m_notify->TcpWritePacket(
-      this, reinterpret_cast<char *>(buffer.get()), len + HEADER_SIZE);
+      this, reinterpret_cast<char *>(buffer), len + sack_len + HEADER_SIZE);
   // Note: When len is 0, this is an ACK packet.  We don't read the return value for those,
   // and thus we won't retry.  So go ahead and treat the packet as a success (basically simulate
   // as if it were dropped), which will prevent our timers from being messed up.
@@ -663,6 +717,14 @@ bool PseudoTcp::process(Segment& seg) {
     return false;
   }
 
+  // SACK blocks ride on pure ACKs; the segment carries no data.
+  if (seg.flags & FLAG_SACK) {
+    if (m_sack_permitted) {
+      processSackBlocks(seg.data, seg.len);
+    }
+    seg.len = 0;
+  }
+
   // Check for control data
   bool bConnect = false;
   if (seg.flags & FLAG_CTL) {
@@ -675,6 +737,10 @@ bool PseudoTcp::process(Segment& seg) {
       // TCP options are in the remainder of the payload after CTL_CONNECT.
       parseOptions(&seg.data[1], seg.len - 1);
 
+      // A new connection starts with an empty SACK scoreboard.
+      if (m_state == TCP_LISTEN || m_state == TCP_SYN_SENT)
+        m_sack_high = m_rexmit_nxt = m_snd_una;
+
       if (m_state == TCP_LISTEN) {
         m_state = TCP_SYN_RECEIVED;
         LOG(LS_INFO) << "State: TCP_SYN_RECEIVED";
@@ -759,13 +825,28 @@ bool PseudoTcp::process(Segment& seg) {
         LOG(LS_INFO) << "exit recovery";
 #endif // _DEBUGMSG
         m_dup_acks = 0;
+        // Blocks reported in this episode are all below m_recover now, so a
+        // later episode must not chase holes up to this one's highest block.
+        m_sack_high = m_rexmit_nxt = m_snd_una;
       } else {
 #if _DEBUGMSG >= _DBG_NORMAL
         LOG(LS_INFO) << "recovery retransmit";
 #endif // _DEBUGMSG
-        if (!transmit(m_slist.begin(), now)) {
-          closedown(ECONNABORTED);
-          return false;
+        // Without SACK the new head is the only hole we know about. With
+        // SACK, fill the next reported hole, or the head if no hole is known
+        // and it hasn't been resent yet in this episode.
+        SList::iterator hole = m_slist.begin();
+        if (m_sack_permitted) {
+          hole = nextSackHole();
+          if (hole == m_slist.end() && m_slist.begin()->seq >= m_rexmit_nxt)
+            hole = m_slist.begin();
+        }
+        if (hole != m_slist.end()) {
+          if (!transmit(hole, now)) {
+            closedown(ECONNABORTED);
+            return false;
+          }
+          m_rexmit_nxt = hole->seq + hole->len;
         }
         m_cwnd += m_mss - std::min(nAcked, m_cwnd);
       }
@@ -775,7 +856,7 @@ bool PseudoTcp::process(Segment& seg) {
       if (m_cwnd < m_ssthresh) {
         m_cwnd += m_mss;
       } else {
-        m_cwnd += std::max<uint32>(1, m_mss * m_mss / m_cwnd);
+        m_cwnd += congestionAvoidanceIncrease(now);
       }
     }
   } else if (seg.ack == m_snd_una) {
@@ -797,12 +878,24 @@ bool PseudoTcp::process(Segment& seg) {
           return false;
         }
         m_recover = m_snd_nxt;
+        m_rexmit_nxt = m_slist.begin()->seq + m_slist.begin()->len;
         uint32 nInFlight = m_snd_nxt - m_snd_una;
-        m_ssthresh = std::max(nInFlight / 2, 2 * m_mss);
+        m_ssthresh = lossThreshold(nInFlight);
         //LOG(LS_INFO) << "m_ssthresh: " << m_ssthresh << "  nInFlight: " << nInFlight << "  m_mss: " << m_mss;
         m_cwnd = m_ssthresh + 3 * m_mss;
       } else if (m_dup_acks > 3) {
         m_cwnd += m_mss;
+        // Each further duplicate ACK means another segment left the network,
+        // which pays for one retransmission of a SACK-reported hole.
+        SList::iterator hole =
+            m_sack_permitted ? nextSackHole() : m_slist.end();
+        if (hole != m_slist.end()) {
+          if (!transmit(hole, now)) {
+            closedown(ECONNABORTED);
+            return false;
+          }
+          m_rexmit_nxt = hole->seq + hole->len;
+        }
       }
     } else {
       m_dup_acks = 0;
@@ -1116,6 +1209,71 @@ void PseudoTcp::attemptSend(SendFlags sflags) {
   }
 }
 
+void PseudoTcp::processSackBlocks(const char* data, uint32 len) {
+  for (uint32 i = 0; i + SACK_BLOCK_SIZE <= len &&
+       i < MAX_SACK_BLOCKS * SACK_BLOCK_SIZE; i += SACK_BLOCK_SIZE) {
+    uint32 left = bytes_to_long(data + i);
+    uint32 right = bytes_to_long(data + i + 4);
+    // Ignore blocks that are stale or that claim data we never sent.
+    if (left >= right || right <= m_snd_una || right > m_snd_nxt)
+      continue;
+    m_sack_high = std::max(m_sack_high, right);
+    for (SList::iterator it = m_slist.begin();
+         it != m_slist.end() && it->seq < right; ++it) {
+      if (it->xmit > 0 && it->seq >= left && it->seq + it->len <= right) {
+        it->bSacked = true;
+      }
+    }
+  }
+}
+
+PseudoTcp::SList::iterator PseudoTcp::nextSackHole() {
+  for (SList::iterator it = m_slist.begin();
+       it != m_slist.end() && it->seq < m_sack_high; ++it) {
+    if (it->xmit > 0 && !it->bSacked && it->seq >= m_rexmit_nxt)
+      return it;
+  }
+  return m_slist.end();
+}
+
+uint32 PseudoTcp::congestionAvoidanceIncrease(uint32 now) {
+  uint32 reno = std::max<uint32>(1, m_mss * m_mss / m_cwnd);
+  if (m_cc != CC_CUBIC)
+    return reno;
+
+  // W(t) = C * (t - K)^3 + W_max, in segments, with t measured from the
+  // start of the epoch and looking one RTT ahead.
+  if (m_cubic_epoch == 0) {
+    m_cubic_epoch = now;
+    m_cubic_wmax = std::max(m_cubic_wmax, m_cwnd);
+  }
+  double wmax = static_cast<double>(m_cubic_wmax) / m_mss;
+  double k = cbrt(wmax * (1 - CUBIC_BETA) / CUBIC_C);
+  double t = rtc::TimeDiff(now + m_rx_srtt, m_cubic_epoch) / 1000.0;
+  double target = (CUBIC_C * (t - k) * (t - k) * (t - k) + wmax) * m_mss;
+  if (target <= m_cwnd) {
+    // Plateau around W_max; never grow slower than Reno would.
+    return reno;
+  }
+  // Spread the step towards the target over the ACKs of one window.
+  uint32 increase = static_cast<uint32>((target - m_cwnd) * m_mss / m_cwnd);
+  return bound(reno, increase, m_mss);
+}
+
+uint32 PseudoTcp::lossThreshold(uint32 in_flight) {
+  if (m_cc != CC_CUBIC)
+    return std::max(in_flight / 2, 2 * m_mss);
+
+  // Fast convergence: release bandwidth when losses come before W_max.
+  if (m_cwnd < m_cubic_wmax) {
+    m_cubic_wmax = static_cast<uint32>(m_cwnd * (1 + CUBIC_BETA) / 2);
+  } else {
+    m_cubic_wmax = m_cwnd;
+  }
+  m_cubic_epoch = 0;
+  return std::max(static_cast<uint32>(in_flight * CUBIC_BETA), 2 * m_mss);
+}
+
 void
 PseudoTcp::closedown(uint32 err) {
   LOG(LS_INFO) << "State: TCP_CLOSED";
@@ -1156,6 +1314,11 @@ PseudoTcp::disableWindowScale() {
   m_support_wnd_scale = false;
 }
 
+void
+PseudoTcp::disableSack() {
+  m_support_sack = false;
+}
+
 void
 PseudoTcp::queueConnectMessage() {
   rtc::ByteBuffer buf(rtc::ByteBuffer::ORDER_NETWORK);
@@ -1166,6 +1329,10 @@ PseudoTcp::queueConnectMessage() {
     buf.WriteUInt8(1);
     buf.WriteUInt8(m_rwnd_scale);
   }
+  if (m_support_sack) {
+    buf.WriteUInt8(TCP_OPT_SACK_PERMITTED);
+    buf.WriteUInt8(0);
+  }
   m_snd_wnd = static_cast<uint32>(buf.Length());
   queue(buf.Data(), static_cast<uint32>(buf.Length()), true);
 }
@@ -1231,6 +1398,9 @@ PseudoTcp::applyOption(char kind, const char* data, uint32 len) {
       return;
     }
     applyWindowScaleOption(data[0]);
+  } else if (kind == TCP_OPT_SACK_PERMITTED) {
+    // http://www.ietf.org/rfc/rfc2018.txt
+    m_sack_permitted = m_support_sack;
   }
 }
 
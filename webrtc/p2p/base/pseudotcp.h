@@ -14,6 +14,7 @@
 #include <list>
 
 #include "webrtc/base/basictypes.h"
+#include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/stream.h"
 
 namespace cricket {
@@ -89,6 +90,11 @@ class PseudoTcp {
     OPT_ACKDELAY,     // The Delayed ACK timeout (0 == off).
     OPT_RCVBUF,       // Set the receive buffer size, in bytes.
     OPT_SNDBUF,       // Set the send buffer size, in bytes.
+    OPT_CONGESTION_CONTROL,  // One of CongestionControl (default NewReno).
+  };
+  enum CongestionControl {
+    CC_NEWRENO,  // RFC 5681 / RFC 6582.
+    CC_CUBIC,    // RFC 8312; grows faster on high bandwidth-delay paths.
   };
   void GetOption(Option opt, int* value);
   void SetOption(Option opt, int value);
@@ -121,12 +127,14 @@ class PseudoTcp {
 
   struct SSegment {
     SSegment(uint32 s, uint32 l, bool c)
-        : seq(s), len(l), /*tstamp(0),*/ xmit(0), bCtrl(c) {
+        : seq(s), len(l), /*tstamp(0),*/ xmit(0), bCtrl(c), bSacked(false) {
     }
     uint32 seq, len;
     //uint32 tstamp;
     uint8 xmit;
     bool bCtrl;
+    // Set once the peer has selectively acknowledged this segment.
+    bool bSacked;
   };
   typedef std::list<SSegment> SList;
 
@@ -159,6 +167,17 @@ class PseudoTcp {
 
   void adjustMTU();
 
+  // Marks the segments covered by the SACK blocks in |data| as received.
+  void processSackBlocks(const char* data, uint32 len);
+  // Returns the next segment in the current recovery episode that was sent
+  // but is missing below the highest SACKed byte, or m_slist.end().
+  SList::iterator nextSackHole();
+
+  // Congestion window growth for one ACK in congestion avoidance, and the
+  // slow start threshold to use after a loss with |in_flight| bytes out.
+  uint32 congestionAvoidanceIncrease(uint32 now);
+  uint32 lossThreshold(uint32 in_flight);
+
  protected:
   // This method is used in test only to query receive buffer state.
   bool isReceiveBufferFull() const;
@@ -167,6 +186,10 @@ class PseudoTcp {
   // support for testing backward compatibility.
   void disableWindowScale();
 
+  // This method is only used in tests, to disable selective acknowledgement
+  // for comparison and backward compatibility testing.
+  void disableSack();
+
  private:
   // Queue the connect message with TCP options.
   void queueConnectMessage();
@@ -223,10 +246,24 @@ class PseudoTcp {
 
   // Congestion avoidance, Fast retransmit/recovery, Delayed ACKs
   uint32 m_ssthresh, m_cwnd;
-  uint8 m_dup_acks;
+  uint32 m_dup_acks;
   uint32 m_recover;
   uint32 m_t_ack;
 
+  // Selective acknowledgement (RFC 2018). |m_sack_high| is the highest
+  // sequence number the peer has SACKed; |m_rexmit_nxt| is where the search
+  // for the next hole to retransmit resumes during recovery.
+  bool m_sack_permitted;
+  uint32 m_sack_high, m_rexmit_nxt;
+
+  // CUBIC state: window before the last reduction and the time the current
+  // growth epoch started (0 if none).
+  CongestionControl m_cc;
+  uint32 m_cubic_wmax, m_cubic_epoch;
+
+  // Reused for every outgoing packet, so sending does not allocate.
+  rtc::scoped_ptr<uint8[]> m_packet;
+
   // Configuration options
   bool m_use_nagling;
   uint32 m_ack_delay;
@@ -234,6 +271,7 @@ class PseudoTcp {
   // This is used by unit tests to test backward compatibility of
   // PseudoTcp implementations that don't support window scaling.
   bool m_support_wnd_scale;
+  bool m_support_sack;
 };
 
 }  // namespace cricket
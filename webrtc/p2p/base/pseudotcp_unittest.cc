@@ -9,6 +9,7 @@
  */
 
 #include <algorithm>
+#include <set>
 #include <vector>
 
 #include "webrtc/p2p/base/pseudotcp.h"
@@ -38,6 +39,10 @@ class PseudoTcpForTest : public cricket::PseudoTcp {
   void disableWindowScale() {
     PseudoTcp::disableWindowScale();
   }
+
+  void disableSack() {
+    PseudoTcp::disableSack();
+  }
 };
 
 class PseudoTcpTestBase : public testing::Test,
@@ -52,7 +57,11 @@ class PseudoTcpTestBase : public testing::Test,
         local_mtu_(65535),
         remote_mtu_(65535),
         delay_(0),
-        loss_(0) {
+        loss_(0),
+        local_sent_high_(0),
+        local_new_segments_(0),
+        local_dropped_bytes_(0),
+        local_retransmitted_bytes_(0) {
     // Set use of the test RNG to get predictable loss patterns.
     rtc::SetRandomTestMode(true);
   }
@@ -74,6 +83,11 @@ class PseudoTcpTestBase : public testing::Test,
   void SetLoss(int percent) {
     loss_ = percent;
   }
+  // Drops the first transmission of the |index|th data segment that the local
+  // side sends, counting from zero.
+  void DropLocalSegment(int index) {
+    local_drops_.insert(index);
+  }
   void SetOptNagling(bool enable_nagles) {
     local_.SetOption(PseudoTcp::OPT_NODELAY, !enable_nagles);
     remote_.SetOption(PseudoTcp::OPT_NODELAY, !enable_nagles);
@@ -98,6 +112,14 @@ class PseudoTcpTestBase : public testing::Test,
   void DisableLocalWindowScale() {
     local_.disableWindowScale();
   }
+  void DisableSack() {
+    local_.disableSack();
+    remote_.disableSack();
+  }
+  void SetOptCongestionControl(PseudoTcp::CongestionControl cc) {
+    local_.SetOption(PseudoTcp::OPT_CONGESTION_CONTROL, cc);
+    remote_.SetOption(PseudoTcp::OPT_CONGESTION_CONTROL, cc);
+  }
 
  protected:
   int Connect() {
@@ -141,7 +163,9 @@ class PseudoTcpTestBase : public testing::Test,
                                      const char* buffer, size_t len) {
     // Randomly drop the desired percentage of packets.
     // Also drop packets that are larger than the configured MTU.
-    if (rtc::CreateRandomId() % 100 < static_cast<uint32>(loss_)) {
+    if (tcp == &local_ && !OnLocalSegment(buffer, len)) {
+      LOG(LS_VERBOSE) << "Dropping packet as scripted, size=" << len;
+    } else if (rtc::CreateRandomId() % 100 < static_cast<uint32>(loss_)) {
       LOG(LS_VERBOSE) << "Randomly dropping packet, size=" << len;
     } else if (len > static_cast<size_t>(std::min(local_mtu_, remote_mtu_))) {
       LOG(LS_VERBOSE) << "Dropping packet that exceeds path MTU, size=" << len;
@@ -154,6 +178,30 @@ class PseudoTcpTestBase : public testing::Test,
     return WR_SUCCESS;
   }
 
+  // Counts the data that |local_| sends, and returns false if the packet is
+  // to be dropped by DropLocalSegment(). Segments are laid out as in
+  // PseudoTcp::packet(): a 24 byte header with the sequence number at offset 4
+  // and the flags at offset 13.
+  bool OnLocalSegment(const char* buffer, size_t len) {
+    const size_t kHeaderSize = 24;
+    const uint8 kFlagCtl = 0x02;
+    const uint8 kFlagSack = 0x08;
+    if (len <= kHeaderSize || (buffer[13] & (kFlagCtl | kFlagSack)))
+      return true;
+    uint32 seq = rtc::GetBE32(buffer + 4);
+    uint32 end = seq + static_cast<uint32>(len - kHeaderSize);
+    if (seq < local_sent_high_) {
+      local_retransmitted_bytes_ += std::min(end, local_sent_high_) - seq;
+      local_sent_high_ = std::max(local_sent_high_, end);
+      return true;
+    }
+    local_sent_high_ = end;
+    if (!local_drops_.count(local_new_segments_++))
+      return true;
+    local_dropped_bytes_ += end - seq;
+    return false;
+  }
+
   void UpdateLocalClock() { UpdateClock(&local_, MSG_LCLOCK); }
   void UpdateRemoteClock() { UpdateClock(&remote_, MSG_RCLOCK); }
   void UpdateClock(PseudoTcp* tcp, uint32 message) {
@@ -204,10 +252,17 @@ class PseudoTcpTestBase : public testing::Test,
   int remote_mtu_;
   int delay_;
   int loss_;
+  std::set<int> local_drops_;
+  uint32 local_sent_high_;
+  int local_new_segments_;
+  size_t local_dropped_bytes_;
+  size_t local_retransmitted_bytes_;
 };
 
 class PseudoTcpTest : public PseudoTcpTestBase {
  public:
+  PseudoTcpTest() : transfer_time_ms_(0) {}
+
   void TestTransfer(int size) {
     uint32 start, elapsed;
     size_t received;
@@ -228,6 +283,7 @@ class PseudoTcpTest : public PseudoTcpTestBase {
     // been received.
     EXPECT_TRUE_WAIT(have_disconnected_, kTransferTimeoutMs);
     elapsed = rtc::TimeSince(start);
+    transfer_time_ms_ = elapsed;
     recv_stream_.GetSize(&received);
     // Ensure we closed down OK and we got the right data.
     // TODO: Ensure the errors are cleared properly.
@@ -308,6 +364,9 @@ class PseudoTcpTest : public PseudoTcpTestBase {
     *done = (tosend == 0);
   }
 
+ protected:
+  uint32 transfer_time_ms_;
+
  private:
   rtc::MemoryStream send_stream_;
   rtc::MemoryStream recv_stream_;
@@ -725,6 +784,112 @@ TEST_F(PseudoTcpTest, TestSendVerySmallReceiveBuffer) {
   TestTransfer(100000);
 }
 
+// Test a 100 ms RTT path with windows large enough to cover the
+// bandwidth-delay product.
+TEST_F(PseudoTcpTest, TestSendHighBdp) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetDelay(50);
+  SetRemoteOptRcvBuf(1000000);
+  SetLocalOptRcvBuf(1000000);
+  SetOptSndBuf(1500000);
+  TestTransfer(4000000);
+}
+
+// Test the same path with 1% loss. Losses are repaired from SACK information.
+TEST_F(PseudoTcpTest, TestSendHighBdpWithLoss) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetDelay(50);
+  SetLoss(1);
+  SetRemoteOptRcvBuf(1000000);
+  SetLocalOptRcvBuf(1000000);
+  SetOptSndBuf(1500000);
+  TestTransfer(500000);
+}
+
+// Same as above without SACK, so only NewReno partial ACKs drive recovery.
+TEST_F(PseudoTcpTest, TestSendHighBdpWithLossNoSack) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetDelay(50);
+  SetLoss(1);
+  SetRemoteOptRcvBuf(1000000);
+  SetLocalOptRcvBuf(1000000);
+  SetOptSndBuf(1500000);
+  DisableSack();
+  TestTransfer(500000);
+}
+
+// Same as TestSendHighBdpWithLoss, using CUBIC congestion control.
+TEST_F(PseudoTcpTest, TestSendHighBdpWithLossCubic) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetDelay(50);
+  SetLoss(1);
+  SetRemoteOptRcvBuf(1000000);
+  SetLocalOptRcvBuf(1000000);
+  SetOptSndBuf(1500000);
+  SetOptCongestionControl(PseudoTcp::CC_CUBIC);
+  TestTransfer(500000);
+}
+
+// Test sending data with 10% packet loss and SACK disabled on both sides.
+TEST_F(PseudoTcpTest, TestSendWithLossNoSack) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetLoss(10);
+  DisableSack();
+  TestTransfer(100000);
+}
+
+// Runs one transfer over the high-BDP path above in a fixture of its own, so
+// that a single test can compare two of them. Instead of random loss, which
+// would differ between the runs, the same burst of segments is dropped from
+// the last windows, along with a single loss after it.
+class PseudoTcpScriptedLossTransfer : public PseudoTcpTest {
+ public:
+  void Run(bool sack) {
+    SetLocalMtu(1500);
+    SetRemoteMtu(1500);
+    SetDelay(50);
+    SetRemoteOptRcvBuf(1000000);
+    SetLocalOptRcvBuf(1000000);
+    SetOptSndBuf(1500000);
+    if (!sack)
+      DisableSack();
+    for (int i = 100; i < 108; ++i)
+      DropLocalSegment(i);
+    DropLocalSegment(130);
+    TestTransfer(200000);
+  }
+
+  size_t dropped_bytes() const { return local_dropped_bytes_; }
+  size_t retransmitted_bytes() const { return local_retransmitted_bytes_; }
+  uint32 transfer_time_ms() const { return transfer_time_ms_; }
+
+ private:
+  void TestBody() override {}
+};
+
+// Test that SACK repairs every lost segment of a window within about a round
+// trip, where NewReno resends one per round trip, and that it resends only
+// what was lost.
+TEST(PseudoTcpLossRecoveryTest, SackRecoversFasterThanNewReno) {
+  PseudoTcpScriptedLossTransfer sack;
+  sack.Run(true);
+  PseudoTcpScriptedLossTransfer newreno;
+  newreno.Run(false);
+  LOG(LS_INFO) << "SACK: " << sack.retransmitted_bytes() << " bytes resent in "
+               << sack.transfer_time_ms() << " ms, NewReno: "
+               << newreno.retransmitted_bytes() << " bytes resent in "
+               << newreno.transfer_time_ms() << " ms";
+  EXPECT_EQ(9u * 1384, sack.dropped_bytes());
+  EXPECT_EQ(sack.dropped_bytes(), sack.retransmitted_bytes());
+  EXPECT_LE(sack.retransmitted_bytes(), newreno.retransmitted_bytes());
+  EXPECT_LT(sack.transfer_time_ms() + 300, newreno.transfer_time_ms());
+}
+
 // Ping-pong (request/response) tests
 
 // Test sending <= 1x MTU of data in each ping/pong.  Should take <10ms.
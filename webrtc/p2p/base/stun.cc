@@ -12,6 +12,8 @@
 
 #include <string.h>
 
+#include <algorithm>
+
 #include "webrtc/base/byteorder.h"
 #include "webrtc/base/common.h"
 #include "webrtc/base/crc32.h"
@@ -40,6 +42,12 @@ const char TURN_MAGIC_COOKIE_VALUE[] = { '\x72', '\xC6', '\x4B', '\xC6' };
 const char EMPTY_TRANSACTION_ID[] = "0000000000000000";
 const uint32 STUN_FINGERPRINT_XOR_VALUE = 0x5354554E;
 
+namespace {
+
+const size_t kHmacBlockSize = 64;
+
+}  // namespace
+
 // StunMessage
 
 StunMessage::StunMessage()
@@ -129,81 +137,14 @@ const StunUInt16ListAttribute* StunMessage::GetUnknownAttributes() const {
 // procedure outlined in RFC 5389, section 15.4.
 bool StunMessage::ValidateMessageIntegrity(const char* data, size_t size,
                                            const std::string& password) {
-  // Verifying the size of the message.
-  if ((size % 4) != 0) {
-    return false;
-  }
-
-  // Getting the message length from the STUN header.
-  uint16 msg_length = rtc::GetBE16(&data[2]);
-  if (size != (msg_length + kStunHeaderSize)) {
-    return false;
-  }
-
-  // Finding Message Integrity attribute in stun message.
-  size_t current_pos = kStunHeaderSize;
-  bool has_message_integrity_attr = false;
-  while (current_pos < size) {
-    uint16 attr_type, attr_length;
-    // Getting attribute type and length.
-    attr_type = rtc::GetBE16(&data[current_pos]);
-    attr_length = rtc::GetBE16(&data[current_pos + sizeof(attr_type)]);
-
-    // If M-I, sanity check it, and break out.
-    if (attr_type == STUN_ATTR_MESSAGE_INTEGRITY) {
-      if (attr_length != kStunMessageIntegritySize ||
-          current_pos + attr_length > size) {
-        return false;
-      }
-      has_message_integrity_attr = true;
-      break;
-    }
-
-    // Otherwise, skip to the next attribute.
-    current_pos += sizeof(attr_type) + sizeof(attr_length) + attr_length;
-    if ((attr_length % 4) != 0) {
-      current_pos += (4 - (attr_length % 4));
-    }
-  }
-
-  if (!has_message_integrity_attr) {
-    return false;
-  }
-
-  // Getting length of the message to calculate Message Integrity.
-  size_t mi_pos = current_pos;
-  rtc::scoped_ptr<char[]> temp_data(new char[current_pos]);
-  memcpy(temp_data.get(), data, current_pos);
-  if (size > mi_pos + kStunAttributeHeaderSize + kStunMessageIntegritySize) {
-    // Stun message has other attributes after message integrity.
-    // Adjust the length parameter in stun message to calculate HMAC.
-    size_t extra_offset = size -
-        (mi_pos + kStunAttributeHeaderSize + kStunMessageIntegritySize);
-    size_t new_adjusted_len = size - extra_offset - kStunHeaderSize;
-
-    // Writing new length of the STUN message @ Message Length in temp buffer.
-    //      0                   1                   2                   3
-    //      0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
-    //     +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-    //     |0 0|     STUN Message Type     |         Message Length        |
-    //     +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-    rtc::SetBE16(temp_data.get() + 2,
-                       static_cast<uint16>(new_adjusted_len));
-  }
-
-  char hmac[kStunMessageIntegritySize];
-  size_t ret = rtc::ComputeHmac(rtc::DIGEST_SHA_1,
-                                      password.c_str(), password.size(),
-                                      temp_data.get(), mi_pos,
-                                      hmac, sizeof(hmac));
-  ASSERT(ret == sizeof(hmac));
-  if (ret != sizeof(hmac))
-    return false;
+  StunMessageView view;
+  return view.Parse(data, size) && view.ValidateMessageIntegrity(password);
+}
 
-  // Comparing the calculated HMAC with the one present in the message.
-  return memcmp(data + current_pos + kStunAttributeHeaderSize,
-                hmac,
-                sizeof(hmac)) == 0;
+bool StunMessage::ValidateMessageIntegrity(
+    const char* data, size_t size, const StunMessageIntegrityKey& key) {
+  StunMessageView view;
+  return view.Parse(data, size) && view.ValidateMessageIntegrity(key);
 }
 
 bool StunMessage::AddMessageIntegrity(const std::string& password) {
@@ -243,6 +184,25 @@ bool StunMessage::AddMessageIntegrity(const char* key,
   return true;
 }
 
+bool StunMessage::AddMessageIntegrity(const StunMessageIntegrityKey& key) {
+  StunByteStringAttribute* msg_integrity_attr =
+      new StunByteStringAttribute(STUN_ATTR_MESSAGE_INTEGRITY,
+          std::string(kStunMessageIntegritySize, '0'));
+  VERIFY(AddAttribute(msg_integrity_attr));
+
+  rtc::ByteBuffer buf;
+  if (!Write(&buf))
+    return false;
+
+  // The attribute is the last one written, so the header length already ends
+  // right after it, as Compute() expects.
+  char hmac[kStunMessageIntegritySize];
+  key.Compute(buf.Data(),
+              buf.Length() - kStunAttributeHeaderSize - sizeof(hmac), hmac);
+  msg_integrity_attr->CopyBytes(hmac, sizeof(hmac));
+  return true;
+}
+
 // Verifies a message is in fact a STUN message, by performing the checks
 // outlined in RFC 5389, section 7.3, including the FINGERPRINT check detailed
 // in section 15.5.
@@ -412,6 +372,171 @@ bool StunMessage::IsValidTransactionId(const std::string& transaction_id) {
       transaction_id.size() == kStunLegacyTransactionIdLength;
 }
 
+// StunMessageIntegrityKey
+
+StunMessageIntegrityKey::StunMessageIntegrityKey() {
+  Init(std::string());
+}
+
+StunMessageIntegrityKey::StunMessageIntegrityKey(const std::string& password) {
+  Init(password);
+}
+
+void StunMessageIntegrityKey::SetPassword(const std::string& password) {
+  if (password != password_)
+    Init(password);
+}
+
+void StunMessageIntegrityKey::Compute(
+    const char* data, size_t mi_pos,
+    char hmac[kStunMessageIntegritySize]) const {
+  char length[sizeof(uint16)];
+  rtc::SetBE16(length, static_cast<uint16>(
+      mi_pos - kStunHeaderSize + kStunAttributeHeaderSize +
+      kStunMessageIntegritySize));
+
+  uint8 inner_hash[rtc::Sha1Digest::kSize];
+  rtc::Sha1Digest inner(inner_);
+  inner.Update(data, sizeof(uint16));
+  inner.Update(length, sizeof(length));
+  inner.Update(data + 2 * sizeof(uint16), mi_pos - 2 * sizeof(uint16));
+  inner.Finish(inner_hash, sizeof(inner_hash));
+
+  rtc::Sha1Digest outer(outer_);
+  outer.Update(inner_hash, sizeof(inner_hash));
+  outer.Finish(hmac, kStunMessageIntegritySize);
+}
+
+void StunMessageIntegrityKey::Init(const std::string& password) {
+  password_ = password;
+
+  // If the key is longer than a block, hash it and use the result instead.
+  uint8 key[kHmacBlockSize];
+  if (password.size() > kHmacBlockSize) {
+    rtc::Sha1Digest digest;
+    digest.Update(password.data(), password.size());
+    digest.Finish(key, sizeof(key));
+    memset(key + rtc::Sha1Digest::kSize, 0,
+           kHmacBlockSize - rtc::Sha1Digest::kSize);
+  } else {
+    memcpy(key, password.data(), password.size());
+    memset(key + password.size(), 0, kHmacBlockSize - password.size());
+  }
+
+  uint8 pad[kHmacBlockSize];
+  for (size_t i = 0; i < kHmacBlockSize; ++i)
+    pad[i] = key[i] ^ 0x36;
+  inner_ = rtc::Sha1Digest();
+  inner_.Update(pad, sizeof(pad));
+
+  for (size_t i = 0; i < kHmacBlockSize; ++i)
+    pad[i] = key[i] ^ 0x5c;
+  outer_ = rtc::Sha1Digest();
+  outer_.Update(pad, sizeof(pad));
+}
+
+// StunMessageView
+
+StunMessageView::StunMessageView()
+    : data_(NULL),
+      size_(0),
+      attributes_end_(0),
+      type_(0),
+      legacy_(false),
+      integrity_offset_(0) {
+}
+
+bool StunMessageView::Parse(const char* data, size_t size) {
+  data_ = NULL;
+  size_ = 0;
+  attributes_end_ = 0;
+  type_ = 0;
+  legacy_ = false;
+  integrity_offset_ = 0;
+
+  if (size < kStunHeaderSize)
+    return false;
+
+  // RTP and RTCP set the MSB of first byte, see StunMessage::Read().
+  uint16 type = rtc::GetBE16(data);
+  if (type & 0x8000)
+    return false;
+
+  if (rtc::GetBE16(data + sizeof(uint16)) + kStunHeaderSize != size)
+    return false;
+
+  // Per RFC 5389, section 15.4, attributes that follow MESSAGE-INTEGRITY
+  // (other than FINGERPRINT, which is checked on the raw buffer by
+  // StunMessage::ValidateFingerprint()) are ignored, so the walk stops there.
+  size_t pos = kStunHeaderSize;
+  while (pos < size) {
+    if (pos + kStunAttributeHeaderSize > size)
+      return false;
+    uint16 attr_type = rtc::GetBE16(data + pos);
+    size_t attr_length = rtc::GetBE16(data + pos + sizeof(uint16));
+    if (pos + kStunAttributeHeaderSize + attr_length > size)
+      return false;
+    if (attr_type == STUN_ATTR_MESSAGE_INTEGRITY)
+      integrity_offset_ = pos;
+    pos += kStunAttributeHeaderSize + attr_length;
+    if ((attr_length % 4) != 0)
+      pos += 4 - (attr_length % 4);
+    if (integrity_offset_ != 0)
+      break;
+  }
+
+  data_ = data;
+  size_ = size;
+  attributes_end_ = std::min(pos, size);
+  type_ = type;
+  // See StunMessage::Read().
+  legacy_ = rtc::GetBE32(data + kStunTransactionIdOffset -
+                         kStunMagicCookieLength) != kStunMagicCookie;
+  return true;
+}
+
+bool StunMessageView::GetAttribute(int type, const char** value,
+                                   size_t* length) const {
+  size_t pos = kStunHeaderSize;
+  while (pos < attributes_end_) {
+    uint16 attr_length = rtc::GetBE16(data_ + pos + sizeof(uint16));
+    if (rtc::GetBE16(data_ + pos) == type) {
+      *value = data_ + pos + kStunAttributeHeaderSize;
+      *length = attr_length;
+      return true;
+    }
+    pos += kStunAttributeHeaderSize + attr_length;
+    if ((attr_length % 4) != 0)
+      pos += 4 - (attr_length % 4);
+  }
+  return false;
+}
+
+bool StunMessageView::HasAttribute(int type) const {
+  const char* value;
+  size_t length;
+  return GetAttribute(type, &value, &length);
+}
+
+bool StunMessageView::ValidateMessageIntegrity(
+    const std::string& password) const {
+  return ValidateMessageIntegrity(StunMessageIntegrityKey(password));
+}
+
+bool StunMessageView::ValidateMessageIntegrity(
+    const StunMessageIntegrityKey& key) const {
+  if (integrity_offset_ == 0 || (size_ % 4) != 0)
+    return false;
+
+  const char* mi_attr = data_ + integrity_offset_;
+  if (rtc::GetBE16(mi_attr + sizeof(uint16)) != kStunMessageIntegritySize)
+    return false;
+
+  char hmac[kStunMessageIntegritySize];
+  key.Compute(data_, integrity_offset_, hmac);
+  return memcmp(mi_attr + kStunAttributeHeaderSize, hmac, sizeof(hmac)) == 0;
+}
+
 // StunAttribute
 
 StunAttribute::StunAttribute(uint16 type, uint16 length)
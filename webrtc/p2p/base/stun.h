@@ -19,6 +19,7 @@
 
 #include "webrtc/base/basictypes.h"
 #include "webrtc/base/bytebuffer.h"
+#include "webrtc/base/sha1digest.h"
 #include "webrtc/base/socketaddress.h"
 
 namespace cricket {
@@ -124,6 +125,7 @@ class StunUInt64Attribute;
 class StunByteStringAttribute;
 class StunErrorCodeAttribute;
 class StunUInt16ListAttribute;
+class StunMessageIntegrityKey;
 
 // Records a complete STUN/TURN message.  Each message consists of a type and
 // any number of attributes.  Each attribute is parsed into an instance of an
@@ -168,9 +170,14 @@ class StunMessage {
   // padding data (which we discard when reading a StunMessage).
   static bool ValidateMessageIntegrity(const char* data, size_t size,
                                        const std::string& password);
+  // Same as above, but with a key prepared once for the password.
+  static bool ValidateMessageIntegrity(const char* data, size_t size,
+                                       const StunMessageIntegrityKey& key);
   // Adds a MESSAGE-INTEGRITY attribute that is valid for the current message.
   bool AddMessageIntegrity(const std::string& password);
   bool AddMessageIntegrity(const char* key, size_t keylen);
+  // Same as above, but with a key prepared once for the password.
+  bool AddMessageIntegrity(const StunMessageIntegrityKey& key);
 
   // Verifies that a given buffer is STUN by checking for a correct FINGERPRINT.
   static bool ValidateFingerprint(const char* data, size_t size);
@@ -204,6 +211,90 @@ class StunMessage {
   std::vector<StunAttribute*>* attrs_;
 };
 
+// The HMAC-SHA1 key state for MESSAGE-INTEGRITY with a given password: the
+// SHA-1 states after absorbing the inner and the outer key pads.  Keeping
+// this around per ICE password means that checking a message only hashes
+// the message, instead of rehashing the key for every packet.
+class StunMessageIntegrityKey {
+ public:
+  StunMessageIntegrityKey();
+  explicit StunMessageIntegrityKey(const std::string& password);
+
+  const std::string& password() const { return password_; }
+
+  // Recomputes the key state if |password| differs from the current one.
+  void SetPassword(const std::string& password);
+
+  // Computes the MESSAGE-INTEGRITY value of a received message for a
+  // MESSAGE-INTEGRITY attribute located at |mi_pos|.  Per RFC 5389, section
+  // 15.4, the HMAC covers the message up to that attribute, with the header
+  // length field adjusted to end right after it.  The adjusted length is
+  // hashed separately so that the message does not need to be copied.
+  void Compute(const char* data, size_t mi_pos,
+               char hmac[kStunMessageIntegritySize]) const;
+
+ private:
+  void Init(const std::string& password);
+
+  std::string password_;
+  rtc::Sha1Digest inner_;
+  rtc::Sha1Digest outer_;
+};
+
+// A read-only view of a serialized STUN message.  Parse() checks the header
+// and the attribute framing in place, and attribute values are looked up
+// directly in the buffer afterwards.  Nothing is copied or allocated, which
+// makes this suitable for checking ICE connectivity checks before (or
+// instead of) building a StunMessage from them.  The buffer must outlive the
+// view.
+class StunMessageView {
+ public:
+  StunMessageView();
+
+  // Returns true if |data| holds a complete STUN message whose attributes,
+  // up to and including MESSAGE-INTEGRITY, fit within the message length.
+  bool Parse(const char* data, size_t size);
+
+  int type() const { return type_; }
+  const char* data() const { return data_; }
+  size_t size() const { return size_; }
+
+  // Like StunMessage, a message without the RFC 5389 magic cookie is an
+  // RFC 3489 message, whose transaction ID also covers the cookie's bytes.
+  bool IsLegacy() const { return legacy_; }
+
+  // Returns a pointer to the transaction ID, which is
+  // transaction_id_length() bytes long: 12, or 16 for legacy messages.
+  const char* transaction_id() const {
+    return data_ + (legacy_ ? kStunTransactionIdOffset - kStunMagicCookieLength
+                            : kStunTransactionIdOffset);
+  }
+  size_t transaction_id_length() const {
+    return legacy_ ? kStunLegacyTransactionIdLength : kStunTransactionIdLength;
+  }
+
+  // Looks up the first attribute of |type| that precedes or is the
+  // MESSAGE-INTEGRITY attribute.  If found, returns true and points |value|
+  // at the (unpadded) attribute value of |length| bytes.
+  bool GetAttribute(int type, const char** value, size_t* length) const;
+  bool HasAttribute(int type) const;
+
+  // Same as StunMessage::ValidateMessageIntegrity(), but computes the HMAC
+  // over the buffer in place instead of over a copy of the message.
+  bool ValidateMessageIntegrity(const std::string& password) const;
+  bool ValidateMessageIntegrity(const StunMessageIntegrityKey& key) const;
+
+ private:
+  const char* data_;
+  size_t size_;
+  // End of the attributes that Parse() has checked.
+  size_t attributes_end_;
+  int type_;
+  bool legacy_;
+  // Offset of the first MESSAGE-INTEGRITY attribute, or 0 if there is none.
+  size_t integrity_offset_;
+};
+
 // Base class for all STUN/TURN attributes.
 class StunAttribute {
  public:
@@ -0,0 +1,115 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/bytebuffer.h"
+#include "webrtc/base/crc32.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/p2p/base/stun.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace cricket {
+
+// Measures the CRC32 used for FINGERPRINT over STUN-sized (100 byte)
+// messages.
+TEST(StunPerfTest, Crc32) {
+  const int kNumMessages = 100000;
+  std::string input(100, 'X');
+  uint32 c = 0;
+  uint64 start = rtc::TimeMicros();
+  for (int i = 0; i < kNumMessages; ++i) {
+    c = rtc::UpdateCrc32(c, input.data(), input.size());
+  }
+  uint64 elapsed_us = rtc::TimeMicros() - start;
+  EXPECT_NE(0U, c);
+  webrtc::test::PrintResult("stun_crc32", "", "100_byte_message",
+                            static_cast<size_t>(elapsed_us * 1000 /
+                                                kNumMessages),
+                            "ns/message", true);
+}
+
+// Measures MESSAGE-INTEGRITY validation of a binding request with and
+// without a cached key, as for a burst of connectivity checks after an ICE
+// restart.
+TEST(StunPerfTest, ValidateMessageIntegrity) {
+  const int kNumMessages = 100000;
+  const std::string kPassword("rpass");
+  IceMessage msg;
+  msg.SetType(STUN_BINDING_REQUEST);
+  msg.SetTransactionID("0123456789ab");
+  msg.AddAttribute(
+      new StunByteStringAttribute(STUN_ATTR_USERNAME, "rfrag:lfrag"));
+  msg.AddAttribute(new StunUInt32Attribute(STUN_ATTR_PRIORITY, 1234));
+  ASSERT_TRUE(msg.AddMessageIntegrity(kPassword));
+  ASSERT_TRUE(msg.AddFingerprint());
+  rtc::ByteBuffer buf;
+  ASSERT_TRUE(msg.Write(&buf));
+
+  uint64 start = rtc::TimeMicros();
+  for (int i = 0; i < kNumMessages; ++i) {
+    ASSERT_TRUE(StunMessage::ValidateMessageIntegrity(buf.Data(),
+                                                      buf.Length(),
+                                                      kPassword));
+  }
+  uint64 uncached_us = rtc::TimeMicros() - start;
+
+  StunMessageIntegrityKey key(kPassword);
+  start = rtc::TimeMicros();
+  for (int i = 0; i < kNumMessages; ++i) {
+    StunMessageView view;
+    ASSERT_TRUE(view.Parse(buf.Data(), buf.Length()) &&
+                view.ValidateMessageIntegrity(key));
+  }
+  uint64 cached_us = rtc::TimeMicros() - start;
+
+  webrtc::test::PrintResult("stun_message_integrity", "", "password",
+                            static_cast<size_t>(uncached_us * 1000 /
+                                                kNumMessages),
+                            "ns/message", true);
+  webrtc::test::PrintResult("stun_message_integrity", "", "cached_key",
+                            static_cast<size_t>(cached_us * 1000 /
+                                                kNumMessages),
+                            "ns/message", true);
+}
+
+// Measures building and signing a binding response with and without a
+// cached key, as Port does for every connectivity check it answers.
+TEST(StunPerfTest, AddMessageIntegrity) {
+  const int kNumMessages = 100000;
+  const std::string kPassword("lpass");
+  StunMessageIntegrityKey key(kPassword);
+  uint64 elapsed_us[2];
+  for (int cached = 0; cached < 2; ++cached) {
+    uint64 start = rtc::TimeMicros();
+    for (int i = 0; i < kNumMessages; ++i) {
+      IceMessage msg;
+      msg.SetType(STUN_BINDING_RESPONSE);
+      msg.SetTransactionID("0123456789ab");
+      msg.AddAttribute(new StunXorAddressAttribute(
+          STUN_ATTR_XOR_MAPPED_ADDRESS, rtc::SocketAddress("1.2.3.4", 5678)));
+      ASSERT_TRUE(cached ? msg.AddMessageIntegrity(key)
+                         : msg.AddMessageIntegrity(kPassword));
+    }
+    elapsed_us[cached] = rtc::TimeMicros() - start;
+  }
+
+  webrtc::test::PrintResult("stun_add_message_integrity", "", "password",
+                            static_cast<size_t>(elapsed_us[0] * 1000 /
+                                                kNumMessages),
+                            "ns/message", true);
+  webrtc::test::PrintResult("stun_add_message_integrity", "", "cached_key",
+                            static_cast<size_t>(elapsed_us[1] * 1000 /
+                                                kNumMessages),
+                            "ns/message", true);
+}
+
+}  // namespace cricket
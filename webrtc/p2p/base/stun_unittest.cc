@@ -12,6 +12,7 @@
 
 #include "webrtc/p2p/base/stun.h"
 #include "webrtc/base/bytebuffer.h"
+#include "webrtc/base/byteorder.h"
 #include "webrtc/base/gunit.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/base/messagedigest.h"
@@ -1201,6 +1202,124 @@ TEST_F(StunTest, ValidateMessageIntegrity) {
   }
 }
 
+// Test that StunMessageView finds attributes in place and validates
+// MESSAGE-INTEGRITY the same way StunMessage does.
+TEST_F(StunTest, ParseMessageView) {
+  StunMessageView view;
+  ASSERT_TRUE(view.Parse(reinterpret_cast<const char*>(kRfc5769SampleRequest),
+                         sizeof(kRfc5769SampleRequest)));
+  EXPECT_EQ(STUN_BINDING_REQUEST, view.type());
+  EXPECT_FALSE(view.IsLegacy());
+  ASSERT_EQ(kStunTransactionIdLength, view.transaction_id_length());
+  EXPECT_EQ(0, memcmp(kRfc5769SampleRequest + kStunTransactionIdOffset,
+                      view.transaction_id(), kStunTransactionIdLength));
+
+  const char* value;
+  size_t length;
+  ASSERT_TRUE(view.GetAttribute(STUN_ATTR_USERNAME, &value, &length));
+  EXPECT_EQ(kRfc5769SampleMsgUsername, std::string(value, length));
+  EXPECT_TRUE(view.HasAttribute(STUN_ATTR_MESSAGE_INTEGRITY));
+  EXPECT_FALSE(view.HasAttribute(STUN_ATTR_USE_CANDIDATE));
+  // Attributes after MESSAGE-INTEGRITY are ignored.
+  EXPECT_FALSE(view.HasAttribute(STUN_ATTR_FINGERPRINT));
+
+  EXPECT_TRUE(view.ValidateMessageIntegrity(kRfc5769SampleMsgPassword));
+  EXPECT_FALSE(view.ValidateMessageIntegrity("InvalidPassword"));
+
+  EXPECT_FALSE(view.Parse(
+      reinterpret_cast<const char*>(kStunMessageWithExcessLength),
+      sizeof(kStunMessageWithExcessLength)));
+  EXPECT_FALSE(view.Parse(
+      reinterpret_cast<const char*>(kStunMessageWithSmallLength),
+      sizeof(kStunMessageWithSmallLength)));
+}
+
+// Test that StunMessageView reports the same 16 byte transaction ID as
+// StunMessage for an RFC3489 message.
+TEST_F(StunTest, ParseLegacyMessageView) {
+  unsigned char rfc3489_packet[sizeof(kStunMessageWithIPv4MappedAddress)];
+  memcpy(rfc3489_packet, kStunMessageWithIPv4MappedAddress,
+      sizeof(kStunMessageWithIPv4MappedAddress));
+  // Overwrite the magic cookie here.
+  memcpy(&rfc3489_packet[4], "ABCD", 4);
+
+  StunMessageView view;
+  ASSERT_TRUE(view.Parse(reinterpret_cast<const char*>(rfc3489_packet),
+                         sizeof(rfc3489_packet)));
+  EXPECT_TRUE(view.IsLegacy());
+  StunMessage msg;
+  ReadStunMessage(&msg, rfc3489_packet);
+  EXPECT_EQ(msg.transaction_id(),
+            std::string(view.transaction_id(), view.transaction_id_length()));
+}
+
+// Test that StunMessageView never reads outside of truncated or corrupted
+// messages.
+TEST_F(StunTest, ParseCorruptedMessageView) {
+  char buf[sizeof(kRfc5769SampleRequest)];
+  StunMessageView view;
+  const char* value;
+  size_t length;
+  for (size_t size = 0; size <= sizeof(buf); ++size) {
+    memcpy(buf, kRfc5769SampleRequest, sizeof(buf));
+    // Also try a header that claims the truncated length.
+    for (int fix_length = 0; fix_length < 2; ++fix_length) {
+      if (fix_length && size >= kStunHeaderSize)
+        rtc::SetBE16(buf + 2, static_cast<uint16>(size - kStunHeaderSize));
+      if (view.Parse(buf, size)) {
+        if (view.GetAttribute(STUN_ATTR_USERNAME, &value, &length))
+          EXPECT_LE(value + length, buf + size);
+        view.ValidateMessageIntegrity(kRfc5769SampleMsgPassword);
+      }
+    }
+  }
+
+  for (size_t i = 0; i < sizeof(buf); ++i) {
+    for (int bit = 0; bit < 8; ++bit) {
+      memcpy(buf, kRfc5769SampleRequest, sizeof(buf));
+      buf[i] ^= (1 << bit);
+      if (view.Parse(buf, sizeof(buf))) {
+        if (view.GetAttribute(STUN_ATTR_USERNAME, &value, &length))
+          EXPECT_LE(value + length, buf + sizeof(buf));
+        view.ValidateMessageIntegrity(kRfc5769SampleMsgPassword);
+      }
+    }
+  }
+}
+
+// Test that a cached StunMessageIntegrityKey gives the same result as
+// validating with the password, including passwords longer than a block.
+TEST_F(StunTest, ValidateMessageIntegrityWithKey) {
+  StunMessageView view;
+  ASSERT_TRUE(view.Parse(reinterpret_cast<const char*>(kRfc5769SampleRequest),
+                         sizeof(kRfc5769SampleRequest)));
+  StunMessageIntegrityKey key;
+  EXPECT_FALSE(view.ValidateMessageIntegrity(key));
+  key.SetPassword(kRfc5769SampleMsgPassword);
+  EXPECT_TRUE(view.ValidateMessageIntegrity(key));
+  key.SetPassword("InvalidPassword");
+  EXPECT_FALSE(view.ValidateMessageIntegrity(key));
+
+  const std::string kLongPassword(100, 'p');
+  IceMessage msg;
+  msg.SetType(STUN_BINDING_REQUEST);
+  msg.SetTransactionID("0123456789ab");
+  msg.AddAttribute(new StunUInt32Attribute(STUN_ATTR_PRIORITY, 1));
+  EXPECT_TRUE(msg.AddMessageIntegrity(kLongPassword));
+  EXPECT_TRUE(msg.AddFingerprint());
+  rtc::ByteBuffer buf;
+  EXPECT_TRUE(msg.Write(&buf));
+  ASSERT_TRUE(view.Parse(buf.Data(), buf.Length()));
+  key.SetPassword(kLongPassword);
+  EXPECT_TRUE(view.ValidateMessageIntegrity(key));
+  EXPECT_TRUE(view.ValidateMessageIntegrity(kLongPassword));
+  EXPECT_TRUE(StunMessage::ValidateMessageIntegrity(buf.Data(), buf.Length(),
+                                                    key));
+  key.SetPassword("InvalidPassword");
+  EXPECT_FALSE(StunMessage::ValidateMessageIntegrity(buf.Data(), buf.Length(),
+                                                     key));
+}
+
 // Validate that we generate correct MESSAGE-INTEGRITY attributes.
 // Note the use of IceMessage instead of StunMessage; this is necessary because
 // the RFC5769 test messages used include attributes not found in basic STUN.
@@ -1240,6 +1359,32 @@ TEST_F(StunTest, AddMessageIntegrity) {
   EXPECT_TRUE(StunMessage::ValidateMessageIntegrity(
         reinterpret_cast<const char*>(buf3.Data()), buf3.Length(),
         kRfc5769SampleMsgPassword));
+
+  // A prepared key gives the same values.
+  StunMessageIntegrityKey key(kRfc5769SampleMsgPassword);
+  IceMessage msg3;
+  rtc::ByteBuffer buf4(
+      reinterpret_cast<const char*>(kRfc5769SampleRequestWithoutMI),
+      sizeof(kRfc5769SampleRequestWithoutMI));
+  EXPECT_TRUE(msg3.Read(&buf4));
+  EXPECT_TRUE(msg3.AddMessageIntegrity(key));
+  const StunByteStringAttribute* mi_attr3 =
+      msg3.GetByteString(STUN_ATTR_MESSAGE_INTEGRITY);
+  EXPECT_EQ(20U, mi_attr3->length());
+  EXPECT_EQ(
+      0, memcmp(mi_attr3->bytes(), kCalculatedHmac1, sizeof(kCalculatedHmac1)));
+
+  IceMessage msg4;
+  rtc::ByteBuffer buf5(
+      reinterpret_cast<const char*>(kRfc5769SampleResponseWithoutMI),
+      sizeof(kRfc5769SampleResponseWithoutMI));
+  EXPECT_TRUE(msg4.Read(&buf5));
+  EXPECT_TRUE(msg4.AddMessageIntegrity(key));
+  const StunByteStringAttribute* mi_attr4 =
+      msg4.GetByteString(STUN_ATTR_MESSAGE_INTEGRITY);
+  EXPECT_EQ(20U, mi_attr4->length());
+  EXPECT_EQ(
+      0, memcmp(mi_attr4->bytes(), kCalculatedHmac2, sizeof(kCalculatedHmac2)));
 }
 
 // Check our STUN message validation code against the RFC5769 test messages.
@@ -366,11 +366,11 @@ void BasicPortAllocatorSession::DoAllocate() {
       done_signal_needed = true;
       sequence->SignalPortAllocationComplete.connect(
           this, &BasicPortAllocatorSession::OnPortAllocationComplete);
-      if (running_)
-        sequence->Start();
       sequences_.push_back(sequence);
     }
   }
+  if (running_)
+    StartPendingSequences();
   if (done_signal_needed) {
     network_thread_->Post(this, MSG_SEQUENCEOBJECTS_CREATED);
   }
@@ -490,6 +490,8 @@ void BasicPortAllocatorSession::OnPortComplete(Port* port) {
 
   // Moving to COMPLETE state.
   data->set_complete();
+  if (running_)
+    StartPendingSequences();
   // Send candidate allocation complete signal if this was the last port.
   MaybeSignalCandidatesAllocationDone();
 }
@@ -505,6 +507,8 @@ void BasicPortAllocatorSession::OnPortError(Port* port) {
   // SignalAddressError is currently sent from StunPort/TurnPort.
   // But this signal itself is generic.
   data->set_error();
+  if (running_)
+    StartPendingSequences();
   // Send candidate allocation complete signal if this was the last port.
   MaybeSignalCandidatesAllocationDone();
 }
@@ -588,10 +592,49 @@ bool BasicPortAllocatorSession::CheckCandidateFilter(const Candidate& c) {
 
 void BasicPortAllocatorSession::OnPortAllocationComplete(
     AllocationSequence* seq) {
+  if (running_)
+    StartPendingSequences();
   // Send candidate allocation complete signal if all ports are done.
   MaybeSignalCandidatesAllocationDone();
 }
 
+// A sequence keeps gathering until it has run all of its phases and all of
+// its ports have completed.
+bool BasicPortAllocatorSession::IsGathering(AllocationSequence* seq) {
+  if (seq->state() == AllocationSequence::kRunning)
+    return true;
+  if (seq->state() != AllocationSequence::kCompleted)
+    return false;
+  for (std::vector<PortData>::iterator it = ports_.begin();
+       it != ports_.end(); ++it) {
+    if (it->sequence() == seq && !it->complete())
+      return true;
+  }
+  return false;
+}
+
+// Starts the sequences that have not been started yet, in the order in which
+// they were created, as long as the allocator's gathering concurrency allows.
+void BasicPortAllocatorSession::StartPendingSequences() {
+  ASSERT(running_);
+  int limit = allocator_->gathering_concurrency();
+  int gathering = 0;
+  if (limit != kUnlimitedGatheringConcurrency) {
+    for (AllocationSequence* sequence : sequences_) {
+      if (IsGathering(sequence))
+        ++gathering;
+    }
+  }
+  for (AllocationSequence* sequence : sequences_) {
+    if (limit != kUnlimitedGatheringConcurrency && gathering >= limit)
+      break;
+    if (sequence->state() == AllocationSequence::kInit) {
+      sequence->Start();
+      ++gathering;
+    }
+  }
+}
+
 void BasicPortAllocatorSession::MaybeSignalCandidatesAllocationDone() {
   // Send signal only if all required AllocationSequence objects
   // are created.
@@ -765,10 +808,34 @@ void AllocationSequence::OnMessage(rtc::Message* msg) {
     "Udp", "Relay", "Tcp", "SslTcp"
   };
 
-  // Perform all of the phases in the current step.
-  LOG_J(LS_INFO, network_) << "Allocation Phase="
-                           << PHASE_NAMES[phase_];
+  // Perform all of the phases in the current step.  In parallel gathering
+  // mode that is every phase; the ports then gather concurrently and signal
+  // their candidates as they get them.
+  while (true) {
+    LOG_J(LS_INFO, network_) << "Allocation Phase="
+                             << PHASE_NAMES[phase_];
+    PerformPhase();
+    if (state() != kRunning ||
+        !IsFlagSet(PORTALLOCATOR_ENABLE_PARALLEL_GATHERING)) {
+      break;
+    }
+    ++phase_;
+  }
+
+  if (state() == kRunning) {
+    ++phase_;
+    session_->network_thread()->PostDelayed(
+        session_->allocator()->step_delay(),
+        this, MSG_ALLOCATION_PHASE);
+  } else {
+    // If all phases in AllocationSequence are completed, no allocation
+    // steps needed further. Canceling  pending signal.
+    session_->network_thread()->Clear(this, MSG_ALLOCATION_PHASE);
+    SignalPortAllocationComplete(this);
+  }
+}
 
+void AllocationSequence::PerformPhase() {
   switch (phase_) {
     case PHASE_UDP:
       CreateUDPPorts();
@@ -793,18 +860,6 @@ void AllocationSequence::OnMessage(rtc::Message* msg) {
     default:
       ASSERT(false);
   }
-
-  if (state() == kRunning) {
-    ++phase_;
-    session_->network_thread()->PostDelayed(
-        session_->allocator()->step_delay(),
-        this, MSG_ALLOCATION_PHASE);
-  } else {
-    // If all phases in AllocationSequence are completed, no allocation
-    // steps needed further. Canceling  pending signal.
-    session_->network_thread()->Clear(this, MSG_ALLOCATION_PHASE);
-    SignalPortAllocationComplete(this);
-  }
 }
 
 void AllocationSequence::EnableProtocol(ProtocolType proto) {
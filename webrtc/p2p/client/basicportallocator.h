@@ -181,6 +181,8 @@ class BasicPortAllocatorSession : public PortAllocatorSession,
   void OnShake();
   void MaybeSignalCandidatesAllocationDone();
   void OnPortAllocationComplete(AllocationSequence* seq);
+  bool IsGathering(AllocationSequence* seq);
+  void StartPendingSequences();
   PortData* FindPort(Port* port);
 
   bool CheckCandidateFilter(const Candidate& c);
@@ -296,6 +298,7 @@ class AllocationSequence : public rtc::MessageHandler,
   typedef std::vector<ProtocolType> ProtocolList;
 
   bool IsFlagSet(uint32 flag) { return ((flags_ & flag) != 0); }
+  void PerformPhase();
   void CreateUDPPorts();
   void CreateTCPPorts();
   void CreateStunPorts();
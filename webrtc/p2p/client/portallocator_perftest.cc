@@ -0,0 +1,112 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <vector>
+
+#include "webrtc/base/fakenetwork.h"
+#include "webrtc/base/gunit.h"
+#include "webrtc/base/physicalsocketserver.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/socketaddress.h"
+#include "webrtc/base/thread.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/base/virtualsocketserver.h"
+#include "webrtc/p2p/base/testturnserver.h"
+#include "webrtc/p2p/client/basicportallocator.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace {
+
+const rtc::SocketAddress kClientAddr("11.11.11.11", 0);
+const rtc::SocketAddress kClientAddr2("22.22.22.22", 0);
+const rtc::SocketAddress kTurnUdpIntAddr("99.99.99.4", 3478);
+const rtc::SocketAddress kTurnUdpExtAddr("99.99.99.6", 0);
+const char kTurnUsername[] = "test";
+const char kTurnPassword[] = "test";
+const char kIceUfrag[] = "TESTICEUFRAG0000";
+const char kIcePwd[] = "TESTICEPWD00000000000000";
+const int kRelayCandidateTimeoutMs = 3000;
+
+}  // namespace
+
+class PortAllocatorPerfTest : public testing::Test,
+                              public sigslot::has_slots<> {
+ public:
+  PortAllocatorPerfTest()
+      : pss_(new rtc::PhysicalSocketServer),
+        vss_(new rtc::VirtualSocketServer(pss_.get())),
+        ss_scope_(vss_.get()),
+        turn_server_(rtc::Thread::Current(), kTurnUdpIntAddr,
+                     kTurnUdpExtAddr),
+        have_relay_candidate_(false) {
+    network_manager_.AddInterface(kClientAddr);
+    network_manager_.AddInterface(kClientAddr2);
+  }
+
+ protected:
+  // Returns the time from starting a session until its first relay
+  // candidate, in ms.
+  uint32 TimeToFirstRelayCandidate(uint32 flags) {
+    cricket::BasicPortAllocator allocator(&network_manager_);
+    cricket::RelayServerConfig relay_server(cricket::RELAY_TURN);
+    relay_server.credentials =
+        cricket::RelayCredentials(kTurnUsername, kTurnPassword);
+    relay_server.ports.push_back(cricket::ProtocolAddress(
+        kTurnUdpIntAddr, cricket::PROTO_UDP, false));
+    allocator.AddRelay(relay_server);
+    allocator.set_step_delay(cricket::kDefaultStepDelay);
+    allocator.set_flags(allocator.flags() | flags);
+
+    rtc::scoped_ptr<cricket::PortAllocatorSession> session(
+        allocator.CreateSession("session", "test content",
+                                cricket::ICE_CANDIDATE_COMPONENT_RTP,
+                                kIceUfrag, kIcePwd));
+    session->SignalCandidatesReady.connect(
+        this, &PortAllocatorPerfTest::OnCandidatesReady);
+    have_relay_candidate_ = false;
+    uint32 start = rtc::Time();
+    session->StartGettingPorts();
+    EXPECT_TRUE_WAIT(have_relay_candidate_, kRelayCandidateTimeoutMs);
+    return rtc::TimeSince(start);
+  }
+
+  void OnCandidatesReady(cricket::PortAllocatorSession* session,
+                         const std::vector<cricket::Candidate>& candidates) {
+    for (const cricket::Candidate& candidate : candidates) {
+      if (candidate.type() == cricket::RELAY_PORT_TYPE)
+        have_relay_candidate_ = true;
+    }
+  }
+
+ private:
+  rtc::scoped_ptr<rtc::PhysicalSocketServer> pss_;
+  rtc::scoped_ptr<rtc::VirtualSocketServer> vss_;
+  rtc::SocketServerScope ss_scope_;
+  cricket::TestTurnServer turn_server_;
+  rtc::FakeNetworkManager network_manager_;
+  bool have_relay_candidate_;
+};
+
+// Measures how long it takes to get the first relay candidate on a host with
+// two networks, with and without parallel gathering. Stepped gathering only
+// creates relay ports one step delay after the UDP ports.
+TEST_F(PortAllocatorPerfTest, TimeToFirstRelayCandidate) {
+  uint32 stepped_ms = TimeToFirstRelayCandidate(0);
+  uint32 parallel_ms = TimeToFirstRelayCandidate(
+      cricket::PORTALLOCATOR_ENABLE_PARALLEL_GATHERING);
+  EXPECT_GE(stepped_ms, cricket::kDefaultStepDelay);
+  EXPECT_LT(parallel_ms, cricket::kDefaultStepDelay);
+  webrtc::test::PrintResult("port_allocator_first_relay_candidate", "",
+                            "stepped", static_cast<size_t>(stepped_ms), "ms",
+                            true);
+  webrtc::test::PrintResult("port_allocator_first_relay_candidate", "",
+                            "parallel", static_cast<size_t>(parallel_ms), "ms",
+                            true);
+}
@@ -462,6 +462,45 @@ TEST_F(PortAllocatorTest, TestGetAllPortsWithOneSecondStepDelay) {
   session_->StopGettingPorts();
 }
 
+// Verify that in parallel gathering mode all the candidates are gathered
+// without waiting for the step delay.
+TEST_F(PortAllocatorTest, TestGetAllPortsInParallel) {
+  AddInterface(kClientAddr);
+  allocator_->set_step_delay(cricket::kDefaultStepDelay);
+  allocator_->set_flags(allocator().flags() |
+                        cricket::PORTALLOCATOR_ENABLE_PARALLEL_GATHERING);
+  EXPECT_TRUE(CreateSession(cricket::ICE_CANDIDATE_COMPONENT_RTP));
+  session_->StartGettingPorts();
+  ASSERT_EQ_WAIT(7U, candidates_.size(), 500);
+  EXPECT_EQ(4U, ports_.size());
+  EXPECT_TRUE_WAIT(candidate_allocation_done_, 500);
+}
+
+// Verify that the gathering concurrency limits how many networks gather
+// candidates at the same time.
+TEST_F(PortAllocatorTest, TestGatheringConcurrency) {
+  AddInterface(kClientAddr);
+  AddInterface(kClientAddr2);
+  allocator_->set_flags(allocator().flags() |
+                        cricket::PORTALLOCATOR_ENABLE_PARALLEL_GATHERING);
+  allocator_->set_gathering_concurrency(1);
+  EXPECT_TRUE(CreateSession(cricket::ICE_CANDIDATE_COMPONENT_RTP));
+  session_->StartGettingPorts();
+  EXPECT_TRUE_WAIT(candidate_allocation_done_, kDefaultAllocationTimeout);
+  EXPECT_EQ(8U, ports_.size());
+
+  // All the ports of one network are ready before those of the other.
+  const rtc::Network* network = nullptr;
+  size_t switches = 0;
+  for (const cricket::PortInterface* port : ports_) {
+    if (port->Network() != network) {
+      network = port->Network();
+      ++switches;
+    }
+  }
+  EXPECT_EQ(2U, switches);
+}
+
 TEST_F(PortAllocatorTest, TestSetupVideoRtpPortsWithNormalSendBuffers) {
   AddInterface(kClientAddr);
   EXPECT_TRUE(CreateSession(cricket::ICE_CANDIDATE_COMPONENT_RTP,
@@ -11,13 +11,16 @@
 #include "webrtc/test/rtp_file_reader.h"
 
 #include <stdio.h>
+#include <string.h>
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <vector>
 
 #include "webrtc/base/checks.h"
 #include "webrtc/base/format_macros.h"
+#include "webrtc/base/memory_mapped_file.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_utility.h"
 
@@ -43,112 +46,183 @@ static uint16_t kPacketHeaderSize = 8;
     }                                                  \
   } while (0)
 
-bool ReadUint32(uint32_t* out, FILE* file) {
-  *out = 0;
-  for (size_t i = 0; i < 4; ++i) {
-    *out <<= 8;
-    uint8_t tmp;
-    if (fread(&tmp, 1, sizeof(uint8_t), file) != sizeof(uint8_t))
-      return false;
-    *out |= tmp;
-  }
+// Reads a big-endian value at |*pos| of |file| and advances |*pos| past it.
+bool ReadUint32(uint32_t* out, const rtc::MemoryMappedFile& file,
+                size_t* pos) {
+  if (file.size() < *pos + 4)
+    return false;
+  const uint8_t* data = file.data() + *pos;
+  *out = (static_cast<uint32_t>(data[0]) << 24) |
+         (static_cast<uint32_t>(data[1]) << 16) |
+         (static_cast<uint32_t>(data[2]) << 8) | data[3];
+  *pos += 4;
   return true;
 }
 
-bool ReadUint16(uint16_t* out, FILE* file) {
-  *out = 0;
-  for (size_t i = 0; i < 2; ++i) {
-    *out <<= 8;
-    uint8_t tmp;
-    if (fread(&tmp, 1, sizeof(uint8_t), file) != sizeof(uint8_t))
-      return false;
-    *out |= tmp;
-  }
+bool ReadUint16(uint16_t* out, const rtc::MemoryMappedFile& file,
+                size_t* pos) {
+  if (file.size() < *pos + 2)
+    return false;
+  const uint8_t* data = file.data() + *pos;
+  *out = static_cast<uint16_t>((data[0] << 8) | data[1]);
+  *pos += 2;
   return true;
 }
 
+// Base for the readers, which memory map the file and index all packets in
+// it when initialized. Packets are then copied straight from the mapped file,
+// and seeking is a search in the index.
 class RtpFileReaderImpl : public RtpFileReader {
  public:
+  // If |fatal_if_too_large| is false, a packet that doesn't fit in an
+  // RtpPacket makes NextPacket() fail instead of crashing.
+  explicit RtpFileReaderImpl(bool fatal_if_too_large)
+      : fatal_if_too_large_(fatal_if_too_large), next_packet_(0) {}
+
   virtual bool Init(const std::string& filename,
                     const std::set<uint32_t>& ssrc_filter) = 0;
-};
 
-class InterleavedRtpFileReader : public RtpFileReaderImpl {
- public:
-  virtual ~InterleavedRtpFileReader() {
-    if (file_ != NULL) {
-      fclose(file_);
-      file_ = NULL;
+  bool NextPacket(RtpPacket* packet) override {
+    if (next_packet_ == index_.size())
+      return false;
+    const PacketInfo& info = index_[next_packet_];
+    if (info.length > RtpPacket::kMaxPacketBufferSize) {
+      if (!fatal_if_too_large_)
+        return false;
+      FATAL() << "Packet is too large to fit: " << info.length << " bytes vs "
+              << RtpPacket::kMaxPacketBufferSize
+              << " bytes allocated. Consider increasing the buffer "
+                 "size";
     }
+    ++next_packet_;
+    memcpy(packet->data, file_.data() + info.pos, info.length);
+    packet->length = info.length;
+    packet->original_length = info.original_length;
+    packet->time_ms = info.time_ms;
+    return true;
   }
 
-  virtual bool Init(const std::string& filename,
-                    const std::set<uint32_t>& ssrc_filter) {
-    file_ = fopen(filename.c_str(), "rb");
-    if (file_ == NULL) {
+  bool SeekToTime(uint32_t time_ms) override {
+    if (seek_table_.size() != index_.size())
+      BuildSeekTable();
+    std::vector<SeekEntry>::const_iterator it = std::lower_bound(
+        seek_table_.begin(), seek_table_.end(), time_ms, &IsBefore);
+    next_packet_ = it != seek_table_.end() ? it->first_packet : index_.size();
+    return it != seek_table_.end();
+  }
+
+  size_t NumPackets() const override { return index_.size(); }
+
+ protected:
+  struct PacketInfo {
+    PacketInfo(size_t pos, size_t length, size_t original_length,
+               uint32_t time_ms)
+        : pos(pos),
+          length(length),
+          original_length(original_length),
+          time_ms(time_ms) {}
+    // Offset of the packet in the file.
+    size_t pos;
+    size_t length;
+    size_t original_length;
+    uint32_t time_ms;
+  };
+
+  bool MapFile(const std::string& filename) {
+    if (!file_.Open(filename)) {
       printf("ERROR: Can't open file: %s\n", filename.c_str());
       return false;
     }
     return true;
   }
-  virtual bool NextPacket(RtpPacket* packet) {
-    assert(file_ != NULL);
-    packet->length = RtpPacket::kMaxPacketBufferSize;
-    uint32_t len = 0;
-    TRY(ReadUint32(&len, file_));
-    if (packet->length < len) {
-      FATAL() << "Packet is too large to fit: " << len << " bytes vs "
-              << packet->length
-              << " bytes allocated. Consider increasing the buffer "
-                 "size";
+
+  rtc::MemoryMappedFile file_;
+  std::vector<PacketInfo> index_;
+
+ private:
+  // Packet times aren't necessarily increasing in captured files. The seek
+  // table has an entry per packet sorted by time, each holding the first
+  // packet, in file order, at or after that time, so that seeking is a binary
+  // search.
+  struct SeekEntry {
+    uint32_t time_ms;
+    size_t first_packet;
+  };
+
+  static bool IsBefore(const SeekEntry& entry, uint32_t time_ms) {
+    return entry.time_ms < time_ms;
+  }
+
+  static bool EarlierEntry(const SeekEntry& a, const SeekEntry& b) {
+    return a.time_ms < b.time_ms;
+  }
+
+  // Built on the first SeekToTime() call, since most users never seek.
+  void BuildSeekTable() {
+    seek_table_.resize(index_.size());
+    for (size_t i = 0; i < index_.size(); ++i) {
+      seek_table_[i].time_ms = index_[i].time_ms;
+      seek_table_[i].first_packet = i;
     }
-    if (fread(packet->data, 1, len, file_) != len)
-      return false;
+    std::sort(seek_table_.begin(), seek_table_.end(), &EarlierEntry);
+    for (size_t i = seek_table_.size(); i > 1; --i) {
+      seek_table_[i - 2].first_packet = std::min(
+          seek_table_[i - 2].first_packet, seek_table_[i - 1].first_packet);
+    }
+  }
+
+  const bool fatal_if_too_large_;
+  std::vector<SeekEntry> seek_table_;
+  size_t next_packet_;
+};
 
-    packet->length = len;
-    packet->original_length = len;
-    packet->time_ms = time_ms_;
-    time_ms_ += 5;
+class InterleavedRtpFileReader : public RtpFileReaderImpl {
+ public:
+  InterleavedRtpFileReader() : RtpFileReaderImpl(true) {}
+
+  virtual bool Init(const std::string& filename,
+                    const std::set<uint32_t>& ssrc_filter) {
+    if (!MapFile(filename))
+      return false;
+    // Each packet is preceded by its length. Packets are spaced 5 ms apart.
+    size_t pos = 0;
+    uint32_t time_ms = 0;
+    uint32_t len = 0;
+    while (ReadUint32(&len, file_, &pos) && len <= file_.size() - pos) {
+      index_.push_back(PacketInfo(pos, len, len, time_ms));
+      pos += len;
+      time_ms += 5;
+    }
     return true;
   }
-
- private:
-  FILE* file_ = NULL;
-  int64_t time_ms_ = 0;
 };
 
 // Read RTP packets from file in rtpdump format, as documented at:
 // http://www.cs.columbia.edu/irt/software/rtptools/
 class RtpDumpReader : public RtpFileReaderImpl {
  public:
-  RtpDumpReader() : file_(NULL) {}
-  virtual ~RtpDumpReader() {
-    if (file_ != NULL) {
-      fclose(file_);
-      file_ = NULL;
-    }
-  }
+  RtpDumpReader() : RtpFileReaderImpl(true) {}
 
   bool Init(const std::string& filename,
             const std::set<uint32_t>& ssrc_filter) {
-    file_ = fopen(filename.c_str(), "rb");
-    if (file_ == NULL) {
-      printf("ERROR: Can't open file: %s\n", filename.c_str());
+    if (!MapFile(filename))
       return false;
-    }
 
-    char firstline[kFirstLineLength + 1] = {0};
-    if (fgets(firstline, kFirstLineLength, file_) == NULL) {
+    const char* data = reinterpret_cast<const char*>(file_.data());
+    const char* end_of_first_line = static_cast<const char*>(memchr(
+        data, '\n', std::min(file_.size(), kFirstLineLength)));
+    if (end_of_first_line == NULL) {
       DEBUG_LOG("ERROR: Can't read from file\n");
       return false;
     }
-    if (strncmp(firstline, "#!rtpplay", 9) == 0) {
-      if (strncmp(firstline, "#!rtpplay1.0", 12) != 0) {
+    std::string firstline(data, end_of_first_line);
+    if (firstline.compare(0, 9, "#!rtpplay") == 0) {
+      if (firstline.compare(0, 12, "#!rtpplay1.0") != 0) {
         DEBUG_LOG("ERROR: wrong rtpplay version, must be 1.0\n");
         return false;
       }
-    } else if (strncmp(firstline, "#!RTPencode", 11) == 0) {
-      if (strncmp(firstline, "#!RTPencode1.0", 14) != 0) {
+    } else if (firstline.compare(0, 11, "#!RTPencode") == 0) {
+      if (firstline.compare(0, 14, "#!RTPencode1.0") != 0) {
         DEBUG_LOG("ERROR: wrong RTPencode version, must be 1.0\n");
         return false;
       }
@@ -157,52 +231,39 @@ class RtpDumpReader : public RtpFileReaderImpl {
       return false;
     }
 
+    size_t pos = end_of_first_line - data + 1;
     uint32_t start_sec;
     uint32_t start_usec;
     uint32_t source;
     uint16_t port;
     uint16_t padding;
-    TRY(ReadUint32(&start_sec, file_));
-    TRY(ReadUint32(&start_usec, file_));
-    TRY(ReadUint32(&source, file_));
-    TRY(ReadUint16(&port, file_));
-    TRY(ReadUint16(&padding, file_));
+    TRY(ReadUint32(&start_sec, file_, &pos));
+    TRY(ReadUint32(&start_usec, file_, &pos));
+    TRY(ReadUint32(&source, file_, &pos));
+    TRY(ReadUint16(&port, file_, &pos));
+    TRY(ReadUint16(&padding, file_, &pos));
 
-    return true;
-  }
-
-  bool NextPacket(RtpPacket* packet) override {
-    uint8_t* rtp_data = packet->data;
-    packet->length = RtpPacket::kMaxPacketBufferSize;
-
-    uint16_t len;
-    uint16_t plen;
-    uint32_t offset;
-    TRY(ReadUint16(&len, file_));
-    TRY(ReadUint16(&plen, file_));
-    TRY(ReadUint32(&offset, file_));
-
-    // Use 'len' here because a 'plen' of 0 specifies rtcp.
-    len -= kPacketHeaderSize;
-    if (packet->length < len) {
-      FATAL() << "Packet is too large to fit: " << len << " bytes vs "
-              << packet->length
-              << " bytes allocated. Consider increasing the buffer "
-                 "size";
-    }
-    if (fread(rtp_data, 1, len, file_) != len) {
-      return false;
+    for (;;) {
+      uint16_t len;
+      uint16_t plen;
+      uint32_t offset;
+      if (!ReadUint16(&len, file_, &pos) || !ReadUint16(&plen, file_, &pos) ||
+          !ReadUint32(&offset, file_, &pos)) {
+        break;
+      }
+      // Use 'len' here because a 'plen' of 0 specifies rtcp.
+      if (len < kPacketHeaderSize ||
+          static_cast<size_t>(len - kPacketHeaderSize) > file_.size() - pos) {
+        break;
+      }
+      len -= kPacketHeaderSize;
+      index_.push_back(PacketInfo(pos, len, plen, offset));
+      pos += len;
     }
-
-    packet->length = len;
-    packet->original_length = plen;
-    packet->time_ms = offset;
     return true;
   }
 
  private:
-  FILE* file_;
-
   DISALLOW_COPY_AND_ASSIGN(RtpDumpReader);
 };
 
@@ -225,8 +286,7 @@ enum {
   kFragmentOffsetDoNotFragment = 0x4000,
   kProtocolTcp = 0x06,
   kProtocolUdp = 0x11,
-  kUdpHeaderLength = 8,
-  kMaxReadBufferSize = 4096
+  kUdpHeaderLength = 8
 };
 
 const uint32_t kPcapBOMSwapOrder = 0xd4c3b2a1UL;
@@ -247,25 +307,20 @@ const uint32_t kPcapBOMNoSwapOrder = 0xa1b2c3d4UL;
 // http://wiki.wireshark.org/Development/LibpcapFileFormat
 class PcapReader : public RtpFileReaderImpl {
  public:
+  // Captures may hold packets larger than an RtpPacket, which just can't be
+  // read.
   PcapReader()
-    : file_(NULL),
+    : RtpFileReaderImpl(false),
+      pos_(0),
+      eof_(false),
       swap_pcap_byte_order_(false),
 #ifdef WEBRTC_ARCH_BIG_ENDIAN
       swap_network_byte_order_(false),
 #else
       swap_network_byte_order_(true),
 #endif
-      read_buffer_(),
       packets_by_ssrc_(),
-      packets_(),
-      next_packet_it_() {
-  }
-
-  virtual ~PcapReader() {
-    if (file_ != NULL) {
-      fclose(file_);
-      file_ = NULL;
-    }
+      packets_() {
   }
 
   bool Init(const std::string& filename,
@@ -275,11 +330,8 @@ class PcapReader : public RtpFileReaderImpl {
 
   int Initialize(const std::string& filename,
                  const std::set<uint32_t>& ssrc_filter) {
-    file_ = fopen(filename.c_str(), "rb");
-    if (file_ == NULL) {
-      printf("ERROR: Can't open file: %s\n", filename.c_str());
+    if (!MapFile(filename))
       return kResultFail;
-    }
 
     if (ReadGlobalHeader() < 0) {
       return kResultFail;
@@ -287,9 +339,9 @@ class PcapReader : public RtpFileReaderImpl {
 
     int total_packet_count = 0;
     uint32_t stream_start_ms = 0;
-    int32_t next_packet_pos = ftell(file_);
+    size_t next_packet_pos = pos_;
     for (;;) {
-      TRY_PCAP(fseek(file_, next_packet_pos, SEEK_SET));
+      TRY_PCAP(Seek(next_packet_pos));
       int result = ReadPacket(&next_packet_pos, stream_start_ms,
                               ++total_packet_count, ssrc_filter);
       if (result == kResultFail) {
@@ -302,7 +354,7 @@ class PcapReader : public RtpFileReaderImpl {
       }
     }
 
-    if (feof(file_) == 0) {
+    if (!eof_) {
       printf("Failed reading file!\n");
       return kResultFail;
     }
@@ -335,37 +387,11 @@ class PcapReader : public RtpFileReaderImpl {
     // - Can also use srcip:port->dstip:port pairs, assuming few SSRC collisions
     //   for up/down streams.
 
-    next_packet_it_ = packets_.begin();
-    return kResultSuccess;
-  }
-
-  bool NextPacket(RtpPacket* packet) override {
-    uint32_t length = RtpPacket::kMaxPacketBufferSize;
-    if (NextPcap(packet->data, &length, &packet->time_ms) != kResultSuccess)
-      return false;
-    packet->length = static_cast<size_t>(length);
-    packet->original_length = packet->length;
-    return true;
-  }
-
-  virtual int NextPcap(uint8_t* data, uint32_t* length, uint32_t* time_ms) {
-    assert(data);
-    assert(length);
-    assert(time_ms);
-
-    if (next_packet_it_ == packets_.end()) {
-      return -1;
-    }
-    if (*length < next_packet_it_->payload_length) {
-      return -1;
+    for (PacketIterator it = packets_.begin(); it != packets_.end(); ++it) {
+      index_.push_back(PacketInfo(it->pos_in_file, it->payload_length,
+                                  it->payload_length, it->time_offset_ms));
     }
-    TRY_PCAP(fseek(file_, next_packet_it_->pos_in_file, SEEK_SET));
-    TRY_PCAP(Read(data, next_packet_it_->payload_length));
-    *length = next_packet_it_->payload_length;
-    *time_ms = next_packet_it_->time_offset_ms;
-    next_packet_it_++;
-
-    return 0;
+    return kResultSuccess;
   }
 
  private:
@@ -378,7 +404,7 @@ class PcapReader : public RtpFileReaderImpl {
     uint16_t source_port;
     uint16_t dest_port;
     RTPHeader rtp_header;
-    int32_t pos_in_file;      // Byte offset of payload from start of file.
+    size_t pos_in_file;       // Byte offset of payload from start of file.
     uint32_t payload_length;
   };
 
@@ -424,7 +450,7 @@ class PcapReader : public RtpFileReaderImpl {
     return kResultSuccess;
   }
 
-  int ReadPacket(int32_t* next_packet_pos,
+  int ReadPacket(size_t* next_packet_pos,
                  uint32_t stream_start_ms,
                  uint32_t number,
                  const std::set<uint32_t>& ssrc_filter) {
@@ -439,21 +465,18 @@ class PcapReader : public RtpFileReaderImpl {
     TRY_PCAP(Read(&incl_len, false));
     TRY_PCAP(Read(&orig_len, false));
 
-    *next_packet_pos = ftell(file_) + incl_len;
+    *next_packet_pos = pos_ + incl_len;
 
     RtpPacketMarker marker = {0};
     marker.packet_number = number;
     marker.time_offset_ms = CalcTimeDelta(ts_sec, ts_usec, stream_start_ms);
     TRY_PCAP(ReadPacketHeader(&marker));
-    marker.pos_in_file = ftell(file_);
+    marker.pos_in_file = pos_;
+    TRY_PCAP(Skip(marker.payload_length));
 
-    if (marker.payload_length > sizeof(read_buffer_)) {
-      printf("Packet too large!\n");
-      return kResultFail;
-    }
-    TRY_PCAP(Read(read_buffer_, marker.payload_length));
-
-    RtpUtility::RtpHeaderParser rtp_parser(read_buffer_, marker.payload_length);
+    // The packet is parsed where it is in the mapped file.
+    RtpUtility::RtpHeaderParser rtp_parser(file_.data() + marker.pos_in_file,
+                                           marker.payload_length);
     if (rtp_parser.RTCP()) {
       rtp_parser.ParseRtcp(&marker.rtp_header);
       packets_.push_back(marker);
@@ -477,7 +500,7 @@ class PcapReader : public RtpFileReaderImpl {
   }
 
   int ReadPacketHeader(RtpPacketMarker* marker) {
-    int32_t file_pos = ftell(file_);
+    size_t file_pos = pos_;
 
     // Check for BSD null/loopback frame header. The header is just 4 bytes in
     // native byte order, so we check for both versions as we don't care about
@@ -493,7 +516,7 @@ class PcapReader : public RtpFileReaderImpl {
       }
     }
 
-    TRY_PCAP(fseek(file_, file_pos, SEEK_SET));
+    TRY_PCAP(Seek(file_pos));
 
     // Check for Ethernet II, IP frame header.
     uint16_t type;
@@ -578,9 +601,7 @@ class PcapReader : public RtpFileReaderImpl {
 
   int Read(uint32_t* out, bool expect_network_order) {
     uint32_t tmp = 0;
-    if (fread(&tmp, 1, sizeof(uint32_t), file_) != sizeof(uint32_t)) {
-      return kResultFail;
-    }
+    TRY_PCAP(Read(reinterpret_cast<uint8_t*>(&tmp), sizeof(tmp)));
     if ((!expect_network_order && swap_pcap_byte_order_) ||
         (expect_network_order && swap_network_byte_order_)) {
       tmp = ((tmp >> 24) & 0x000000ff) | (tmp << 24) |
@@ -592,9 +613,7 @@ class PcapReader : public RtpFileReaderImpl {
 
   int Read(uint16_t* out, bool expect_network_order) {
     uint16_t tmp = 0;
-    if (fread(&tmp, 1, sizeof(uint16_t), file_) != sizeof(uint16_t)) {
-      return kResultFail;
-    }
+    TRY_PCAP(Read(reinterpret_cast<uint8_t*>(&tmp), sizeof(tmp)));
     if ((!expect_network_order && swap_pcap_byte_order_) ||
         (expect_network_order && swap_network_byte_order_)) {
       tmp = ((tmp >> 8) & 0x00ff) | (tmp << 8);
@@ -604,41 +623,49 @@ class PcapReader : public RtpFileReaderImpl {
   }
 
   int Read(uint8_t* out, uint32_t count) {
-    if (fread(out, 1, count, file_) != count) {
+    if (count > file_.size() - pos_) {
+      // Like reading past the end of a FILE, which sets feof().
+      eof_ = true;
+      pos_ = file_.size();
       return kResultFail;
     }
+    memcpy(out, file_.data() + pos_, count);
+    pos_ += count;
     return kResultSuccess;
   }
 
   int Read(int32_t* out, bool expect_network_order) {
-    int32_t tmp = 0;
-    if (fread(&tmp, 1, sizeof(uint32_t), file_) != sizeof(uint32_t)) {
-      return kResultFail;
-    }
-    if ((!expect_network_order && swap_pcap_byte_order_) ||
-        (expect_network_order && swap_network_byte_order_)) {
-      tmp = ((tmp >> 24) & 0x000000ff) | (tmp << 24) |
-          ((tmp >> 8) & 0x0000ff00) | ((tmp << 8) & 0x00ff0000);
-    }
-    *out = tmp;
+    uint32_t tmp = 0;
+    TRY_PCAP(Read(&tmp, expect_network_order));
+    *out = static_cast<int32_t>(tmp);
+    return kResultSuccess;
+  }
+
+  // Like fseek(), seeking past the end succeeds but makes the next read fail.
+  int Seek(size_t pos) {
+    pos_ = std::min(pos, file_.size());
     return kResultSuccess;
   }
 
   int Skip(uint32_t length) {
-    if (fseek(file_, length, SEEK_CUR) != 0) {
+    if (length > file_.size() - pos_) {
+      eof_ = true;
+      pos_ = file_.size();
       return kResultFail;
     }
+    pos_ += length;
     return kResultSuccess;
   }
 
-  FILE* file_;
+  // Read position in the mapped file.
+  size_t pos_;
+  // Set when a read has run past the end of the file.
+  bool eof_;
   bool swap_pcap_byte_order_;
   const bool swap_network_byte_order_;
-  uint8_t read_buffer_[kMaxReadBufferSize];
 
   SsrcMap packets_by_ssrc_;
   std::vector<RtpPacketMarker> packets_;
-  PacketIterator next_packet_it_;
 
   DISALLOW_COPY_AND_ASSIGN(PcapReader);
 };
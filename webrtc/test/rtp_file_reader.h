@@ -43,6 +43,15 @@ class RtpFileReader {
                                const std::set<uint32_t>& ssrc_filter);
 
   virtual bool NextPacket(RtpPacket* packet) = 0;
+
+  // The file is memory mapped and indexed by Create(), so the packets can be
+  // counted and seeked to without reading through them.
+  virtual size_t NumPackets() const = 0;
+
+  // Makes the next NextPacket() call return the first packet, in file order,
+  // with |time_ms| at or after |time_ms|. Returns false, and makes NextPacket()
+  // fail, if there is no such packet.
+  virtual bool SeekToTime(uint32_t time_ms) = 0;
 };
 }  // namespace test
 }  // namespace webrtc
@@ -0,0 +1,93 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/test/rtp_file_reader.h"
+#include "webrtc/test/rtp_file_writer.h"
+#include "webrtc/test/testsupport/fileutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+const uint32_t kSsrc = 0x12345678;
+
+// Writes |num_packets| RTP packets of |length| bytes, sent 10 ms apart, to the
+// rtpdump file |filename|.
+void WriteRtpDump(const std::string& filename,
+                  int num_packets,
+                  size_t length) {
+  rtc::scoped_ptr<test::RtpFileWriter> writer(
+      test::RtpFileWriter::Create(test::RtpFileWriter::kRtpDump, filename));
+  ASSERT_TRUE(writer.get() != NULL);
+  test::RtpPacket packet;
+  memset(packet.data, 0, length);
+  packet.data[0] = 0x80;
+  packet.data[1] = 100;
+  for (int i = 0; i < 4; ++i)
+    packet.data[8 + i] = kSsrc >> (24 - 8 * i);
+  packet.length = length;
+  packet.original_length = length;
+  for (int i = 0; i < num_packets; ++i) {
+    packet.data[2] = static_cast<uint8_t>(i >> 8);
+    packet.data[3] = static_cast<uint8_t>(i);
+    packet.time_ms = 10 * i;
+    ASSERT_TRUE(writer->WritePacket(&packet));
+  }
+}
+
+}  // namespace
+
+// Reads a 100000 packet rtpdump, about 20 minutes of a 1 Mbps video stream,
+// once from start to end, and then seeks to a few hundred positions in it.
+// The file takes about 120 MB.
+TEST(RtpFileReaderPerfTest, ReadAndSeek) {
+  const int kNumPackets = 100000;
+  const int kNumSeeks = 500;
+  std::string filename = test::OutputPath() + "rtp_file_reader_perf.rtp";
+  WriteRtpDump(filename, kNumPackets, 1200);
+
+  int64_t start_us = TickTime::MicrosecondTimestamp();
+  rtc::scoped_ptr<test::RtpFileReader> reader(
+      test::RtpFileReader::Create(test::RtpFileReader::kRtpDump, filename));
+  ASSERT_TRUE(reader.get() != NULL);
+  test::RtpPacket packet;
+  int num_packets = 0;
+  while (reader->NextPacket(&packet))
+    ++num_packets;
+  const int64_t read_us = TickTime::MicrosecondTimestamp() - start_us;
+  EXPECT_EQ(kNumPackets, num_packets);
+
+  start_us = TickTime::MicrosecondTimestamp();
+  for (int i = 0; i < kNumSeeks; ++i) {
+    uint32_t time_ms = (i * 7919 % kNumPackets) * 10;
+    ASSERT_TRUE(reader->SeekToTime(time_ms));
+    ASSERT_TRUE(reader->NextPacket(&packet));
+    EXPECT_EQ(time_ms, packet.time_ms);
+  }
+  const int64_t seek_us = TickTime::MicrosecondTimestamp() - start_us;
+  remove(filename.c_str());
+
+  test::PrintResult("rtp_file_reader", "", "read",
+                    static_cast<size_t>(read_us * 1000 / kNumPackets),
+                    "ns/packet", true);
+  test::PrintResult("rtp_file_reader", "", "seek",
+                    static_cast<size_t>(seek_us * 1000 / kNumSeeks),
+                    "ns/seek", true);
+}
+
+}  // namespace webrtc
@@ -8,12 +8,18 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
 #include <map>
+#include <vector>
 
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_utility.h"
 #include "webrtc/test/rtp_file_reader.h"
+#include "webrtc/test/rtp_file_writer.h"
 #include "webrtc/test/testsupport/fileutils.h"
 
 namespace webrtc {
@@ -122,4 +128,182 @@ TEST_F(TestPcapFileReader, TestThreeSsrc) {
   EXPECT_EQ(113, pps[0x59fe6ef0]);
   EXPECT_EQ(61, pps[0xed2bd2ac]);
 }
+
+namespace {
+const uint32_t kSsrc = 0x12345678;
+
+// Fills |packet| with an RTP packet of |length| bytes, with sequence number
+// |sequence_number|, sent at |time_ms|.
+void CreateRtpPacket(uint16_t sequence_number,
+                     uint32_t time_ms,
+                     size_t length,
+                     test::RtpPacket* packet) {
+  memset(packet->data, 0, length);
+  packet->data[0] = 0x80;
+  packet->data[1] = 100;
+  packet->data[2] = sequence_number >> 8;
+  packet->data[3] = sequence_number & 0xff;
+  uint32_t timestamp = time_ms * 90;
+  for (int i = 0; i < 4; ++i) {
+    packet->data[4 + i] = timestamp >> (24 - 8 * i);
+    packet->data[8 + i] = kSsrc >> (24 - 8 * i);
+  }
+  packet->length = length;
+  packet->original_length = length;
+  packet->time_ms = time_ms;
+}
+
+// Writes |num_packets| RTP packets of |length| bytes, sent 10 ms apart, to the
+// rtpdump file |filename|.
+void WriteRtpDump(const std::string& filename,
+                  int num_packets,
+                  size_t length) {
+  rtc::scoped_ptr<test::RtpFileWriter> writer(
+      test::RtpFileWriter::Create(test::RtpFileWriter::kRtpDump, filename));
+  ASSERT_TRUE(writer.get() != NULL);
+  test::RtpPacket packet;
+  for (int i = 0; i < num_packets; ++i) {
+    CreateRtpPacket(i, 10 * i, length, &packet);
+    ASSERT_TRUE(writer->WritePacket(&packet));
+  }
+}
+
+void AppendBigEndian(uint32_t value, int bytes, std::vector<uint8_t>* out) {
+  for (int i = bytes - 1; i >= 0; --i)
+    out->push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+// Writes RTP packets captured at |times_ms| as UDP over IPv4 over Ethernet II
+// to the pcap file |filename|. Packet i has sequence number i.
+void WritePcap(const std::string& filename,
+               const std::vector<uint32_t>& times_ms,
+               size_t length) {
+  FILE* file = fopen(filename.c_str(), "wb");
+  ASSERT_TRUE(file != NULL);
+  // Global header, in native byte order.
+  const uint32_t kGlobalHeader[] = {0xa1b2c3d4, 0x00040002, 0, 0, 65535, 1};
+  fwrite(kGlobalHeader, sizeof(kGlobalHeader), 1, file);
+  // The payload is generated into a larger buffer, as it may be larger than
+  // an RtpPacket.
+  std::vector<uint8_t> payload(length);
+  test::RtpPacket packet;
+  for (size_t i = 0; i < times_ms.size(); ++i) {
+    CreateRtpPacket(static_cast<uint16_t>(i), times_ms[i],
+                    std::min(length, sizeof(packet.data)), &packet);
+    memcpy(&payload[0], packet.data, packet.length);
+    std::vector<uint8_t> frame(12, 0);  // Destination and source MAC.
+    AppendBigEndian(0x0800, 2, &frame);  // IPv4.
+    AppendBigEndian(0x4500, 2, &frame);  // Version and header length.
+    AppendBigEndian(20 + 8 + length, 2, &frame);
+    AppendBigEndian(0, 2, &frame);       // Identification.
+    AppendBigEndian(0x4000, 2, &frame);  // Don't fragment.
+    AppendBigEndian(0x4011, 2, &frame);  // TTL and UDP.
+    AppendBigEndian(0, 2, &frame);       // Checksum.
+    AppendBigEndian(0x7f000001, 4, &frame);
+    AppendBigEndian(0x7f000001, 4, &frame);
+    AppendBigEndian(5000, 2, &frame);
+    AppendBigEndian(5001, 2, &frame);
+    AppendBigEndian(8 + length, 2, &frame);
+    AppendBigEndian(0, 2, &frame);
+    frame.insert(frame.end(), payload.begin(), payload.end());
+    const uint32_t record_header[] = {
+        1000 + times_ms[i] / 1000, (times_ms[i] % 1000) * 1000,
+        static_cast<uint32_t>(frame.size()),
+        static_cast<uint32_t>(frame.size())};
+    fwrite(record_header, sizeof(record_header), 1, file);
+    fwrite(&frame[0], 1, frame.size(), file);
+  }
+  fclose(file);
+}
+
+// Packets are sent 10 ms apart unless |time_ms| is given.
+void ExpectNextPacket(test::RtpFileReader* reader,
+                      uint16_t sequence_number,
+                      size_t length,
+                      uint32_t time_ms = 0) {
+  test::RtpPacket packet;
+  ASSERT_TRUE(reader->NextPacket(&packet));
+  EXPECT_EQ(length, packet.length);
+  EXPECT_EQ(time_ms != 0 ? time_ms : 10u * sequence_number, packet.time_ms);
+  RtpUtility::RtpHeaderParser parser(packet.data, packet.length);
+  RTPHeader header;
+  ASSERT_TRUE(parser.Parse(header, NULL));
+  EXPECT_EQ(sequence_number, header.sequenceNumber);
+  EXPECT_EQ(kSsrc, header.ssrc);
+}
+}  // namespace
+
+TEST(RtpFileReaderSeekTest, SeeksInRtpDump) {
+  std::string filename = test::OutputPath() + "rtp_file_reader_seek.rtp";
+  WriteRtpDump(filename, 100, 200);
+  rtc::scoped_ptr<test::RtpFileReader> reader(
+      test::RtpFileReader::Create(test::RtpFileReader::kRtpDump, filename));
+  ASSERT_TRUE(reader.get() != NULL);
+  EXPECT_EQ(100u, reader->NumPackets());
+
+  ExpectNextPacket(reader.get(), 0, 200);
+  EXPECT_TRUE(reader->SeekToTime(505));
+  ExpectNextPacket(reader.get(), 51, 200);
+  ExpectNextPacket(reader.get(), 52, 200);
+  EXPECT_TRUE(reader->SeekToTime(0));
+  ExpectNextPacket(reader.get(), 0, 200);
+  EXPECT_FALSE(reader->SeekToTime(1000));
+  test::RtpPacket packet;
+  EXPECT_FALSE(reader->NextPacket(&packet));
+  remove(filename.c_str());
+}
+
+TEST(RtpFileReaderSeekTest, SeeksInPcap) {
+  std::string filename = test::OutputPath() + "rtp_file_reader_seek.pcap";
+  std::vector<uint32_t> times_ms;
+  for (uint32_t i = 0; i < 100; ++i)
+    times_ms.push_back(10 * i);
+  WritePcap(filename, times_ms, 200);
+  rtc::scoped_ptr<test::RtpFileReader> reader(
+      test::RtpFileReader::Create(test::RtpFileReader::kPcap, filename));
+  ASSERT_TRUE(reader.get() != NULL);
+  EXPECT_EQ(100u, reader->NumPackets());
+
+  ExpectNextPacket(reader.get(), 0, 200);
+  EXPECT_TRUE(reader->SeekToTime(505));
+  ExpectNextPacket(reader.get(), 51, 200);
+  EXPECT_FALSE(reader->SeekToTime(1000));
+  test::RtpPacket packet;
+  EXPECT_FALSE(reader->NextPacket(&packet));
+  remove(filename.c_str());
+}
+
+TEST(RtpFileReaderSeekTest, SeeksToFirstPacketInFileOrderInReorderedPcap) {
+  std::string filename = test::OutputPath() + "rtp_file_reader_reordered.pcap";
+  const uint32_t kTimesMs[] = {0, 10, 30, 20, 40, 50};
+  WritePcap(filename, std::vector<uint32_t>(kTimesMs, kTimesMs + 6), 200);
+  rtc::scoped_ptr<test::RtpFileReader> reader(
+      test::RtpFileReader::Create(test::RtpFileReader::kPcap, filename));
+  ASSERT_TRUE(reader.get() != NULL);
+
+  // The packet captured at 30 ms is the first one at or after 20 ms.
+  EXPECT_TRUE(reader->SeekToTime(20));
+  ExpectNextPacket(reader.get(), 2, 200, 30);
+  ExpectNextPacket(reader.get(), 3, 200, 20);
+  EXPECT_TRUE(reader->SeekToTime(35));
+  ExpectNextPacket(reader.get(), 4, 200, 40);
+  EXPECT_TRUE(reader->SeekToTime(0));
+  ExpectNextPacket(reader.get(), 0, 200);
+  EXPECT_FALSE(reader->SeekToTime(51));
+  test::RtpPacket packet;
+  EXPECT_FALSE(reader->NextPacket(&packet));
+  remove(filename.c_str());
+}
+
+TEST(RtpFileReaderSeekTest, FailsToReadTooLargePacketInPcap) {
+  std::string filename = test::OutputPath() + "rtp_file_reader_large.pcap";
+  test::RtpPacket packet;
+  WritePcap(filename, std::vector<uint32_t>(1, 0), sizeof(packet.data) + 1);
+  rtc::scoped_ptr<test::RtpFileReader> reader(
+      test::RtpFileReader::Create(test::RtpFileReader::kPcap, filename));
+  ASSERT_TRUE(reader.get() != NULL);
+  EXPECT_EQ(1u, reader->NumPackets());
+  EXPECT_FALSE(reader->NextPacket(&packet));
+  remove(filename.c_str());
+}
 }  // namespace webrtc
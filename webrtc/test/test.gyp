@@ -67,6 +67,7 @@
       'dependencies': [
         '<(DEPTH)/webrtc/common.gyp:webrtc_common',
         '<(DEPTH)/testing/gtest.gyp:gtest',
+        '<(webrtc_root)/base/base.gyp:rtc_base_approved',
         '<(webrtc_root)/modules/modules.gyp:rtp_rtcp',
       ],
     },
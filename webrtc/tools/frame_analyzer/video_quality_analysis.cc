@@ -13,9 +13,15 @@
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include <algorithm>
 #include <string>
 
+#include "webrtc/system_wrappers/interface/condition_variable_wrapper.h"
+#include "webrtc/system_wrappers/interface/cpu_info.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+
 #define STATS_LINE_LENGTH 32
 #define Y4M_FILE_HEADER_MAX_SIZE 200
 #define Y4M_FRAME_DELIMITER "FRAME"
@@ -211,24 +217,183 @@ double CalculateMetrics(VideoAnalysisMetricsType video_metrics_type,
   return result;
 }
 
+VideoFileMap::VideoFileMap() {
+}
+
+VideoFileMap::~VideoFileMap() {
+}
+
+bool VideoFileMap::Open(const char* file_name, int width, int height) {
+  frame_offsets_.clear();
+  if (!file_.Open(file_name)) {
+    fprintf(stderr, "Couldn't open input file for reading: %s\n", file_name);
+    return false;
+  }
+  // Frames are mostly read front to back.
+  file_.AdviseSequential();
+
+  const size_t frame_size = GetI420FrameSize(width, height);
+  if (frame_size == 0)
+    return true;
+  const uint8* data = file_.data();
+  const size_t size = file_.size();
+  if (std::string(file_name).find("y4m") == std::string::npos) {
+    for (size_t offset = 0; offset + frame_size <= size; offset += frame_size)
+      frame_offsets_.push_back(offset);
+    return true;
+  }
+
+  // YUV4MPEG2, a.k.a. Y4M File format has a file header and a frame header.
+  // The file header has the aspect: "YUV4MPEG2 C420 W640 H360 Ip F30:1 A1:1".
+  std::string header_contents(
+      reinterpret_cast<const char*>(data),
+      std::min(size, static_cast<size_t>(Y4M_FILE_HEADER_MAX_SIZE)));
+  size_t offset = header_contents.find(Y4M_FRAME_DELIMITER);
+  if (offset == std::string::npos) {
+    fprintf(stdout, "Corrupted Y4M header, could not find \"FRAME\" in %s\n",
+            file_name);
+    file_.Close();
+    return false;
+  }
+  // Each frame header is "FRAME", optionally followed by parameters, and ends
+  // with a newline.
+  const size_t delimiter_length = strlen(Y4M_FRAME_DELIMITER);
+  while (size - offset >= delimiter_length &&
+         memcmp(data + offset, Y4M_FRAME_DELIMITER, delimiter_length) == 0) {
+    const void* header_end = memchr(
+        data + offset, '\n',
+        std::min(size - offset, static_cast<size_t>(Y4M_FILE_HEADER_MAX_SIZE)));
+    if (header_end == NULL)
+      break;
+    const size_t frame_offset =
+        static_cast<const uint8*>(header_end) - data + 1;
+    if (size - frame_offset < frame_size)
+      break;
+    frame_offsets_.push_back(frame_offset);
+    offset = frame_offset + frame_size;
+  }
+  return true;
+}
+
+const uint8* VideoFileMap::GetFrame(int frame_number) const {
+  if (frame_number < 0 || frame_number >= num_frames())
+    return NULL;
+  return file_.data() + frame_offsets_[frame_number];
+}
+
+ParallelFrameAnalyzer::ParallelFrameAnalyzer(int width, int height,
+                                             int num_threads)
+    : width_(width),
+      height_(height),
+      crit_(CriticalSectionWrapper::CreateCriticalSection()),
+      job_added_(ConditionVariableWrapper::CreateConditionVariable()),
+      job_done_(ConditionVariableWrapper::CreateConditionVariable()),
+      next_job_(0),
+      stop_(false) {
+  assert(num_threads > 0);
+  for (int i = 0; i < num_threads; ++i) {
+    rtc::scoped_ptr<ThreadWrapper> thread = ThreadWrapper::CreateThread(
+        &ParallelFrameAnalyzer::Run, this, "FrameAnalyzer");
+    thread->Start();
+    threads_.push_back(thread.release());
+  }
+}
+
+ParallelFrameAnalyzer::~ParallelFrameAnalyzer() {
+  {
+    CriticalSectionScoped cs(crit_.get());
+    stop_ = true;
+  }
+  job_added_->WakeAll();
+  for (size_t i = 0; i < threads_.size(); ++i) {
+    threads_[i]->Stop();
+    delete threads_[i];
+  }
+}
+
+void ParallelFrameAnalyzer::AddFramePair(int frame_number,
+                                         const uint8* reference_frame,
+                                         const uint8* test_frame) {
+  {
+    CriticalSectionScoped cs(crit_.get());
+    jobs_.push_back(Job(frame_number, reference_frame, test_frame));
+  }
+  job_added_->Wake();
+}
+
+size_t ParallelFrameAnalyzer::num_pending() const {
+  CriticalSectionScoped cs(crit_.get());
+  return jobs_.size();
+}
+
+bool ParallelFrameAnalyzer::GetNextResult(AnalysisResult* result) {
+  CriticalSectionScoped cs(crit_.get());
+  if (jobs_.empty())
+    return false;
+  while (!jobs_.front().done)
+    job_done_->SleepCS(*crit_);
+  *result = jobs_.front().result;
+  jobs_.pop_front();
+  // The job was taken by a thread before it could be done.
+  --next_job_;
+  return true;
+}
+
+bool ParallelFrameAnalyzer::Run(void* obj) {
+  return static_cast<ParallelFrameAnalyzer*>(obj)->Process();
+}
+
+bool ParallelFrameAnalyzer::Process() {
+  Job* job;
+  {
+    CriticalSectionScoped cs(crit_.get());
+    while (!stop_ && next_job_ == jobs_.size())
+      job_added_->SleepCS(*crit_);
+    if (stop_)
+      return false;
+    job = &jobs_[next_job_++];
+  }
+
+  double psnr = CalculateMetrics(kPSNR, job->reference_frame, job->test_frame,
+                                 width_, height_);
+  double ssim = CalculateMetrics(kSSIM, job->reference_frame, job->test_frame,
+                                 width_, height_);
+
+  {
+    CriticalSectionScoped cs(crit_.get());
+    job->result.psnr_value = psnr;
+    job->result.ssim_value = ssim;
+    job->done = true;
+  }
+  job_done_->WakeAll();
+  return true;
+}
+
+int DefaultNumAnalysisThreads() {
+  return static_cast<int>(CpuInfo::DetectNumberOfCores());
+}
+
 void RunAnalysis(const char* reference_file_name, const char* test_file_name,
                  const char* stats_file_name, int width, int height,
                  ResultsContainer* results) {
-  // Check if the reference_file_name ends with "y4m".
-  bool y4m_mode = false;
-  if (std::string(reference_file_name).find("y4m") != std::string::npos){
-    y4m_mode = true;
+  VideoFileMap reference_file;
+  VideoFileMap test_file;
+  if (!reference_file.Open(reference_file_name, width, height) ||
+      !test_file.Open(test_file_name, width, height)) {
+    return;
   }
 
-  int size = GetI420FrameSize(width, height);
   FILE* stats_file = fopen(stats_file_name, "r");
+  if (stats_file == NULL) {
+    fprintf(stderr, "Couldn't open stats file for reading: %s\n",
+            stats_file_name);
+    return;
+  }
 
   // String buffer for the lines in the stats file.
   char line[STATS_LINE_LENGTH];
 
-  // Allocate buffers for test and reference frames.
-  uint8* test_frame = new uint8[size];
-  uint8* reference_frame = new uint8[size];
+  ParallelFrameAnalyzer analyzer(width, height, DefaultNumAnalysisThreads());
   int previous_frame_number = -1;
 
   // While there are entries in the stats file.
@@ -246,37 +411,27 @@ void RunAnalysis(const char* reference_file_name, const char* test_file_name,
     assert(extracted_test_frame != -1);
     assert(decoded_frame_number != -1);
 
-    ExtractFrameFromYuvFile(test_file_name, width, height, extracted_test_frame,
-                            test_frame);
-    if (y4m_mode) {
-      ExtractFrameFromY4mFile(reference_file_name, width, height,
-                              decoded_frame_number, reference_frame);
-    } else {
-      ExtractFrameFromYuvFile(reference_file_name, width, height,
-                              decoded_frame_number, reference_frame);
-    }
-
-    // Calculate the PSNR and SSIM.
-    double result_psnr = CalculateMetrics(kPSNR, reference_frame, test_frame,
-                                          width, height);
-    double result_ssim = CalculateMetrics(kSSIM, reference_frame, test_frame,
-                                          width, height);
-
     previous_frame_number = decoded_frame_number;
 
-    // Fill in the result struct.
-    AnalysisResult result;
-    result.frame_number = decoded_frame_number;
-    result.psnr_value = result_psnr;
-    result.ssim_value = result_ssim;
+    const uint8* test_frame = test_file.GetFrame(extracted_test_frame);
+    const uint8* reference_frame =
+        reference_file.GetFrame(decoded_frame_number);
+    if (test_frame == NULL || reference_frame == NULL) {
+      fprintf(stdout, "Error while reading frame no %d from file %s\n",
+              test_frame == NULL ? extracted_test_frame : decoded_frame_number,
+              test_frame == NULL ? test_file_name : reference_file_name);
+      continue;
+    }
 
-    results->frames.push_back(result);
+    // The PSNR and SSIM are calculated by the analyzer threads.
+    analyzer.AddFramePair(decoded_frame_number, reference_frame, test_frame);
   }
-
-  // Cleanup.
   fclose(stats_file);
-  delete[] test_frame;
-  delete[] reference_frame;
+
+  // Fill in the results, in stats file order.
+  AnalysisResult result;
+  while (analyzer.GetNextResult(&result))
+    results->frames.push_back(result);
 }
 
 void PrintMaxRepeatedAndSkippedFrames(const std::string& label,
@@ -11,13 +11,22 @@
 #ifndef WEBRTC_TOOLS_FRAME_ANALYZER_VIDEO_QUALITY_ANALYSIS_H_
 #define WEBRTC_TOOLS_FRAME_ANALYZER_VIDEO_QUALITY_ANALYSIS_H_
 
+#include <deque>
 #include <string>
 #include <vector>
 
 #include "libyuv/compare.h"  // NOLINT
 #include "libyuv/convert.h"  // NOLINT
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/memory_mapped_file.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
 
 namespace webrtc {
+
+class ConditionVariableWrapper;
+class CriticalSectionWrapper;
+
 namespace test {
 
 struct AnalysisResult {
@@ -50,6 +59,8 @@ enum VideoAnalysisMetricsType {kPSNR, kSSIM};
 // tools/barcode_tools/barcode_decoder.py. This script decodes the barcodes
 // integrated in every video and generates the stats file. If three was some
 // problem with the decoding there would be 'Barcode error' instead of yyyy.
+// The video files are memory mapped, and the frames analyzed on
+// DefaultNumAnalysisThreads() threads.
 void RunAnalysis(const char* reference_file_name, const char* test_file_name,
                  const char* stats_file_name, int width, int height,
                  ResultsContainer* results);
@@ -62,6 +73,91 @@ double CalculateMetrics(VideoAnalysisMetricsType video_metrics_type,
                         const uint8* ref_frame,  const uint8* test_frame,
                         int width, int height);
 
+// Read-only memory map of an I420 YUV or Y4M file, giving access to every frame
+// without reading it into a buffer first. Files ending with "y4m" are parsed as
+// Y4M, where each frame is preceded by a "FRAME" header line that may carry
+// frame parameters, so the frames are located by walking these headers.
+class VideoFileMap {
+ public:
+  VideoFileMap();
+  ~VideoFileMap();
+
+  // Returns false if the file can't be mapped, or if a Y4M file has no frame
+  // header within its file header. A Y4M file is read up to the first
+  // malformed frame header or incomplete frame.
+  bool Open(const char* file_name, int width, int height);
+
+  // Number of complete frames in the file.
+  int num_frames() const { return static_cast<int>(frame_offsets_.size()); }
+
+  // Returns the I420 frame at position |frame_number|, the first frame being
+  // 0, or NULL if there is no such frame.
+  const uint8* GetFrame(int frame_number) const;
+
+ private:
+  rtc::MemoryMappedFile file_;
+  // Offset of the I420 data of each frame.
+  std::vector<size_t> frame_offsets_;
+
+  DISALLOW_COPY_AND_ASSIGN(VideoFileMap);
+};
+
+// Calculates PSNR and SSIM for pairs of frames on a pool of threads. Results
+// are returned in the order the pairs were added, so that they can be written
+// out while later pairs are still being analyzed.
+class ParallelFrameAnalyzer {
+ public:
+  ParallelFrameAnalyzer(int width, int height, int num_threads);
+  ~ParallelFrameAnalyzer();
+
+  // Queues a pair of frames for analysis. The frames must stay valid until
+  // their result has been returned by GetNextResult().
+  void AddFramePair(int frame_number, const uint8* reference_frame,
+                    const uint8* test_frame);
+
+  // Number of pairs added but not yet returned by GetNextResult().
+  size_t num_pending() const;
+
+  // Blocks until the oldest pending pair has been analyzed. Returns false if
+  // there are no pending pairs.
+  bool GetNextResult(AnalysisResult* result);
+
+ private:
+  struct Job {
+    Job(int frame_number, const uint8* reference_frame,
+        const uint8* test_frame)
+        : result(frame_number, 0.0, 0.0),
+          reference_frame(reference_frame),
+          test_frame(test_frame),
+          done(false) {}
+    AnalysisResult result;
+    const uint8* reference_frame;
+    const uint8* test_frame;
+    bool done;
+  };
+
+  static bool Run(void* obj);
+  bool Process();
+
+  const int width_;
+  const int height_;
+  const rtc::scoped_ptr<CriticalSectionWrapper> crit_;
+  // Signalled when a job is added or the threads should stop.
+  const rtc::scoped_ptr<ConditionVariableWrapper> job_added_;
+  // Signalled when a job is done.
+  const rtc::scoped_ptr<ConditionVariableWrapper> job_done_;
+  std::vector<ThreadWrapper*> threads_;
+
+  // Pending jobs, oldest first. Jobs before |next_job_| have been taken by a
+  // thread. Elements of a deque stay in place when others are added or
+  // removed at the ends, so threads work on them outside of |crit_|.
+  std::deque<Job> jobs_;
+  size_t next_job_;
+  bool stop_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelFrameAnalyzer);
+};
+
 // Prints the result from the analysis in Chromium performance
 // numbers compatible format to stdout. If the results object contains no frames
 // no output will be written.
@@ -97,6 +193,10 @@ bool IsThereBarcodeError(std::string line);
 // frame_0023 0284, we will get 284.
 int ExtractDecodedFrameNumber(std::string line);
 
+// Number of threads used to analyze frames by RunAnalysis(), and by default by
+// the analyzer tools.
+int DefaultNumAnalysisThreads();
+
 // Extracts an I420 frame at position frame_number from the raw YUV file.
 bool ExtractFrameFromYuvFile(const char* i420_file_name, int width, int height,
                              int frame_number, uint8* result_frame);
@@ -0,0 +1,107 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/test/testsupport/fileutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
+#include "webrtc/tools/frame_analyzer/video_quality_analysis.h"
+
+namespace webrtc {
+namespace test {
+namespace {
+
+// Writes |num_frames| I420 frames to |file_name|, each with a different
+// pattern depending on |seed_offset| and the frame number.
+void WriteYuvFile(const std::string& file_name, int width, int height,
+                  int num_frames, int seed_offset) {
+  FILE* file = fopen(file_name.c_str(), "wb");
+  ASSERT_TRUE(file != NULL);
+  std::vector<uint8> frame(GetI420FrameSize(width, height));
+  for (int i = 0; i < num_frames; ++i) {
+    const int seed = seed_offset + i;
+    for (size_t j = 0; j < frame.size(); ++j)
+      frame[j] = static_cast<uint8>((j * (seed + 1) + seed * 7) % 251);
+    ASSERT_EQ(frame.size(), fwrite(&frame[0], 1, frame.size(), file));
+  }
+  fclose(file);
+}
+
+}  // namespace
+
+// Compares analyzing a 1080p clip by reading each frame from file and running
+// the metrics on one thread, as the analyzer tools used to, to analyzing it
+// from a memory mapped file on DefaultNumAnalysisThreads() threads.
+TEST(VideoQualityAnalysisPerfTest, Analysis1080p) {
+  const int kWidth = 1920;
+  const int kHeight = 1080;
+  const int kNumFrames = 10;
+  std::string reference_file_name = OutputPath() + "analysis_perf_ref.yuv";
+  std::string test_file_name = OutputPath() + "analysis_perf_test.yuv";
+  WriteYuvFile(reference_file_name, kWidth, kHeight, kNumFrames, 0);
+  WriteYuvFile(test_file_name, kWidth, kHeight, kNumFrames, 1);
+
+  int64_t start_ms = TickTime::MillisecondTimestamp();
+  std::vector<uint8> reference_frame(GetI420FrameSize(kWidth, kHeight));
+  std::vector<uint8> test_frame(reference_frame.size());
+  std::vector<AnalysisResult> serial_results;
+  for (int i = 0; i < kNumFrames; ++i) {
+    ASSERT_TRUE(ExtractFrameFromYuvFile(reference_file_name.c_str(), kWidth,
+                                        kHeight, i, &reference_frame[0]));
+    ASSERT_TRUE(ExtractFrameFromYuvFile(test_file_name.c_str(), kWidth,
+                                        kHeight, i, &test_frame[0]));
+    serial_results.push_back(AnalysisResult(
+        i, CalculateMetrics(kPSNR, &reference_frame[0], &test_frame[0], kWidth,
+                            kHeight),
+        CalculateMetrics(kSSIM, &reference_frame[0], &test_frame[0], kWidth,
+                         kHeight)));
+  }
+  const int64_t serial_ms = TickTime::MillisecondTimestamp() - start_ms;
+
+  start_ms = TickTime::MillisecondTimestamp();
+  VideoFileMap reference_file;
+  VideoFileMap test_file;
+  ASSERT_TRUE(reference_file.Open(reference_file_name.c_str(), kWidth,
+                                  kHeight));
+  ASSERT_TRUE(test_file.Open(test_file_name.c_str(), kWidth, kHeight));
+  std::vector<AnalysisResult> parallel_results;
+  {
+    ParallelFrameAnalyzer analyzer(kWidth, kHeight,
+                                   DefaultNumAnalysisThreads());
+    for (int i = 0; i < kNumFrames; ++i) {
+      analyzer.AddFramePair(i, reference_file.GetFrame(i),
+                            test_file.GetFrame(i));
+    }
+    AnalysisResult result;
+    while (analyzer.GetNextResult(&result))
+      parallel_results.push_back(result);
+  }
+  const int64_t parallel_ms = TickTime::MillisecondTimestamp() - start_ms;
+
+  ASSERT_EQ(serial_results.size(), parallel_results.size());
+  for (size_t i = 0; i < serial_results.size(); ++i) {
+    EXPECT_EQ(serial_results[i].psnr_value, parallel_results[i].psnr_value);
+    EXPECT_EQ(serial_results[i].ssim_value, parallel_results[i].ssim_value);
+  }
+  PrintResult("video_quality_analysis_1080p", "", "frame_by_frame",
+              static_cast<size_t>(serial_ms), "ms", false);
+  PrintResult("video_quality_analysis_1080p", "", "memory_mapped_parallel",
+              static_cast<size_t>(parallel_ms), "ms", true);
+  remove(reference_file_name.c_str());
+  remove(test_file_name.c_str());
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -13,6 +13,7 @@
 
 #include <fstream>
 #include <string>
+#include <vector>
 
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/test/testsupport/fileutils.h"
@@ -38,6 +39,33 @@ class VideoQualityAnalysisTest : public ::testing::Test {
 };
 FILE* VideoQualityAnalysisTest::logfile_ = NULL;
 
+namespace {
+// Fills |frame| with a pattern that depends on |seed|, so that frames made
+// from different seeds have different PSNR and SSIM against each other.
+void FillFrame(int seed, std::vector<uint8>* frame) {
+  for (size_t i = 0; i < frame->size(); ++i)
+    (*frame)[i] = static_cast<uint8>((i * (seed + 1) + seed * 7) % 251);
+}
+
+// Writes |num_frames| frames made by FillFrame() with seeds |seed_offset|,
+// |seed_offset| + 1, ... to |file_name|, as a Y4M file if |y4m| is true.
+void WriteVideoFile(const std::string& file_name, int width, int height,
+                    int num_frames, int seed_offset, bool y4m) {
+  FILE* file = fopen(file_name.c_str(), "wb");
+  ASSERT_TRUE(file != NULL);
+  if (y4m)
+    fprintf(file, "YUV4MPEG2 W%d H%d F30:1 C420\n", width, height);
+  std::vector<uint8> frame(GetI420FrameSize(width, height));
+  for (int i = 0; i < num_frames; ++i) {
+    FillFrame(seed_offset + i, &frame);
+    if (y4m)
+      fprintf(file, "FRAME\n");
+    ASSERT_EQ(frame.size(), fwrite(&frame[0], 1, frame.size(), file));
+  }
+  fclose(file);
+}
+}  // namespace
+
 TEST_F(VideoQualityAnalysisTest, PrintAnalysisResultsEmpty) {
   ResultsContainer result;
   PrintAnalysisResults(logfile_, "Empty", &result);
@@ -86,6 +114,118 @@ TEST_F(VideoQualityAnalysisTest, PrintMaxRepeatedAndSkippedFramesNormalFile) {
   PrintMaxRepeatedAndSkippedFrames(logfile_, "NormalStatsFile", stats_filename);
 }
 
+TEST_F(VideoQualityAnalysisTest, VideoFileMapReadsYuvFrames) {
+  const int kWidth = 8;
+  const int kHeight = 6;
+  std::string file_name = OutputPath() + "video_file_map_test.yuv";
+  WriteVideoFile(file_name, kWidth, kHeight, 3, 0, false);
+
+  VideoFileMap file;
+  ASSERT_TRUE(file.Open(file_name.c_str(), kWidth, kHeight));
+  EXPECT_EQ(3, file.num_frames());
+  std::vector<uint8> frame(GetI420FrameSize(kWidth, kHeight));
+  std::vector<uint8> extracted_frame(frame.size());
+  for (int i = 0; i < file.num_frames(); ++i) {
+    FillFrame(i, &frame);
+    ASSERT_TRUE(file.GetFrame(i) != NULL);
+    EXPECT_EQ(0, memcmp(&frame[0], file.GetFrame(i), frame.size()));
+    ASSERT_TRUE(ExtractFrameFromYuvFile(file_name.c_str(), kWidth, kHeight, i,
+                                        &extracted_frame[0]));
+    EXPECT_EQ(frame, extracted_frame);
+  }
+  EXPECT_TRUE(file.GetFrame(-1) == NULL);
+  EXPECT_TRUE(file.GetFrame(3) == NULL);
+  remove(file_name.c_str());
+}
+
+TEST_F(VideoQualityAnalysisTest, VideoFileMapReadsY4mFrames) {
+  const int kWidth = 8;
+  const int kHeight = 6;
+  std::string file_name = OutputPath() + "video_file_map_test.y4m";
+  WriteVideoFile(file_name, kWidth, kHeight, 3, 0, true);
+
+  VideoFileMap file;
+  ASSERT_TRUE(file.Open(file_name.c_str(), kWidth, kHeight));
+  EXPECT_EQ(3, file.num_frames());
+  std::vector<uint8> frame(GetI420FrameSize(kWidth, kHeight));
+  for (int i = 0; i < file.num_frames(); ++i) {
+    FillFrame(i, &frame);
+    ASSERT_TRUE(file.GetFrame(i) != NULL);
+    EXPECT_EQ(0, memcmp(&frame[0], file.GetFrame(i), frame.size()));
+  }
+  EXPECT_TRUE(file.GetFrame(3) == NULL);
+  remove(file_name.c_str());
+}
+
+TEST_F(VideoQualityAnalysisTest, VideoFileMapReadsY4mFrameParameters) {
+  const int kWidth = 8;
+  const int kHeight = 6;
+  const char* const kFrameHeaders[] = {"FRAME\n", "FRAME Ip\n",
+                                       "FRAME Ib XYSCSS=420JPEG\n"};
+  const int kNumFrames = sizeof(kFrameHeaders) / sizeof(kFrameHeaders[0]);
+  std::string file_name = OutputPath() + "video_file_map_params_test.y4m";
+  FILE* output = fopen(file_name.c_str(), "wb");
+  ASSERT_TRUE(output != NULL);
+  fprintf(output, "YUV4MPEG2 W%d H%d F30:1 C420\n", kWidth, kHeight);
+  std::vector<uint8> frame(GetI420FrameSize(kWidth, kHeight));
+  for (int i = 0; i < kNumFrames; ++i) {
+    FillFrame(i, &frame);
+    fputs(kFrameHeaders[i], output);
+    ASSERT_EQ(frame.size(), fwrite(&frame[0], 1, frame.size(), output));
+  }
+  // An incomplete last frame is not counted.
+  fputs("FRAME\n", output);
+  ASSERT_EQ(1u, fwrite(&frame[0], 1, 1, output));
+  fclose(output);
+
+  VideoFileMap file;
+  ASSERT_TRUE(file.Open(file_name.c_str(), kWidth, kHeight));
+  EXPECT_EQ(kNumFrames, file.num_frames());
+  for (int i = 0; i < file.num_frames(); ++i) {
+    FillFrame(i, &frame);
+    ASSERT_TRUE(file.GetFrame(i) != NULL);
+    EXPECT_EQ(0, memcmp(&frame[0], file.GetFrame(i), frame.size()));
+  }
+  remove(file_name.c_str());
+}
+
+TEST_F(VideoQualityAnalysisTest, VideoFileMapFailsForMissingFile) {
+  std::string file_name = OutputPath() + "non-existing-video-file.yuv";
+  remove(file_name.c_str());
+  VideoFileMap file;
+  EXPECT_FALSE(file.Open(file_name.c_str(), 8, 6));
+  EXPECT_EQ(0, file.num_frames());
+}
+
+TEST_F(VideoQualityAnalysisTest, ParallelFrameAnalyzerReturnsResultsInOrder) {
+  const int kWidth = 64;
+  const int kHeight = 48;
+  const int kNumFrames = 20;
+  std::vector<std::vector<uint8> > frames(
+      kNumFrames + 1, std::vector<uint8>(GetI420FrameSize(kWidth, kHeight)));
+  for (int i = 0; i <= kNumFrames; ++i)
+    FillFrame(i, &frames[i]);
+
+  ParallelFrameAnalyzer analyzer(kWidth, kHeight, 4);
+  AnalysisResult result;
+  EXPECT_FALSE(analyzer.GetNextResult(&result));
+  // Frame i is compared against frame i + 1.
+  for (int i = 0; i < kNumFrames; ++i)
+    analyzer.AddFramePair(i, &frames[i][0], &frames[i + 1][0]);
+  EXPECT_EQ(static_cast<size_t>(kNumFrames), analyzer.num_pending());
+  for (int i = 0; i < kNumFrames; ++i) {
+    ASSERT_TRUE(analyzer.GetNextResult(&result));
+    EXPECT_EQ(i, result.frame_number);
+    EXPECT_EQ(CalculateMetrics(kPSNR, &frames[i][0], &frames[i + 1][0], kWidth,
+                               kHeight),
+              result.psnr_value);
+    EXPECT_EQ(CalculateMetrics(kSSIM, &frames[i][0], &frames[i + 1][0], kWidth,
+                               kHeight),
+              result.ssim_value);
+  }
+  EXPECT_EQ(0u, analyzer.num_pending());
+  EXPECT_FALSE(analyzer.GetNextResult(&result));
+}
 
 }  // namespace test
 }  // namespace webrtc
@@ -8,10 +8,10 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
-#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <vector>
@@ -19,47 +19,50 @@
 #include "webrtc/tools/frame_analyzer/video_quality_analysis.h"
 #include "webrtc/tools/simple_command_line_parser.h"
 
-#define MAX_NUM_FRAMES_PER_FILE INT_MAX
+void WriteResult(FILE* results_file, bool csv,
+                 const webrtc::test::AnalysisResult& result) {
+  fprintf(results_file,
+          csv ? "%d,%f,%f\n" : "Frame: %d, PSNR: %f, SSIM: %f\n",
+          result.frame_number, result.psnr_value, result.ssim_value);
+}
 
 void CompareFiles(const char* reference_file_name, const char* test_file_name,
-                  const char* results_file_name, int width, int height) {
-  // Check if the reference_file_name ends with "y4m".
-  bool y4m_mode = false;
-  if (std::string(reference_file_name).find("y4m") != std::string::npos){
-    y4m_mode = true;
+                  const char* results_file_name, int width, int height,
+                  int num_threads, bool csv) {
+  webrtc::test::VideoFileMap reference_file;
+  webrtc::test::VideoFileMap test_file;
+  if (!reference_file.Open(reference_file_name, width, height) ||
+      !test_file.Open(test_file_name, width, height)) {
+    return;
   }
 
   FILE* results_file = fopen(results_file_name, "w");
-
-  int size = webrtc::test::GetI420FrameSize(width, height);
-
-  // Allocate buffers for test and reference frames.
-  uint8* test_frame = new uint8[size];
-  uint8* ref_frame = new uint8[size];
-
-  bool read_result = true;
-  for(int frame_counter = 0; frame_counter < MAX_NUM_FRAMES_PER_FILE;
-      ++frame_counter){
-    read_result &= (y4m_mode) ? webrtc::test::ExtractFrameFromY4mFile(
-        reference_file_name, width, height, frame_counter, ref_frame):
-        webrtc::test::ExtractFrameFromYuvFile(reference_file_name, width,
-                                              height, frame_counter, ref_frame);
-    read_result &=  webrtc::test::ExtractFrameFromYuvFile(test_file_name, width,
-        height, frame_counter, test_frame);
-
-    if (!read_result)
-      break;
-
-    // Calculate the PSNR and SSIM.
-    double result_psnr = webrtc::test::CalculateMetrics(
-        webrtc::test::kPSNR, ref_frame, test_frame, width, height);
-    double result_ssim = webrtc::test::CalculateMetrics(
-        webrtc::test::kSSIM, ref_frame, test_frame, width, height);
-    fprintf(results_file, "Frame: %d, PSNR: %f, SSIM: %f\n", frame_counter,
-            result_psnr, result_ssim);
+  if (results_file == NULL) {
+    fprintf(stderr, "Couldn't open results file for writing: %s\n",
+            results_file_name);
+    return;
   }
-  delete[] test_frame;
-  delete[] ref_frame;
+  if (csv)
+    fprintf(results_file, "frame,psnr,ssim\n");
+
+  // Run until either of the files runs out of frames. A few frames per thread
+  // are kept queued, so that no thread runs idle while the results are written
+  // out in order.
+  const size_t max_pending_frames = 2 * num_threads;
+  const int num_frames =
+      std::min(reference_file.num_frames(), test_file.num_frames());
+  webrtc::test::ParallelFrameAnalyzer analyzer(width, height, num_threads);
+  webrtc::test::AnalysisResult result;
+  for (int frame_counter = 0; frame_counter < num_frames; ++frame_counter) {
+    analyzer.AddFramePair(frame_counter, reference_file.GetFrame(frame_counter),
+                          test_file.GetFrame(frame_counter));
+    if (analyzer.num_pending() >= max_pending_frames &&
+        analyzer.GetNextResult(&result)) {
+      WriteResult(results_file, csv, result);
+    }
+  }
+  while (analyzer.GetNextResult(&result))
+    WriteResult(results_file, csv, result);
 
   fclose(results_file);
 }
@@ -72,13 +75,16 @@ void CompareFiles(const char* reference_file_name, const char* test_file_name,
  * frames. The result is written in a results text file in the format:
  * Frame: <frame_number>, PSNR: <psnr_value>, SSIM: <ssim_value>
  * Frame: <frame_number>, ........
+ * or, with --csv, as comma separated values with a header line. Frames are
+ * analyzed on --num_threads threads, by default one per CPU core, and the
+ * input files are memory mapped rather than read frame by frame.
  *
  * The max value for PSNR is 48.0 (between equal frames), as for SSIM it is 1.0.
  *
  * Usage:
  * psnr_ssim_analyzer --reference_file=<name_of_file> --test_file=<name_of_file>
  * --results_file=<name_of_file> --width=<width_of_frames>
- * --height=<height_of_frames>
+ * --height=<height_of_frames> [--num_threads=<number_of_threads>] [--csv]
  */
 int main(int argc, char** argv) {
   std::string program_name = argv[0];
@@ -96,7 +102,11 @@ int main(int argc, char** argv) {
       "  - test_file(string): The test YUV file to run the analysis for."
       " Default: test_file.yuv\n"
       "  - results_file(string): The full name of the file where the results "
-      "will be written. Default: results.txt\n";
+      "will be written. Default: results.txt\n"
+      "  - num_threads(int): The number of threads to analyze frames on. "
+      "Default: the number of CPU cores\n"
+      "  - csv(bool): Write the results as comma separated values. "
+      "Default: false\n";
 
   webrtc::test::CommandLineParser parser;
 
@@ -110,6 +120,8 @@ int main(int argc, char** argv) {
   parser.SetFlag("reference_file", "ref.yuv");
   parser.SetFlag("test_file", "test.yuv");
   parser.SetFlag("results_file", "results.txt");
+  parser.SetFlag("num_threads", "-1");
+  parser.SetFlag("csv", "false");
   parser.SetFlag("help", "false");
 
   parser.ProcessFlags();
@@ -127,7 +139,12 @@ int main(int argc, char** argv) {
     return -1;
   }
 
+  int num_threads = strtol((parser.GetFlag("num_threads")).c_str(), NULL, 10);
+  if (num_threads <= 0)
+    num_threads = webrtc::test::DefaultNumAnalysisThreads();
+
   CompareFiles(parser.GetFlag("reference_file").c_str(),
                parser.GetFlag("test_file").c_str(),
-               parser.GetFlag("results_file").c_str(), width, height);
+               parser.GetFlag("results_file").c_str(), width, height,
+               num_threads, parser.GetFlag("csv") == "true");
 }
@@ -15,7 +15,9 @@
       'target_name': 'video_quality_analysis',
       'type': 'static_library',
       'dependencies': [
+        '<(webrtc_root)/base/base.gyp:rtc_base_approved',
         '<(webrtc_root)/common_video/common_video.gyp:common_video',
+        '<(webrtc_root)/system_wrappers/system_wrappers.gyp:system_wrappers',
       ],
       'export_dependent_settings': [
         '<(webrtc_root)/common_video/common_video.gyp:common_video',
@@ -10,7 +10,9 @@
 
 #include <string.h>
 
+#include <algorithm>
 #include <map>
+#include <utility>
 #include <vector>
 
 #include "webrtc/base/checks.h"
@@ -18,13 +20,16 @@
 #include "webrtc/base/thread_annotations.h"
 #include "webrtc/call.h"
 #include "webrtc/common.h"
+#include "webrtc/common_video/interface/render_scheduler.h"
 #include "webrtc/config.h"
 #include "webrtc/modules/rtp_rtcp/interface/rtp_header_parser.h"
 #include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_utility.h"
 #include "webrtc/modules/utility/interface/process_thread.h"
 #include "webrtc/modules/video_coding/codecs/vp8/include/vp8.h"
 #include "webrtc/modules/video_coding/codecs/vp9/include/vp9.h"
 #include "webrtc/modules/video_render/include/video_render.h"
+#include "webrtc/system_wrappers/interface/clock.h"
 #include "webrtc/system_wrappers/interface/cpu_info.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/logging.h"
@@ -34,6 +39,7 @@
 #include "webrtc/video/audio_receive_stream.h"
 #include "webrtc/video/video_receive_stream.h"
 #include "webrtc/video/video_send_stream.h"
+#include "webrtc/video_engine/decode_thread_pool.h"
 
 namespace webrtc {
 
@@ -41,6 +47,167 @@ const int Call::Config::kDefaultStartBitrateBps = 300000;
 
 namespace internal {
 
+// SSRC -> stream table kept as a vector sorted by SSRC. It only changes when
+// streams are created or destroyed, while the packet path looks up every
+// packet, so it is laid out for a binary search over contiguous memory rather
+// than the node chasing of a std::map.
+template <typename Stream>
+class SsrcTable {
+ public:
+  typedef std::pair<uint32_t, Stream*> Entry;
+  typedef typename std::vector<Entry>::const_iterator const_iterator;
+
+  Stream* Find(uint32_t ssrc) const {
+    const_iterator it = LowerBound(ssrc);
+    return (it != entries_.end() && it->first == ssrc) ? it->second : nullptr;
+  }
+
+  void Insert(uint32_t ssrc, Stream* stream) {
+    DCHECK(Find(ssrc) == nullptr);
+    entries_.insert(LowerBound(ssrc), Entry(ssrc, stream));
+  }
+
+  size_t Erase(uint32_t ssrc) {
+    const_iterator it = LowerBound(ssrc);
+    if (it == entries_.end() || it->first != ssrc)
+      return 0;
+    entries_.erase(entries_.begin() + (it - entries_.begin()));
+    return 1;
+  }
+
+  // Removes every SSRC mapped to |stream| and returns how many there were.
+  size_t EraseStream(Stream* stream) {
+    size_t size = entries_.size();
+    entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+                                  [stream](const Entry& entry) {
+                                    return entry.second == stream;
+                                  }),
+                   entries_.end());
+    return size - entries_.size();
+  }
+
+  size_t size() const { return entries_.size(); }
+  const_iterator begin() const { return entries_.begin(); }
+  const_iterator end() const { return entries_.end(); }
+
+ private:
+  const_iterator LowerBound(uint32_t ssrc) const {
+    return std::lower_bound(entries_.begin(), entries_.end(), ssrc,
+                            [](const Entry& entry, uint32_t ssrc) {
+                              return entry.first < ssrc;
+                            });
+  }
+
+  std::vector<Entry> entries_;
+};
+
+// Upper bound on the number of SSRCs GetRtcpSsrcs() collects from a compound
+// packet; packets referring to more are broadcast to all streams instead.
+static const size_t kMaxRtcpSsrcs = 32;
+
+static void AddRtcpSsrc(uint32_t ssrc, uint32_t* ssrcs, size_t* num_ssrcs) {
+  for (size_t i = 0; i < std::min(*num_ssrcs, kMaxRtcpSsrcs); ++i) {
+    if (ssrcs[i] == ssrc)
+      return;
+  }
+  if (*num_ssrcs < kMaxRtcpSsrcs)
+    ssrcs[*num_ssrcs] = ssrc;
+  // Counted even when full so the caller can tell the list is incomplete.
+  ++*num_ssrcs;
+}
+
+// Collects the SSRCs a compound RTCP packet refers to, as seen by the same
+// parser the streams use: the sender SSRC of every packet in it, the sources
+// of report blocks, the media source of feedback messages, the SSRCs listed in
+// FIR, TMMBR/TMMBN and REMB messages and the SSRCs of XR DLRR and VoIP metric
+// blocks. Returns false if the packet is invalid or refers to more than
+// kMaxRtcpSsrcs SSRCs.
+static bool GetRtcpSsrcs(const uint8_t* packet,
+                         size_t length,
+                         uint32_t* ssrcs,
+                         size_t* num_ssrcs) {
+  *num_ssrcs = 0;
+  RTCPUtility::RTCPParserV2 parser(packet, length, true);
+  if (!parser.IsValid())
+    return false;
+  for (RTCPUtility::RTCPPacketTypes type = parser.Begin();
+       type != RTCPUtility::RTCPPacketTypes::kInvalid;
+       type = parser.Iterate()) {
+    const RTCPUtility::RTCPPacket& rtcp = parser.Packet();
+    switch (type) {
+      case RTCPUtility::RTCPPacketTypes::kSr:
+        AddRtcpSsrc(rtcp.SR.SenderSSRC, ssrcs, num_ssrcs);
+        break;
+      case RTCPUtility::RTCPPacketTypes::kRr:
+        AddRtcpSsrc(rtcp.RR.SenderSSRC, ssrcs, num_ssrcs);
+        break;
+      case RTCPUtility::RTCPPacketTypes::kReportBlockItem:
+        AddRtcpSsrc(rtcp.ReportBlockItem.SSRC, ssrcs, num_ssrcs);
+        break;
+      case RTCPUtility::RTCPPacketTypes::kSdesChunk:
+        AddRtcpSsrc(rtcp.CName.SenderSSRC, ssrcs, num_ssrcs);
+        break;
+      case RTCPUtility::RTCPPacketTypes::kBye:
+        AddRtcpSsrc(rtcp.BYE.SenderSSRC, ssrcs, num_ssrcs);
+        break;
+      case RTCPUtility::RTCPPacketTypes::kRtpfbNack:
+        AddRtcpSsrc(rtcp.NACK.SenderSSRC, ssrcs, num_ssrcs);
+        AddRtcpSsrc(rtcp.NACK.MediaSSRC, ssrcs, num_ssrcs);
+        break;
+      case RTCPUtility::RTCPPacketTypes::kPsfbPli:
+        AddRtcpSsrc(rtcp.PLI.SenderSSRC, ssrcs, num_ssrcs);
+        AddRtcpSsrc(rtcp.PLI.MediaSSRC, ssrcs, num_ssrcs);
+        break;
+      case RTCPUtility::RTCPPacketTypes::kPsfbSli:
+        AddRtcpSsrc(rtcp.SLI.SenderSSRC, ssrcs, num_ssrcs);
+        AddRtcpSsrc(rtcp.SLI.MediaSSRC, ssrcs, num_ssrcs);
+        break;
+      case RTCPUtility::RTCPPacketTypes::kPsfbRpsi:
+        AddRtcpSsrc(rtcp.RPSI.SenderSSRC, ssrcs, num_ssrcs);
+        AddRtcpSsrc(rtcp.RPSI.MediaSSRC, ssrcs, num_ssrcs);
+        break;
+      case RTCPUtility::RTCPPacketTypes::kPsfbApp:
+        AddRtcpSsrc(rtcp.PSFBAPP.SenderSSRC, ssrcs, num_ssrcs);
+        AddRtcpSsrc(rtcp.PSFBAPP.MediaSSRC, ssrcs, num_ssrcs);
+        break;
+      case RTCPUtility::RTCPPacketTypes::kPsfbRembItem:
+        for (uint8_t i = 0; i < rtcp.REMBItem.NumberOfSSRCs; ++i)
+          AddRtcpSsrc(rtcp.REMBItem.SSRCs[i], ssrcs, num_ssrcs);
+        break;
+      case RTCPUtility::RTCPPacketTypes::kRtpfbTmmbr:
+        AddRtcpSsrc(rtcp.TMMBR.SenderSSRC, ssrcs, num_ssrcs);
+        break;
+      case RTCPUtility::RTCPPacketTypes::kRtpfbTmmbrItem:
+        AddRtcpSsrc(rtcp.TMMBRItem.SSRC, ssrcs, num_ssrcs);
+        break;
+      case RTCPUtility::RTCPPacketTypes::kRtpfbTmmbn:
+        AddRtcpSsrc(rtcp.TMMBN.SenderSSRC, ssrcs, num_ssrcs);
+        break;
+      case RTCPUtility::RTCPPacketTypes::kRtpfbTmmbnItem:
+        AddRtcpSsrc(rtcp.TMMBNItem.SSRC, ssrcs, num_ssrcs);
+        break;
+      case RTCPUtility::RTCPPacketTypes::kPsfbFir:
+        AddRtcpSsrc(rtcp.FIR.SenderSSRC, ssrcs, num_ssrcs);
+        break;
+      case RTCPUtility::RTCPPacketTypes::kPsfbFirItem:
+        AddRtcpSsrc(rtcp.FIRItem.SSRC, ssrcs, num_ssrcs);
+        break;
+      case RTCPUtility::RTCPPacketTypes::kXrHeader:
+        AddRtcpSsrc(rtcp.XR.OriginatorSSRC, ssrcs, num_ssrcs);
+        break;
+      case RTCPUtility::RTCPPacketTypes::kXrDlrrReportBlockItem:
+        AddRtcpSsrc(rtcp.XRDLRRReportBlockItem.SSRC, ssrcs, num_ssrcs);
+        break;
+      case RTCPUtility::RTCPPacketTypes::kXrVoipMetric:
+        AddRtcpSsrc(rtcp.XRVOIPMetricItem.SSRC, ssrcs, num_ssrcs);
+        break;
+      default:
+        break;
+    }
+  }
+  return *num_ssrcs > 0 && *num_ssrcs <= kMaxRtcpSsrcs;
+}
+
 class CpuOveruseObserverProxy : public webrtc::CpuOveruseObserver {
  public:
   explicit CpuOveruseObserverProxy(LoadObserver* overuse_callback)
@@ -112,8 +279,18 @@ class Call : public webrtc::Call, public PacketReceiver {
   void ConfigureSync(const std::string& sync_group)
       EXCLUSIVE_LOCKS_REQUIRED(receive_crit_);
 
+  // Creates the decode thread pool when the first receive stream needs it, so
+  // that calls that only send don't start its threads.
+  DecodeThreadPool* GetDecodeThreadPool();
+
   const int num_cpu_cores_;
   const rtc::scoped_ptr<ProcessThread> module_process_thread_;
+  // Renders the frames of all receive streams.
+  RenderScheduler render_scheduler_;
+  rtc::CriticalSection decode_thread_pool_crit_;
+  // Decodes the frames of all receive streams, one thread per core.
+  rtc::scoped_ptr<DecodeThreadPool> decode_thread_pool_
+      GUARDED_BY(decode_thread_pool_crit_);
   const rtc::scoped_ptr<ChannelGroup> channel_group_;
   volatile int next_channel_id_;
   Call::Config config_;
@@ -125,17 +302,15 @@ class Call : public webrtc::Call, public PacketReceiver {
   bool network_enabled_ GUARDED_BY(network_enabled_crit_);
 
   rtc::scoped_ptr<RWLockWrapper> receive_crit_;
-  std::map<uint32_t, AudioReceiveStream*> audio_receive_ssrcs_
-      GUARDED_BY(receive_crit_);
-  std::map<uint32_t, VideoReceiveStream*> video_receive_ssrcs_
-      GUARDED_BY(receive_crit_);
+  SsrcTable<AudioReceiveStream> audio_receive_ssrcs_ GUARDED_BY(receive_crit_);
+  SsrcTable<VideoReceiveStream> video_receive_ssrcs_ GUARDED_BY(receive_crit_);
   std::set<VideoReceiveStream*> video_receive_streams_
       GUARDED_BY(receive_crit_);
   std::map<std::string, AudioReceiveStream*> sync_stream_mapping_
       GUARDED_BY(receive_crit_);
 
   rtc::scoped_ptr<RWLockWrapper> send_crit_;
-  std::map<uint32_t, VideoSendStream*> video_send_ssrcs_ GUARDED_BY(send_crit_);
+  SsrcTable<VideoSendStream> video_send_ssrcs_ GUARDED_BY(send_crit_);
   std::set<VideoSendStream*> video_send_streams_ GUARDED_BY(send_crit_);
 
   rtc::scoped_ptr<CpuOveruseObserverProxy> overuse_observer_proxy_;
@@ -171,6 +346,7 @@ Call::Call(const Call::Config& config)
 
   Trace::CreateTrace();
   module_process_thread_->Start();
+  render_scheduler_.Start();
 
   if (config.overuse_callback) {
     overuse_observer_proxy_.reset(
@@ -187,6 +363,7 @@ Call::~Call() {
   CHECK_EQ(0u, video_receive_ssrcs_.size());
   CHECK_EQ(0u, video_receive_streams_.size());
 
+  render_scheduler_.Stop();
   module_process_thread_->Stop();
   Trace::ReturnTrace();
 }
@@ -209,9 +386,7 @@ webrtc::AudioReceiveStream* Call::CreateAudioReceiveStream(
       channel_group_->GetRemoteBitrateEstimator(), config);
   {
     WriteLockScoped write_lock(*receive_crit_);
-    DCHECK(audio_receive_ssrcs_.find(config.rtp.remote_ssrc) ==
-        audio_receive_ssrcs_.end());
-    audio_receive_ssrcs_[config.rtp.remote_ssrc] = receive_stream;
+    audio_receive_ssrcs_.Insert(config.rtp.remote_ssrc, receive_stream);
     ConfigureSync(config.sync_group);
   }
   return receive_stream;
@@ -225,7 +400,7 @@ void Call::DestroyAudioReceiveStream(
       static_cast<AudioReceiveStream*>(receive_stream);
   {
     WriteLockScoped write_lock(*receive_crit_);
-    size_t num_deleted = audio_receive_ssrcs_.erase(
+    size_t num_deleted = audio_receive_ssrcs_.Erase(
         audio_receive_stream->config().rtp.remote_ssrc);
     DCHECK(num_deleted == 1);
     const std::string& sync_group = audio_receive_stream->config().sync_group;
@@ -258,10 +433,8 @@ webrtc::VideoSendStream* Call::CreateVideoSendStream(
   // while changing network state.
   rtc::CritScope lock(&network_enabled_crit_);
   WriteLockScoped write_lock(*send_crit_);
-  for (uint32_t ssrc : config.rtp.ssrcs) {
-    DCHECK(video_send_ssrcs_.find(ssrc) == video_send_ssrcs_.end());
-    video_send_ssrcs_[ssrc] = send_stream;
-  }
+  for (uint32_t ssrc : config.rtp.ssrcs)
+    video_send_ssrcs_.Insert(ssrc, send_stream);
   video_send_streams_.insert(send_stream);
 
   if (!network_enabled_)
@@ -278,14 +451,9 @@ void Call::DestroyVideoSendStream(webrtc::VideoSendStream* send_stream) {
   VideoSendStream* send_stream_impl = nullptr;
   {
     WriteLockScoped write_lock(*send_crit_);
-    auto it = video_send_ssrcs_.begin();
-    while (it != video_send_ssrcs_.end()) {
-      if (it->second == static_cast<VideoSendStream*>(send_stream)) {
-        send_stream_impl = it->second;
-        video_send_ssrcs_.erase(it++);
-      } else {
-        ++it;
-      }
+    if (video_send_ssrcs_.EraseStream(
+            static_cast<VideoSendStream*>(send_stream)) > 0) {
+      send_stream_impl = static_cast<VideoSendStream*>(send_stream);
     }
     video_send_streams_.erase(send_stream_impl);
   }
@@ -307,22 +475,20 @@ webrtc::VideoReceiveStream* Call::CreateVideoReceiveStream(
   TRACE_EVENT0("webrtc", "Call::CreateVideoReceiveStream");
   LOG(LS_INFO) << "CreateVideoReceiveStream: " << config.ToString();
   VideoReceiveStream* receive_stream = new VideoReceiveStream(
-      num_cpu_cores_, channel_group_.get(),
-      rtc::AtomicOps::Increment(&next_channel_id_), config,
-      config_.voice_engine);
+      num_cpu_cores_, channel_group_.get(), &render_scheduler_,
+      GetDecodeThreadPool(), rtc::AtomicOps::Increment(&next_channel_id_),
+      config, config_.voice_engine);
 
   // This needs to be taken before receive_crit_ as both locks need to be held
   // while changing network state.
   rtc::CritScope lock(&network_enabled_crit_);
   WriteLockScoped write_lock(*receive_crit_);
-  DCHECK(video_receive_ssrcs_.find(config.rtp.remote_ssrc) ==
-      video_receive_ssrcs_.end());
-  video_receive_ssrcs_[config.rtp.remote_ssrc] = receive_stream;
+  video_receive_ssrcs_.Insert(config.rtp.remote_ssrc, receive_stream);
   // TODO(pbos): Configure different RTX payloads per receive payload.
   VideoReceiveStream::Config::Rtp::RtxMap::const_iterator it =
       config.rtp.rtx.begin();
   if (it != config.rtp.rtx.end())
-    video_receive_ssrcs_[it->second.ssrc] = receive_stream;
+    video_receive_ssrcs_.Insert(it->second.ssrc, receive_stream);
   video_receive_streams_.insert(receive_stream);
 
   ConfigureSync(config.sync_group);
@@ -333,6 +499,15 @@ webrtc::VideoReceiveStream* Call::CreateVideoReceiveStream(
   return receive_stream;
 }
 
+DecodeThreadPool* Call::GetDecodeThreadPool() {
+  rtc::CritScope lock(&decode_thread_pool_crit_);
+  if (!decode_thread_pool_) {
+    decode_thread_pool_.reset(
+        new DecodeThreadPool(Clock::GetRealTimeClock(), num_cpu_cores_));
+  }
+  return decode_thread_pool_.get();
+}
+
 void Call::DestroyVideoReceiveStream(
     webrtc::VideoReceiveStream* receive_stream) {
   TRACE_EVENT0("webrtc", "Call::DestroyVideoReceiveStream");
@@ -342,16 +517,9 @@ void Call::DestroyVideoReceiveStream(
     WriteLockScoped write_lock(*receive_crit_);
     // Remove all ssrcs pointing to a receive stream. As RTX retransmits on a
     // separate SSRC there can be either one or two.
-    auto it = video_receive_ssrcs_.begin();
-    while (it != video_receive_ssrcs_.end()) {
-      if (it->second == static_cast<VideoReceiveStream*>(receive_stream)) {
-        if (receive_stream_impl != nullptr)
-          DCHECK(receive_stream_impl == it->second);
-        receive_stream_impl = it->second;
-        video_receive_ssrcs_.erase(it++);
-      } else {
-        ++it;
-      }
+    if (video_receive_ssrcs_.EraseStream(
+            static_cast<VideoReceiveStream*>(receive_stream)) > 0) {
+      receive_stream_impl = static_cast<VideoReceiveStream*>(receive_stream);
     }
     video_receive_streams_.erase(receive_stream_impl);
     CHECK(receive_stream_impl != nullptr);
@@ -483,19 +651,66 @@ void Call::ConfigureSync(const std::string& sync_group) {
 PacketReceiver::DeliveryStatus Call::DeliverRtcp(MediaType media_type,
                                                  const uint8_t* packet,
                                                  size_t length) {
-  // TODO(pbos): Figure out what channel needs it actually.
-  //             Do NOT broadcast! Also make sure it's a valid packet.
-  //             Return DELIVERY_UNKNOWN_SSRC if it can be determined that
+  if (media_type != MediaType::ANY && media_type != MediaType::VIDEO)
+    return DELIVERY_PACKET_ERROR;
+
+  // Hand the packet only to the streams owning an SSRC it refers to, rather
+  // than having every stream parse it. Packets that can't be routed that way
+  // are broadcast, leaving it to the streams to reject them.
+  uint32_t ssrcs[kMaxRtcpSsrcs];
+  size_t num_ssrcs = 0;
+  if (GetRtcpSsrcs(packet, length, ssrcs, &num_ssrcs)) {
+    bool rtcp_routed = false;
+    bool rtcp_delivered = false;
+    {
+      ReadLockScoped read_lock(*receive_crit_);
+      VideoReceiveStream* delivered[kMaxRtcpSsrcs];
+      size_t num_delivered = 0;
+      for (size_t i = 0; i < num_ssrcs; ++i) {
+        VideoReceiveStream* stream = video_receive_ssrcs_.Find(ssrcs[i]);
+        if (stream == nullptr ||
+            std::find(delivered, delivered + num_delivered, stream) !=
+                delivered + num_delivered) {
+          continue;
+        }
+        delivered[num_delivered++] = stream;
+        rtcp_routed = true;
+        if (stream->DeliverRtcp(packet, length))
+          rtcp_delivered = true;
+      }
+    }
+    {
+      ReadLockScoped read_lock(*send_crit_);
+      VideoSendStream* delivered[kMaxRtcpSsrcs];
+      size_t num_delivered = 0;
+      for (size_t i = 0; i < num_ssrcs; ++i) {
+        VideoSendStream* stream = video_send_ssrcs_.Find(ssrcs[i]);
+        if (stream == nullptr ||
+            std::find(delivered, delivered + num_delivered, stream) !=
+                delivered + num_delivered) {
+          continue;
+        }
+        delivered[num_delivered++] = stream;
+        rtcp_routed = true;
+        if (stream->DeliverRtcp(packet, length))
+          rtcp_delivered = true;
+      }
+    }
+    if (rtcp_routed)
+      return rtcp_delivered ? DELIVERY_OK : DELIVERY_PACKET_ERROR;
+  }
+
+  // TODO(pbos): Return DELIVERY_UNKNOWN_SSRC if it can be determined that
   //             there's no receiver of the packet.
   bool rtcp_delivered = false;
-  if (media_type == MediaType::ANY || media_type == MediaType::VIDEO) {
+  {
     ReadLockScoped read_lock(*receive_crit_);
     for (VideoReceiveStream* stream : video_receive_streams_) {
       if (stream->DeliverRtcp(packet, length))
         rtcp_delivered = true;
     }
   }
-  if (media_type == MediaType::ANY || media_type == MediaType::VIDEO) {
+  {
     ReadLockScoped read_lock(*send_crit_);
     for (VideoSendStream* stream : video_send_streams_) {
       if (stream->DeliverRtcp(packet, length))
@@ -516,17 +731,17 @@ PacketReceiver::DeliveryStatus Call::DeliverRtp(MediaType media_type,
 
   ReadLockScoped read_lock(*receive_crit_);
   if (media_type == MediaType::ANY || media_type == MediaType::AUDIO) {
-    auto it = audio_receive_ssrcs_.find(ssrc);
-    if (it != audio_receive_ssrcs_.end()) {
-      return it->second->DeliverRtp(packet, length) ? DELIVERY_OK
-                                                    : DELIVERY_PACKET_ERROR;
+    AudioReceiveStream* stream = audio_receive_ssrcs_.Find(ssrc);
+    if (stream != nullptr) {
+      return stream->DeliverRtp(packet, length) ? DELIVERY_OK
+                                                : DELIVERY_PACKET_ERROR;
     }
   }
   if (media_type == MediaType::ANY || media_type == MediaType::VIDEO) {
-    auto it = video_receive_ssrcs_.find(ssrc);
-    if (it != video_receive_ssrcs_.end()) {
-      return it->second->DeliverRtp(packet, length) ? DELIVERY_OK
-                                                    : DELIVERY_PACKET_ERROR;
+    VideoReceiveStream* stream = video_receive_ssrcs_.Find(ssrc);
+    if (stream != nullptr) {
+      return stream->DeliverRtp(packet, length) ? DELIVERY_OK
+                                                : DELIVERY_PACKET_ERROR;
     }
   }
   return DELIVERY_UNKNOWN_SSRC;
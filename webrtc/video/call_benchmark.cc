@@ -0,0 +1,357 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Runs a number of one-way video calls in parallel in one process, each
+// between its own sender and receiver Call connected through FakeNetworkPipes,
+// and reports the CPU time used per stream, end-to-end latency percentiles
+// and heap allocations per rendered frame.
+
+#if defined(WEBRTC_WIN)
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#include <sys/time.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/checks.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/call.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/sleep.h"
+#include "webrtc/test/direct_transport.h"
+#include "webrtc/test/encoder_settings.h"
+#include "webrtc/test/fake_encoder.h"
+#include "webrtc/test/field_trial.h"
+#include "webrtc/test/frame_generator_capturer.h"
+#include "webrtc/test/run_test.h"
+#include "webrtc/test/testsupport/perf_test.h"
+#include "webrtc/typedefs.h"
+#include "webrtc/video_decoder.h"
+#include "webrtc/video_encoder.h"
+#include "webrtc/video_frame.h"
+#include "webrtc/video_renderer.h"
+
+namespace {
+// Counts every heap allocation made in the process, so that allocations made
+// by the media pipeline can be related to the number of frames it handled.
+volatile int g_num_allocations = 0;
+}  // namespace
+
+void* operator new(size_t size) {
+  rtc::AtomicOps::Increment(&g_num_allocations);
+  void* p = malloc(size ? size : 1);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void* p) throw() {
+  free(p);
+}
+
+namespace webrtc {
+namespace flags {
+
+DEFINE_int32(num_calls, 8, "Number of calls to run in parallel.");
+DEFINE_int32(width, 320, "Video width.");
+DEFINE_int32(height, 240, "Video height.");
+DEFINE_int32(fps, 30, "Frames per second.");
+DEFINE_string(codec, "FAKE", "Video codec to use, FAKE or VP8.");
+DEFINE_int32(warmup_ms,
+             3000,
+             "Time to run before measuring, to let bitrates ramp up and the "
+             "receivers get RTCP sender reports.");
+DEFINE_int32(duration_ms, 10000, "Time to measure for.");
+DEFINE_int32(loss_percent, 0, "Percentage of packets randomly lost.");
+DEFINE_int32(link_capacity,
+             0,
+             "Capacity (kbps) of the fake link. 0 means infinite.");
+DEFINE_int32(queue_size, 0, "Size of the bottleneck link queue in packets.");
+DEFINE_int32(avg_propagation_delay_ms,
+             0,
+             "Average link propagation delay in ms.");
+DEFINE_int32(std_propagation_delay_ms,
+             0,
+             "Link propagation delay standard deviation in ms.");
+DEFINE_string(
+    force_fieldtrials,
+    "",
+    "Field trials control experimental feature code which can be forced. "
+    "E.g. running with --force_fieldtrials=WebRTC-FooFeature/Enable/"
+    " will assign the group Enable to field trial WebRTC-FooFeature. Multiple "
+    "trials are separated by \"/\"");
+
+}  // namespace flags
+
+namespace {
+
+static const uint32_t kSendSsrc = 0x654321;
+static const uint32_t kReceiverLocalSsrc = 0x123456;
+static const uint8_t kVideoPayloadType = 124;
+static const int kAbsSendTimeExtensionId = 7;
+
+// CPU time, user and system, used by all threads of the process.
+int64_t ProcessCpuTimeUs() {
+#if defined(WEBRTC_WIN)
+  FILETIME creation_time, exit_time, kernel_time, user_time;
+  if (!GetProcessTimes(GetCurrentProcess(), &creation_time, &exit_time,
+                       &kernel_time, &user_time)) {
+    return 0;
+  }
+  ULARGE_INTEGER kernel, user;
+  kernel.LowPart = kernel_time.dwLowDateTime;
+  kernel.HighPart = kernel_time.dwHighDateTime;
+  user.LowPart = user_time.dwLowDateTime;
+  user.HighPart = user_time.dwHighDateTime;
+  // In units of 100 ns.
+  return static_cast<int64_t>((kernel.QuadPart + user.QuadPart) / 10);
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+  return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000LL +
+         usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+#endif
+}
+
+// Records the time from capture to render of each frame. The capture time is
+// the NTP time estimated by the receiver from RTCP sender reports, which is
+// comparable to the local clock since both ends run in this process.
+class LatencyRecorder : public VideoRenderer {
+ public:
+  explicit LatencyRecorder(Clock* clock)
+      : clock_(clock), crit_(CriticalSectionWrapper::CreateCriticalSection()) {}
+
+  void RenderFrame(const VideoFrame& video_frame,
+                   int time_to_render_ms) override {
+    if (video_frame.ntp_time_ms() <= 0) {
+      // Haven't got enough RTCP SR in order to calculate the capture ntp
+      // time.
+      return;
+    }
+    const int64_t latency_ms =
+        clock_->CurrentNtpInMilliseconds() - video_frame.ntp_time_ms();
+    CriticalSectionScoped cs(crit_.get());
+    latencies_ms_.push_back(latency_ms);
+  }
+
+  bool IsTextureSupported() const override { return false; }
+
+  // Moves the latencies recorded since the last call to |latencies_ms|.
+  void TakeLatencies(std::vector<int64_t>* latencies_ms) {
+    CriticalSectionScoped cs(crit_.get());
+    latencies_ms->insert(latencies_ms->end(), latencies_ms_.begin(),
+                         latencies_ms_.end());
+    latencies_ms_.clear();
+  }
+
+ private:
+  Clock* const clock_;
+  const rtc::scoped_ptr<CriticalSectionWrapper> crit_;
+  std::vector<int64_t> latencies_ms_;
+};
+
+// One video stream sent from a sender Call to a receiver Call, with RTCP
+// going back through a second network pipe.
+class BenchmarkCall {
+ public:
+  explicit BenchmarkCall(Clock* clock)
+      : sender_call_(Call::Create(Call::Config())),
+        receiver_call_(Call::Create(Call::Config())),
+        send_transport_(CreatePipeConfig()),
+        receive_transport_(CreatePipeConfig()),
+        renderer_(clock),
+        send_stream_(nullptr),
+        receive_stream_(nullptr) {
+    send_transport_.SetReceiver(receiver_call_->Receiver());
+    receive_transport_.SetReceiver(sender_call_->Receiver());
+
+    VideoSendStream::Config send_config(&send_transport_);
+    send_config.rtp.ssrcs.push_back(kSendSsrc);
+    send_config.rtp.extensions.push_back(
+        RtpExtension(RtpExtension::kAbsSendTime, kAbsSendTimeExtensionId));
+    if (flags::FLAGS_codec == "VP8") {
+      encoder_.reset(VideoEncoder::Create(VideoEncoder::kVp8));
+    } else {
+      CHECK_EQ(flags::FLAGS_codec, "FAKE") << "Codec not supported!";
+      encoder_.reset(new test::FakeEncoder(clock));
+    }
+    send_config.encoder_settings.encoder = encoder_.get();
+    send_config.encoder_settings.payload_name = flags::FLAGS_codec;
+    send_config.encoder_settings.payload_type = kVideoPayloadType;
+
+    VideoEncoderConfig encoder_config;
+    encoder_config.streams = test::CreateVideoStreams(1);
+    VideoStream* stream = &encoder_config.streams[0];
+    stream->width = flags::FLAGS_width;
+    stream->height = flags::FLAGS_height;
+    stream->max_framerate = flags::FLAGS_fps;
+    send_stream_ =
+        sender_call_->CreateVideoSendStream(send_config, encoder_config);
+
+    VideoReceiveStream::Config receive_config(&receive_transport_);
+    receive_config.rtp.remote_ssrc = kSendSsrc;
+    receive_config.rtp.local_ssrc = kReceiverLocalSsrc;
+    receive_config.rtp.remb = true;
+    receive_config.rtp.extensions = send_config.rtp.extensions;
+    receive_config.renderer = &renderer_;
+    VideoReceiveStream::Decoder decoder =
+        test::CreateMatchingDecoder(send_config.encoder_settings);
+    decoder_.reset(decoder.decoder);
+    receive_config.decoders.push_back(decoder);
+    receive_stream_ = receiver_call_->CreateVideoReceiveStream(receive_config);
+
+    capturer_.reset(test::FrameGeneratorCapturer::Create(
+        send_stream_->Input(), flags::FLAGS_width, flags::FLAGS_height,
+        flags::FLAGS_fps, clock));
+  }
+
+  ~BenchmarkCall() {
+    capturer_.reset();
+    send_transport_.StopSending();
+    receive_transport_.StopSending();
+    sender_call_->DestroyVideoSendStream(send_stream_);
+    receiver_call_->DestroyVideoReceiveStream(receive_stream_);
+  }
+
+  void Start() {
+    receive_stream_->Start();
+    send_stream_->Start();
+    capturer_->Start();
+  }
+
+  void Stop() {
+    capturer_->Stop();
+    send_stream_->Stop();
+    receive_stream_->Stop();
+  }
+
+  LatencyRecorder* renderer() { return &renderer_; }
+
+ private:
+  static FakeNetworkPipe::Config CreatePipeConfig() {
+    FakeNetworkPipe::Config config;
+    config.loss_percent = flags::FLAGS_loss_percent;
+    config.link_capacity_kbps = flags::FLAGS_link_capacity;
+    config.queue_length_packets = flags::FLAGS_queue_size;
+    config.queue_delay_ms = flags::FLAGS_avg_propagation_delay_ms;
+    config.delay_standard_deviation_ms = flags::FLAGS_std_propagation_delay_ms;
+    return config;
+  }
+
+  const rtc::scoped_ptr<Call> sender_call_;
+  const rtc::scoped_ptr<Call> receiver_call_;
+  test::DirectTransport send_transport_;
+  test::DirectTransport receive_transport_;
+  LatencyRecorder renderer_;
+  rtc::scoped_ptr<VideoEncoder> encoder_;
+  rtc::scoped_ptr<VideoDecoder> decoder_;
+  VideoSendStream* send_stream_;
+  VideoReceiveStream* receive_stream_;
+  rtc::scoped_ptr<test::FrameGeneratorCapturer> capturer_;
+};
+
+// |sorted| must not be empty.
+int64_t Percentile(const std::vector<int64_t>& sorted, int percentile) {
+  size_t index = sorted.size() * percentile / 100;
+  return sorted[std::min(index, sorted.size() - 1)];
+}
+
+std::string ToString(double value) {
+  std::ostringstream ss;
+  ss << value;
+  return ss.str();
+}
+
+void RunBenchmark() {
+  Clock* clock = Clock::GetRealTimeClock();
+  const int num_calls = flags::FLAGS_num_calls;
+  std::vector<BenchmarkCall*> calls;
+  for (int i = 0; i < num_calls; ++i)
+    calls.push_back(new BenchmarkCall(clock));
+  for (BenchmarkCall* call : calls)
+    call->Start();
+
+  SleepMs(flags::FLAGS_warmup_ms);
+  std::vector<int64_t> latencies_ms;
+  for (BenchmarkCall* call : calls)
+    call->renderer()->TakeLatencies(&latencies_ms);
+  latencies_ms.clear();
+
+  const int64_t start_time_us = clock->TimeInMicroseconds();
+  const int64_t start_cpu_time_us = ProcessCpuTimeUs();
+  const int start_num_allocations =
+      rtc::AtomicOps::AcquireLoad(&g_num_allocations);
+  SleepMs(flags::FLAGS_duration_ms);
+  const int num_allocations =
+      rtc::AtomicOps::AcquireLoad(&g_num_allocations) - start_num_allocations;
+  const int64_t cpu_time_us = ProcessCpuTimeUs() - start_cpu_time_us;
+  const int64_t elapsed_us = clock->TimeInMicroseconds() - start_time_us;
+
+  for (BenchmarkCall* call : calls)
+    call->renderer()->TakeLatencies(&latencies_ms);
+  for (BenchmarkCall* call : calls)
+    call->Stop();
+  for (BenchmarkCall* call : calls)
+    delete call;
+
+  const std::string trace = ToString(num_calls) + "_calls_" +
+                            flags::FLAGS_codec;
+  test::PrintResult("cpu_per_stream", "", trace,
+                    ToString(100.0 * cpu_time_us / elapsed_us / num_calls),
+                    "%", true);
+  test::PrintResult("rendered_fps_per_stream", "", trace,
+                    ToString(1e6 * latencies_ms.size() / elapsed_us /
+                             num_calls),
+                    "fps", false);
+  if (latencies_ms.empty()) {
+    printf("No frames were rendered with a capture time.\n");
+    return;
+  }
+  std::sort(latencies_ms.begin(), latencies_ms.end());
+  test::PrintResult("end_to_end_latency", "_p50", trace,
+                    static_cast<size_t>(Percentile(latencies_ms, 50)), "ms",
+                    true);
+  test::PrintResult("end_to_end_latency", "_p90", trace,
+                    static_cast<size_t>(Percentile(latencies_ms, 90)), "ms",
+                    false);
+  test::PrintResult("end_to_end_latency", "_p99", trace,
+                    static_cast<size_t>(Percentile(latencies_ms, 99)), "ms",
+                    true);
+  test::PrintResult("end_to_end_latency", "_max", trace,
+                    static_cast<size_t>(latencies_ms.back()), "ms", false);
+  test::PrintResult("allocations_per_frame", "", trace,
+                    ToString(static_cast<double>(num_allocations) /
+                             latencies_ms.size()),
+                    "allocations", true);
+}
+
+}  // namespace
+}  // namespace webrtc
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  webrtc::test::InitFieldTrialsFromString(
+      webrtc::flags::FLAGS_force_fieldtrials);
+  webrtc::test::RunTest(webrtc::RunBenchmark);
+  return 0;
+}
@@ -19,6 +19,7 @@
 #include "webrtc/call.h"
 #include "webrtc/modules/audio_coding/main/interface/audio_coding_module.h"
 #include "webrtc/modules/rtp_rtcp/interface/rtp_header_parser.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
 #include "webrtc/modules/rtp_rtcp/source/rtcp_utility.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/rtp_to_ntp.h"
@@ -30,6 +31,7 @@
 #include "webrtc/test/fake_encoder.h"
 #include "webrtc/test/frame_generator.h"
 #include "webrtc/test/frame_generator_capturer.h"
+#include "webrtc/test/null_transport.h"
 #include "webrtc/test/rtp_rtcp_observer.h"
 #include "webrtc/test/testsupport/fileutils.h"
 #include "webrtc/test/testsupport/perf_test.h"
@@ -710,4 +712,79 @@ TEST_F(CallPerfTest, KeepsHighBitrateWhenReconfiguringSender) {
   RunBaseTest(&test);
 }
 
+// Measures the per-packet cost of Call::DeliverPacket with 500 started video
+// receive streams, both for RTP, where an SSRC no stream owns isolates the
+// demuxing from the stream's own processing, and for an RTCP sender report
+// that only concerns one of the streams.
+TEST_F(CallPerfTest, DeliverPacketWith500ReceiveStreams) {
+  static const size_t kNumStreams = 500;
+  static const int kNumPackets = 10000;
+  static const uint32_t kFirstRemoteSsrc = 0x10000;
+
+  CreateReceiverCall(Call::Config());
+  test::NullTransport null_transport;
+  VideoReceiveStream::Config config(&null_transport);
+  config.rtp.local_ssrc = kReceiverLocalSsrc;
+  for (size_t i = 0; i < kNumStreams; ++i) {
+    VideoReceiveStream::Decoder decoder;
+    decoder.decoder = new test::FakeDecoder();
+    decoder.payload_type = kFakeSendPayloadType;
+    decoder.payload_name = "FAKE";
+    allocated_decoders_.push_back(decoder.decoder);
+    config.decoders.clear();
+    config.decoders.push_back(decoder);
+    config.rtp.remote_ssrc = kFirstRemoteSsrc + static_cast<uint32_t>(i);
+    receive_streams_.push_back(
+        receiver_call_->CreateVideoReceiveStream(config));
+    receive_streams_.back()->Start();
+  }
+  PacketReceiver* receiver = receiver_call_->Receiver();
+
+  uint8_t rtp_packet[12] = {0x80, kFakeSendPayloadType};
+  ByteWriter<uint32_t>::WriteBigEndian(&rtp_packet[8],
+                                       kFirstRemoteSsrc + kNumStreams);
+  int num_unknown_ssrc = 0;
+  int64_t start_us = clock_->TimeInMicroseconds();
+  for (int i = 0; i < kNumPackets; ++i) {
+    if (receiver->DeliverPacket(MediaType::VIDEO, rtp_packet,
+                                sizeof(rtp_packet)) ==
+        PacketReceiver::DELIVERY_UNKNOWN_SSRC) {
+      ++num_unknown_ssrc;
+    }
+  }
+  int64_t rtp_elapsed_us = clock_->TimeInMicroseconds() - start_us;
+  EXPECT_EQ(kNumPackets, num_unknown_ssrc);
+
+  // Sender report without report blocks: header, SSRC and 20 bytes of sender
+  // info.
+  uint8_t rtcp_packet[28] = {0x80, 200, 0, 6};
+  ByteWriter<uint32_t>::WriteBigEndian(&rtcp_packet[4],
+                                       kFirstRemoteSsrc + kNumStreams / 2);
+  int num_delivered = 0;
+  start_us = clock_->TimeInMicroseconds();
+  for (int i = 0; i < kNumPackets; ++i) {
+    if (receiver->DeliverPacket(MediaType::VIDEO, rtcp_packet,
+                                sizeof(rtcp_packet)) ==
+        PacketReceiver::DELIVERY_OK) {
+      ++num_delivered;
+    }
+  }
+  int64_t rtcp_elapsed_us = clock_->TimeInMicroseconds() - start_us;
+  EXPECT_EQ(kNumPackets, num_delivered);
+
+  webrtc::test::PrintResult(
+      "deliver_packet_500_streams", "", "rtp_unknown_ssrc",
+      static_cast<double>(rtp_elapsed_us) * 1000 / kNumPackets, "ns", false);
+  webrtc::test::PrintResult(
+      "deliver_packet_500_streams", "", "rtcp_sender_report",
+      static_cast<double>(rtcp_elapsed_us) * 1000 / kNumPackets, "ns", false);
+
+  for (VideoReceiveStream* stream : receive_streams_) {
+    stream->Stop();
+    receiver_call_->DestroyVideoReceiveStream(stream);
+  }
+  receive_streams_.clear();
+  allocated_decoders_.clear();
+}
+
 }  // namespace webrtc
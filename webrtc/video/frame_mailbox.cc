@@ -0,0 +1,84 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/video/frame_mailbox.h"
+
+#include "webrtc/base/atomicops.h"
+
+namespace webrtc {
+namespace internal {
+namespace {
+const int kIndexMask = 3;
+const int kNewFrame = 4;
+}  // namespace
+
+FrameMailbox::FrameMailbox(DropPolicy drop_policy)
+    : drop_policy_(drop_policy),
+      shared_index_(1),
+      put_index_(0),
+      take_index_(2),
+      num_dropped_frames_(0) {
+}
+
+void FrameMailbox::Put(const VideoFrame& frame, int64_t time_ms) {
+  Slot& slot = slots_[put_index_];
+  slot.frame.ShallowCopy(frame);
+  slot.time_ms = time_ms;
+
+  int shared_index = rtc::AtomicOps::AcquireLoad(&shared_index_);
+  while (true) {
+    if ((shared_index & kNewFrame) &&
+        drop_policy_ == DropPolicy::kDropNewest) {
+      slot.frame.Reset();
+      rtc::AtomicOps::Increment(&num_dropped_frames_);
+      return;
+    }
+    const int previous = rtc::AtomicOps::CompareAndSwap(
+        &shared_index_, shared_index, put_index_ | kNewFrame);
+    if (previous == shared_index)
+      break;
+    // Take() swapped in its slot in between.
+    shared_index = previous;
+  }
+  put_index_ = shared_index & kIndexMask;
+  if (shared_index & kNewFrame) {
+    // The frame we swapped out was never taken.
+    slots_[put_index_].frame.Reset();
+    rtc::AtomicOps::Increment(&num_dropped_frames_);
+  }
+}
+
+bool FrameMailbox::Take(VideoFrame* frame, int64_t* time_ms) {
+  int shared_index = rtc::AtomicOps::AcquireLoad(&shared_index_);
+  while (shared_index & kNewFrame) {
+    const int previous = rtc::AtomicOps::CompareAndSwap(
+        &shared_index_, shared_index, take_index_);
+    if (previous == shared_index) {
+      take_index_ = shared_index & kIndexMask;
+      Slot& slot = slots_[take_index_];
+      frame->ShallowCopy(slot.frame);
+      *time_ms = slot.time_ms;
+      // Hands the slot back empty, so that the mailbox doesn't hold on to the
+      // buffer after the encoder is done with it.
+      slot.frame.Reset();
+      return true;
+    }
+    // Put() swapped in a newer frame in between.
+    shared_index = previous;
+  }
+  return false;
+}
+
+int FrameMailbox::NumDroppedFrames() const {
+  return rtc::AtomicOps::AcquireLoad(&num_dropped_frames_);
+}
+
+}  // namespace internal
+}  // namespace webrtc
@@ -0,0 +1,74 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#ifndef WEBRTC_VIDEO_FRAME_MAILBOX_H_
+#define WEBRTC_VIDEO_FRAME_MAILBOX_H_
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/video_frame.h"
+
+namespace webrtc {
+namespace internal {
+
+// Hands captured frames over to the encoder thread without locking. The
+// mailbox holds at most one frame; a frame put while another one is waiting
+// makes one of them be dropped, as chosen by the drop policy. Frames are
+// reference counted, so handing one over never copies its buffer.
+//
+// It is a triple buffer: Put() and Take() each own a slot, and swap it with
+// the third, shared, slot using a compare-and-swap on its index. Put() must
+// only be called from one thread at a time, and so must Take().
+class FrameMailbox {
+ public:
+  // What happens to a frame put while the previous one is still waiting.
+  enum class DropPolicy {
+    // The waiting frame is dropped, so that the encoder always gets the newest
+    // frame. This gives the lowest capture-to-encode delay.
+    kDropOldest,
+    // The new frame is dropped, so that a frame once put is always taken,
+    // however long it takes until Take() is called.
+    kDropNewest,
+  };
+
+  explicit FrameMailbox(DropPolicy drop_policy);
+
+  // Puts |frame| in the mailbox, along with the local |time_ms| it was put.
+  void Put(const VideoFrame& frame, int64_t time_ms);
+
+  // Takes the waiting frame, if any, into |frame|, and the time it was put
+  // into |time_ms|. Returns false if no frame was waiting.
+  bool Take(VideoFrame* frame, int64_t* time_ms);
+
+  // Number of frames dropped so far. Can be called from any thread.
+  int NumDroppedFrames() const;
+
+ private:
+  struct Slot {
+    Slot() : time_ms(-1) {}
+    VideoFrame frame;
+    int64_t time_ms;
+  };
+
+  const DropPolicy drop_policy_;
+  Slot slots_[3];
+  // Index of the shared slot, or'ed with kNewFrame if it holds a frame that
+  // hasn't been taken.
+  volatile int shared_index_;
+  // Slots owned by Put() and Take().
+  int put_index_;
+  int take_index_;
+  volatile int num_dropped_frames_;
+
+  DISALLOW_COPY_AND_ASSIGN(FrameMailbox);
+};
+
+}  // namespace internal
+}  // namespace webrtc
+
+#endif  // WEBRTC_VIDEO_FRAME_MAILBOX_H_
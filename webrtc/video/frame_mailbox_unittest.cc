@@ -0,0 +1,172 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/video/frame_mailbox.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+
+namespace webrtc {
+namespace internal {
+namespace {
+
+VideoFrame CreateFrame(int64_t render_time_ms) {
+  VideoFrame frame;
+  frame.CreateEmptyFrame(16, 16, 16, 8, 8);
+  frame.set_render_time_ms(render_time_ms);
+  return frame;
+}
+
+// Sets |destroyed| when the buffer is deleted.
+class TestBuffer : public I420Buffer {
+ public:
+  explicit TestBuffer(bool* destroyed)
+      : I420Buffer(16, 16), destroyed_(destroyed) {}
+
+ private:
+  friend class rtc::RefCountedObject<TestBuffer>;
+  ~TestBuffer() override { *destroyed_ = true; }
+  bool* const destroyed_;
+};
+
+VideoFrame CreateTestBufferFrame(bool* destroyed) {
+  return VideoFrame(new rtc::RefCountedObject<TestBuffer>(destroyed), 0, 0,
+                    kVideoRotation_0);
+}
+
+class FramePutter {
+ public:
+  FramePutter(FrameMailbox* mailbox, int num_frames)
+      : mailbox_(mailbox), num_frames_(num_frames) {}
+
+  static bool Run(void* obj) { return static_cast<FramePutter*>(obj)->Put(); }
+
+  bool Put() {
+    for (int i = 1; i <= num_frames_; ++i)
+      mailbox_->Put(CreateFrame(i), i);
+    return false;
+  }
+
+  FrameMailbox* const mailbox_;
+  const int num_frames_;
+};
+}  // namespace
+
+TEST(FrameMailboxTest, IsEmptyAtFirst) {
+  FrameMailbox mailbox(FrameMailbox::DropPolicy::kDropOldest);
+  VideoFrame frame;
+  int64_t time_ms = -1;
+  EXPECT_FALSE(mailbox.Take(&frame, &time_ms));
+  EXPECT_EQ(0, mailbox.NumDroppedFrames());
+}
+
+TEST(FrameMailboxTest, HandsOverBufferWithoutCopying) {
+  FrameMailbox mailbox(FrameMailbox::DropPolicy::kDropOldest);
+  VideoFrame input = CreateFrame(1);
+  mailbox.Put(input, 10);
+
+  VideoFrame output;
+  int64_t time_ms = -1;
+  ASSERT_TRUE(mailbox.Take(&output, &time_ms));
+  EXPECT_EQ(10, time_ms);
+  EXPECT_EQ(1, output.render_time_ms());
+  EXPECT_EQ(input.video_frame_buffer().get(),
+            output.video_frame_buffer().get());
+  EXPECT_FALSE(mailbox.Take(&output, &time_ms));
+}
+
+TEST(FrameMailboxTest, DropOldestKeepsNewestFrame) {
+  FrameMailbox mailbox(FrameMailbox::DropPolicy::kDropOldest);
+  mailbox.Put(CreateFrame(1), 10);
+  mailbox.Put(CreateFrame(2), 20);
+  mailbox.Put(CreateFrame(3), 30);
+
+  VideoFrame frame;
+  int64_t time_ms = -1;
+  ASSERT_TRUE(mailbox.Take(&frame, &time_ms));
+  EXPECT_EQ(3, frame.render_time_ms());
+  EXPECT_EQ(30, time_ms);
+  EXPECT_FALSE(mailbox.Take(&frame, &time_ms));
+  EXPECT_EQ(2, mailbox.NumDroppedFrames());
+}
+
+TEST(FrameMailboxTest, DropNewestKeepsWaitingFrame) {
+  FrameMailbox mailbox(FrameMailbox::DropPolicy::kDropNewest);
+  mailbox.Put(CreateFrame(1), 10);
+  mailbox.Put(CreateFrame(2), 20);
+  mailbox.Put(CreateFrame(3), 30);
+
+  VideoFrame frame;
+  int64_t time_ms = -1;
+  ASSERT_TRUE(mailbox.Take(&frame, &time_ms));
+  EXPECT_EQ(1, frame.render_time_ms());
+  EXPECT_EQ(10, time_ms);
+  EXPECT_EQ(2, mailbox.NumDroppedFrames());
+
+  // Once taken, the next frame is accepted.
+  mailbox.Put(CreateFrame(4), 40);
+  ASSERT_TRUE(mailbox.Take(&frame, &time_ms));
+  EXPECT_EQ(4, frame.render_time_ms());
+  EXPECT_EQ(2, mailbox.NumDroppedFrames());
+}
+
+TEST(FrameMailboxTest, DoesNotRetainTakenOrDroppedFrames) {
+  FrameMailbox mailbox(FrameMailbox::DropPolicy::kDropOldest);
+  bool dropped_destroyed = false;
+  bool taken_destroyed = false;
+  mailbox.Put(CreateTestBufferFrame(&dropped_destroyed), 10);
+  mailbox.Put(CreateTestBufferFrame(&taken_destroyed), 20);
+  EXPECT_TRUE(dropped_destroyed);
+  EXPECT_FALSE(taken_destroyed);
+
+  VideoFrame frame;
+  int64_t time_ms = -1;
+  ASSERT_TRUE(mailbox.Take(&frame, &time_ms));
+  EXPECT_FALSE(taken_destroyed);
+  frame.Reset();
+  EXPECT_TRUE(taken_destroyed);
+}
+
+// Takes frames while another thread puts them, and checks that frames are
+// taken in order and that every frame is either taken or dropped.
+TEST(FrameMailboxTest, HandsOverFramesBetweenThreads) {
+  const int kNumFrames = 100000;
+  for (FrameMailbox::DropPolicy drop_policy :
+       {FrameMailbox::DropPolicy::kDropOldest,
+        FrameMailbox::DropPolicy::kDropNewest}) {
+    FrameMailbox mailbox(drop_policy);
+    FramePutter putter(&mailbox, kNumFrames);
+    rtc::scoped_ptr<ThreadWrapper> thread(
+        ThreadWrapper::CreateThread(&FramePutter::Run, &putter, "FramePutter"));
+    ASSERT_TRUE(thread->Start());
+
+    int num_taken = 0;
+    int64_t last_time_ms = 0;
+    VideoFrame frame;
+    int64_t time_ms = -1;
+    while (last_time_ms < kNumFrames &&
+           num_taken + mailbox.NumDroppedFrames() < kNumFrames) {
+      if (mailbox.Take(&frame, &time_ms)) {
+        EXPECT_GT(time_ms, last_time_ms);
+        EXPECT_EQ(time_ms, frame.render_time_ms());
+        last_time_ms = time_ms;
+        ++num_taken;
+      }
+    }
+    ASSERT_TRUE(thread->Stop());
+    if (mailbox.Take(&frame, &time_ms))
+      ++num_taken;
+    EXPECT_EQ(kNumFrames, num_taken + mailbox.NumDroppedFrames());
+  }
+}
+
+}  // namespace internal
+}  // namespace webrtc
@@ -10,6 +10,7 @@
 
 #include <stdio.h>
 
+#include <algorithm>
 #include <map>
 #include <sstream>
 
@@ -132,6 +133,22 @@ static std::string DecoderBitstreamFilename() {
 DEFINE_string(codec, "VP8", "Video codec");
 static std::string Codec() { return static_cast<std::string>(FLAGS_codec); }
 
+// Flag for replay speed.
+DEFINE_bool(as_fast_as_possible,
+            false,
+            "Deliver packets as fast as they can be handled, instead of at "
+            "the pace they were recorded at");
+static bool AsFastAsPossible() { return FLAGS_as_fast_as_possible; }
+
+// Flag for start position.
+DEFINE_int32(start_time_ms,
+             0,
+             "Time in the input file, relative to its first packet, to start "
+             "replaying from");
+static uint32_t StartTimeMs() {
+  return static_cast<uint32_t>(FLAGS_start_time_ms);
+}
+
 }  // namespace flags
 
 static const uint32_t kReceiverLocalSsrc = 0x123456;
@@ -274,8 +291,22 @@ void RtpReplay() {
       }
     }
   }
+  if (flags::StartTimeMs() != 0) {
+    // The index of the file is searched; nothing is read up to the position.
+    test::RtpPacket first_packet;
+    if (!rtp_reader->NextPacket(&first_packet) ||
+        !rtp_reader->SeekToTime(first_packet.time_ms + flags::StartTimeMs())) {
+      fprintf(stderr, "Input file ends before start time %u ms.\n",
+              flags::StartTimeMs());
+      call->DestroyVideoReceiveStream(receive_stream);
+      delete decoder.decoder;
+      return;
+    }
+  }
   receive_stream->Start();
 
+  const int64_t start_ms = Clock::GetRealTimeClock()->TimeInMilliseconds();
+  uint32_t first_time_ms = 0;
   uint32_t last_time_ms = 0;
   int num_packets = 0;
   std::map<uint32_t, int> unknown_packets;
@@ -283,6 +314,8 @@ void RtpReplay() {
     test::RtpPacket packet;
     if (!rtp_reader->NextPacket(&packet))
       break;
+    if (num_packets == 0)
+      first_time_ms = packet.time_ms;
     ++num_packets;
     switch (call->Receiver()->DeliverPacket(webrtc::MediaType::ANY, packet.data,
                                             packet.length)) {
@@ -301,12 +334,19 @@ void RtpReplay() {
         fprintf(stderr, "Packet error, corrupt packets or incorrect setup?\n");
         break;
     }
-    if (last_time_ms != 0 && last_time_ms != packet.time_ms) {
+    if (!flags::AsFastAsPossible() && last_time_ms != 0 &&
+        last_time_ms != packet.time_ms) {
       SleepMs(packet.time_ms - last_time_ms);
     }
     last_time_ms = packet.time_ms;
   }
+  const int64_t elapsed_ms = std::max<int64_t>(
+      Clock::GetRealTimeClock()->TimeInMilliseconds() - start_ms, 1);
   fprintf(stderr, "num_packets: %d\n", num_packets);
+  fprintf(stderr,
+          "Replayed %u ms of packets in %d ms (%d packets/s).\n",
+          last_time_ms - first_time_ms, static_cast<int>(elapsed_ms),
+          static_cast<int>(num_packets * 1000 / elapsed_ms));
 
   for (std::map<uint32_t, int>::const_iterator it = unknown_packets.begin();
        it != unknown_packets.end();
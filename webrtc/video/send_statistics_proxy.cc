@@ -23,13 +23,19 @@ namespace webrtc {
 
 const int SendStatisticsProxy::kStatsTimeoutMs = 5000;
 
+namespace {
+// About ten seconds worth of frames at 30 fps.
+const size_t kMaxCaptureToEncodeSamples = 300;
+}  // namespace
+
 SendStatisticsProxy::SendStatisticsProxy(Clock* clock,
                                          const VideoSendStream::Config& config)
     : clock_(clock),
       config_(config),
       last_sent_frame_timestamp_(0),
       max_sent_width_per_timestamp_(0),
-      max_sent_height_per_timestamp_(0) {
+      max_sent_height_per_timestamp_(0),
+      recent_capture_to_encode_ms_(kMaxCaptureToEncodeSamples) {
 }
 
 SendStatisticsProxy::~SendStatisticsProxy() {
@@ -62,6 +68,12 @@ void SendStatisticsProxy::UpdateHistograms() {
   int encode_ms = encode_time_counter_.Avg(kMinRequiredSamples);
   if (encode_ms != -1)
     RTC_HISTOGRAM_COUNTS_1000("WebRTC.Video.EncodeTimeInMs", encode_ms);
+  int capture_to_encode_ms =
+      capture_to_encode_counter_.Avg(kMinRequiredSamples);
+  if (capture_to_encode_ms != -1) {
+    RTC_HISTOGRAM_COUNTS_1000("WebRTC.Video.CaptureToEncodeDelayInMs",
+                              capture_to_encode_ms);
+  }
 }
 
 void SendStatisticsProxy::OutgoingRate(const int video_channel,
@@ -90,6 +102,12 @@ VideoSendStream::Stats SendStatisticsProxy::GetStats() {
   PurgeOldStats();
   stats_.input_frame_rate =
       static_cast<int>(input_frame_rate_tracker_.units_second());
+  stats_.capture_to_encode_p50_ms =
+      recent_capture_to_encode_ms_.Percentile(50);
+  stats_.capture_to_encode_p95_ms =
+      recent_capture_to_encode_ms_.Percentile(95);
+  stats_.capture_to_encode_p99_ms =
+      recent_capture_to_encode_ms_.Percentile(99);
   return stats_;
 }
 
@@ -195,6 +213,12 @@ void SendStatisticsProxy::OnEncodedFrame(int encode_time_ms) {
   encode_time_counter_.Add(encode_time_ms);
 }
 
+void SendStatisticsProxy::OnFrameDeliveredToEncoder(int capture_to_encode_ms) {
+  rtc::CritScope lock(&crit_);
+  capture_to_encode_counter_.Add(capture_to_encode_ms);
+  recent_capture_to_encode_ms_.Add(capture_to_encode_ms);
+}
+
 void SendStatisticsProxy::RtcpPacketTypesCounterUpdated(
     uint32_t ssrc,
     const RtcpPacketTypeCounter& packet_counter) {
@@ -274,4 +298,23 @@ int SendStatisticsProxy::SampleCounter::Avg(int min_required_samples) const {
   return sum / num_samples;
 }
 
+void SendStatisticsProxy::PercentileCounter::Add(int sample) {
+  if (samples.size() < max_samples) {
+    samples.push_back(sample);
+  } else {
+    samples[next_index] = sample;
+  }
+  next_index = (next_index + 1) % max_samples;
+}
+
+int SendStatisticsProxy::PercentileCounter::Percentile(int percent) const {
+  if (samples.empty())
+    return -1;
+  std::vector<int> sorted(samples);
+  std::vector<int>::iterator nth =
+      sorted.begin() + (sorted.size() - 1) * percent / 100;
+  std::nth_element(sorted.begin(), nth, sorted.end());
+  return *nth;
+}
+
 }  // namespace webrtc
@@ -12,6 +12,7 @@
 #define WEBRTC_VIDEO_SEND_STATISTICS_PROXY_H_
 
 #include <string>
+#include <vector>
 
 #include "webrtc/base/criticalsection.h"
 #include "webrtc/base/ratetracker.h"
@@ -52,6 +53,10 @@ class SendStatisticsProxy : public CpuOveruseMetricsObserver,
   // Used to update encode time of frames.
   void OnEncodedFrame(int encode_time_ms);
 
+  // Used to update the time from a frame being captured until it is handed to
+  // the encoder.
+  void OnFrameDeliveredToEncoder(int capture_to_encode_ms);
+
   // From VideoEncoderRateObserver.
   void OnSetRates(uint32_t bitrate_bps, int framerate) override;
 
@@ -102,6 +107,19 @@ class SendStatisticsProxy : public CpuOveruseMetricsObserver,
     int sum;
     int num_samples;
   };
+  // Keeps the most recent samples to compute percentiles over.
+  struct PercentileCounter {
+    explicit PercentileCounter(size_t max_samples)
+        : max_samples(max_samples), next_index(0) {}
+    void Add(int sample);
+    // Returns the |percent|th percentile, or -1 if there are no samples.
+    int Percentile(int percent) const;
+
+   private:
+    const size_t max_samples;
+    size_t next_index;
+    std::vector<int> samples;
+  };
   struct StatsUpdateTimes {
     StatsUpdateTimes() : resolution_update_ms(0) {}
     int64_t resolution_update_ms;
@@ -129,6 +147,8 @@ class SendStatisticsProxy : public CpuOveruseMetricsObserver,
   SampleCounter sent_width_counter_ GUARDED_BY(crit_);
   SampleCounter sent_height_counter_ GUARDED_BY(crit_);
   SampleCounter encode_time_counter_ GUARDED_BY(crit_);
+  SampleCounter capture_to_encode_counter_ GUARDED_BY(crit_);
+  PercentileCounter recent_capture_to_encode_ms_ GUARDED_BY(crit_);
 };
 
 }  // namespace webrtc
@@ -140,6 +140,26 @@ TEST_F(SendStatisticsProxyTest, EncodedBitrateAndFramerate) {
   EXPECT_EQ(encode_fps, stats.encode_frame_rate);
 }
 
+TEST_F(SendStatisticsProxyTest, CaptureToEncodeDelayPercentiles) {
+  VideoSendStream::Stats stats = statistics_proxy_->GetStats();
+  EXPECT_EQ(-1, stats.capture_to_encode_p50_ms);
+  EXPECT_EQ(-1, stats.capture_to_encode_p99_ms);
+
+  for (int delay_ms = 100; delay_ms > 0; --delay_ms)
+    statistics_proxy_->OnFrameDeliveredToEncoder(delay_ms);
+  stats = statistics_proxy_->GetStats();
+  EXPECT_EQ(50, stats.capture_to_encode_p50_ms);
+  EXPECT_EQ(95, stats.capture_to_encode_p95_ms);
+  EXPECT_EQ(99, stats.capture_to_encode_p99_ms);
+
+  // Only the most recent frames are taken into account.
+  for (int i = 0; i < 1000; ++i)
+    statistics_proxy_->OnFrameDeliveredToEncoder(5);
+  stats = statistics_proxy_->GetStats();
+  EXPECT_EQ(5, stats.capture_to_encode_p50_ms);
+  EXPECT_EQ(5, stats.capture_to_encode_p99_ms);
+}
+
 TEST_F(SendStatisticsProxyTest, Suspended) {
   // Verify that the value is false by default.
   EXPECT_FALSE(statistics_proxy_->GetStats().suspended);
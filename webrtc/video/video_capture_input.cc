@@ -33,19 +33,19 @@ VideoCaptureInput::VideoCaptureInput(ProcessThread* module_process_thread,
                                      VideoCaptureCallback* frame_callback,
                                      VideoRenderer* local_renderer,
                                      SendStatisticsProxy* stats_proxy,
-                                     CpuOveruseObserver* overuse_observer)
+                                     CpuOveruseObserver* overuse_observer,
+                                     FrameMailbox::DropPolicy drop_policy)
     : capture_cs_(CriticalSectionWrapper::CreateCriticalSection()),
       module_process_thread_(module_process_thread),
       frame_callback_(frame_callback),
       local_renderer_(local_renderer),
       stats_proxy_(stats_proxy),
-      incoming_frame_cs_(CriticalSectionWrapper::CreateCriticalSection()),
       capture_thread_(ThreadWrapper::CreateThread(CaptureThreadFunction,
                                                   this,
                                                   "CaptureThread")),
       capture_event_(*EventWrapper::Create()),
-      deliver_event_(*EventWrapper::Create()),
       stop_(0),
+      mailbox_(drop_policy),
       last_captured_timestamp_(0),
       delta_ntp_internal_ms_(
           Clock::GetRealTimeClock()->CurrentNtpInMilliseconds() -
@@ -69,7 +69,6 @@ VideoCaptureInput::~VideoCaptureInput() {
   // Stop the camera input.
   capture_thread_->Stop();
   delete &capture_event_;
-  delete &deliver_event_;
 }
 
 void VideoCaptureInput::IncomingCapturedFrame(const VideoFrame& video_frame) {
@@ -107,12 +106,13 @@ void VideoCaptureInput::IncomingCapturedFrame(const VideoFrame& video_frame) {
     return;
   }
 
-  captured_frame_.ShallowCopy(incoming_frame);
+  mailbox_.Put(incoming_frame,
+               Clock::GetRealTimeClock()->TimeInMilliseconds());
   last_captured_timestamp_ = incoming_frame.ntp_time_ms();
 
-  overuse_detector_->FrameCaptured(captured_frame_.width(),
-                                   captured_frame_.height(),
-                                   captured_frame_.render_time_ms());
+  overuse_detector_->FrameCaptured(incoming_frame.width(),
+                                   incoming_frame.height(),
+                                   incoming_frame.render_time_ms());
 
   TRACE_EVENT_ASYNC_BEGIN1("webrtc", "Video", video_frame.render_time_ms(),
                            "render_time", video_frame.render_time_ms());
@@ -132,17 +132,14 @@ bool VideoCaptureInput::CaptureProcess() {
       return false;
 
     int64_t encode_start_time = -1;
+    int64_t captured_frame_time_ms = -1;
     VideoFrame deliver_frame;
-    {
-      CriticalSectionScoped cs(capture_cs_.get());
-      if (!captured_frame_.IsZeroSize()) {
-        deliver_frame = captured_frame_;
-        captured_frame_.Reset();
-      }
-    }
-    if (!deliver_frame.IsZeroSize()) {
+    if (mailbox_.Take(&deliver_frame, &captured_frame_time_ms) &&
+        !deliver_frame.IsZeroSize()) {
       capture_time = deliver_frame.render_time_ms();
       encode_start_time = Clock::GetRealTimeClock()->TimeInMilliseconds();
+      stats_proxy_->OnFrameDeliveredToEncoder(
+          static_cast<int>(encode_start_time - captured_frame_time_ms));
       frame_callback_->DeliverFrame(deliver_frame);
     }
     // Update the overuse detector with the duration.
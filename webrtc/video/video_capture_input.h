@@ -25,6 +25,7 @@
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/thread_wrapper.h"
 #include "webrtc/typedefs.h"
+#include "webrtc/video/frame_mailbox.h"
 #include "webrtc/video_engine/vie_defines.h"
 #include "webrtc/video_send_stream.h"
 
@@ -55,7 +56,8 @@ class VideoCaptureInput : public webrtc::VideoCaptureInput {
                     VideoCaptureCallback* frame_callback,
                     VideoRenderer* local_renderer,
                     SendStatisticsProxy* send_stats_proxy,
-                    CpuOveruseObserver* overuse_observer);
+                    CpuOveruseObserver* overuse_observer,
+                    FrameMailbox::DropPolicy drop_policy);
   ~VideoCaptureInput();
 
   void IncomingCapturedFrame(const VideoFrame& video_frame) override;
@@ -67,6 +69,8 @@ class VideoCaptureInput : public webrtc::VideoCaptureInput {
 
   void DeliverI420Frame(VideoFrame* video_frame);
 
+  // Serializes capturers. The capture thread takes frames from |mailbox_|
+  // without locking.
   rtc::scoped_ptr<CriticalSectionWrapper> capture_cs_;
   ProcessThread* const module_process_thread_;
 
@@ -74,19 +78,16 @@ class VideoCaptureInput : public webrtc::VideoCaptureInput {
   VideoRenderer* const local_renderer_;
   SendStatisticsProxy* const stats_proxy_;
 
-  // Frame used in IncomingFrameI420.
-  rtc::scoped_ptr<CriticalSectionWrapper> incoming_frame_cs_;
-  VideoFrame incoming_frame_;
-
   // Capture thread.
   rtc::scoped_ptr<ThreadWrapper> capture_thread_;
   // TODO(pbos): scoped_ptr
   EventWrapper& capture_event_;
-  EventWrapper& deliver_event_;
 
   volatile int stop_;
 
-  VideoFrame captured_frame_ GUARDED_BY(capture_cs_.get());
+  // Captured frame not yet handed to the encoder. Frames are dropped here,
+  // rather than queued up, when encoding falls behind.
+  FrameMailbox mailbox_;
   // Used to make sure incoming time stamp is increasing for every frame.
   int64_t last_captured_timestamp_;
   // Delta used for translating between NTP and internal timestamps.
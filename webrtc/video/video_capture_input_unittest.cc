@@ -64,7 +64,8 @@ class VideoCaptureInputTest : public ::testing::Test {
     Config config;
     input_.reset(new internal::VideoCaptureInput(
         mock_process_thread_.get(), mock_frame_callback_.get(), nullptr,
-        &stats_proxy_, nullptr));
+        &stats_proxy_, nullptr,
+        internal::FrameMailbox::DropPolicy::kDropOldest));
   }
 
   virtual void TearDown() {
@@ -161,6 +162,16 @@ TEST_F(VideoCaptureInputTest, TestRtpTimeStampSet) {
             input_frames_[0]->ntp_time_ms() * 90);
 }
 
+TEST_F(VideoCaptureInputTest, ReportsCaptureToEncodeDelay) {
+  input_frames_.push_back(CreateVideoFrame(0));
+  AddInputFrame(input_frames_[0]);
+  WaitOutputFrame();
+
+  VideoSendStream::Stats stats = stats_proxy_.GetStats();
+  EXPECT_GE(stats.capture_to_encode_p50_ms, 0);
+  EXPECT_LT(stats.capture_to_encode_p99_ms, FRAME_TIMEOUT_MS);
+}
+
 TEST_F(VideoCaptureInputTest, DropsFramesWithSameOrOldNtpTimestamp) {
   input_frames_.push_back(CreateVideoFrame(0));
 
@@ -126,6 +126,8 @@ VideoCodec CreateDecoderVideoCodec(const VideoReceiveStream::Decoder& decoder) {
 
 VideoReceiveStream::VideoReceiveStream(int num_cpu_cores,
                                        ChannelGroup* channel_group,
+                                       RenderScheduler* render_scheduler,
+                                       DecodeThreadPool* decode_thread_pool,
                                        int channel_id,
                                        const VideoReceiveStream::Config& config,
                                        webrtc::VoiceEngine* voice_engine)
@@ -234,7 +236,9 @@ VideoReceiveStream::VideoReceiveStream(int num_cpu_cores,
     CHECK_EQ(0, vie_channel_->SetReceiveCodec(codec));
   }
 
-  incoming_video_stream_.reset(new IncomingVideoStream(0));
+  vie_channel_->SetDecodeThreadPool(decode_thread_pool);
+
+  incoming_video_stream_.reset(new IncomingVideoStream(0, render_scheduler));
   incoming_video_stream_->SetExpectedRenderDelay(config.render_delay_ms);
   incoming_video_stream_->SetExternalCallback(this);
   vie_channel_->SetIncomingVideoStream(incoming_video_stream_.get());
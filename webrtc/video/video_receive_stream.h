@@ -39,6 +39,8 @@ class VideoReceiveStream : public webrtc::VideoReceiveStream,
  public:
   VideoReceiveStream(int num_cpu_cores,
                      ChannelGroup* channel_group,
+                     RenderScheduler* render_scheduler,
+                     DecodeThreadPool* decode_thread_pool,
                      int channel_id,
                      const VideoReceiveStream::Config& config,
                      webrtc::VoiceEngine* voice_engine);
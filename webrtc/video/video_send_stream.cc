@@ -95,6 +95,8 @@ std::string VideoSendStream::Config::ToString() const {
   ss << ", target_delay_ms: " << target_delay_ms;
   ss << ", suspend_below_min_bitrate: " << (suspend_below_min_bitrate ? "on"
                                                                       : "off");
+  ss << ", drop_newer_captured_frames: "
+     << (drop_newer_captured_frames ? "on" : "off");
   ss << '}';
   return ss.str();
 }
@@ -162,7 +164,10 @@ VideoSendStream::VideoSendStream(
 
   input_.reset(new internal::VideoCaptureInput(
       module_process_thread_, vie_encoder_, config_.local_renderer,
-      &stats_proxy_, overuse_observer));
+      &stats_proxy_, overuse_observer,
+      config_.drop_newer_captured_frames
+          ? FrameMailbox::DropPolicy::kDropNewest
+          : FrameMailbox::DropPolicy::kDropOldest));
 
   // 28 to match packet overhead in ModuleRtpRtcpImpl.
   DCHECK_LE(config_.rtp.max_packet_size, static_cast<size_t>(0xFFFF - 28));
@@ -0,0 +1,178 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/video_engine/decode_thread_pool.h"
+
+#include "webrtc/base/checks.h"
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/condition_variable_wrapper.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+
+namespace webrtc {
+
+// Same as the wait time of the per-channel decode thread.
+const int64_t DecodeThreadPool::kMaxPollIntervalMs = 50;
+
+DecodeThreadPool::DecodeThreadPool(Clock* clock, int num_threads)
+    : clock_(clock),
+      crit_(CriticalSectionWrapper::CreateCriticalSection()),
+      wake_up_(ConditionVariableWrapper::CreateConditionVariable()),
+      decoder_done_(ConditionVariableWrapper::CreateConditionVariable()),
+      stop_(false) {
+  DCHECK_GT(num_threads, 0);
+  for (int i = 0; i < num_threads; ++i) {
+    rtc::scoped_ptr<ThreadWrapper> thread = ThreadWrapper::CreateThread(
+        &DecodeThreadPool::Run, this, "DecodingThread");
+    CHECK(thread->Start());
+    thread->SetPriority(kHighestPriority);
+    threads_.push_back(thread.release());
+  }
+}
+
+DecodeThreadPool::~DecodeThreadPool() {
+  {
+    CriticalSectionScoped cs(crit_.get());
+    DCHECK(decoders_.empty());
+    stop_ = true;
+  }
+  wake_up_->WakeAll();
+  for (ThreadWrapper* thread : threads_) {
+    CHECK(thread->Stop());
+    delete thread;
+  }
+}
+
+void DecodeThreadPool::AddDecoder(Decoder* decoder) {
+  CriticalSectionScoped cs(crit_.get());
+  std::map<Decoder*, DecoderState>::iterator it = decoders_.find(decoder);
+  if (it != decoders_.end()) {
+    // Re-added from within DecodeNextFrame() after being removed.
+    it->second.removed = false;
+    return;
+  }
+  decoders_[decoder] = DecoderState();
+  ScheduleLocked(decoder, clock_->TimeInMilliseconds());
+}
+
+void DecodeThreadPool::RemoveDecoder(Decoder* decoder) {
+  CriticalSectionScoped cs(crit_.get());
+  std::map<Decoder*, DecoderState>::iterator it = decoders_.find(decoder);
+  if (it == decoders_.end())
+    return;
+  if (it->second.running &&
+      rtc::IsThreadRefEqual(it->second.running_thread,
+                            rtc::CurrentThreadRef())) {
+    // Called from within DecodeNextFrame(), which would never return if we
+    // waited for it. Erased by Process() once it returns.
+    it->second.removed = true;
+    return;
+  }
+  while (it->second.running) {
+    decoder_done_->SleepCS(*crit_);
+    it = decoders_.find(decoder);
+    // Removed by itself meanwhile.
+    if (it == decoders_.end())
+      return;
+  }
+  decoders_.erase(it);
+}
+
+void DecodeThreadPool::WakeUp(Decoder* decoder) {
+  CriticalSectionScoped cs(crit_.get());
+  std::map<Decoder*, DecoderState>::iterator it = decoders_.find(decoder);
+  if (it == decoders_.end() || it->second.removed)
+    return;
+  if (it->second.running) {
+    // Rescheduled when done, so that it isn't picked up by another thread.
+    it->second.woken_up = true;
+    return;
+  }
+  ScheduleLocked(decoder, clock_->TimeInMilliseconds());
+}
+
+void DecodeThreadPool::ScheduleLocked(Decoder* decoder, int64_t run_at_ms) {
+  DecoderState& state = decoders_[decoder];
+  if (state.run_at_ms != -1 && state.run_at_ms <= run_at_ms)
+    return;
+  const bool earliest = heap_.empty() || run_at_ms < heap_.top().first;
+  state.run_at_ms = run_at_ms;
+  heap_.push(ScheduledDecoder(run_at_ms, decoder));
+  if (earliest)
+    wake_up_->Wake();
+}
+
+// static
+bool DecodeThreadPool::Run(void* obj) {
+  return static_cast<DecodeThreadPool*>(obj)->Process();
+}
+
+bool DecodeThreadPool::Process() {
+  CriticalSectionScoped cs(crit_.get());
+  if (stop_)
+    return false;
+
+  // Find the decoder that has been due the longest, dropping stale entries.
+  const int64_t now_ms = clock_->TimeInMilliseconds();
+  Decoder* decoder = nullptr;
+  while (!heap_.empty()) {
+    const ScheduledDecoder scheduled = heap_.top();
+    std::map<Decoder*, DecoderState>::iterator it =
+        decoders_.find(scheduled.second);
+    if (it == decoders_.end() || it->second.run_at_ms != scheduled.first) {
+      heap_.pop();
+      continue;
+    }
+    if (scheduled.first > now_ms)
+      break;
+    heap_.pop();
+    it->second.run_at_ms = -1;
+    it->second.running = true;
+    it->second.running_thread = rtc::CurrentThreadRef();
+    it->second.woken_up = false;
+    decoder = scheduled.second;
+    // Hand any other due decoder to another thread.
+    if (!heap_.empty() && heap_.top().first <= now_ms)
+      wake_up_->Wake();
+    break;
+  }
+
+  if (!decoder) {
+    const int64_t wait_ms =
+        heap_.empty() ? kMaxPollIntervalMs : heap_.top().first - now_ms;
+    wake_up_->SleepCS(*crit_, static_cast<unsigned long>(wait_ms));
+    return true;
+  }
+
+  int64_t delay_ms;
+  {
+    crit_->Leave();
+    delay_ms = decoder->DecodeNextFrame();
+    crit_->Enter();
+  }
+
+  std::map<Decoder*, DecoderState>::iterator it = decoders_.find(decoder);
+  DCHECK(it != decoders_.end());
+  decoder_done_->WakeAll();
+  if (it->second.removed) {
+    decoders_.erase(it);
+    return true;
+  }
+  it->second.running = false;
+  if (it->second.woken_up) {
+    delay_ms = 0;
+  } else if (delay_ms == -1) {
+    delay_ms = kMaxPollIntervalMs;
+  }
+  ScheduleLocked(decoder, clock_->TimeInMilliseconds() + delay_ms);
+  return true;
+}
+
+}  // namespace webrtc
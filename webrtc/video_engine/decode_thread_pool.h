@@ -0,0 +1,115 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_VIDEO_ENGINE_DECODE_THREAD_POOL_H_
+#define WEBRTC_VIDEO_ENGINE_DECODE_THREAD_POOL_H_
+
+#include <functional>
+#include <map>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/thread_annotations.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+
+namespace webrtc {
+
+class Clock;
+class ConditionVariableWrapper;
+class CriticalSectionWrapper;
+
+// Decodes frames for any number of receive channels on a fixed number of
+// threads, instead of one blocking decode thread per channel. A decoder is
+// run at the time it reports its next frame is due for decoding, and when it
+// has been woken up because new data arrived. A decoder without a pending
+// frame is polled at kMaxPollIntervalMs. Decoders that are due are run in the
+// order they became due, and a decoder is never run on two threads at once.
+class DecodeThreadPool {
+ public:
+  class Decoder {
+   public:
+    // Decodes the next frame if it's due, without blocking. Returns the
+    // number of milliseconds until it wants to run again: until the next
+    // frame is due for decoding, 0 if a frame was decoded, or -1 if there is
+    // no frame to wait for. The pool schedules the next run on its own clock.
+    virtual int64_t DecodeNextFrame() = 0;
+
+   protected:
+    virtual ~Decoder() {}
+  };
+
+  // Decoders without a pending frame are polled this often, to pick up frames
+  // that become decodable without new data arriving.
+  static const int64_t kMaxPollIntervalMs;
+
+  DecodeThreadPool(Clock* clock, int num_threads);
+  ~DecodeThreadPool();
+
+  // Adding a decoder that has already been added has no effect.
+  void AddDecoder(Decoder* decoder);
+  // Blocks until an ongoing DecodeNextFrame() call on |decoder| has returned.
+  // If called from within that call, the decoder is removed when it returns
+  // instead, since waiting would deadlock.
+  void RemoveDecoder(Decoder* decoder);
+
+  // Runs |decoder| as soon as a thread is available, e.g. since a packet has
+  // been inserted into its jitter buffer. Allowed to be called on any thread.
+  void WakeUp(Decoder* decoder);
+
+ private:
+  struct DecoderState {
+    DecoderState()
+        : run_at_ms(-1), running(false), woken_up(false), removed(false) {}
+    // Time the decoder is scheduled to run at, or -1 if not scheduled.
+    int64_t run_at_ms;
+    // Set while a thread, |running_thread|, is running the decoder.
+    bool running;
+    rtc::PlatformThreadRef running_thread;
+    // Set if the decoder was woken up while running.
+    bool woken_up;
+    // Set if the decoder was removed from within DecodeNextFrame().
+    bool removed;
+  };
+  typedef std::pair<int64_t, Decoder*> ScheduledDecoder;
+
+  static bool Run(void* obj);
+  bool Process();
+
+  // Schedules |decoder| to run at |run_at_ms| unless it's already scheduled
+  // to run earlier.
+  void ScheduleLocked(Decoder* decoder, int64_t run_at_ms)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  Clock* const clock_;
+  const rtc::scoped_ptr<CriticalSectionWrapper> crit_;
+  // Signalled when a decoder becomes due earlier than the threads are waiting
+  // for.
+  const rtc::scoped_ptr<ConditionVariableWrapper> wake_up_;
+  // Signalled when a decoder has finished running.
+  const rtc::scoped_ptr<ConditionVariableWrapper> decoder_done_;
+  std::vector<ThreadWrapper*> threads_;
+
+  std::map<Decoder*, DecoderState> decoders_ GUARDED_BY(crit_);
+  // Entries that don't match the decoder's |run_at_ms| are stale and skipped.
+  std::priority_queue<ScheduledDecoder,
+                      std::vector<ScheduledDecoder>,
+                      std::greater<ScheduledDecoder>> heap_ GUARDED_BY(crit_);
+  bool stop_ GUARDED_BY(crit_);
+
+  DISALLOW_COPY_AND_ASSIGN(DecodeThreadPool);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_VIDEO_ENGINE_DECODE_THREAD_POOL_H_
@@ -0,0 +1,148 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/video_engine/decode_thread_pool.h"
+
+#include <deque>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/stringutils.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/sleep.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+// Stands in for a receive channel whose frames take |decode_time_ms| of CPU
+// time to decode. Counts frames that are not decoded within |deadline_ms| of
+// being inserted.
+class FakeChannel : public DecodeThreadPool::Decoder {
+ public:
+  FakeChannel(Clock* clock, int decode_time_ms, int64_t deadline_ms)
+      : clock_(clock),
+        crit_(CriticalSectionWrapper::CreateCriticalSection()),
+        decode_time_ms_(decode_time_ms),
+        deadline_ms_(deadline_ms),
+        num_decoded_(0),
+        num_deadline_misses_(0) {}
+
+  void InsertFrame() {
+    CriticalSectionScoped cs(crit_.get());
+    frames_.push_back(clock_->TimeInMilliseconds());
+  }
+
+  int64_t DecodeNextFrame() override {
+    int64_t insert_time_ms;
+    {
+      CriticalSectionScoped cs(crit_.get());
+      if (frames_.empty())
+        return -1;
+      insert_time_ms = frames_.front();
+      frames_.pop_front();
+    }
+    const int64_t start_us = clock_->TimeInMicroseconds();
+    while (clock_->TimeInMicroseconds() - start_us < 1000 * decode_time_ms_) {
+    }
+    CriticalSectionScoped cs(crit_.get());
+    ++num_decoded_;
+    if (clock_->TimeInMilliseconds() > insert_time_ms + deadline_ms_)
+      ++num_deadline_misses_;
+    return 0;
+  }
+
+  int num_decoded() const {
+    CriticalSectionScoped cs(crit_.get());
+    return num_decoded_;
+  }
+  int num_deadline_misses() const {
+    CriticalSectionScoped cs(crit_.get());
+    return num_deadline_misses_;
+  }
+
+ private:
+  Clock* const clock_;
+  const rtc::scoped_ptr<CriticalSectionWrapper> crit_;
+  const int decode_time_ms_;
+  const int64_t deadline_ms_;
+  std::deque<int64_t> frames_;
+  int num_decoded_;
+  int num_deadline_misses_;
+};
+
+}  // namespace
+
+// Decodes 25 streams at 30 fps with 1 ms of CPU per frame, either with one
+// thread per stream, like ViEChannel's own decode thread, or with all streams
+// on a pool of 4 threads. A frame misses its deadline if it isn't decoded
+// within 30 ms of being inserted. The result depends on the number of cores
+// of the machine running the test.
+TEST(DecodeThreadPoolPerfTest, TwentyFiveStreams) {
+  const int kNumStreams = 25;
+  const int kFps = 30;
+  const int kDecodeTimeMs = 1;
+  const int64_t kDeadlineMs = 30;
+  const int64_t kDurationMs = 3000;
+  Clock* clock = Clock::GetRealTimeClock();
+  for (int num_pools : {kNumStreams, 1}) {
+    const int threads_per_pool = num_pools == 1 ? 4 : 1;
+    std::vector<DecodeThreadPool*> pools;
+    for (int i = 0; i < num_pools; ++i)
+      pools.push_back(new DecodeThreadPool(clock, threads_per_pool));
+    std::vector<FakeChannel*> channels;
+    for (int i = 0; i < kNumStreams; ++i) {
+      channels.push_back(new FakeChannel(clock, kDecodeTimeMs, kDeadlineMs));
+      pools[i % num_pools]->AddDecoder(channels[i]);
+    }
+
+    const int64_t start_ms = clock->TimeInMilliseconds();
+    int num_frames = 0;
+    for (int64_t next_frame_ms = start_ms;
+         next_frame_ms < start_ms + kDurationMs;
+         next_frame_ms += 1000 / kFps) {
+      const int64_t sleep_ms = next_frame_ms - clock->TimeInMilliseconds();
+      if (sleep_ms > 0)
+        SleepMs(static_cast<int>(sleep_ms));
+      for (int i = 0; i < kNumStreams; ++i) {
+        channels[i]->InsertFrame();
+        pools[i % num_pools]->WakeUp(channels[i]);
+      }
+      ++num_frames;
+    }
+
+    int num_decoded = 0;
+    int num_deadline_misses = 0;
+    for (int i = 0; i < kNumStreams; ++i) {
+      for (int j = 0; j < 5000 && channels[i]->num_decoded() < num_frames; ++j)
+        SleepMs(1);
+      pools[i % num_pools]->RemoveDecoder(channels[i]);
+      num_decoded += channels[i]->num_decoded();
+      num_deadline_misses += channels[i]->num_deadline_misses();
+      delete channels[i];
+    }
+    for (DecodeThreadPool* pool : pools)
+      delete pool;
+
+    EXPECT_EQ(kNumStreams * num_frames, num_decoded);
+    char trace[32];
+    rtc::sprintfn(trace, sizeof(trace), "%d_threads",
+                  num_pools * threads_per_pool);
+    test::PrintResult("decode_thread_pool_deadline_misses", "", trace,
+                      static_cast<size_t>(num_deadline_misses), "frames",
+                      true);
+    test::PrintResult("decode_thread_pool_frames_decoded", "", trace,
+                      static_cast<size_t>(num_decoded), "frames", false);
+  }
+}
+
+}  // namespace webrtc
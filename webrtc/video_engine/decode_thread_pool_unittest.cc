@@ -0,0 +1,232 @@
+/*
+ *  Copyright (c) 2015 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/video_engine/decode_thread_pool.h"
+
+#include <algorithm>
+#include <deque>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/sleep.h"
+
+namespace webrtc {
+namespace {
+
+// Stands in for a receive channel. Frames are inserted as if they had been
+// completed in the jitter buffer, each due for decoding at a given time, like
+// VideoCodingModule::DecodeIfDue(). Decoding one takes |decode_time_ms| of
+// CPU time, like FakeDecoder with a fixed cost.
+class FakeChannel : public DecodeThreadPool::Decoder {
+ public:
+  FakeChannel(Clock* clock, int decode_time_ms, int64_t deadline_ms)
+      : clock_(clock),
+        crit_(CriticalSectionWrapper::CreateCriticalSection()),
+        decode_time_ms_(decode_time_ms),
+        deadline_ms_(deadline_ms),
+        remove_from_pool_(nullptr),
+        num_calls_(0),
+        num_decoded_(0),
+        num_deadline_misses_(0),
+        max_lateness_ms_(0),
+        num_concurrent_calls_(0),
+        max_concurrent_calls_(0) {}
+
+  // Inserts a frame that is due for decoding at |decode_time_ms|.
+  void InsertFrame(int64_t decode_time_ms) {
+    CriticalSectionScoped cs(crit_.get());
+    frames_.push_back(decode_time_ms);
+  }
+  void InsertFrame() { InsertFrame(clock_->TimeInMilliseconds()); }
+
+  // Makes the next DecodeNextFrame() call remove the channel from |pool|.
+  void RemoveOnNextCall(DecodeThreadPool* pool) {
+    CriticalSectionScoped cs(crit_.get());
+    remove_from_pool_ = pool;
+  }
+
+  int64_t DecodeNextFrame() override {
+    int64_t due_ms;
+    {
+      CriticalSectionScoped cs(crit_.get());
+      ++num_calls_;
+      if (remove_from_pool_) {
+        remove_from_pool_->RemoveDecoder(this);
+        remove_from_pool_ = nullptr;
+      }
+      ++num_concurrent_calls_;
+      max_concurrent_calls_ =
+          std::max(max_concurrent_calls_, num_concurrent_calls_);
+      if (frames_.empty()) {
+        --num_concurrent_calls_;
+        return -1;
+      }
+      due_ms = frames_.front();
+      if (due_ms > clock_->TimeInMilliseconds()) {
+        --num_concurrent_calls_;
+        return due_ms - clock_->TimeInMilliseconds();
+      }
+      frames_.pop_front();
+      max_lateness_ms_ =
+          std::max(max_lateness_ms_, clock_->TimeInMilliseconds() - due_ms);
+    }
+    const int64_t start_us = clock_->TimeInMicroseconds();
+    while (clock_->TimeInMicroseconds() - start_us < 1000 * decode_time_ms_) {
+    }
+    CriticalSectionScoped cs(crit_.get());
+    ++num_decoded_;
+    if (clock_->TimeInMilliseconds() > due_ms + deadline_ms_)
+      ++num_deadline_misses_;
+    --num_concurrent_calls_;
+    return 0;
+  }
+
+  int num_calls() const {
+    CriticalSectionScoped cs(crit_.get());
+    return num_calls_;
+  }
+  int num_decoded() const {
+    CriticalSectionScoped cs(crit_.get());
+    return num_decoded_;
+  }
+  int num_deadline_misses() const {
+    CriticalSectionScoped cs(crit_.get());
+    return num_deadline_misses_;
+  }
+  int max_concurrent_calls() const {
+    CriticalSectionScoped cs(crit_.get());
+    return max_concurrent_calls_;
+  }
+  // Longest time from a frame being due to it being decoded.
+  int64_t max_lateness_ms() const {
+    CriticalSectionScoped cs(crit_.get());
+    return max_lateness_ms_;
+  }
+
+ private:
+  Clock* const clock_;
+  const rtc::scoped_ptr<CriticalSectionWrapper> crit_;
+  const int decode_time_ms_;
+  const int64_t deadline_ms_;
+  DecodeThreadPool* remove_from_pool_;
+  std::deque<int64_t> frames_;
+  int num_calls_;
+  int num_decoded_;
+  int num_deadline_misses_;
+  int64_t max_lateness_ms_;
+  int num_concurrent_calls_;
+  int max_concurrent_calls_;
+};
+
+// Waits until |channel| has decoded |num_frames| frames or 5 s have passed.
+void WaitForDecoded(const FakeChannel& channel, int num_frames) {
+  for (int i = 0; i < 5000 && channel.num_decoded() < num_frames; ++i)
+    SleepMs(1);
+}
+}  // namespace
+
+class DecodeThreadPoolTest : public ::testing::Test {
+ protected:
+  DecodeThreadPoolTest() : clock_(Clock::GetRealTimeClock()) {}
+
+  Clock* const clock_;
+};
+
+TEST_F(DecodeThreadPoolTest, DecodesWhenWokenUp) {
+  DecodeThreadPool pool(clock_, 1);
+  FakeChannel channel(clock_, 0, 1000);
+  pool.AddDecoder(&channel);
+  // Let the first poll pass.
+  SleepMs(10);
+
+  const int64_t start_ms = clock_->TimeInMilliseconds();
+  channel.InsertFrame();
+  pool.WakeUp(&channel);
+  WaitForDecoded(channel, 1);
+  EXPECT_EQ(1, channel.num_decoded());
+  EXPECT_LT(clock_->TimeInMilliseconds() - start_ms,
+            DecodeThreadPool::kMaxPollIntervalMs);
+  pool.RemoveDecoder(&channel);
+}
+
+TEST_F(DecodeThreadPoolTest, PollsDecodersThatAreNotWokenUp) {
+  DecodeThreadPool pool(clock_, 1);
+  FakeChannel channel(clock_, 0, 1000);
+  pool.AddDecoder(&channel);
+  SleepMs(10);
+  channel.InsertFrame();
+  WaitForDecoded(channel, 1);
+  EXPECT_EQ(1, channel.num_decoded());
+
+  // Without new frames the decoder is only polled, not busy-looped.
+  const int num_calls = channel.num_calls();
+  SleepMs(10 * DecodeThreadPool::kMaxPollIntervalMs);
+  EXPECT_LE(channel.num_calls() - num_calls, 11);
+  pool.RemoveDecoder(&channel);
+}
+
+// Frames that aren't due yet, e.g. since they are to be rendered later, are
+// decoded when they become due rather than when the decoder is next woken up
+// or polled. Runs on a simulated clock, which only the test advances, so a
+// frame can't be decoded early or late because of scheduling delays.
+TEST_F(DecodeThreadPoolTest, DecodesFramesWhenDue) {
+  SimulatedClock clock(1000);
+  DecodeThreadPool pool(&clock, 1);
+  FakeChannel channel(&clock, 0, 1000);
+  pool.AddDecoder(&channel);
+
+  const int64_t kDecodeDelayMs = 30;
+  channel.InsertFrame(clock.TimeInMilliseconds() + kDecodeDelayMs);
+  pool.WakeUp(&channel);
+  clock.AdvanceTimeMilliseconds(kDecodeDelayMs - 1);
+  SleepMs(2 * kDecodeDelayMs);
+  EXPECT_EQ(0, channel.num_decoded());
+
+  clock.AdvanceTimeMilliseconds(1);
+  WaitForDecoded(channel, 1);
+  EXPECT_EQ(1, channel.num_decoded());
+  EXPECT_EQ(0, channel.max_lateness_ms());
+  pool.RemoveDecoder(&channel);
+}
+
+TEST_F(DecodeThreadPoolTest, DecoderCanRemoveItself) {
+  DecodeThreadPool pool(clock_, 1);
+  FakeChannel channel(clock_, 0, 1000);
+  channel.InsertFrame();
+  channel.RemoveOnNextCall(&pool);
+  pool.AddDecoder(&channel);
+  WaitForDecoded(channel, 1);
+  EXPECT_EQ(1, channel.num_decoded());
+
+  // Not run again once removed, even when woken up.
+  const int num_calls = channel.num_calls();
+  channel.InsertFrame();
+  pool.WakeUp(&channel);
+  SleepMs(2 * DecodeThreadPool::kMaxPollIntervalMs);
+  EXPECT_EQ(num_calls, channel.num_calls());
+}
+
+TEST_F(DecodeThreadPoolTest, DoesNotRunDecoderOnTwoThreadsAtOnce) {
+  DecodeThreadPool pool(clock_, 4);
+  FakeChannel channel(clock_, 1, 1000);
+  pool.AddDecoder(&channel);
+  for (int i = 0; i < 50; ++i) {
+    channel.InsertFrame();
+    pool.WakeUp(&channel);
+  }
+  WaitForDecoded(channel, 50);
+  pool.RemoveDecoder(&channel);
+  EXPECT_EQ(50, channel.num_decoded());
+  EXPECT_EQ(1, channel.max_concurrent_calls());
+}
+
+}  // namespace webrtc
@@ -24,6 +24,7 @@
       ],
       'sources': [
         'call_stats_unittest.cc',
+        'decode_thread_pool_unittest.cc',
         'encoder_state_feedback_unittest.cc',
         'overuse_frame_detector_unittest.cc',
         'payload_router_unittest.cc',
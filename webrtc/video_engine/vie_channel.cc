@@ -113,6 +113,7 @@ ViEChannel::ViEChannel(int32_t channel_id,
       packet_router_(packet_router),
       bandwidth_observer_(bandwidth_observer),
       send_time_observer_(send_time_observer),
+      decode_thread_pool_(nullptr),
       nack_history_size_sender_(kSendSidePacketHistorySize),
       max_nack_reordering_threshold_(kMaxPacketAgeToNack),
       pre_render_callback_(NULL),
@@ -189,9 +190,7 @@ ViEChannel::~ViEChannel() {
     module_process_thread_->DeRegisterModule(rtp_rtcp);
     delete rtp_rtcp;
   }
-  if (decode_thread_) {
-    StopDecodeThread();
-  }
+  StopDecodeThread();
   // Release modules.
   VideoCodingModule::Destroy(vcm_);
 }
@@ -988,8 +987,12 @@ void ViEChannel::StopReceive() {
 int32_t ViEChannel::ReceivedRTPPacket(const void* rtp_packet,
                                       size_t rtp_packet_length,
                                       const PacketTime& packet_time) {
-  return vie_receiver_.ReceivedRTPPacket(
+  const int32_t ret = vie_receiver_.ReceivedRTPPacket(
       rtp_packet, rtp_packet_length, packet_time);
+  // The packet may have completed a frame.
+  if (decode_thread_pool_)
+    decode_thread_pool_->WakeUp(this);
+  return ret;
 }
 
 int32_t ViEChannel::ReceivedRTCPPacket(const void* rtcp_packet,
@@ -1102,6 +1105,20 @@ bool ViEChannel::ChannelDecodeProcess() {
   return true;
 }
 
+int64_t ViEChannel::DecodeNextFrame() {
+  int64_t next_decode_time_ms;
+  if (vcm_->DecodeIfDue(&next_decode_time_ms) != VCM_FRAME_NOT_READY) {
+    // More frames may be due.
+    return 0;
+  }
+  if (next_decode_time_ms == -1)
+    return -1;
+  // |next_decode_time_ms| is in the clock |vcm_| was created with.
+  return std::max<int64_t>(
+      next_decode_time_ms - Clock::GetRealTimeClock()->TimeInMilliseconds(),
+      0);
+}
+
 void ViEChannel::OnRttUpdate(int64_t avg_rtt_ms, int64_t max_rtt_ms) {
   vcm_->SetReceiveChannelParameters(max_rtt_ms);
 
@@ -1189,6 +1206,10 @@ std::vector<RtpRtcp*> ViEChannel::CreateRtpRtcpModules(
 
 void ViEChannel::StartDecodeThread() {
   DCHECK(!sender_);
+  if (decode_thread_pool_) {
+    decode_thread_pool_->AddDecoder(this);
+    return;
+  }
   // Start the decode thread
   if (decode_thread_)
     return;
@@ -1199,6 +1220,11 @@ void ViEChannel::StartDecodeThread() {
 }
 
 void ViEChannel::StopDecodeThread() {
+  if (decode_thread_pool_) {
+    // Waits for an ongoing DecodeNextFrame() call to return.
+    decode_thread_pool_->RemoveDecoder(this);
+    return;
+  }
   if (!decode_thread_)
     return;
 
@@ -1274,4 +1300,9 @@ void ViEChannel::SetIncomingVideoStream(
   CriticalSectionScoped cs(crit_.get());
   incoming_video_stream_ = incoming_video_stream;
 }
+
+void ViEChannel::SetDecodeThreadPool(DecodeThreadPool* decode_thread_pool) {
+  DCHECK(!decode_thread_);
+  decode_thread_pool_ = decode_thread_pool;
+}
 }  // namespace webrtc
@@ -22,6 +22,7 @@
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/tick_util.h"
 #include "webrtc/typedefs.h"
+#include "webrtc/video_engine/decode_thread_pool.h"
 #include "webrtc/video_engine/vie_defines.h"
 #include "webrtc/video_engine/vie_receiver.h"
 #include "webrtc/video_engine/vie_sync_module.h"
@@ -60,7 +61,8 @@ class ViEChannel : public VCMFrameTypeCallback,
                    public VCMReceiveStatisticsCallback,
                    public VCMDecoderTimingCallback,
                    public VCMPacketRequestCallback,
-                   public RtpFeedback {
+                   public RtpFeedback,
+                   public DecodeThreadPool::Decoder {
  public:
   friend class ChannelStatsObserver;
   friend class ViEChannelProtectionCallback;
@@ -281,11 +283,17 @@ class ViEChannel : public VCMFrameTypeCallback,
   void RegisterReceiveStatisticsProxy(
       ReceiveStatisticsProxy* receive_statistics_proxy);
   void SetIncomingVideoStream(IncomingVideoStream* incoming_video_stream);
+  // Decodes on |decode_thread_pool| instead of a thread of the channel's own.
+  // Must be called before StartReceive().
+  void SetDecodeThreadPool(DecodeThreadPool* decode_thread_pool);
 
  protected:
   static bool ChannelDecodeThreadFunction(void* obj);
   bool ChannelDecodeProcess();
 
+  // Implements DecodeThreadPool::Decoder.
+  int64_t DecodeNextFrame() override;
+
   void OnRttUpdate(int64_t avg_rtt_ms, int64_t max_rtt_ms);
 
   int ProtectionRequest(const FecProtectionParams* delta_fec_params,
@@ -444,6 +452,7 @@ class ViEChannel : public VCMFrameTypeCallback,
   SendTimeObserver* const send_time_observer_;
 
   rtc::scoped_ptr<ThreadWrapper> decode_thread_;
+  DecodeThreadPool* decode_thread_pool_;
 
   int nack_history_size_sender_;
   int max_nack_reordering_threshold_;
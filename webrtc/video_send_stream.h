@@ -58,6 +58,11 @@ class VideoSendStream : public SendStream {
     int encode_frame_rate = 0;
     int avg_encode_time_ms = 0;
     int encode_usage_percent = 0;
+    // Percentiles over recent frames of the time from a frame being handed to
+    // the send stream until it is delivered to the encoder. -1 if unknown.
+    int capture_to_encode_p50_ms = -1;
+    int capture_to_encode_p95_ms = -1;
+    int capture_to_encode_p99_ms = -1;
     int target_media_bitrate_bps = 0;
     int media_bitrate_bps = 0;
     bool suspended = false;
@@ -147,6 +152,12 @@ class VideoSendStream : public SendStream {
     // below the minimum configured bitrate. If this variable is false, the
     // stream may send at a rate higher than the estimated available bitrate.
     bool suspend_below_min_bitrate = false;
+
+    // Frames captured faster than they can be encoded are dropped. By default
+    // a frame waiting to be encoded is dropped when a newer one is captured,
+    // which gives the lowest capture-to-encode delay. If true, the newer frame
+    // is dropped instead, so that a waiting frame always reaches the encoder.
+    bool drop_newer_captured_frames = false;
   };
 
   // Gets interface used to insert captured frames. Valid as long as the